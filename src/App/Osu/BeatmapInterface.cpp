@@ -537,6 +537,9 @@ bool BeatmapInterface::start() {
     osu->bIsPlayingASelectedBeatmap = true;
     osu->setShouldPauseBGThreads(true);
 
+    // frame time percentiles are reported per play
+    engine->resetFrameTimeStats();
+
     soundEngine->play(this->getSkin()->s_menu_hit);
 
     osu->updateMods();
@@ -1067,10 +1070,9 @@ void BeatmapInterface::seekMS(u32 ms) {
     }
 
     if(this->is_watching) {
-        // When seeking backwards, restart simulation from beginning
+        // Continue the simulation from the closest checkpoint, instead of from the beginning
+        if(this->sim) this->sim->seek_to((i32)ms);
         if(std::cmp_less(ms, this->iCurMusicPos)) {
-            this->sim = std::make_unique<SimulatedBeatmapInterface>(this->beatmap, osu->getScore()->mods);
-            this->sim->spectated_replay = this->spectated_replay;
             osu->getScore()->reset();
         }
     }
@@ -0,0 +1,273 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "BeatmapSearchIndex.h"
+
+#include "ByteBufferedFile.h"
+#include "DatabaseBeatmap.h"
+#include "Logging.h"
+
+#include <algorithm>
+
+// bump whenever the trigram extraction, the blob contents or the blob hash change
+#define NEOSU_SEARCH_INDEX_VERSION 20261017
+
+template <typename F>
+void BeatmapSearchIndex::forEachTrigram(std::string_view str, F &&callback) {
+    for(uSz i = 0; i + 3 <= str.size(); i++) {
+        const auto a = static_cast<u8>(str[i]);
+        const auto b = static_cast<u8>(str[i + 1]);
+        const auto c = static_cast<u8>(str[i + 2]);
+
+        // search blob fields are separated by newlines, trigrams spanning two fields are useless
+        if(a == '\n' || b == '\n' || c == '\n') continue;
+
+        callback(static_cast<u32>(a) | (static_cast<u32>(b) << 8) | (static_cast<u32>(c) << 16));
+    }
+}
+
+void BeatmapSearchIndex::add(const DatabaseBeatmap *diff) {
+    if(diff == nullptr) return;
+
+    const std::string_view blob = diff->getSearchBlob();
+    const u64 blob_hash = Hash::flat::hash<std::string_view>{}(blob);
+
+    Sync::unique_lock lock(this->mtx);
+    this->addLocked(diff->getMD5(), blob, blob_hash);
+}
+
+void BeatmapSearchIndex::addLocked(const MD5Hash &hash, std::string_view blob, u64 blob_hash) {
+    if(const auto it = this->slots.find(hash); it != this->slots.end()) {
+        if(this->entries[it->second].blob_hash == blob_hash) return;
+
+        // search blob changed (e.g. set id override), the old postings are dropped on the next compaction
+        this->removeSlot(it->second);
+        this->compactIfNeeded();
+    }
+
+    const auto slot = static_cast<u32>(this->entries.size());
+    this->entries.push_back({.hash = hash, .blob_hash = blob_hash, .live = true});
+    this->slots[hash] = slot;
+
+    forEachTrigram(blob, [this, slot](u32 trigram) {
+        PostingList &list = this->postings[trigram];
+        // the same trigram can occur multiple times in one blob
+        if(list.empty() || list.back() != slot) list.push_back(slot);
+    });
+}
+
+void BeatmapSearchIndex::remove(const MD5Hash &hash) {
+    Sync::unique_lock lock(this->mtx);
+    if(const auto it = this->slots.find(hash); it != this->slots.end()) {
+        this->removeSlot(it->second);
+        this->compactIfNeeded();
+    }
+}
+
+void BeatmapSearchIndex::removeSlot(u32 slot) {
+    Entry &entry = this->entries[slot];
+    if(!entry.live) return;
+
+    this->slots.erase(entry.hash);
+    entry.live = false;
+    this->nb_dead++;
+}
+
+void BeatmapSearchIndex::compactIfNeeded() {
+    if(this->nb_dead < 1024 || this->nb_dead * 4 < this->entries.size()) return;
+
+    // renumber the live slots, keeping their order so that the posting lists stay sorted
+    constexpr u32 DEAD = static_cast<u32>(-1);
+    std::vector<u32> remap(this->entries.size(), DEAD);
+    u32 nb_live = 0;
+    for(u32 slot = 0; slot < this->entries.size(); slot++) {
+        if(!this->entries[slot].live) continue;
+        remap[slot] = nb_live;
+        this->entries[nb_live] = this->entries[slot];
+        this->slots[this->entries[nb_live].hash] = nb_live;
+        nb_live++;
+    }
+    this->entries.resize(nb_live);
+    this->nb_dead = 0;
+
+    for(auto it = this->postings.begin(); it != this->postings.end();) {
+        PostingList &list = it->second;
+        std::erase_if(list, [&remap](u32 slot) { return remap[slot] == DEAD; });
+        if(list.empty()) {
+            it = this->postings.erase(it);
+            continue;
+        }
+        for(u32 &slot : list) slot = remap[slot];
+        list.shrink_to_fit();
+        ++it;
+    }
+}
+
+void BeatmapSearchIndex::clear() {
+    Sync::unique_lock lock(this->mtx);
+    this->entries.clear();
+    this->slots.clear();
+    this->postings.clear();
+    this->nb_dead = 0;
+}
+
+uSz BeatmapSearchIndex::size() const {
+    Sync::shared_lock lock(this->mtx);
+    return this->slots.size();
+}
+
+std::optional<BeatmapSearchIndex::Candidates> BeatmapSearchIndex::findCandidates(
+    const std::vector<std::string> &literals) const {
+    std::vector<u32> trigrams;
+    for(const auto &literal : literals) {
+        forEachTrigram(literal, [&trigrams](u32 trigram) { trigrams.push_back(trigram); });
+    }
+    if(trigrams.empty()) return std::nullopt;
+
+    std::ranges::sort(trigrams);
+    const auto [first, last] = std::ranges::unique(trigrams);
+    trigrams.erase(first, last);
+
+    Sync::shared_lock lock(this->mtx);
+
+    std::vector<const PostingList *> lists;
+    lists.reserve(trigrams.size());
+    for(const u32 trigram : trigrams) {
+        const auto it = this->postings.find(trigram);
+        if(it == this->postings.end()) return Candidates{};  // no blob contains this trigram
+        lists.push_back(&it->second);
+    }
+
+    // intersect the shortest lists first, that keeps the intermediate result small
+    std::ranges::sort(lists, {}, [](const PostingList *list) { return list->size(); });
+
+    PostingList result{*lists[0]};
+    PostingList tmp;
+    for(uSz i = 1; i < lists.size() && !result.empty(); i++) {
+        tmp.clear();
+        std::ranges::set_intersection(result, *lists[i], std::back_inserter(tmp));
+        result.swap(tmp);
+    }
+
+    Candidates candidates;
+    candidates.reserve(result.size());
+    for(const u32 slot : result) {
+        if(const Entry &entry = this->entries[slot]; entry.live) candidates.insert(entry.hash);
+    }
+    return candidates;
+}
+
+bool BeatmapSearchIndex::load(std::string_view path) {
+    ByteBufferedFile::Reader reader(path);
+    if(!reader.good() || reader.total_size == 0) return false;
+
+    const u32 version = reader.read<u32>();
+    if(version != NEOSU_SEARCH_INDEX_VERSION) {
+        debugLog("Ignoring search index {} (version {}, expected {})", path, version, NEOSU_SEARCH_INDEX_VERSION);
+        return false;
+    }
+
+    std::vector<Entry> new_entries;
+    Hash::flat::map<MD5Hash, u32> new_slots;
+    Hash::flat::map<u32, PostingList> new_postings;
+
+    // don't trust the counts for allocations, each entry takes at least 24 bytes
+    const u32 nb_entries = reader.read<u32>();
+    const uSz max_entries = reader.total_size / (sizeof(MD5Hash) + sizeof(u64));
+    new_entries.reserve(std::min<uSz>(nb_entries, max_entries));
+    new_slots.reserve(std::min<uSz>(nb_entries, max_entries));
+    for(u32 i = 0; i < nb_entries && reader.good(); i++) {
+        Entry entry{.live = true};
+        (void)reader.read_hash_digest(entry.hash);
+        entry.blob_hash = reader.read<u64>();
+        if(!new_slots.try_emplace(entry.hash, i).second) {
+            debugLog("Ignoring search index {}: duplicate entry {}", path, entry.hash);
+            return false;
+        }
+        new_entries.push_back(entry);
+    }
+
+    const u32 nb_trigrams = reader.read<u32>();
+    new_postings.reserve(std::min<uSz>(nb_trigrams, reader.total_size / sizeof(u32)));
+    for(u32 i = 0; i < nb_trigrams && reader.good(); i++) {
+        const u32 trigram = reader.read<u32>();
+        const u32 nb_slots = reader.read_uleb128();
+
+        // delta-encoded, the first slot is stored as-is
+        PostingList &list = new_postings[trigram];
+        list.reserve(std::min(nb_slots, nb_entries));
+        u32 slot = 0;
+        for(u32 j = 0; j < nb_slots && reader.good(); j++) {
+            const u32 delta = reader.read_uleb128();
+            if(j > 0 && delta == 0) break;  // not sorted, caught below
+            slot += delta;
+            list.push_back(slot);
+        }
+
+        if(list.empty() || list.size() != nb_slots || list.back() >= nb_entries) {
+            debugLog("Ignoring search index {}: invalid posting list for trigram {:#x}", path, trigram);
+            return false;
+        }
+    }
+
+    if(!reader.good()) {
+        debugLog("Ignoring search index {}: {}", path, reader.error());
+        return false;
+    }
+
+    Sync::unique_lock lock(this->mtx);
+    this->entries = std::move(new_entries);
+    this->slots = std::move(new_slots);
+    this->postings = std::move(new_postings);
+    this->nb_dead = 0;
+    return true;
+}
+
+bool BeatmapSearchIndex::save(std::string_view path) const {
+    ByteBufferedFile::Writer writer(path);
+    if(!writer.good()) {
+        debugLog("Cannot save search index to {}: {}", path, writer.error());
+        return false;
+    }
+
+    Sync::shared_lock lock(this->mtx);
+
+    // dead slots aren't saved, so the remaining ones have to be renumbered
+    constexpr u32 DEAD = static_cast<u32>(-1);
+    std::vector<u32> remap(this->entries.size(), DEAD);
+    u32 nb_live = 0;
+    for(u32 slot = 0; slot < this->entries.size(); slot++) {
+        if(this->entries[slot].live) remap[slot] = nb_live++;
+    }
+
+    writer.write<u32>(NEOSU_SEARCH_INDEX_VERSION);
+
+    writer.write<u32>(nb_live);
+    for(const Entry &entry : this->entries) {
+        if(!entry.live) continue;
+        writer.write_hash_digest(entry.hash);
+        writer.write<u64>(entry.blob_hash);
+    }
+
+    // lists which only contain dead slots can't be skipped without counting first
+    u32 nb_trigrams = 0;
+    for(const auto &[_, list] : this->postings) {
+        if(std::ranges::any_of(list, [&remap](u32 slot) { return remap[slot] != DEAD; })) nb_trigrams++;
+    }
+
+    writer.write<u32>(nb_trigrams);
+    for(const auto &[trigram, list] : this->postings) {
+        const auto nb_slots = static_cast<u32>(
+            std::ranges::count_if(list, [&remap](u32 slot) { return remap[slot] != DEAD; }));
+        if(nb_slots == 0) continue;
+
+        writer.write<u32>(trigram);
+        writer.write_uleb128(nb_slots);
+        u32 prev = 0;
+        for(const u32 slot : list) {
+            if(remap[slot] == DEAD) continue;
+            writer.write_uleb128(remap[slot] - prev);
+            prev = remap[slot];
+        }
+    }
+
+    return writer.good();
+}
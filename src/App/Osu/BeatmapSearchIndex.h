@@ -0,0 +1,79 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "noinclude.h"
+#include "MD5Hash.h"
+#include "Hashing.h"
+#include "SyncMutex.h"
+
+#include <optional>
+#include <utility>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class DatabaseBeatmap;
+
+// Trigram inverted index over the search blobs of all difficulties (see DatabaseBeatmap::getSearchBlob()).
+// Entries are keyed by MD5 instead of pointing to the difficulties, so that stale entries are harmless: the index can
+// be loaded before the maps are, and maps which are gone only need to be dropped eventually (see retain()).
+// All methods are thread-safe.
+class BeatmapSearchIndex final {
+    NOCOPY_NOMOVE(BeatmapSearchIndex)
+   public:
+    using Candidates = Hash::flat::set<MD5Hash>;
+
+    BeatmapSearchIndex() = default;
+    ~BeatmapSearchIndex() = default;
+
+    // (re-)indexes a difficulty, no-op if it's already indexed with the same search blob
+    void add(const DatabaseBeatmap *diff);
+    void remove(const MD5Hash &hash);
+    void clear();
+
+    // drops every entry for which keep(hash) returns false
+    template <typename Pred>
+    void retain(Pred &&keep) {
+        Sync::unique_lock lock(this->mtx);
+        for(u32 slot = 0; slot < this->entries.size(); slot++) {
+            if(this->entries[slot].live && !keep(std::as_const(this->entries[slot].hash))) {
+                this->removeSlot(slot);
+            }
+        }
+        this->compactIfNeeded();
+    }
+
+    // hashes of all difficulties whose search blob may contain every literal (a superset, matches still have to be
+    // verified against the blob), or nullopt if the literals are too short for the index to narrow anything down
+    [[nodiscard]] std::optional<Candidates> findCandidates(const std::vector<std::string> &literals) const;
+
+    [[nodiscard]] uSz size() const;
+
+    bool load(std::string_view path);
+    bool save(std::string_view path) const;
+
+   private:
+    struct Entry {
+        MD5Hash hash;
+        u64 blob_hash{0};  // to detect changed search blobs
+        bool live{false};
+    };
+
+    // posting lists are sorted by slot, since new entries always get the highest one
+    using PostingList = std::vector<u32>;
+
+    // 3 bytes of the (lowercased, UTF-8) search blob, packed into the low 24 bits
+    template <typename F>
+    static void forEachTrigram(std::string_view str, F &&callback);
+
+    void addLocked(const MD5Hash &hash, std::string_view blob, u64 blob_hash);
+    void removeSlot(u32 slot);
+    void compactIfNeeded();
+
+    std::vector<Entry> entries;  // indexed by slot
+    Hash::flat::map<MD5Hash, u32> slots;
+    Hash::flat::map<u32, PostingList> postings;
+    u32 nb_dead{0};
+
+    mutable Sync::shared_mutex mtx;
+};
@@ -9,12 +9,10 @@
 #include "BeatmapInterface.h"
 #include "CBaseUIButton.h"
 #include "CBaseUIContainer.h"
-#include "CBaseUILabel.h"
 #include "CBaseUITextbox.h"
 #include "Logging.h"
 #include "NetworkHandler.h"
 #include "OsuConVars.h"
-#include "ChatLink.h"
 #include "Engine.h"
 #include "Font.h"
 #include "Keyboard.h"
@@ -36,7 +34,6 @@
 #include "SpectatorScreen.h"
 #include "UI.h"
 #include "UIButton.h"
-#include "UIUserContextMenu.h"
 #include "UserCard2.h"
 #include "Timing.h"
 #include "Environment.h"
@@ -45,7 +42,6 @@
 
 #include <algorithm>
 #include <cmath>
-#include "ctre.hpp"
 #include <utility>
 
 using namespace flags::operators;
@@ -63,6 +59,9 @@ ChatChannel::ChatChannel(Chat *chat, UString name_arg) {
     this->ui->setDrawScrollbars(true);
     this->ui->setAutoscroll(true);
 
+    this->log = new ChatLog(this->ui);
+    this->ui->container.addBaseUIElement(this->log);
+
     if(chat != nullptr) {
         this->btn = new UIButton(0, 0, 0, 0, "button", this->name);
         this->btn->setGrabClicks(true);
@@ -86,198 +85,21 @@ void ChatChannel::onChannelButtonClick(CBaseUIButton * /*btn*/) {
 }
 
 void ChatChannel::add_message(ChatMessage msg) {
-    const float line_height = 20;
-    const Color system_color = 0xffffff00;
-
-    float x = 10;
-
-    const bool is_action = msg.text.startsWith(US_("\001ACTION"));
-    if(is_action) {
-        msg.text.erase(0, 7);
-        if(msg.text.endsWith(US_("\001"))) {
-            msg.text.erase(msg.text.length() - 1, 1);
-        }
-    }
-
-    struct tm tm;
-    localtime_x(&msg.tms, &tm);
-    UString timestamp_str = fmt::format("{:02d}:{:02d} ", tm.tm_hour, tm.tm_min);
-    if(is_action) timestamp_str.append(u'*');
-    float time_width = chat_font->getStringWidth(timestamp_str);
-    auto *timestamp = new CBaseUILabel(x, this->y_total, time_width, line_height, "", timestamp_str);
-    timestamp->setDrawFrame(false);
-    timestamp->setDrawBackground(false);
-    this->ui->container.addBaseUIElement(timestamp);
-    x += time_width;
-
-    bool is_system_message = msg.author_name.length() == 0;
-    if(!is_system_message) {
-        float name_width = chat_font->getStringWidth(msg.author_name);
-        auto user_box = new UIUserLabel(msg.author_id, msg.author_name);
-        user_box->setTextColor(0xff2596be);
-        user_box->setPos(x, this->y_total);
-        user_box->setSize(name_width, line_height);
-        this->ui->container.addBaseUIElement(user_box);
-        x += name_width;
-
-        if(!is_action) {
-            msg.text.insert(0, US_(": "));
-        }
-    }
-
-    // regex101 format: (\[\[(.+?)\]\])|(\[((\S+):\/\/\S+) (.+?)\])|(https?:\/\/\S+)
-    // This matches:
-    // - Raw URLs      https://example.com
-    // - Labeled URLs  [https://regex101.com useful website]
-    // - Lobby invites [osump://0/ join my lobby plz]
-    // - Wiki links    [[Chat Console]]
-    //
-    // Group 1) [[FAQ]]
-    // Group 2) FAQ
-    // Group 3) [https://regex101.com label]
-    // Group 4) https://regex101.com
-    // Group 5) https
-    // Group 6) label
-    // Group 7) https://example.com
-    //
-    // Groups 1, 2 only exist for wiki links
-    // Groups 3, 4, 5, 6 only exist for labeled links
-    // Group 7 only exists for raw links
-    static constexpr ctll::fixed_string url_pattern{LR"((\[\[(.+?)\]\])|(\[((\S+)://\S+) (.+?)\])|(https?://\S+))"};
-
-    std::wstring msg_text = msg.text.to_wstring();
-    std::vector<CBaseUILabel *> temp_text_fragments;
-    sSz text_idx = 0;
-
-    for(auto match : ctre::search_all<url_pattern>(msg_text)) {
-        sSz match_start = match.begin() - msg_text.cbegin();
-        sSz match_len = match.end() - match.begin();
-
-        UString link_url;
-        UString link_label;
-
-        if(auto raw_link = match.get<7>(); raw_link) {
-            // Raw link
-            link_url = raw_link.to_view();
-            link_label = raw_link.to_view();
-        } else if(auto labeled_link = match.get<3>(); labeled_link) {
-            // Labeled link
-            link_url = match.get<4>().to_view();
-            link_label = match.get<6>().to_view();
-
-            // Normalize invite links to osump://
-            UString link_protocol = match.get<5>().to_view();
-            if(link_protocol == US_("osu")) {
-                // osu:// -> osump://
-                link_url.insert(3, US_("mp"));
-            } else if(link_protocol == US_("http://osump")) {
-                // http://osump:// -> osump://
-                link_url.erase(0, 7);
-            }
-        } else {
-            // Wiki link
-            auto wiki_name = match.get<2>().to_view();
-            link_url = US_("https://osu.ppy.sh/wiki/");
-            link_url.append(wiki_name);
-            link_label = US_("wiki:");
-            link_label.append(wiki_name);
-        }
-
-        // Add preceding text
-        if(match_start > text_idx) {
-            auto preceding_text = msg.text.substr(text_idx, match_start - text_idx);
-            temp_text_fragments.push_back(new CBaseUILabel(0, 0, 0, 0, "", preceding_text));
-        }
-
-        auto link = new ChatLink(0, 0, 0, 0, link_url, link_label);
-        temp_text_fragments.push_back(link);
-
-        text_idx = match_start + match_len;
-    }
-
-    // Add remaining text after last match
-    if(text_idx < (sSz)msg_text.size()) {
-        auto text = msg.text.substr(text_idx);
-        temp_text_fragments.push_back(new CBaseUILabel(0, 0, 0, 0, "", text));
-    }
-    if(is_action) {
-        // Only appending now to prevent this character from being included in a link
-        msg.text.append(u'*');
-        msg_text.push_back(L'*');
-    }
-
-    // We're offsetting the first fragment to account for the username + timestamp
-    // Since first fragment will always be text, we don't care about the size being wrong
-    float line_width = x;
-
-    // We got a bunch of text fragments, now position them, and if we start a new line,
-    // possibly divide them into more text fragments.
-    for(auto fragment : temp_text_fragments) {
-        UString text_str("");
-        auto fragment_text = fragment->getText();
-
-        for(int i = 0; i < fragment_text.length(); i++) {
-            float char_width = chat_font->getGlyphWidth(fragment_text[i]);
-            if(line_width + char_width + 20 >= this->ui->getSize().x) {
-                auto *link_fragment = dynamic_cast<ChatLink *>(fragment);
-                if(link_fragment == nullptr) {
-                    auto *text = new CBaseUILabel(x, this->y_total, line_width - x, line_height, "", text_str);
-                    text->setDrawFrame(false);
-                    text->setDrawBackground(false);
-                    if(is_system_message) {
-                        text->setTextColor(system_color);
-                    }
-                    this->ui->container.addBaseUIElement(text);
-                } else {
-                    auto *link =
-                        new ChatLink(x, this->y_total, line_width - x, line_height, fragment->getName(), text_str);
-                    this->ui->container.addBaseUIElement(link);
-                }
-
-                x = 10;
-                this->y_total += line_height;
-                line_width = x;
-                text_str.clear();
-            }
-
-            text_str.append(fragment_text[i]);
-            line_width += char_width;
-        }
-
-        auto *link_fragment = dynamic_cast<ChatLink *>(fragment);
-        if(link_fragment == nullptr) {
-            auto *text = new CBaseUILabel(x, this->y_total, line_width - x, line_height, "", text_str);
-            text->setDrawFrame(false);
-            text->setDrawBackground(false);
-            if(is_system_message) {
-                text->setTextColor(system_color);
-            }
-            this->ui->container.addBaseUIElement(text);
-        } else {
-            auto *link = new ChatLink(x, this->y_total, line_width - x, line_height, fragment->getName(), text_str);
-            this->ui->container.addBaseUIElement(link);
-        }
-
-        x = line_width;
-    }
+    const bool was_at_bottom = this->ui->isAtBottom();
+    const f32 dropped_height = this->log->add(std::move(msg));
+    this->ui->setScrollSizeToContent();
 
-    for(auto &fragment : temp_text_fragments) {
-        SAFE_DELETE(fragment);
+    // oldest messages got dropped, keep showing the same messages if we're scrolled up
+    if(dropped_height > 0.f && !was_at_bottom) {
+        this->ui->scrollToY(static_cast<int>(this->ui->getRelPosY() + dropped_height), false);
     }
-
-    this->y_total += line_height;
-    this->ui->setScrollSizeToContent();
 }
 
 void ChatChannel::updateLayout(vec2 pos, vec2 size) {
-    this->ui->freeElements();
     this->ui->setPos(pos);
     this->ui->setSize(size);
-    this->y_total = 7;
-
-    for(const auto &msg : this->messages) {
-        this->add_message(msg);
-    }
+    this->log->setLayoutWidth(size.x);
+    this->ui->setScrollSizeToContent();
 }
 
 Chat::Chat() : UIScreen() {
@@ -460,7 +282,7 @@ void Chat::update(CBaseUIEventCtx &c) {
 
 void Chat::handle_command(const UString &msg) {
     if(msg == US_("/clear")) {
-        this->selected_channel->messages.clear();
+        this->selected_channel->log->clear();
         this->updateLayout(osu->getVirtScreenSize());
         return;
     }
@@ -932,7 +754,6 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
     this->addChannel(channel_name);
     for(auto chan : this->channels) {
         if(chan->name != channel_name) continue;
-        chan->messages.push_back(msg);
         chan->add_message(msg);
 
         if(mark_unread) {
@@ -944,8 +765,7 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
                 if(msg.author_name.toUtf8() != BanchoState::get_username()) {
                     auto screen = osu->getVirtScreenSize();
                     this->ticker_tms = engine->getTime();
-                    this->ticker->messages.clear();
-                    this->ticker->messages.push_back(msg);
+                    this->ticker->log->clear();
                     this->ticker->add_message(msg);
                     this->updateTickerLayout(screen);
                 }
@@ -954,10 +774,6 @@ void Chat::addMessage(UString channel_name, const ChatMessage &msg, bool mark_un
             }
         }
 
-        if(chan->messages.size() > 100) {
-            chan->messages.erase(chan->messages.begin());
-        }
-
         break;
     }
 
@@ -3,6 +3,7 @@
 
 #include "CBaseUIScrollView.h"
 #include "CBaseUITextbox.h"
+#include "ChatLog.h"
 #include "UIScreen.h"
 
 class CBaseUIButton;
@@ -11,13 +12,6 @@ class Chat;
 class UIButton;
 class UserCard2;
 
-struct ChatMessage final {
-    time_t tms;
-    i32 author_id;
-    UString author_name;
-    UString text;
-};
-
 struct ChatChannel final {
     NOCOPY_NOMOVE(ChatChannel)
    public:
@@ -26,10 +20,9 @@ struct ChatChannel final {
 
     Chat *chat;
     CBaseUIScrollView *ui;
+    ChatLog *log;  // owned by ui
     UIButton *btn;
     UString name;
-    std::vector<ChatMessage> messages;
-    float y_total{.0f};
     bool read = true;
 
     void add_message(ChatMessage msg);
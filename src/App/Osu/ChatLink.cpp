@@ -10,7 +10,6 @@
 #include "Parsing.h"
 #include "RoomScreen.h"
 #include "SongBrowser/SongBrowser.h"
-#include "TooltipOverlay.h"
 #include "UI.h"
 #include "UIUserContextMenu.h"
 
@@ -18,29 +17,8 @@
 
 #include <utility>
 
-ChatLink::ChatLink(float xPos, float yPos, float xSize, float ySize, const UString& link, const UString& label)
-    : CBaseUILabel(xPos, yPos, xSize, ySize, link, label) {
-    this->link = link;
-    this->setDrawFrame(false);
-    this->setDrawBackground(true);
-    this->setBackgroundColor(0xff2e3784);
-}
-
-void ChatLink::update(CBaseUIEventCtx& c) {
-    CBaseUILabel::update(c);
-
-    if(this->isMouseInside()) {
-        ui->getTooltipOverlay()->begin();
-        ui->getTooltipOverlay()->addLine(fmt::format("link: {}", this->link.toUtf8()));
-        ui->getTooltipOverlay()->end();
-
-        this->setBackgroundColor(0xff3d48ac);
-    } else {
-        this->setBackgroundColor(0xff2e3784);
-    }
-}
-
-void ChatLink::open_beatmap_link(i32 map_id, i32 set_id) {
+namespace {
+void open_beatmap_link(const UString& link, i32 map_id, i32 set_id) {
     if(ui->getSongBrowser()->isVisible()) {
         ui->getSongBrowser()->map_autodl = map_id;
         ui->getSongBrowser()->set_autodl = set_id;
@@ -49,15 +27,16 @@ void ChatLink::open_beatmap_link(i32 map_id, i32 set_id) {
         ui->getSongBrowser()->map_autodl = map_id;
         ui->getSongBrowser()->set_autodl = set_id;
     } else {
-        env->openURLInDefaultBrowser(this->link.toUtf8());
+        env->openURLInDefaultBrowser(link.toUtf8());
     }
 }
+}  // namespace
 
-void ChatLink::onMouseUpInside(bool /*left*/, bool /*right*/) {
-    std::wstring link_wstr = this->link.to_wstring();
+void ChatLink::open(const UString& link) {
+    std::wstring link_wstr = link.to_wstring();
 
     // Detect multiplayer invite links
-    if(this->link.startsWith(US_("osump://"))) {
+    if(link.startsWith(US_("osump://"))) {
         if(ui->getRoom()->isVisible()) {
             ui->getNotificationOverlay()->addNotification("You are already in a multiplayer room.");
             return;
@@ -106,7 +85,7 @@ void ChatLink::onMouseUpInside(bool /*left*/, bool /*right*/) {
         if(matches_endpoint(domain) || domain == L"osu.ppy.sh") {
             const UString match_ustr = match.get<2>().to_view();
             i32 map_id = Parsing::strto<i32>(match_ustr.utf8View());
-            this->open_beatmap_link(map_id, 0);
+            open_beatmap_link(link, map_id, 0);
             return;
         }
     }
@@ -124,10 +103,10 @@ void ChatLink::onMouseUpInside(bool /*left*/, bool /*right*/) {
                 const UString uGroup = map_group.to_view();
                 map_id = Parsing::strto<i32>(uGroup.utf8View());
             }
-            this->open_beatmap_link(map_id, set_id);
+            open_beatmap_link(link, map_id, set_id);
             return;
         }
     }
 
-    env->openURLInDefaultBrowser(this->link.toUtf8());
+    env->openURLInDefaultBrowser(link.toUtf8());
 }
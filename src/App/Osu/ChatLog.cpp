@@ -0,0 +1,410 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "ChatLog.h"
+
+#include "CBaseUIScrollView.h"
+#include "ChatLink.h"
+#include "Engine.h"
+#include "Font.h"
+#include "Graphics.h"
+#include "Mouse.h"
+#include "OsuConVars.h"
+#include "Timing.h"
+#include "TooltipOverlay.h"
+#include "UI.h"
+#include "UIUserContextMenu.h"
+
+#include "ctre.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {  // static namespace
+constexpr Color user_color{0xff2596be};
+constexpr Color system_color{0xffffff00};
+constexpr Color link_color{0xff2e3784};
+constexpr Color link_hover_color{0xff3d48ac};
+
+// space kept free on the right (scrollbar)
+constexpr f32 wrap_margin{20.f};
+}  // namespace
+
+ChatLog::ChatLog(CBaseUIScrollView *view) : CBaseUIElement(0, 0, 0, 0, ""), view(view) {
+    this->font = engine->getDefaultFont();
+}
+
+void ChatLog::parse(Entry &entry, ChatMessage &msg) const {
+    entry.runs.clear();
+    entry.author_id = msg.author_id;
+
+    const auto add_run = [&](UString text, RunType type, UString link = {}) {
+        f32 width = 0.f;
+        for(int i = 0; i < text.length(); i++) {
+            width += this->font->getGlyphWidth(text[i]);
+        }
+        entry.runs.push_back({.text = std::move(text), .link = std::move(link), .width = width, .type = type});
+    };
+
+    const bool is_action = msg.text.startsWith(US_("\001ACTION"));
+    if(is_action) {
+        msg.text.erase(0, 7);
+        if(msg.text.endsWith(US_("\001"))) {
+            msg.text.erase(msg.text.length() - 1, 1);
+        }
+    }
+
+    struct tm tm;
+    localtime_x(&msg.tms, &tm);
+    UString timestamp_str = fmt::format("{:02d}:{:02d} ", tm.tm_hour, tm.tm_min);
+    if(is_action) timestamp_str.append(u'*');
+    add_run(std::move(timestamp_str), RunType::TIMESTAMP);
+
+    const bool is_system_message = msg.author_name.length() == 0;
+    if(!is_system_message) {
+        add_run(msg.author_name, RunType::USER);
+
+        if(!is_action) {
+            msg.text.insert(0, US_(": "));
+        }
+    }
+
+    const RunType text_type = is_system_message ? RunType::SYSTEM_TEXT : RunType::TEXT;
+
+    // regex101 format: (\[\[(.+?)\]\])|(\[((\S+):\/\/\S+) (.+?)\])|(https?:\/\/\S+)
+    // This matches:
+    // - Raw URLs      https://example.com
+    // - Labeled URLs  [https://regex101.com useful website]
+    // - Lobby invites [osump://0/ join my lobby plz]
+    // - Wiki links    [[Chat Console]]
+    //
+    // Group 1) [[FAQ]]
+    // Group 2) FAQ
+    // Group 3) [https://regex101.com label]
+    // Group 4) https://regex101.com
+    // Group 5) https
+    // Group 6) label
+    // Group 7) https://example.com
+    //
+    // Groups 1, 2 only exist for wiki links
+    // Groups 3, 4, 5, 6 only exist for labeled links
+    // Group 7 only exists for raw links
+    static constexpr ctll::fixed_string url_pattern{LR"((\[\[(.+?)\]\])|(\[((\S+)://\S+) (.+?)\])|(https?://\S+))"};
+
+    const std::wstring msg_text = msg.text.to_wstring();
+    sSz text_idx = 0;
+
+    for(auto match : ctre::search_all<url_pattern>(msg_text)) {
+        sSz match_start = match.begin() - msg_text.cbegin();
+        sSz match_len = match.end() - match.begin();
+
+        UString link_url;
+        UString link_label;
+
+        if(auto raw_link = match.get<7>(); raw_link) {
+            // Raw link
+            link_url = raw_link.to_view();
+            link_label = raw_link.to_view();
+        } else if(auto labeled_link = match.get<3>(); labeled_link) {
+            // Labeled link
+            link_url = match.get<4>().to_view();
+            link_label = match.get<6>().to_view();
+
+            // Normalize invite links to osump://
+            UString link_protocol = match.get<5>().to_view();
+            if(link_protocol == US_("osu")) {
+                // osu:// -> osump://
+                link_url.insert(3, US_("mp"));
+            } else if(link_protocol == US_("http://osump")) {
+                // http://osump:// -> osump://
+                link_url.erase(0, 7);
+            }
+        } else {
+            // Wiki link
+            auto wiki_name = match.get<2>().to_view();
+            link_url = US_("https://osu.ppy.sh/wiki/");
+            link_url.append(wiki_name);
+            link_label = US_("wiki:");
+            link_label.append(wiki_name);
+        }
+
+        // Add preceding text
+        if(match_start > text_idx) {
+            add_run(msg.text.substr(text_idx, match_start - text_idx), text_type);
+        }
+
+        add_run(std::move(link_label), RunType::LINK, std::move(link_url));
+
+        text_idx = match_start + match_len;
+    }
+
+    // Add remaining text after last match
+    if(text_idx < (sSz)msg_text.size()) {
+        add_run(msg.text.substr(text_idx), text_type);
+    }
+    if(is_action) {
+        // Only appending now to prevent this character from being included in a link
+        add_run(US_("*"), text_type);
+    }
+}
+
+void ChatLog::wrap(Entry &entry) const {
+    entry.pieces.clear();
+
+    u32 line = 0;
+    f32 x = padding_left;
+
+    for(u32 r = 0; r < entry.runs.size(); r++) {
+        const Run &run = entry.runs[r];
+
+        // timestamp and username always start the first line
+        // the rest fits as a whole in the common case, so only walk the glyphs of runs which need wrapping
+        if(run.type == RunType::TIMESTAMP || run.type == RunType::USER ||
+           x + run.width + wrap_margin < this->layout_width) {
+            entry.pieces.push_back({.text = run.text, .x = x, .width = run.width, .line = line, .run = r});
+            x += run.width;
+            continue;
+        }
+
+        UString text_str;
+        f32 line_width = x;
+        for(int i = 0; i < run.text.length(); i++) {
+            const f32 char_width = this->font->getGlyphWidth(run.text[i]);
+            if(line_width + char_width + wrap_margin >= this->layout_width) {
+                if(text_str.length() > 0) {
+                    entry.pieces.push_back(
+                        {.text = std::move(text_str), .x = x, .width = line_width - x, .line = line, .run = r});
+                    text_str.clear();
+                }
+
+                x = padding_left;
+                line++;
+                line_width = x;
+            }
+
+            text_str.append(run.text[i]);
+            line_width += char_width;
+        }
+
+        if(text_str.length() > 0) {
+            entry.pieces.push_back({.text = std::move(text_str), .x = x, .width = line_width - x, .line = line, .run = r});
+        }
+        x = line_width;
+    }
+
+    entry.num_lines = line + 1;
+}
+
+f32 ChatLog::resizeRing(uSz capacity) {
+    // linearize, keeping the newest messages
+    const uSz kept = std::min(this->count, capacity);
+    const uSz dropped = this->count - kept;
+
+    f32 dropped_height = 0.f;
+    for(uSz i = 0; i < dropped; i++) {
+        dropped_height += this->at(i).height();
+    }
+
+    std::vector<Entry> resized(capacity);
+    for(uSz i = 0; i < kept; i++) {
+        resized[i] = std::move(this->at(dropped + i));
+    }
+
+    this->ring = std::move(resized);
+    this->head = 0;
+    this->count = kept;
+
+    return dropped_height;
+}
+
+f32 ChatLog::add(ChatMessage msg) {
+    f32 dropped_height = 0.f;
+
+    const uSz capacity = std::max(cv::chat_max_messages.getInt(), 1);
+    if(capacity != this->ring.size()) {
+        dropped_height += this->resizeRing(capacity);
+    }
+
+    // full, overwrite the oldest message
+    if(this->count == this->ring.size()) {
+        dropped_height += this->at(0).height();
+        this->head = (this->head + 1) % this->ring.size();
+        this->count--;
+    }
+
+    const u64 first_line = this->count > 0 ? this->at(this->count - 1).first_line + this->at(this->count - 1).num_lines : 0;
+
+    Entry &entry = this->at(this->count);
+    this->parse(entry, msg);
+    this->wrap(entry);
+    entry.first_line = first_line;
+    this->count++;
+
+    // indices shifted
+    this->hovered = this->pressed = {};
+
+    this->updateSize();
+    return dropped_height;
+}
+
+void ChatLog::clear() {
+    this->ring.clear();
+    this->head = 0;
+    this->count = 0;
+    this->hovered = this->pressed = {};
+    this->updateSize();
+}
+
+void ChatLog::setLayoutWidth(f32 width) {
+    if(width == this->layout_width) return;
+    this->layout_width = width;
+
+    u64 first_line = 0;
+    for(uSz i = 0; i < this->count; i++) {
+        Entry &entry = this->at(i);
+        this->wrap(entry);
+        entry.first_line = first_line;
+        first_line += entry.num_lines;
+    }
+
+    this->hovered = this->pressed = {};
+    this->updateSize();
+}
+
+void ChatLog::updateSize() {
+    if(this->count == 0) {
+        this->content_height = 0.f;
+    } else {
+        const Entry &last = this->at(this->count - 1);
+        this->content_height = padding_top + this->entryY(this->count - 1) + last.height();
+    }
+
+    this->setSize(this->layout_width, this->content_height);
+}
+
+uSz ChatLog::findEntry(f32 y) const {
+    uSz lo = 0;
+    uSz hi = this->count;
+    while(lo < hi) {
+        const uSz mid = lo + (hi - lo) / 2;
+        if(this->entryY(mid) + this->at(mid).height() <= y) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+ChatLog::HitTarget ChatLog::hitTest(vec2 pos) const {
+    const vec2 local = pos - this->getPos();
+    const f32 y = local.y - padding_top;
+    if(this->count == 0 || y < 0.f) return {};
+
+    const uSz i = this->findEntry(y);
+    if(i >= this->count) return {};
+
+    const Entry &entry = this->at(i);
+    const auto line = static_cast<u32>((y - this->entryY(i)) / line_height);
+    for(uSz p = 0; p < entry.pieces.size(); p++) {
+        const Piece &piece = entry.pieces[p];
+        if(piece.line != line || local.x < piece.x || local.x >= piece.x + piece.width) continue;
+
+        const RunType type = entry.runs[piece.run].type;
+        if(type == RunType::USER || type == RunType::LINK) return {.entry = i, .piece = p, .valid = true};
+        break;
+    }
+
+    return {};
+}
+
+void ChatLog::draw() {
+    if(!this->bVisible || this->count == 0) return;
+
+    const f32 view_top = this->view->getPos().y;
+    const f32 view_bottom = view_top + this->view->getSize().y;
+    const f32 log_top = this->getPos().y + padding_top;
+    const f32 text_offset_y = line_height / 2.f + this->font->getHeight() / 2.f;
+
+    const Run *hovered_run =
+        this->hovered.valid
+            ? &this->at(this->hovered.entry).runs[this->at(this->hovered.entry).pieces[this->hovered.piece].run]
+            : nullptr;
+
+    for(uSz i = this->findEntry(view_top - log_top); i < this->count; i++) {
+        const Entry &entry = this->at(i);
+        const f32 entry_y = log_top + this->entryY(i);
+        if(entry_y > view_bottom) break;
+
+        for(const Piece &piece : entry.pieces) {
+            const f32 line_y = entry_y + static_cast<f32>(piece.line) * line_height;
+            if(line_y + line_height < view_top || line_y > view_bottom) continue;
+
+            const Run &run = entry.runs[piece.run];
+            const f32 x = this->getPos().x + piece.x;
+
+            Color text_color = 0xffffffff;
+            switch(run.type) {
+                case RunType::USER:
+                    text_color = user_color;
+                    break;
+                case RunType::SYSTEM_TEXT:
+                    text_color = system_color;
+                    break;
+                case RunType::LINK:
+                    g->setColor(&run == hovered_run ? link_hover_color : link_color);
+                    g->fillRect(x + 1, line_y + 1, piece.width - 1, line_height - 1);
+                    break;
+                case RunType::TIMESTAMP:
+                case RunType::TEXT:
+                    break;
+            }
+
+            g->pushTransform();
+            {
+                g->translate((i32)x, (i32)(line_y + text_offset_y));
+                g->setColor(text_color);
+                g->drawString(this->font, piece.text);
+            }
+            g->popTransform();
+        }
+    }
+}
+
+void ChatLog::update(CBaseUIEventCtx &c) {
+    CBaseUIElement::update(c);
+    if(!this->bVisible) return;
+
+    // the element spans all messages, so also check against the visible part
+    const vec2 mouse_pos = mouse->getPos();
+    this->hovered = {};
+    if(this->isMouseInside() && this->view->getRect().contains(mouse_pos)) {
+        this->hovered = this->hitTest(mouse_pos);
+    }
+
+    if(this->hovered.valid) {
+        const Entry &entry = this->at(this->hovered.entry);
+        const Run &run = entry.runs[entry.pieces[this->hovered.piece].run];
+        if(run.type == RunType::LINK) {
+            ui->getTooltipOverlay()->begin();
+            ui->getTooltipOverlay()->addLine(fmt::format("link: {}", run.link.toUtf8()));
+            ui->getTooltipOverlay()->end();
+        }
+    }
+}
+
+void ChatLog::onMouseDownInside(bool /*left*/, bool /*right*/) { this->pressed = this->hovered; }
+
+void ChatLog::onMouseUpInside(bool /*left*/, bool /*right*/) {
+    const HitTarget target = std::exchange(this->pressed, {});
+    if(!target.valid || target != this->hovered) return;
+
+    const Entry &entry = this->at(target.entry);
+    const Run &run = entry.runs[entry.pieces[target.piece].run];
+    // copies, opening either can end up adding chat messages
+    if(run.type == RunType::LINK) {
+        const UString link = run.link;
+        ChatLink::open(link);
+    } else if(run.type == RunType::USER) {
+        const i32 user_id = entry.author_id;
+        ui->getUserActions()->open(user_id);
+    }
+}
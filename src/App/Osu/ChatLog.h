@@ -0,0 +1,116 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+
+#include "CBaseUIElement.h"
+#include "UString.h"
+#include "types.h"
+
+#include <ctime>
+#include <vector>
+
+class CBaseUIScrollView;
+class McFont;
+
+struct ChatMessage final {
+    time_t tms;
+    i32 author_id;
+    UString author_name;
+    UString text;
+};
+
+// Message history of a single chat channel, drawn as one element inside the channel's scrollview.
+// Messages live in a ring buffer capped by chat_max_messages. Each message is parsed once into styled runs (with
+// cached widths) and only re-wrapped when the available width changes. Only the lines inside the scrollview get drawn.
+class ChatLog final : public CBaseUIElement {
+    NOCOPY_NOMOVE(ChatLog)
+   public:
+    ChatLog(CBaseUIScrollView *view);
+    ~ChatLog() override = default;
+
+    void draw() override;
+    void update(CBaseUIEventCtx &c) override;
+
+    // returns the height of the messages which had to be dropped to make room (0 if none)
+    f32 add(ChatMessage msg);
+    void clear();
+
+    // re-wraps all messages if the width changed
+    void setLayoutWidth(f32 width);
+
+    [[nodiscard]] inline uSz getNumMessages() const { return this->count; }
+
+    static constexpr f32 line_height{20.f};
+    static constexpr f32 padding_top{7.f};
+    static constexpr f32 padding_left{10.f};
+
+   protected:
+    void onMouseDownInside(bool left = true, bool right = false) override;
+    void onMouseUpInside(bool left = true, bool right = false) override;
+
+   private:
+    enum class RunType : u8 { TIMESTAMP, USER, TEXT, SYSTEM_TEXT, LINK };
+
+    // part of a message with uniform styling
+    struct Run {
+        UString text;
+        UString link;
+        f32 width;
+        RunType type;
+    };
+
+    // (part of) a run, placed on a line
+    struct Piece {
+        UString text;
+        f32 x;
+        f32 width;
+        u32 line;
+        u32 run;
+    };
+
+    struct Entry {
+        std::vector<Run> runs;
+        std::vector<Piece> pieces;
+        u64 first_line{0};  // running line count, subtract the first entry's to get the position in the log
+        u32 num_lines{0};
+        i32 author_id{0};
+
+        [[nodiscard]] inline f32 height() const { return static_cast<f32>(this->num_lines) * line_height; }
+    };
+
+    struct HitTarget {
+        uSz entry{0};
+        uSz piece{0};
+        bool valid{false};
+
+        bool operator==(const HitTarget &) const = default;
+    };
+
+    [[nodiscard]] inline Entry &at(uSz i) { return this->ring[(this->head + i) % this->ring.size()]; }
+    [[nodiscard]] inline const Entry &at(uSz i) const { return this->ring[(this->head + i) % this->ring.size()]; }
+
+    void parse(Entry &entry, ChatMessage &msg) const;
+    void wrap(Entry &entry) const;
+    f32 resizeRing(uSz capacity);
+    void updateSize();
+
+    [[nodiscard]] inline f32 entryY(uSz i) const {
+        return static_cast<f32>(this->at(i).first_line - this->at(0).first_line) * line_height;
+    }
+
+    // first entry whose bottom is below y (relative to the top of the first entry)
+    [[nodiscard]] uSz findEntry(f32 y) const;
+    [[nodiscard]] HitTarget hitTest(vec2 pos) const;
+
+    CBaseUIScrollView *view;
+    McFont *font;
+
+    std::vector<Entry> ring;
+    uSz head{0};
+    uSz count{0};
+
+    f32 layout_width{0.f};
+    f32 content_height{0.f};
+
+    HitTarget hovered;
+    HitTarget pressed;
+};
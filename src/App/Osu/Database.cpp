@@ -15,12 +15,17 @@
 #include "Engine.h"
 #include "File.h"
 #include "LegacyReplay.h"
+#include "MapsDatabaseFile.h"
 #include "NotificationOverlay.h"
+#include "Osu.h"
+#include "BeatmapInterface.h"
 #include "ResourceManager.h"
 #include "AsyncPPCalculator.h"
+#include "AsyncStarCalculator.h"
 #include "SongBrowser/LoudnessCalcThread.h"
 #include "DiffCalc/BatchDiffCalc.h"
 #include "SongBrowser/SongBrowser.h"
+#include "BanchoPacket.h"
 #include "Timing.h"
 #include "UI.h"
 #include "Logging.h"
@@ -29,11 +34,16 @@
 #include "Environment.h"
 #include "MakeDelegateWrapper.h"
 #include "Hashing.h"
+#include "Thread.h"
+#include "SyncJthread.h"
 
 #include "fmt/chrono.h"
 
 #include <algorithm>
 #include <cstring>
+#include <numeric>
+#include <ranges>
+#include <span>
 #include <utility>
 
 std::unique_ptr<Database> db = nullptr;
@@ -224,6 +234,8 @@ void Database::AsyncDBLoader::init() {
     if(db->needs_raw_load) {
         db->scheduleLoadRaw();
     } else {
+        db->pruneSearchIndex();
+
         // signal that we are done
         db->loading_progress = 1.0f;
 
@@ -248,10 +260,15 @@ void Database::AsyncDBLoader::initAsync() {
 
     using enum Database::DatabaseType;
     db->loadScores(db->database_files[NEOSU_SCORES]);
+    db->replayScoresJournal();
     if(db->load_interrupted.load(std::memory_order_acquire)) goto done;
     db->loadOldMcNeosuScores(db->database_files[MCNEOSU_SCORES]);
     if(db->load_interrupted.load(std::memory_order_acquire)) goto done;
     db->loadPeppyScores(db->database_files[STABLE_SCORES]);
+    {
+        Sync::shared_lock lock(db->scores_mtx);
+        db->player_stats.rebuild(db->scores, cv::user_include_relax_and_autopilot_for_stats.getBool());
+    }
     db->scores_loaded = true;
     if(db->load_interrupted.load(std::memory_order_acquire)) goto done;
 
@@ -278,12 +295,107 @@ done:
     logIf(cv::debug_db.getBool() || cv::debug_async_db.getBool(), "(AsyncDBLoader) done");
 }
 
+struct Database::RawImportPool {
+    NOCOPY_NOMOVE(RawImportPool)
+   public:
+    RawImportPool(const std::string &songs_folder, const std::vector<std::string> &folders,
+                  Hash::unstable_stringmap<RawFolderEntry> prev_folders, bool is_peppy)
+        : songs_folder(songs_folder), folders(folders), prev_folders(std::move(prev_folders)), is_peppy(is_peppy) {
+        const i32 nb_cpus = McThread::get_logical_cpu_count();
+        i32 nb_threads = std::clamp(cv::database_import_threads.getInt(), 0, nb_cpus);
+        if(nb_threads == 0) {
+            // leave one core for the main thread, it still has to register finished sets and draw the loading screen
+            nb_threads = std::max(nb_cpus - 1, 1);
+        }
+        nb_threads = std::clamp<i32>(nb_threads, 1, std::max<i32>(static_cast<i32>(this->folders.size()), 1));
+
+        debugLog("Database: importing {} folders with {} threads", this->folders.size(), nb_threads);
+
+        this->timer.start();
+        this->workers.reserve(nb_threads);
+        for(i32 i = 0; i < nb_threads; i++) {
+            this->workers.emplace_back([this, i](const Sync::stop_token &stoken) { this->worker_fn(stoken, i); });
+        }
+    }
+
+    // jthread destructors request stop and join (workers are destroyed first, see member order)
+    ~RawImportPool() = default;
+
+    // moves all results finished since the last call into out
+    void take_finished(std::vector<RawImportResult> &out) {
+        Sync::scoped_lock lock(this->finished_mtx);
+        out.swap(this->finished);
+    }
+
+    [[nodiscard]] u32 get_num_processed() const { return this->num_processed.load(std::memory_order_acquire); }
+    [[nodiscard]] bool all_processed() const { return this->get_num_processed() >= this->folders.size(); }
+
+    [[nodiscard]] bool had_previous_load() const { return !this->prev_folders.empty(); }
+
+    // whether the previous raw load registered a set from this folder
+    [[nodiscard]] bool was_loaded(std::string_view folder) const { return this->prev_folders.contains(folder); }
+
+    [[nodiscard]] f32 get_sets_per_second() {
+        this->timer.update();
+        const f64 elapsed = this->timer.getElapsedTime();
+        return elapsed > 0.0 ? static_cast<f32>(this->get_num_processed() / elapsed) : 0.f;
+    }
+
+   private:
+    void worker_fn(const Sync::stop_token &stoken, i32 thread_index) {
+        McThread::set_current_thread_name(fmt::format("db_import_{}", thread_index));
+
+        while(!stoken.stop_requested()) {
+            const u32 idx = this->next_folder_idx.fetch_add(1, std::memory_order_relaxed);
+            if(idx >= this->folders.size()) break;
+
+            std::string fullBeatmapPath = this->songs_folder;
+            fullBeatmapPath.append(this->folders[idx]);
+            fullBeatmapPath.append("/");
+
+            RawImportResult result{.folder = this->folders[idx], .stamp = Database::getRawFolderStamp(fullBeatmapPath)};
+
+            // only parse folders which are new or changed since the last raw load
+            if(const auto it = this->prev_folders.find(result.folder);
+               it != this->prev_folders.end() && it->second.stamp == result.stamp) {
+                result.unchanged = true;
+            } else {
+                result.set = Database::loadRawBeatmap(fullBeatmapPath, this->is_peppy);
+            }
+
+            {
+                Sync::scoped_lock lock(this->finished_mtx);
+                this->finished.push_back(std::move(result));
+            }
+
+            this->num_processed.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    const std::string songs_folder;
+    const std::vector<std::string> &folders;  // owned by Database (raw_load_beatmap_folders), outlives us
+    const Hash::unstable_stringmap<RawFolderEntry> prev_folders;
+    const bool is_peppy;
+
+    Timer timer;
+
+    std::atomic<u32> next_folder_idx{0};
+    std::atomic<u32> num_processed{0};
+
+    Sync::mutex finished_mtx;
+    std::vector<RawImportResult> finished;
+
+    // must be last, so that the workers are joined before anything they use is destroyed
+    std::vector<Sync::jthread> workers;
+};
+
 void Database::startLoader() {
     logIf(cv::debug_db.getBool() || cv::debug_async_db.getBool(), "start");
     this->destroyLoader();
 
     // stop threads that rely on database content
     BatchDiffCalc::abort_calc();
+    AsyncStarCalc::abort();
     AsyncPPC::set_map(nullptr);
     VolNormalization::abort();
 
@@ -297,7 +409,22 @@ void Database::startLoader() {
                            (!cv::database_enabled.getBool() || !isOsuDBReadable(getDBPath(DatabaseType::STABLE_MAPS)));
     // const bool nextLoadIsRaw{this->needs_raw_load};
 
-    this->is_first_load = true;
+    // keep the sets from the last raw load around, scheduleLoadRaw() only re-parses folders which changed
+    this->raw_reusable_sets.clear();
+    if(!this->needs_raw_load) {
+        this->raw_loaded_folders.clear();
+    } else if(!this->raw_loaded_folders.empty()) {
+        Hash::flat::map<const BeatmapSet *, const std::string *> raw_set_folders;
+        raw_set_folders.reserve(this->raw_loaded_folders.size());
+        for(const auto &[folder, entry] : this->raw_loaded_folders) {
+            raw_set_folders.emplace(entry.set, &folder);
+        }
+        for(auto &set : this->beatmapsets) {
+            if(const auto it = raw_set_folders.find(set.get()); it != raw_set_folders.end()) {
+                this->raw_reusable_sets.emplace(*it->second, std::move(set));
+            }
+        }
+    }
 
     this->loudness_to_calc.clear();
     {
@@ -331,6 +458,13 @@ void Database::startLoader() {
 void Database::destroyLoader() {
     logIf(cv::debug_db.getBool() || cv::debug_async_db.getBool(), "start");
     directoryWatcher->stop_watching(NEOSU_MAPS_PATH "/");
+    if(!this->raw_watched_folder.empty()) {
+        directoryWatcher->stop_watching(this->raw_watched_folder);
+        this->raw_watched_folder.clear();
+        this->raw_watch_changed_paths.clear();
+        this->raw_watch_rescan_all = false;
+    }
+    this->raw_import_pool.reset();
     if(this->loader) {
         resourceManager->destroyResource(this->loader.get(), ResourceDestroyFlags::RDF_NODELETE);  // force blocking
     }
@@ -351,6 +485,7 @@ Database::~Database() {
     }
 
     BatchDiffCalc::abort_calc();
+    AsyncStarCalc::abort();
     AsyncPPC::set_map(nullptr);
     VolNormalization::abort();
     this->loudness_to_calc.clear();
@@ -361,71 +496,149 @@ Database::~Database() {
     }
     this->temp_loading_beatmapsets.clear();
     this->beatmapsets.clear();
+    this->raw_reusable_sets.clear();
 
     Collections::unload_all();
 }
 
+namespace {  // static namespace
+
+// name of the beatmap folder containing path (a folder name, or any path inside the raw songs folder)
+std::string_view raw_folder_name(std::string_view path, std::string_view songs_folder) {
+    std::string_view folder{path};
+    if(folder.starts_with(songs_folder)) folder.remove_prefix(songs_folder.size());
+    while(folder.starts_with('/') || folder.starts_with('\\')) folder.remove_prefix(1);
+    if(const auto slash = folder.find_first_of("/\\"); slash != std::string_view::npos) {
+        folder = folder.substr(0, slash);
+    }
+    return folder;
+}
+
+}  // namespace
+
 void Database::update() {
-    // loadRaw() logic
-    if(this->raw_load_scheduled) {
-        Timer t;
+    // deletions made while the score saver was busy
+    bool deletions_pending = false;
+    {
+        Sync::scoped_lock lock(this->pending_score_deletions_mtx);
+        deletions_pending = !this->pending_score_deletions.empty();
+    }
+    if(deletions_pending) {
+        this->startScoreDeletionSaver();
+    }
+
+    // changes in the raw songs folder, every written .osu file gets its set rescanned right away
+    // (sets can get replaced or removed, which can't happen to the one being played, so those wait until after)
+    if((!this->raw_watch_changed_paths.empty() || this->raw_watch_rescan_all) && !osu->isInPlayMode()) {
+        if(this->raw_watch_rescan_all) {
+            // events were lost, check every folder on disk and every loaded one
+            this->raw_watch_rescan_all = false;
+            this->raw_watch_changed_paths = Environment::getFoldersInFolder(this->raw_load_osu_song_folder);
+            for(const auto &[folder, entry] : this->raw_loaded_folders) {
+                this->raw_watch_changed_paths.push_back(folder);
+            }
+        }
 
-        while(t.getElapsedTime() < 0.033f) {
-            if(this->load_interrupted.load(std::memory_order_acquire)) break;  // cancellation point
+        const RawFolderChanges changes = this->rescanRawFolders(this->raw_watch_changed_paths);
+        this->raw_watch_changed_paths.clear();
+        if(!changes.empty()) {
+            ui->getNotificationOverlay()->addNotification(
+                fmt::format("Beatmaps: {:d} new, {:d} changed, {:d} removed.", changes.added, changes.modified,
+                            changes.removed),
+                0xff00ff00);
+        }
+    }
 
-            if(this->raw_load_beatmap_folders.size() > 0 &&
-               this->cur_raw_load_idx < this->raw_load_beatmap_folders.size()) {
-                std::string curBeatmap = this->raw_load_beatmap_folders[this->cur_raw_load_idx++];
-                this->raw_loaded_beatmap_folders.push_back(
-                    curBeatmap);  // for future incremental loads, so that we know what's been loaded already
+    // loadRaw() logic
+    if(!this->raw_load_scheduled || !this->raw_import_pool) return;
+    if(this->load_interrupted.load(std::memory_order_acquire)) return;  // cancel() cleans up
 
-                std::string fullBeatmapPath = this->raw_load_osu_song_folder;
-                fullBeatmapPath.append(curBeatmap);
-                fullBeatmapPath.append("/");
+    auto &pool = *this->raw_import_pool;
 
-                this->addBeatmapSet(fullBeatmapPath,          //
-                                    -1,                       // no set id override
-                                    !this->raw_load_is_neosu  // is_peppy
-                );
+    // check this before draining, so that nothing can be finished after the last drain
+    const bool all_processed = pool.all_processed();
+
+    // hand the sets finished since last frame to the main thread (deduplication, songbrowser notification)
+    pool.take_finished(this->raw_import_batch);
+    for(auto &result : this->raw_import_batch) {
+        if(result.unchanged) {
+            if(auto it = this->raw_reusable_sets.find(result.folder); it != this->raw_reusable_sets.end()) {
+                result.set = std::move(it->second);
+                this->raw_reusable_sets.erase(it);
+            } else {
+                // shouldn't happen, but don't lose the folder if it does
+                result.set = Database::loadRawBeatmap(
+                    fmt::format("{}{}/", this->raw_load_osu_song_folder, result.folder), !this->raw_load_is_neosu);
             }
+        } else if(pool.was_loaded(result.folder)) {
+            this->raw_load_changes.modified++;
+        } else {
+            this->raw_load_changes.added++;
+        }
 
-            // update progress
-            this->loading_progress = (float)this->cur_raw_load_idx / (float)this->num_beatmaps_to_load;
+        if(BeatmapSet *set = this->registerBeatmapSet(std::move(result.set), -1)) {
+            this->raw_loaded_folders[result.folder] = {.stamp = result.stamp, .set = set};
+        }
+    }
+    this->raw_import_batch.clear();
 
-            // check if we are finished
-            if(this->cur_raw_load_idx >= this->num_beatmaps_to_load ||
-               std::cmp_greater(this->cur_raw_load_idx, (this->raw_load_beatmap_folders.size() - 1))) {
-                this->raw_load_beatmap_folders.clear();
-                this->raw_load_scheduled = false;
+    this->raw_import_rate.store(pool.get_sets_per_second(), std::memory_order_release);
 
-                this->importTimer->update();
+    if(!all_processed) {
+        // update progress (never report 1.0 before the finalization below has run)
+        this->loading_progress = std::min((f32)pool.get_num_processed() / (f32)this->num_beatmaps_to_load, 0.99f);
+        return;
+    }
 
-                debugLog("Refresh finished, added {} beatmaps in {:f} seconds.", this->beatmapsets.size(),
-                         this->importTimer->getElapsedTime());
+    // finished
+    const bool was_incremental = pool.had_previous_load();
+    this->raw_import_pool.reset();
+    this->raw_import_rate.store(0.f, std::memory_order_release);
 
-                Collections::load_all();
+    // whatever wasn't reused belonged to a removed or modified folder
+    this->raw_reusable_sets.clear();
+    this->pruneSearchIndex();
+    this->raw_load_beatmap_folders.clear();
+    this->raw_load_scheduled = false;
+    this->watchRawSongsFolder();
 
-                // clang-format off
-                for(auto &diff : this->beatmapsets
-                                // for all diffs within the set with fStarsNomod <= 0.f (peppy difficulties needing recalc)
-                                | std::views::transform([](const auto &set) -> auto & { return *set->difficulties; })
-                                | std::views::join
-                                | std::views::filter([](const auto &diff) { return diff->fStarsNomod <= 0.f; })) {
-                    diff->fStarsNomod *= -1.f;
-                }
-                // clang-format on
-                this->loading_progress = 1.0f;
+    this->importTimer->update();
 
-                // will find maps/scores needing recalc dynamically
-                BatchDiffCalc::start_calc();
-                VolNormalization::start_calc(this->loudness_to_calc);
+    debugLog("Refresh finished, added {} beatmaps in {:f} seconds.", this->beatmapsets.size(),
+             this->importTimer->getElapsedTime());
 
-                break;
-            }
+    if(was_incremental) {
+        const auto &changes = this->raw_load_changes;
+        debugLog("Database: {} new, {} modified, {} removed beatmap folders.", changes.added, changes.modified,
+                 changes.removed);
 
-            t.update();
+        this->raw_found_changes = !changes.empty();
+        if(this->raw_found_changes) {
+            ui->getNotificationOverlay()->addNotification(
+                fmt::format("Beatmaps: {:d} new, {:d} modified, {:d} removed.", changes.added, changes.modified,
+                            changes.removed),
+                0xff00ff00);
+        } else {
+            ui->getNotificationOverlay()->addNotification(US_("No new beatmaps detected."), 0xff00ff00);
         }
     }
+
+    Collections::load_all();
+
+    // clang-format off
+    for(auto &diff : this->beatmapsets
+                    // for all diffs within the set with fStarsNomod <= 0.f (peppy difficulties needing recalc)
+                    | std::views::transform([](const auto &set) -> auto & { return *set->difficulties; })
+                    | std::views::join
+                    | std::views::filter([](const auto &diff) { return diff->fStarsNomod <= 0.f; })) {
+        diff->fStarsNomod *= -1.f;
+    }
+    // clang-format on
+    this->loading_progress = 1.0f;
+
+    // will find maps/scores needing recalc dynamically
+    BatchDiffCalc::start_calc();
+    VolNormalization::start_calc(this->loudness_to_calc);
 }
 
 void Database::load() {
@@ -442,11 +655,17 @@ void Database::cancel() {
     this->load_interrupted = true;
     this->loading_progress = 1.0f;  // force finished
     this->raw_found_changes = true;
+
+    // joins the import workers, each of them only has to finish the folder it's currently on
+    this->raw_import_pool.reset();
+    this->raw_import_rate.store(0.f, std::memory_order_release);
+    this->raw_load_scheduled = false;
 }
 
 void Database::save() {
     Collections::save_collections();
     this->saveMaps();
+    this->saveSearchIndex();
     this->saveScores();
 }
 
@@ -454,7 +673,13 @@ void Database::save() {
 //       See loadRawBeatmap()
 //       (unless is_peppy is specified, in which case we're loading a raw osu folder and not saving the things we loaded)
 BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 set_id_override, bool is_peppy) {
-    std::unique_ptr<BeatmapSet> mapset = this->loadRawBeatmap(beatmapFolderPath, is_peppy);
+    std::unique_ptr<BeatmapSet> mapset = Database::loadRawBeatmap(beatmapFolderPath, is_peppy);
+    if(mapset == nullptr) return nullptr;
+
+    return this->registerBeatmapSet(std::move(mapset), set_id_override);
+}
+
+BeatmapSet *Database::registerBeatmapSet(std::unique_ptr<BeatmapSet> mapset, i32 set_id_override) {
     if(mapset == nullptr) return nullptr;
 
     BeatmapSet *raw_mapset = mapset.get();
@@ -477,6 +702,8 @@ BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 se
                     diffparent->iSetID = set_id_override;
                     for(auto &existingdiff : diffparent->getDifficulties()) {
                         existingdiff->iSetID = set_id_override;
+                        existingdiff->rebuildSearchBlob();
+                        this->search_index.add(existingdiff.get());
                     }
                 }
                 logIfCV(debug_db, "skipping raw {} (already in beatmap_difficulties), current size: {}", diff->getMD5(),
@@ -502,9 +729,14 @@ BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 se
         mapset->iSetID = set_id_override;
         for(auto &diff : mapset->getDifficulties()) {
             diff->iSetID = set_id_override;
+            diff->rebuildSearchBlob();
         }
     }
 
+    for(const auto &diff : mapset->getDifficulties()) {
+        this->search_index.add(diff.get());
+    }
+
     this->beatmapsets.push_back(std::move(mapset));
 
     // only notify songbrowser if loading is done (it rebuilds from beatmapsets in onDatabaseLoadingFinished)
@@ -516,10 +748,163 @@ BeatmapSet *Database::addBeatmapSet(const std::string &beatmapFolderPath, i32 se
     return raw_mapset;
 }
 
+void Database::removeBeatmapSet(BeatmapSet *mapset) {
+    const auto setIt = std::ranges::find(this->beatmapsets, mapset, &std::unique_ptr<BeatmapSet>::get);
+    if(setIt == this->beatmapsets.end()) return;
+
+    ui->getSongBrowser()->removeBeatmapSet(mapset);
+
+    // background work holding on to difficulties gets restarted without them
+    BatchDiffCalc::abort_calc();
+    this->bPendingBatchDiffCalc = true;  // picked up by SongBrowser::update
+    if(std::erase_if(this->loudness_to_calc, [mapset](const auto *diff) { return diff->getParentSet() == mapset; })) {
+        VolNormalization::start_calc(this->loudness_to_calc);
+    }
+
+    {
+        Sync::unique_lock lock(this->beatmap_difficulties_mtx);
+        for(const auto &diff : mapset->getDifficulties()) {
+            const auto it = this->beatmap_difficulties.find(diff->getMD5());
+            if(it == this->beatmap_difficulties.end() || it->second != diff.get()) continue;
+            this->beatmap_difficulties.erase(it);
+            this->search_index.remove(diff->getMD5());
+        }
+    }
+
+    std::erase_if(this->raw_loaded_folders, [mapset](const auto &folder) { return folder.second.set == mapset; });
+    this->beatmapsets.erase(setIt);
+}
+
+BeatmapSet *Database::replaceBeatmapSet(BeatmapSet *old_mapset, std::unique_ptr<BeatmapSet> new_mapset) {
+    std::string selected_path;
+    if(const BeatmapDifficulty *map = osu->getMapInterface()->getBeatmap(); map && map->getParentSet() == old_mapset) {
+        selected_path = map->getFilePath();
+    }
+
+    // the old difficulties have to be gone first, otherwise the unchanged ones would be deduplicated away
+    this->removeBeatmapSet(old_mapset);
+    BeatmapSet *mapset = this->registerBeatmapSet(std::move(new_mapset), -1);
+    if(!mapset || selected_path.empty() || !this->isFinished()) return mapset;
+
+    for(const auto &diff : mapset->getDifficulties()) {
+        if(diff->getFilePath() != selected_path) continue;
+        osu->getMapInterface()->selectBeatmap(diff.get());
+        ui->getSongBrowser()->selectSelectedBeatmapSongButton();
+        break;
+    }
+
+    return mapset;
+}
+
+void Database::watchRawSongsFolder() {
+    if(this->raw_watched_folder == this->raw_load_osu_song_folder) return;
+
+    if(!this->raw_watched_folder.empty()) directoryWatcher->stop_watching(this->raw_watched_folder);
+    this->raw_watched_folder = this->raw_load_osu_song_folder;
+    if(this->raw_watched_folder.empty()) return;
+
+    // new/changed beatmap folders get picked up without a manual reload
+    directoryWatcher->watch_directory(
+        this->raw_watched_folder,
+        [](const FileChangeEvent &ev) {
+            if(!db) return;
+            if(ev.type == FileChangeType::RESCAN) {
+                db->raw_watch_rescan_all = true;
+                return;
+            }
+
+            // only .osu files make up a set (their folder is rescanned as soon as one is written),
+            // and a removed/renamed folder takes its set with it
+            const std::string_view folder = raw_folder_name(ev.path, db->raw_load_osu_song_folder);
+            if(folder.empty()) return;
+            std::string_view path{ev.path};
+            while(path.ends_with('/') || path.ends_with('\\')) path.remove_suffix(1);
+            const bool is_folder = path.ends_with(folder);
+            if(Environment::getFileExtensionFromFilePath(ev.path) == "osu" ||
+               (is_folder && ev.type == FileChangeType::DELETED)) {
+                db->raw_watch_changed_paths.push_back(ev.path);
+            }
+        },
+        true);
+}
+
+Database::RawFolderChanges Database::rescanRawFolders(const std::vector<std::string> &changed_paths) {
+    RawFolderChanges changes;
+
+    // a running raw load picks up changes by itself, and there's nothing to compare against if the last load wasn't raw
+    if(!this->needs_raw_load || !this->isFinished() || this->raw_load_osu_song_folder.empty()) return changes;
+
+    const std::string &songs_folder = this->raw_load_osu_song_folder;
+
+    // several changed files usually belong to the same folder
+    Hash::flat::set<std::string_view> folders;
+    for(const auto &path : changed_paths) {
+        if(const std::string_view folder = raw_folder_name(path, songs_folder); !folder.empty()) {
+            folders.insert(folder);
+        }
+    }
+
+    for(const auto folder : folders) {
+        const std::string folder_path = fmt::format("{}{}/", songs_folder, folder);
+        const auto it = this->raw_loaded_folders.find(folder);
+        BeatmapSet *loaded = it != this->raw_loaded_folders.end() ? it->second.set : nullptr;
+
+        if(!Environment::directoryExists(std::string_view{folder_path})) {
+            if(loaded) {
+                this->removeBeatmapSet(loaded);
+                changes.removed++;
+            }
+            continue;
+        }
+
+        const RawFolderStamp stamp = Database::getRawFolderStamp(folder_path);
+        if(loaded && it->second.stamp == stamp) continue;
+
+        std::unique_ptr<BeatmapSet> mapset = Database::loadRawBeatmap(folder_path, !this->raw_load_is_neosu);
+        if(!loaded) {
+            if(BeatmapSet *added = this->registerBeatmapSet(std::move(mapset), -1)) {
+                this->raw_loaded_folders[std::string{folder}] = {.stamp = stamp, .set = added};
+                changes.added++;
+            }
+        } else if(!mapset) {
+            // nothing loadable left in it
+            this->removeBeatmapSet(loaded);
+            changes.removed++;
+        } else {
+            if(BeatmapSet *replaced = this->replaceBeatmapSet(loaded, std::move(mapset))) {
+                this->raw_loaded_folders[std::string{folder}] = {.stamp = stamp, .set = replaced};
+            }
+            changes.modified++;
+        }
+    }
+
+    if(!changes.empty()) {
+        logIfCV(debug_db, "rescan: {} new, {} modified, {} removed", changes.added, changes.modified,
+                changes.removed);
+        this->raw_found_changes = true;
+    }
+
+    return changes;
+}
+
 void Database::AsyncScoreSaver::initAsync() {
-    auto compressed_replay = LegacyReplay::compress_frames(this->scorecopy.replay);
+    if(this->scorecopy) {
+        saveScore(*this->scorecopy);
+    }
+
+    if(db && !engine->isShuttingDown() && cv::scores_save_immediately.getBool()) {
+        db->journalPendingScoreDeletions();
+    }
+
+    this->setAsyncReady(true);
+    // nothing to do in init(), set ready now
+    this->setReady(true);
+}
+
+void Database::AsyncScoreSaver::saveScore(const FinishedScore &score) {
+    auto compressed_replay = LegacyReplay::compress_frames(score.replay);
     if(!compressed_replay.empty()) {
-        auto replay_path = fmt::format(NEOSU_REPLAYS_PATH "/{:d}.replay.lzma", this->scorecopy.unixTimestamp);
+        auto replay_path = fmt::format(NEOSU_REPLAYS_PATH "/{:d}.replay.lzma", score.unixTimestamp);
         debugLog("Saving replay to {}...", replay_path);
         io->write(replay_path, std::move(compressed_replay), [replay_path](bool success) {
             if(success) {
@@ -531,12 +916,11 @@ void Database::AsyncScoreSaver::initAsync() {
     }
 
     if(db && !engine->isShuttingDown() && cv::scores_save_immediately.getBool()) {
-        db->saveScores();
+        // only rewrite every score once the journal gets long (or can't be written to)
+        if(!db->journalScoreChange(ScoresJournal::RecordType::SCORE_ADDED, score)) {
+            db->saveScores();
+        }
     }
-
-    this->setAsyncReady(true);
-    // nothing to do in init(), set ready now
-    this->setReady(true);
 }
 
 bool Database::addScore(const FinishedScore &score) {
@@ -546,8 +930,6 @@ bool Database::addScore(const FinishedScore &score) {
     if(added) {
         this->sortScores(score.beatmap_hash);
 
-        this->scores_changed = true;
-
         // create initial instance
         if(!this->score_saver) {
             this->score_saver = std::make_unique<AsyncScoreSaver>(score);
@@ -623,6 +1005,7 @@ bool Database::addScoreRaw(const FinishedScore &score) {
         // new score
         this->scores[score.beatmap_hash].push_back(score);
     }
+    this->updatePlayerStats(score.beatmap_hash, score.playerName);
 
     return true;
 }
@@ -630,11 +1013,47 @@ bool Database::addScoreRaw(const FinishedScore &score) {
 void Database::deleteScore(const FinishedScore &scoreToDelete) {
     if(scoreToDelete.beatmap_hash.empty()) return;
 
-    Sync::unique_lock lock(this->scores_mtx);
-    if(const auto &scoreit = this->scores.find(scoreToDelete.beatmap_hash); scoreit != this->scores.end()) {
-        if(std::erase(scoreit->second, scoreToDelete)) {
-            this->scores_changed.store(true, std::memory_order_release);
+    bool deleted = false;
+    {
+        Sync::unique_lock lock(this->scores_mtx);
+        if(const auto &scoreit = this->scores.find(scoreToDelete.beatmap_hash); scoreit != this->scores.end()) {
+            deleted = std::erase(scoreit->second, scoreToDelete) > 0;
         }
+        if(deleted) {
+            this->updatePlayerStats(scoreToDelete.beatmap_hash, scoreToDelete.playerName);
+        }
+    }
+
+    if(deleted && cv::scores_save_immediately.getBool()) {
+        {
+            Sync::scoped_lock lock(this->pending_score_deletions_mtx);
+            this->pending_score_deletions.push_back(scoreToDelete);
+        }
+        this->startScoreDeletionSaver();
+    }
+}
+
+void Database::startScoreDeletionSaver() {
+    if(!this->score_saver) {
+        this->score_saver = std::make_unique<AsyncScoreSaver>(std::nullopt);
+        resourceManager->requestNextLoadAsync();
+        resourceManager->loadResource(this->score_saver.get());
+    } else if(this->score_saver->isReady()) {
+        this->score_saver->scorecopy.reset();
+        resourceManager->reloadResource(this->score_saver.get(), true);
+    }
+}
+
+void Database::journalPendingScoreDeletions() {
+    std::vector<FinishedScore> deletions;
+    {
+        Sync::scoped_lock lock(this->pending_score_deletions_mtx);
+        deletions.swap(this->pending_score_deletions);
+    }
+
+    // the next saved play (or exiting) takes care of compacting the journal
+    for(const auto &score : deletions) {
+        (void)this->journalScoreChange(ScoresJournal::RecordType::SCORE_DELETED, score);
     }
 }
 
@@ -666,126 +1085,83 @@ void Database::sortScores(const MD5Hash &beatmapMD5Hash) {
     return;
 }
 
+void Database::updatePlayerStats(const MD5Hash &beatmapMD5Hash, const std::string &playerName) {
+    if(const auto &it = this->scores.find(beatmapMD5Hash); it != this->scores.end()) {
+        this->player_stats.update(beatmapMD5Hash, it->second, playerName);
+    } else {
+        this->player_stats.update(beatmapMD5Hash, {}, playerName);
+    }
+}
+
 Database::PlayerPPScores Database::getPlayerPPScores(const std::string &playerName) {
     PlayerPPScores ppScores;
     ppScores.totalScore = 0;
     if(this->getProgress() < 1.0f) return ppScores;
 
-    // hoist out of the loop
-    const bool include_autopilot_relax = cv::user_include_relax_and_autopilot_for_stats.getBool();
-
-    u64 totalScore = 0;
-
-    std::vector<FinishedScore *> scores;
-    {
-        Sync::shared_lock lock(this->scores_mtx);
+    this->syncPlayerStatsModFilter();
 
-        for(auto &[hash, scorevec] : this->scores) {
-            if(scorevec.empty()) continue;
+    const std::vector<PlayerStatsIndex::TopScore> top = this->player_stats.getTopScores(playerName);
+    ppScores.totalScore = this->player_stats.getTotals(playerName).total_score;
+    ppScores.ppScores.reserve(top.size());
 
-            FinishedScore *tempScore = &scorevec[0];
-
-            // only add highest pp score per diff
-            bool foundValidScore = false;
-            f64 prevPP = -1.0;
-            for(auto &score : scorevec) {
-                // filter out scores set with a different name or if we shouldn't allow relax/autopilot
-                if((!include_autopilot_relax &&
-                    (u64)score.mods.flags & ((u64)ModFlags::Relax | (u64)ModFlags::Autopilot)) ||
-                   (playerName != score.playerName)) {
-                    continue;
-                }
+    Sync::shared_lock lock(this->scores_mtx);
 
-                foundValidScore = true;
-                totalScore += score.score;
+    // sorted by pp (reversed), lowest first
+    for(const auto &entry : top | std::views::reverse) {
+        const auto &it = this->scores.find(entry.beatmap_hash);
+        if(it == this->scores.end()) continue;
 
-                const auto scorePP = score.get_pp();
-                if(scorePP > prevPP || prevPP < 0.0) {
-                    prevPP = scorePP;
-                    tempScore = &score;
-                }
+        for(auto &score : it->second) {
+            if(score.unixTimestamp == entry.unixTimestamp && score.playerName == playerName) {
+                ppScores.ppScores.push_back(&score);
+                break;
             }
-
-            if(foundValidScore) scores.push_back(tempScore);
         }
-
-        // sort by pp (reversed)
-        // for some reason this was originally backwards from sortScoreByPP, so negating it here
-        std::ranges::sort(scores, [](const FinishedScore *const a, const FinishedScore *const b) -> bool {
-            if(a == b) return false;
-            return sortScoreByPP(*b, *a);
-        });
     }
 
-    ppScores.ppScores = std::move(scores);
-    ppScores.totalScore = totalScore;
-
     return ppScores;
 }
 
-Database::PlayerStats Database::calculatePlayerStats(const std::string &playerName) {
-    // FIXME: returning cached statistics even if we got new scores
-    // this is makes this function a "sneaky" API that might return stale stats
-    // done for performance to not tank FPS during score recalc where this is done on the main thread
-    // every frame (by UserCard::updateUserStats)
-
-    // should be done by the caller but it's more complicated because the prevPlayerStats are
-    // cached inside Database...
-    const bool scoresChanged = this->scores_changed.load(std::memory_order_acquire);
-    const bool returnCached =
-        playerName == this->prevPlayerStats.name.utf8View() &&
-        (!scoresChanged || (!BatchDiffCalc::scores_finished() && !engine->throttledShouldRun(120)));
-    if(returnCached) {
-        return this->prevPlayerStats;
-    }
-
-    const PlayerPPScores ps = this->getPlayerPPScores(playerName);
-
-    // delay caching until we actually have scores loaded
-    if(ps.ppScores.size() > 0 || this->isFinished()) {
-        this->scores_changed.store(false, std::memory_order_release);
+void Database::syncPlayerStatsModFilter() {
+    // the index is only rebuilt from scratch when the setting changes, everything else updates it as scores change
+    const bool include_autopilot_relax = cv::user_include_relax_and_autopilot_for_stats.getBool();
+    if(this->player_stats.isBuilt() && this->player_stats.includesRelaxAutopilot() != include_autopilot_relax) {
+        Sync::shared_lock lock(this->scores_mtx);
+        this->player_stats.rebuild(this->scores, include_autopilot_relax);
     }
+}
 
-    // "If n is the amount of scores giving more pp than a given score, then the score's weight is 0.95^n"
-    // "Total pp = PP[1] * 0.95^0 + PP[2] * 0.95^1 + PP[3] * 0.95^2 + ... + PP[n] * 0.95^(n-1)"
-    // also, total accuracy is apparently weighted the same as pp
-    float pp = 0.0f;
-    float acc = 0.0f;
-    for(uSz i = 0; i < ps.ppScores.size(); i++) {
-        const float weight = getWeightForIndex(ps.ppScores.size() - 1 - i);
+Database::PlayerStats Database::calculatePlayerStats(const std::string &playerName) {
+    this->syncPlayerStatsModFilter();
 
-        pp += ps.ppScores[i]->get_pp() * weight;
-        acc += LiveScore::calculateAccuracy(ps.ppScores[i]->num300s, ps.ppScores[i]->num100s, ps.ppScores[i]->num50s,
-                                            ps.ppScores[i]->numMisses) *
-               weight;
-    }
+    const PlayerStatsIndex::Totals totals = this->player_stats.getTotals(playerName);
 
     // bonus pp
     // https://osu.ppy.sh/wiki/en/Performance_points
-    if(cv::scores_bonus_pp.getBool()) pp += getBonusPPForNumScores(ps.ppScores.size());
-
-    // normalize accuracy
-    if(ps.ppScores.size() > 0) acc /= (20.0f * (1.0f - getWeightForIndex(ps.ppScores.size())));
+    f32 pp = totals.pp;
+    if(cv::scores_bonus_pp.getBool()) pp += getBonusPPForNumScores(totals.num_scores);
 
     // fill stats
-    this->prevPlayerStats.name = playerName;
+    if(playerName != this->prevPlayerStats.name.utf8View()) {
+        this->prevPlayerStats.name = playerName;
+    }
     this->prevPlayerStats.pp = pp;
-    this->prevPlayerStats.accuracy = acc;
-    this->prevPlayerStats.numScoresWithPP = ps.ppScores.size();
+    this->prevPlayerStats.accuracy = totals.accuracy;
+    this->prevPlayerStats.numScoresWithPP = static_cast<int>(totals.num_scores);
 
-    if(ps.totalScore != this->prevPlayerStats.totalScore) {
-        this->prevPlayerStats.level = getLevelForScore(ps.totalScore);
+    if(totals.total_score != this->prevPlayerStats.totalScore) {
+        this->prevPlayerStats.level = getLevelForScore(totals.total_score);
 
         const u64 requiredScoreForCurrentLevel = getRequiredScoreForLevel(this->prevPlayerStats.level);
         const u64 requiredScoreForNextLevel = getRequiredScoreForLevel(this->prevPlayerStats.level + 1);
 
         if(requiredScoreForNextLevel > requiredScoreForCurrentLevel)
             this->prevPlayerStats.percentToNextLevel =
-                (double)(ps.totalScore - requiredScoreForCurrentLevel) /
+                (double)(totals.total_score - requiredScoreForCurrentLevel) /
                 (double)(requiredScoreForNextLevel - requiredScoreForCurrentLevel);
     }
 
-    this->prevPlayerStats.totalScore = ps.totalScore;
+    this->prevPlayerStats.totalScore = totals.total_score;
 
     return this->prevPlayerStats;
 }
@@ -908,41 +1284,26 @@ void Database::scheduleLoadRaw() {
             this->raw_load_is_neosu = false;
         }
 
+        // nothing from the previous raw load can be reused if we're loading from somewhere else now
+        if(folderToLoadFrom != this->raw_load_osu_song_folder) {
+            this->raw_loaded_folders.clear();
+            this->raw_reusable_sets.clear();
+        }
+
         this->raw_load_osu_song_folder = std::move(folderToLoadFrom);
         this->raw_load_beatmap_folders = std::move(foldersInFolder);
     }
 
     this->num_beatmaps_to_load = this->raw_load_beatmap_folders.size();
 
-    // if this isn't the first load, only load the differences
-    if(!this->is_first_load) {
-        std::vector<std::string> toLoad;
-        for(uSz i = 0; i < this->num_beatmaps_to_load; i++) {
-            bool alreadyLoaded = false;
-            for(const auto &rawBeatmapFolder : this->raw_loaded_beatmap_folders) {
-                if(this->raw_load_beatmap_folders[i] == rawBeatmapFolder) {
-                    alreadyLoaded = true;
-                    break;
-                }
-            }
-
-            if(!alreadyLoaded) toLoad.push_back(this->raw_load_beatmap_folders[i]);
+    // added/modified folders are counted by update() as they come in, removed ones are simply never seen again
+    this->raw_load_changes = {};
+    if(!this->raw_loaded_folders.empty()) {
+        Hash::flat::set<std::string_view> on_disk{this->raw_load_beatmap_folders.begin(),
+                                                  this->raw_load_beatmap_folders.end()};
+        for(const auto &[folder, entry] : this->raw_loaded_folders) {
+            if(!on_disk.contains(folder)) this->raw_load_changes.removed++;
         }
-
-        // only load differences
-        this->raw_load_beatmap_folders = toLoad;
-        this->num_beatmaps_to_load = this->raw_load_beatmap_folders.size();
-
-        debugLog("Database: Found {} new/changed beatmaps.", this->num_beatmaps_to_load);
-
-        this->raw_found_changes = this->num_beatmaps_to_load > 0;
-        if(this->raw_found_changes)
-            ui->getNotificationOverlay()->addNotification(
-                fmt::format("Adding {:d} new beatmap{}.", this->num_beatmaps_to_load,
-                            this->num_beatmaps_to_load == 1 ? "" : "s"),
-                0xff00ff00);
-        else
-            ui->getNotificationOverlay()->addNotification(US_("No new beatmaps detected."), 0xff00ff00);
     }
 
     debugLog("Database: Building beatmap database ...");
@@ -951,14 +1312,20 @@ void Database::scheduleLoadRaw() {
     // only start loading if we have something to load
     if(this->raw_load_beatmap_folders.size() > 0) {
         this->loading_progress = 0.0f;
-        this->cur_raw_load_idx = 0;
 
         this->raw_load_scheduled = true;
         this->importTimer->start();
-    } else
-        this->loading_progress = 1.0f;
 
-    this->is_first_load = false;
+        // the pool takes the previous folder states to compare against, raw_loaded_folders is rebuilt in update()
+        this->raw_import_pool = std::make_unique<RawImportPool>(
+            this->raw_load_osu_song_folder, this->raw_load_beatmap_folders, std::move(this->raw_loaded_folders),
+            !this->raw_load_is_neosu /* is_peppy */);
+        this->raw_loaded_folders.clear();
+    } else {
+        this->raw_loaded_folders.clear();
+        this->raw_reusable_sets.clear();
+        this->loading_progress = 1.0f;
+    }
 }
 namespace {
 constexpr i64 TICKS_PER_SECOND = 10'000'000;
@@ -984,385 +1351,658 @@ MD5Hash Database::recalcMD5(std::string osu_path) {
     return md5digest;
 }
 
-void Database::loadMaps() {
-    const auto &peppy_db_path = this->database_files[DatabaseType::STABLE_MAPS];
-    const auto &neosu_maps_path = this->database_files[DatabaseType::NEOSU_MAPS];
+// NEOSU_MAPS_DB_LAST_STREAMED_VERSION and older, with every record one after another
+void Database::loadStreamedNeosuMaps(std::string_view neosu_maps_path, u32 &nb_neosu_maps, u32 &nb_overrides) {
+    ByteBufferedFile::Reader neosu_maps(neosu_maps_path);
+    if(neosu_maps.total_size == 0) return;
 
-    const std::string &songFolder = Database::getOsuSongsFolder();
-    debugLog("Database: songFolder = {:s}", songFolder);
+    u32 version = neosu_maps.read<u32>();
+    if(version < NEOSU_MAPS_DB_VERSION) {
+        // Reading from older database version: backup just in case
+        auto backup_path = fmt::format("{}.{}-{:%F}", neosu_maps_path, version, fmt::gmtime(std::time(nullptr)));
+        if(File::copy(neosu_maps_path, backup_path)) {
+            debugLog("older database {} < {}, backed up {} -> {}", version, NEOSU_MAPS_DB_VERSION, neosu_maps_path,
+                     backup_path);
+        }
+    }
 
-    this->importTimer->start();
+    u32 nb_sets = neosu_maps.read<u32>();
+    for(uSz i = 0; i < nb_sets; i++) {
+        if(this->load_interrupted.load(std::memory_order_acquire)) break;  // cancellation point
 
-    u32 nb_neosu_maps = 0;
-    u32 nb_peppy_maps = 0;
-    u32 nb_overrides = 0;
+        u32 progress_bytes = this->bytes_processed + neosu_maps.total_pos;
+        f64 progress_float = (f64)progress_bytes / (f64)this->total_bytes;
+        this->loading_progress = std::clamp(progress_float, 0.01, 0.99);
 
-    // Load neosu map database
-    {
-        ByteBufferedFile::Reader neosu_maps(neosu_maps_path);
-        if(neosu_maps.total_size > 0) {
-            u32 version = neosu_maps.read<u32>();
-            if(version < NEOSU_MAPS_DB_VERSION) {
-                // Reading from older database version: backup just in case
-                auto backup_path =
-                    fmt::format("{}.{}-{:%F}", neosu_maps_path, version, fmt::gmtime(std::time(nullptr)));
-                if(File::copy(neosu_maps_path, backup_path)) {
-                    debugLog("older database {} < {}, backed up {} -> {}", version, NEOSU_MAPS_DB_VERSION,
-                             neosu_maps_path, backup_path);
+        i32 set_id = neosu_maps.read<i32>();
+        u16 nb_diffs = neosu_maps.read<u16>();
+
+        // NOTE: Ignoring mapsets with ID -1, since we most likely saved them in the correct folder,
+        //       but mistakenly set their ID to -1 (because the ID was missing from the .osu file).
+        if(set_id == -1) {
+            for(u16 j = 0; j < nb_diffs; j++) {
+                neosu_maps.skip_string();  // osu_filename
+                neosu_maps.skip<i32>();    // iID
+                neosu_maps.skip_string();  // sTitle
+                neosu_maps.skip_string();  // sAudioFileName
+                neosu_maps.skip<i32>();    // iLengthMS
+                neosu_maps.skip<f32>();    // fStackLeniency
+                neosu_maps.skip_string();  // sArtist
+                neosu_maps.skip_string();  // sCreator
+                neosu_maps.skip_string();  // sDifficultyName
+                neosu_maps.skip_string();  // sSource
+                neosu_maps.skip_string();  // sTags
+                MD5Hash md5;
+                if(version >= 20260202) {
+                    // storing as the raw digest bytes past this ver
+                    (void)neosu_maps.read_hash_digest(md5);  // TODO: validate
+                } else {
+                    (void)neosu_maps.read_hash_chars(md5);  // TODO: validate
+                }
+                // other fixed-sized fields in the middle... try adding new stuff at the end so this doesn't break in the future
+                neosu_maps.skip_bytes(sizeof(f32) + sizeof(f32) + sizeof(f32) + sizeof(f32) + sizeof(f64) +
+                                      sizeof(u32) + sizeof(u64) + sizeof(i16) + sizeof(i16) + sizeof(u16) +
+                                      sizeof(u16) + sizeof(u16) + sizeof(f64) + (sizeof(i32) * 3));
+                if(version < 20240812) {
+                    u32 nb_timing_points = neosu_maps.read<u32>();
+                    neosu_maps.skip_bytes(sizeof(DB_TIMINGPOINT) * nb_timing_points);
+                }
+                if(version >= 20240703) {  // draw_background
+                    neosu_maps.skip<u8>();
+                }
+                if(version >= 20240812) {  // loudness
+                    neosu_maps.skip<f32>();
+                }
+                if(version >= 20250801) {  // unicode title+artist
+                    neosu_maps.skip_string();
+                    neosu_maps.skip_string();
+                }
+                if(version >= 20251009) {  // background image filename
+                    neosu_maps.skip_string();
+                }
+                if(version >= 20251225) {  // ppv2 version
+                    neosu_maps.skip<u32>();
                 }
-            }
 
-            u32 nb_sets = neosu_maps.read<u32>();
-            for(uSz i = 0; i < nb_sets; i++) {
-                if(this->load_interrupted.load(std::memory_order_acquire)) break;  // cancellation point
+                logIfCV(debug_db, "skipped iSetID==-1 beatmap with hash {} load idx: {},{}", md5, i, j);
+            }
+            continue;
+        }
 
-                u32 progress_bytes = this->bytes_processed + neosu_maps.total_pos;
-                f64 progress_float = (f64)progress_bytes / (f64)this->total_bytes;
-                this->loading_progress = std::clamp(progress_float, 0.01, 0.99);
+        auto diffs = std::make_unique<DiffContainer>();
+        std::string mapset_path = fmt::format(NEOSU_MAPS_PATH "/{}/", set_id);
 
-                i32 set_id = neosu_maps.read<i32>();
-                u16 nb_diffs = neosu_maps.read<u16>();
-
-                // NOTE: Ignoring mapsets with ID -1, since we most likely saved them in the correct folder,
-                //       but mistakenly set their ID to -1 (because the ID was missing from the .osu file).
-                if(set_id == -1) {
-                    for(u16 j = 0; j < nb_diffs; j++) {
-                        neosu_maps.skip_string();  // osu_filename
-                        neosu_maps.skip<i32>();    // iID
-                        neosu_maps.skip_string();  // sTitle
-                        neosu_maps.skip_string();  // sAudioFileName
-                        neosu_maps.skip<i32>();    // iLengthMS
-                        neosu_maps.skip<f32>();    // fStackLeniency
-                        neosu_maps.skip_string();  // sArtist
-                        neosu_maps.skip_string();  // sCreator
-                        neosu_maps.skip_string();  // sDifficultyName
-                        neosu_maps.skip_string();  // sSource
-                        neosu_maps.skip_string();  // sTags
-                        MD5Hash md5;
-                        if(version >= 20260202) {
-                            // storing as the raw digest bytes past this ver
-                            (void)neosu_maps.read_hash_digest(md5);  // TODO: validate
-                        } else {
-                            (void)neosu_maps.read_hash_chars(md5);  // TODO: validate
-                        }
-                        // other fixed-sized fields in the middle... try adding new stuff at the end so this doesn't break in the future
-                        neosu_maps.skip_bytes(sizeof(f32) + sizeof(f32) + sizeof(f32) + sizeof(f32) + sizeof(f64) +
-                                              sizeof(u32) + sizeof(u64) + sizeof(i16) + sizeof(i16) + sizeof(u16) +
-                                              sizeof(u16) + sizeof(u16) + sizeof(f64) + (sizeof(i32) * 3));
-                        if(version < 20240812) {
-                            u32 nb_timing_points = neosu_maps.read<u32>();
-                            neosu_maps.skip_bytes(sizeof(DB_TIMINGPOINT) * nb_timing_points);
-                        }
-                        if(version >= 20240703) {  // draw_background
-                            neosu_maps.skip<u8>();
-                        }
-                        if(version >= 20240812) {  // loudness
-                            neosu_maps.skip<f32>();
-                        }
-                        if(version >= 20250801) {  // unicode title+artist
-                            neosu_maps.skip_string();
-                            neosu_maps.skip_string();
-                        }
-                        if(version >= 20251009) {  // background image filename
-                            neosu_maps.skip_string();
-                        }
-                        if(version >= 20251225) {  // ppv2 version
-                            neosu_maps.skip<u32>();
-                        }
+        for(u16 j = 0; j < nb_diffs; j++) {
+            if(this->load_interrupted.load(std::memory_order_acquire)) {  // cancellation point
+                // clean up partially loaded diffs in current set
+                Sync::unique_lock lock(this->beatmap_difficulties_mtx);
+                for(const auto &diff : *diffs) {
+                    this->beatmap_difficulties.erase(diff->getMD5());
 
-                        logIfCV(debug_db, "skipped iSetID==-1 beatmap with hash {} load idx: {},{}", md5, i, j);
-                    }
-                    continue;
+                    // remove from loudness_to_calc
+                    std::erase(this->loudness_to_calc, diff.get());
                 }
+                diffs.reset();
+                break;
+            }
 
-                auto diffs = std::make_unique<DiffContainer>();
-                std::string mapset_path = fmt::format(NEOSU_MAPS_PATH "/{}/", set_id);
-
-                for(u16 j = 0; j < nb_diffs; j++) {
-                    if(this->load_interrupted.load(std::memory_order_acquire)) {  // cancellation point
-                        // clean up partially loaded diffs in current set
-                        Sync::unique_lock lock(this->beatmap_difficulties_mtx);
-                        for(const auto &diff : *diffs) {
-                            this->beatmap_difficulties.erase(diff->getMD5());
-
-                            // remove from loudness_to_calc
-                            std::erase(this->loudness_to_calc, diff.get());
-                        }
-                        diffs.reset();
-                        break;
-                    }
+            std::string osu_filename = neosu_maps.read_string();
+
+            i32 iID = neosu_maps.read<i32>();
+            i32 iSetID = set_id;
+            std::string sTitle = neosu_maps.read_string();
+            std::string sAudioFileName = neosu_maps.read_string();
+            i32 iLengthMS = neosu_maps.read<i32>();
+            f32 fStackLeniency = neosu_maps.read<f32>();
+            std::string sArtist = neosu_maps.read_string();
+            std::string sCreator = neosu_maps.read_string();
+            std::string sDifficultyName = neosu_maps.read_string();
+            std::string sSource = neosu_maps.read_string();
+            std::string sTags = neosu_maps.read_string();
+
+            MD5Hash diff_hash;
+            // TODO: properly validate and skip beatmaps with invalid hashes
+            if(version >= 20260202) {
+                // storing as the raw digest bytes past this ver
+                (void)neosu_maps.read_hash_digest(diff_hash);
+            } else {
+                (void)neosu_maps.read_hash_chars(diff_hash);
+            }
 
-                    std::string osu_filename = neosu_maps.read_string();
-
-                    i32 iID = neosu_maps.read<i32>();
-                    i32 iSetID = set_id;
-                    std::string sTitle = neosu_maps.read_string();
-                    std::string sAudioFileName = neosu_maps.read_string();
-                    i32 iLengthMS = neosu_maps.read<i32>();
-                    f32 fStackLeniency = neosu_maps.read<f32>();
-                    std::string sArtist = neosu_maps.read_string();
-                    std::string sCreator = neosu_maps.read_string();
-                    std::string sDifficultyName = neosu_maps.read_string();
-                    std::string sSource = neosu_maps.read_string();
-                    std::string sTags = neosu_maps.read_string();
-
-                    MD5Hash diff_hash;
-                    // TODO: properly validate and skip beatmaps with invalid hashes
-                    if(version >= 20260202) {
-                        // storing as the raw digest bytes past this ver
-                        (void)neosu_maps.read_hash_digest(diff_hash);
-                    } else {
-                        (void)neosu_maps.read_hash_chars(diff_hash);
-                    }
+            f32 fAR = neosu_maps.read<f32>();
+            f32 fCS = neosu_maps.read<f32>();
+            f32 fHP = neosu_maps.read<f32>();
+            f32 fOD = neosu_maps.read<f32>();
+            f64 fSliderMultiplier = neosu_maps.read<f64>();
+            u32 iPreviewTime = neosu_maps.read<u32>();
+            const i64 maybe_dotnettime = neosu_maps.read<i64>();
+            i64 last_modification_time = maybe_dotnettime;
+            // convert .NET timestamp to unix timestamp (mtime)
+            // we don't really need to update db format for this because it was only used for sorting
+            // so just fix it up here
+            if(maybe_dotnettime > 1'000'000'000'000'000 /* 100% .net timestamp from non-updated db */) {
+                last_modification_time = (maybe_dotnettime - UNIX_EPOCH_TICKS) / TICKS_PER_SECOND;
+            }
+            i16 iLocalOffset = neosu_maps.read<i16>();
+            i16 iOnlineOffset = neosu_maps.read<i16>();
+            u16 iNumCircles = neosu_maps.read<u16>();
+            u16 iNumSliders = neosu_maps.read<u16>();
+            u16 iNumSpinners = neosu_maps.read<u16>();
+            f64 fStarsNomod = neosu_maps.read<f64>();
+
+            i32 iMinBPM{-1}, iMaxBPM{-1}, iMostCommonBPM{-1};
+            if(version >= 20251209) {  // prior versions had a rounding bug, force recalc
+                iMinBPM = neosu_maps.read<i32>();
+                iMaxBPM = neosu_maps.read<i32>();
+                iMostCommonBPM = neosu_maps.read<i32>();
+            } else {
+                neosu_maps.skip_bytes(sizeof(i32) * 3);
+            }
 
-                    f32 fAR = neosu_maps.read<f32>();
-                    f32 fCS = neosu_maps.read<f32>();
-                    f32 fHP = neosu_maps.read<f32>();
-                    f32 fOD = neosu_maps.read<f32>();
-                    f64 fSliderMultiplier = neosu_maps.read<f64>();
-                    u32 iPreviewTime = neosu_maps.read<u32>();
-                    const i64 maybe_dotnettime = neosu_maps.read<i64>();
-                    i64 last_modification_time = maybe_dotnettime;
-                    // convert .NET timestamp to unix timestamp (mtime)
-                    // we don't really need to update db format for this because it was only used for sorting
-                    // so just fix it up here
-                    if(maybe_dotnettime > 1'000'000'000'000'000 /* 100% .net timestamp from non-updated db */) {
-                        last_modification_time = (maybe_dotnettime - UNIX_EPOCH_TICKS) / TICKS_PER_SECOND;
-                    }
-                    i16 iLocalOffset = neosu_maps.read<i16>();
-                    i16 iOnlineOffset = neosu_maps.read<i16>();
-                    u16 iNumCircles = neosu_maps.read<u16>();
-                    u16 iNumSliders = neosu_maps.read<u16>();
-                    u16 iNumSpinners = neosu_maps.read<u16>();
-                    f64 fStarsNomod = neosu_maps.read<f64>();
-
-                    i32 iMinBPM{-1}, iMaxBPM{-1}, iMostCommonBPM{-1};
-                    if(version >= 20251209) {  // prior versions had a rounding bug, force recalc
-                        iMinBPM = neosu_maps.read<i32>();
-                        iMaxBPM = neosu_maps.read<i32>();
-                        iMostCommonBPM = neosu_maps.read<i32>();
-                    } else {
-                        neosu_maps.skip_bytes(sizeof(i32) * 3);
-                    }
+            if(version < 20240812) {
+                u32 nb_timing_points = neosu_maps.read<u32>();
+                neosu_maps.skip_bytes(sizeof(DB_TIMINGPOINT) * nb_timing_points);
+            }
 
-                    if(version < 20240812) {
-                        u32 nb_timing_points = neosu_maps.read<u32>();
-                        neosu_maps.skip_bytes(sizeof(DB_TIMINGPOINT) * nb_timing_points);
-                    }
+            bool draw_background = true;
+            if(version >= 20240703) {
+                draw_background = neosu_maps.read<u8>();
+            }
 
-                    bool draw_background = true;
-                    if(version >= 20240703) {
-                        draw_background = neosu_maps.read<u8>();
-                    }
+            f32 loudness = 0.f;
+            if(version >= 20240812) {
+                loudness = neosu_maps.read<f32>();
+            }
 
-                    f32 loudness = 0.f;
-                    if(version >= 20240812) {
-                        loudness = neosu_maps.read<f32>();
-                    }
+            std::string sTitleUnicode = sTitle;
+            std::string sArtistUnicode = sArtist;
+            if(version >= 20250801) {
+                neosu_maps.read_string(sTitleUnicode);
+                neosu_maps.read_string(sArtistUnicode);
+            }
 
-                    std::string sTitleUnicode = sTitle;
-                    std::string sArtistUnicode = sArtist;
-                    if(version >= 20250801) {
-                        neosu_maps.read_string(sTitleUnicode);
-                        neosu_maps.read_string(sArtistUnicode);
-                    }
+            const bool bEmptyTitleUnicode = SString::is_wspace_only(sTitleUnicode);
+            const bool bEmptyArtistUnicode = SString::is_wspace_only(sArtistUnicode);
 
-                    const bool bEmptyTitleUnicode = SString::is_wspace_only(sTitleUnicode);
-                    const bool bEmptyArtistUnicode = SString::is_wspace_only(sArtistUnicode);
+            // we cache the background image filename in the database past this version
+            std::string sBackgroundImageFileName;
+            if(version >= 20251009) {
+                neosu_maps.read_string(sBackgroundImageFileName);
+            }
 
-                    // we cache the background image filename in the database past this version
-                    std::string sBackgroundImageFileName;
-                    if(version >= 20251009) {
-                        neosu_maps.read_string(sBackgroundImageFileName);
-                    }
+            // prior versions did not store PPv2 version, so there was no way to know if the maps needed pp recalc
+            u32 ppv2Version = 0;
+            if(version >= 20251225) {
+                ppv2Version = neosu_maps.read<u32>();
+            }
 
-                    // prior versions did not store PPv2 version, so there was no way to know if the maps needed pp recalc
-                    u32 ppv2Version = 0;
-                    if(version >= 20251225) {
-                        ppv2Version = neosu_maps.read<u32>();
+            // Fixup a bug with certain bleeding edge commits ~December 2025,
+            // where the osu_filename was saved as just the folder name itself...
+            if(osu_filename.empty() || osu_filename == mapset_path) {
+                for(const auto &osufile_nameonly : Environment::getFilesInFolder(mapset_path)) {
+                    if(Environment::getFileExtensionFromFilePath(osufile_nameonly).compare("osu") != 0) {
+                        continue;
                     }
-
-                    // Fixup a bug with certain bleeding edge commits ~December 2025,
-                    // where the osu_filename was saved as just the folder name itself...
-                    if(osu_filename.empty() || osu_filename == mapset_path) {
-                        for(const auto &osufile_nameonly : Environment::getFilesInFolder(mapset_path)) {
-                            if(Environment::getFileExtensionFromFilePath(osufile_nameonly).compare("osu") != 0) {
+                    const std::string osufile_fullpath = mapset_path + osufile_nameonly;
+                    bool inMetadata = false;
+                    i32 tempiID = -1;
+                    {
+                        File file(osufile_fullpath);
+                        for(auto line = file.readLine(); !line.empty() || file.canRead();
+                            line = file.readLine()) {
+                            if(line.empty() || SString::is_comment(line)) continue;
+                            if(line.contains("[Metadata]")) {
+                                inMetadata = true;
                                 continue;
                             }
-                            const std::string osufile_fullpath = mapset_path + osufile_nameonly;
-                            bool inMetadata = false;
-                            i32 tempiID = -1;
-                            {
-                                File file(osufile_fullpath);
-                                for(auto line = file.readLine(); !line.empty() || file.canRead();
-                                    line = file.readLine()) {
-                                    if(line.empty() || SString::is_comment(line)) continue;
-                                    if(line.contains("[Metadata]")) {
-                                        inMetadata = true;
-                                        continue;
-                                    }
-                                    if(line.starts_with('[') && inMetadata) {
-                                        break;
-                                    }
-                                    if(inMetadata) {
-                                        if(Parsing::parse(line, "BeatmapID", ':', &tempiID)) {
-                                            break;
-                                        }
-                                        continue;
-                                    }
-                                }
-                            }
-                            if(tempiID != -1 && tempiID == iID) {
-                                osu_filename = osufile_nameonly;
-                                debugLog("found fixed .osu filename {} iID {} hash {}", osu_filename, iID, diff_hash);
+                            if(line.starts_with('[') && inMetadata) {
                                 break;
                             }
+                            if(inMetadata) {
+                                if(Parsing::parse(line, "BeatmapID", ':', &tempiID)) {
+                                    break;
+                                }
+                                continue;
+                            }
                         }
                     }
-
-                    // force calculate hash if we saved with empty/0 hash
-                    if(diff_hash.empty()) {
-                        diff_hash = recalcMD5(mapset_path + osu_filename);
+                    if(tempiID != -1 && tempiID == iID) {
+                        osu_filename = osufile_nameonly;
+                        debugLog("found fixed .osu filename {} iID {} hash {}", osu_filename, iID, diff_hash);
+                        break;
                     }
+                }
+            }
 
-                    auto diff = std::make_unique<BeatmapDifficulty>(mapset_path + osu_filename, mapset_path,
-                                                                    DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
-
-                    diff->iID = iID;
-                    diff->iSetID = iSetID;
-                    diff->sTitle = std::move(sTitle);
-                    diff->sAudioFileName = std::move(sAudioFileName);
-                    diff->iLengthMS = iLengthMS;
-                    diff->fStackLeniency = fStackLeniency;
-                    diff->sArtist = std::move(sArtist);
-                    diff->sCreator = std::move(sCreator);
-                    diff->sDifficultyName = std::move(sDifficultyName);
-                    diff->sSource = std::move(sSource);
-                    diff->sTags = std::move(sTags);
-                    diff->writeMD5(diff_hash);
-                    diff->fAR = fAR;
-                    diff->fCS = fCS;
-                    diff->fHP = fHP;
-                    diff->fOD = fOD;
-                    diff->fSliderMultiplier = fSliderMultiplier;
-                    diff->iPreviewTime = iPreviewTime;
-                    diff->last_modification_time = last_modification_time;
-                    diff->iLocalOffset = iLocalOffset;
-                    diff->iOnlineOffset = iOnlineOffset;
-                    diff->iNumCircles = iNumCircles;
-                    diff->iNumSliders = iNumSliders;
-                    diff->iNumSpinners = iNumSpinners;
-                    diff->fStarsNomod = fStarsNomod;
-
-                    diff->iMinBPM = iMinBPM;
-                    diff->iMaxBPM = iMaxBPM;
-                    diff->iMostCommonBPM = iMostCommonBPM;
-
-                    diff->draw_background = draw_background;
-
-                    if(loudness == 0.f) {
-                        this->loudness_to_calc.push_back(diff.get());
-                    } else {
-                        diff->loudness = loudness;
-                    }
+            // force calculate hash if we saved with empty/0 hash
+            if(diff_hash.empty()) {
+                diff_hash = recalcMD5(mapset_path + osu_filename);
+            }
 
-                    diff->sTitleUnicode = std::move(sTitleUnicode);
-                    diff->sArtistUnicode = std::move(sArtistUnicode);
+            auto diff = std::make_unique<BeatmapDifficulty>(mapset_path + osu_filename, mapset_path,
+                                                            DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
+
+            diff->iID = iID;
+            diff->iSetID = iSetID;
+            diff->sTitle = std::move(sTitle);
+            diff->sAudioFileName = std::move(sAudioFileName);
+            diff->iLengthMS = iLengthMS;
+            diff->fStackLeniency = fStackLeniency;
+            diff->sArtist = std::move(sArtist);
+            diff->sCreator = std::move(sCreator);
+            diff->sDifficultyName = std::move(sDifficultyName);
+            diff->sSource = std::move(sSource);
+            diff->sTags = std::move(sTags);
+            diff->writeMD5(diff_hash);
+            diff->fAR = fAR;
+            diff->fCS = fCS;
+            diff->fHP = fHP;
+            diff->fOD = fOD;
+            diff->fSliderMultiplier = fSliderMultiplier;
+            diff->iPreviewTime = iPreviewTime;
+            diff->last_modification_time = last_modification_time;
+            diff->iLocalOffset = iLocalOffset;
+            diff->iOnlineOffset = iOnlineOffset;
+            diff->iNumCircles = iNumCircles;
+            diff->iNumSliders = iNumSliders;
+            diff->iNumSpinners = iNumSpinners;
+            diff->fStarsNomod = fStarsNomod;
+
+            diff->iMinBPM = iMinBPM;
+            diff->iMaxBPM = iMaxBPM;
+            diff->iMostCommonBPM = iMostCommonBPM;
+
+            diff->draw_background = draw_background;
+
+            if(loudness == 0.f) {
+                this->loudness_to_calc.push_back(diff.get());
+            } else {
+                diff->loudness = loudness;
+            }
 
-                    diff->bEmptyTitleUnicode = bEmptyTitleUnicode;
-                    diff->bEmptyArtistUnicode = bEmptyArtistUnicode;
+            diff->sTitleUnicode = std::move(sTitleUnicode);
+            diff->sArtistUnicode = std::move(sArtistUnicode);
 
-                    diff->sBackgroundImageFileName = std::move(sBackgroundImageFileName);
+            diff->bEmptyTitleUnicode = bEmptyTitleUnicode;
+            diff->bEmptyArtistUnicode = bEmptyArtistUnicode;
 
-                    diff->ppv2Version = ppv2Version;
+            diff->sBackgroundImageFileName = std::move(sBackgroundImageFileName);
 
-                    {
-                        Sync::unique_lock lock(this->beatmap_difficulties_mtx);
-                        this->beatmap_difficulties[diff_hash] = diff.get();
-                    }
-                    diffs->push_back(std::move(diff));
-                    nb_neosu_maps++;
-                }
+            diff->ppv2Version = ppv2Version;
 
-                if(diffs && !diffs->empty()) {
-                    auto set =
-                        std::make_unique<BeatmapSet>(std::move(diffs), DatabaseBeatmap::BeatmapType::NEOSU_BEATMAPSET);
-                    this->temp_loading_beatmapsets.push_back(std::move(set));
+            {
+                Sync::unique_lock lock(this->beatmap_difficulties_mtx);
+                this->beatmap_difficulties[diff_hash] = diff.get();
+            }
+            diffs->push_back(std::move(diff));
+            nb_neosu_maps++;
+        }
 
-                    // NOTE: Don't add neosu sets to beatmapSets since they're already processed
-                    // Adding them would create duplicate ownership of the diffs vector
-                }
+        if(diffs && !diffs->empty()) {
+            auto set = std::make_unique<BeatmapSet>(std::move(diffs), DatabaseBeatmap::BeatmapType::NEOSU_BEATMAPSET);
+            this->temp_loading_beatmapsets.push_back(std::move(set));
+
+            // NOTE: Don't add neosu sets to beatmapSets since they're already processed
+            // Adding them would create duplicate ownership of the diffs vector
+        }
+    }
+
+    if(version >= 20240812) {
+        nb_overrides = neosu_maps.read<u32>();
+        Sync::unique_lock lock(this->peppy_overrides_mtx);
+        for(uSz i = 0; i < nb_overrides; i++) {
+            MapOverrides over;
+            MD5Hash map_md5;
+            if(version >= 20260202) {
+                // storing as the raw digest bytes past this ver
+                (void)neosu_maps.read_hash_digest(map_md5);  // TODO: validate
+            } else {
+                (void)neosu_maps.read_hash_chars(map_md5);  // TODO: validate
             }
 
-            if(version >= 20240812) {
-                nb_overrides = neosu_maps.read<u32>();
-                Sync::unique_lock lock(this->peppy_overrides_mtx);
-                for(uSz i = 0; i < nb_overrides; i++) {
-                    MapOverrides over;
-                    MD5Hash map_md5;
-                    if(version >= 20260202) {
-                        // storing as the raw digest bytes past this ver
-                        (void)neosu_maps.read_hash_digest(map_md5);  // TODO: validate
-                    } else {
-                        (void)neosu_maps.read_hash_chars(map_md5);  // TODO: validate
-                    }
+            over.local_offset = neosu_maps.read<i16>();
+            over.online_offset = neosu_maps.read<i16>();
+            over.star_rating = neosu_maps.read<f32>();
+            over.loudness = neosu_maps.read<f32>();
+            if(version >= 20251209) {  // only override if we have accurately calculated values
+                over.min_bpm = neosu_maps.read<i32>();
+                over.max_bpm = neosu_maps.read<i32>();
+                over.avg_bpm = neosu_maps.read<i32>();
+            } else {
+                neosu_maps.skip_bytes(sizeof(i32) * 3);
+                over.min_bpm = -1;  // sentinel values, to be re-calculated when importing the map from peppy db
+                over.max_bpm = -1;
+                over.avg_bpm = -1;
+            }
+            over.draw_background = neosu_maps.read<u8>();
+            if(version >= 20251009) {
+                neosu_maps.read_string(over.background_image_filename);
+            }
+            if(version >= 20251225) {
+                over.ppv2_version = neosu_maps.read<u32>();
+            }
+            this->peppy_overrides[map_md5] = over;
+        }
+    }
 
-                    over.local_offset = neosu_maps.read<i16>();
-                    over.online_offset = neosu_maps.read<i16>();
-                    over.star_rating = neosu_maps.read<f32>();
-                    over.loudness = neosu_maps.read<f32>();
-                    if(version >= 20251209) {  // only override if we have accurately calculated values
-                        over.min_bpm = neosu_maps.read<i32>();
-                        over.max_bpm = neosu_maps.read<i32>();
-                        over.avg_bpm = neosu_maps.read<i32>();
-                    } else {
-                        neosu_maps.skip_bytes(sizeof(i32) * 3);
-                        over.min_bpm = -1;  // sentinel values, to be re-calculated when importing the map from peppy db
-                        over.max_bpm = -1;
-                        over.avg_bpm = -1;
-                    }
-                    over.draw_background = neosu_maps.read<u8>();
-                    if(version >= 20251009) {
-                        neosu_maps.read_string(over.background_image_filename);
-                    }
-                    if(version >= 20251225) {
-                        over.ppv2_version = neosu_maps.read<u32>();
-                    }
-                    this->peppy_overrides[map_md5] = over;
+    // star ratings section
+    if(version >= 20260202) {
+        const uSz stored_speeds = neosu_maps.read<u8>();
+        const uSz stored_combos = neosu_maps.read<u8>();
+        const u32 nb_star_entries = neosu_maps.read<u32>();
+        const uSz stored_entries = stored_speeds * stored_combos;
+        const bool layout_matches =
+            (stored_speeds == StarPrecalc::SPEEDS_NUM && stored_combos == StarPrecalc::NUM_MOD_COMBOS);
+
+        if(layout_matches) {
+            Sync::unique_lock lock(this->star_ratings_mtx);
+            this->star_ratings.reserve(nb_star_entries);
+            for(u32 i = 0; i < nb_star_entries; i++) {
+                MD5Hash hash;
+                (void)neosu_maps.read_hash_digest(hash);
+                auto ratings = std::make_unique<StarPrecalc::SRArray>();
+                (void)neosu_maps.read_bytes(reinterpret_cast<u8 *>(ratings->data()),
+                                            sizeof(f32) * StarPrecalc::NUM_PRECALC_RATINGS);
+                this->star_ratings.emplace(hash, std::move(ratings));
+            }
+        } else {
+            // layout changed; skip stored data, recalc will be triggered
+            debugLog("star ratings layout changed (stored {}x{}, current {}x{}), skipping", stored_speeds,
+                     stored_combos, (u8)StarPrecalc::SPEEDS_NUM, (uSz)StarPrecalc::NUM_MOD_COMBOS);
+            for(u32 i = 0; i < nb_star_entries; i++) {
+                neosu_maps.skip_bytes(sizeof(MD5Hash) + sizeof(f32) * stored_entries);
+            }
+        }
+    }
+}
+
+namespace {  // static namespace
+// columns can be missing from neosu_maps.db (added later, or their width changed), every row gets a default then
+template <typename T>
+struct OptColumn {
+    std::span<const T> values;
+    T fallback;
+
+    OptColumn(const MapsDB::Reader &reader, MapsDB::Col id, uSz nb_rows, T fallback_value = T{})
+        : values(reader.column<T>(id)), fallback(fallback_value) {
+        if(this->values.size() != nb_rows) this->values = {};
+    }
+
+    [[nodiscard]] bool has_values() const { return !this->values.empty(); }
+    [[nodiscard]] T operator[](uSz row) const { return this->values.empty() ? this->fallback : this->values[row]; }
+};
+}  // namespace
+
+bool Database::loadColumnarNeosuMaps(const MapsDB::Reader &neosu_maps, u32 &nb_neosu_maps, u32 &nb_overrides) {
+    using MapsDB::Col;
+    using MapsDB::StrRef;
+
+    // invalid string references read as empty strings
+    constexpr StrRef NO_STRING = static_cast<StrRef>(-1);
+
+    const auto set_ids = neosu_maps.column<i32>(Col::SET_ID);
+    const auto set_nb_diffs = neosu_maps.column<u32>(Col::SET_NB_DIFFS);
+    const auto filenames = neosu_maps.column<StrRef>(Col::DIFF_FILENAME);
+    const auto hashes = neosu_maps.column<MD5Hash>(Col::DIFF_MD5);
+    const uSz nb_diffs = filenames.size();
+
+    if(set_nb_diffs.size() != set_ids.size() || hashes.size() != nb_diffs ||
+       std::accumulate(set_nb_diffs.begin(), set_nb_diffs.end(), u64{0}) != nb_diffs) {
+        debugLog("inconsistent beatmapset columns ({} sets, {} diffs, {} hashes)", set_ids.size(), nb_diffs,
+                 hashes.size());
+        return false;
+    }
+
+    const OptColumn<i32> ids(neosu_maps, Col::DIFF_ID, nb_diffs, -1);
+    const OptColumn<StrRef> titles(neosu_maps, Col::DIFF_TITLE, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> audio_filenames(neosu_maps, Col::DIFF_AUDIO_FILENAME, nb_diffs, NO_STRING);
+    const OptColumn<i32> lengths(neosu_maps, Col::DIFF_LENGTH_MS, nb_diffs);
+    const OptColumn<f32> stack_leniencies(neosu_maps, Col::DIFF_STACK_LENIENCY, nb_diffs, 0.7f);
+    const OptColumn<StrRef> artists(neosu_maps, Col::DIFF_ARTIST, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> creators(neosu_maps, Col::DIFF_CREATOR, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> diff_names(neosu_maps, Col::DIFF_NAME, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> sources(neosu_maps, Col::DIFF_SOURCE, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> tags(neosu_maps, Col::DIFF_TAGS, nb_diffs, NO_STRING);
+    const OptColumn<f32> ARs(neosu_maps, Col::DIFF_AR, nb_diffs, 5.f);
+    const OptColumn<f32> CSs(neosu_maps, Col::DIFF_CS, nb_diffs, 5.f);
+    const OptColumn<f32> HPs(neosu_maps, Col::DIFF_HP, nb_diffs, 5.f);
+    const OptColumn<f32> ODs(neosu_maps, Col::DIFF_OD, nb_diffs, 5.f);
+    const OptColumn<f64> slider_multipliers(neosu_maps, Col::DIFF_SLIDER_MULTIPLIER, nb_diffs, 1.0);
+    const OptColumn<u32> preview_times(neosu_maps, Col::DIFF_PREVIEW_TIME, nb_diffs);
+    const OptColumn<i64> mtimes(neosu_maps, Col::DIFF_MTIME, nb_diffs);
+    const OptColumn<i16> local_offsets(neosu_maps, Col::DIFF_LOCAL_OFFSET, nb_diffs);
+    const OptColumn<i16> online_offsets(neosu_maps, Col::DIFF_ONLINE_OFFSET, nb_diffs);
+    const OptColumn<u16> nb_circles(neosu_maps, Col::DIFF_NB_CIRCLES, nb_diffs);
+    const OptColumn<u16> nb_sliders(neosu_maps, Col::DIFF_NB_SLIDERS, nb_diffs);
+    const OptColumn<u16> nb_spinners(neosu_maps, Col::DIFF_NB_SPINNERS, nb_diffs);
+    const OptColumn<f64> stars_nomod(neosu_maps, Col::DIFF_STARS_NOMOD, nb_diffs);
+    // -1 forces a recalculation
+    const OptColumn<i32> min_bpms(neosu_maps, Col::DIFF_MIN_BPM, nb_diffs, -1);
+    const OptColumn<i32> max_bpms(neosu_maps, Col::DIFF_MAX_BPM, nb_diffs, -1);
+    const OptColumn<i32> avg_bpms(neosu_maps, Col::DIFF_AVG_BPM, nb_diffs, -1);
+    const OptColumn<u8> draw_backgrounds(neosu_maps, Col::DIFF_DRAW_BACKGROUND, nb_diffs, 1);
+    const OptColumn<f32> loudnesses(neosu_maps, Col::DIFF_LOUDNESS, nb_diffs);
+    const OptColumn<StrRef> titles_unicode(neosu_maps, Col::DIFF_TITLE_UNICODE, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> artists_unicode(neosu_maps, Col::DIFF_ARTIST_UNICODE, nb_diffs, NO_STRING);
+    const OptColumn<StrRef> background_filenames(neosu_maps, Col::DIFF_BACKGROUND_FILENAME, nb_diffs, NO_STRING);
+    const OptColumn<u32> ppv2_versions(neosu_maps, Col::DIFF_PPV2_VERSION, nb_diffs);
+
+    // the pool is already deduplicated, so every string only has to be copied out of it once
+    // difficulties referencing the same one (usually all of a set's metadata) share that copy
+    std::vector<SharedString> shared_strings(neosu_maps.num_strings());
+    const auto shared = [&](StrRef ref) -> SharedString {
+        if(ref >= shared_strings.size()) return {};
+        SharedString &str = shared_strings[ref];
+        if(str.empty()) str = neosu_maps.string(ref);
+        return str;
+    };
+
+    uSz row = 0;
+    for(uSz i = 0; i < set_ids.size(); i++) {
+        if(this->load_interrupted.load(std::memory_order_acquire)) break;  // cancellation point
+
+        // rows are roughly evenly sized, good enough for progress
+        const f64 progress_bytes = (f64)this->bytes_processed + (f64)neosu_maps.size() * (f64)row / (f64)nb_diffs;
+        this->loading_progress = std::clamp(progress_bytes / (f64)this->total_bytes, 0.01, 0.99);
+
+        const i32 set_id = set_ids[i];
+        const uSz first_row = row;
+        row += set_nb_diffs[i];
+
+        // NOTE: Ignoring mapsets with ID -1, since we most likely saved them in the correct folder,
+        //       but mistakenly set their ID to -1 (because the ID was missing from the .osu file).
+        if(set_id == -1) {
+            logIfCV(debug_db, "skipped iSetID==-1 beatmapset with {} diffs, load idx: {}", row - first_row, i);
+            continue;
+        }
+
+        auto diffs = std::make_unique<DiffContainer>();
+        const SharedString mapset_path{fmt::format(NEOSU_MAPS_PATH "/{}/", set_id)};
+
+        for(uSz j = first_row; j < row; j++) {
+            if(this->load_interrupted.load(std::memory_order_acquire)) {  // cancellation point
+                // clean up partially loaded diffs in current set
+                Sync::unique_lock lock(this->beatmap_difficulties_mtx);
+                for(const auto &diff : *diffs) {
+                    this->beatmap_difficulties.erase(diff->getMD5());
+
+                    // remove from loudness_to_calc
+                    std::erase(this->loudness_to_calc, diff.get());
                 }
+                diffs.reset();
+                break;
             }
 
-            // star ratings section
-            if(version >= 20260202) {
-                const uSz stored_speeds = neosu_maps.read<u8>();
-                const uSz stored_combos = neosu_maps.read<u8>();
-                const u32 nb_star_entries = neosu_maps.read<u32>();
-                const uSz stored_entries = stored_speeds * stored_combos;
-                const bool layout_matches =
-                    (stored_speeds == StarPrecalc::SPEEDS_NUM && stored_combos == StarPrecalc::NUM_MOD_COMBOS);
-
-                if(layout_matches) {
-                    Sync::unique_lock lock(this->star_ratings_mtx);
-                    this->star_ratings.reserve(nb_star_entries);
-                    for(u32 i = 0; i < nb_star_entries; i++) {
-                        MD5Hash hash;
-                        (void)neosu_maps.read_hash_digest(hash);
-                        auto ratings = std::make_unique<StarPrecalc::SRArray>();
-                        (void)neosu_maps.read_bytes(reinterpret_cast<u8 *>(ratings->data()),
-                                                    sizeof(f32) * StarPrecalc::NUM_PRECALC_RATINGS);
-                        this->star_ratings.emplace(hash, std::move(ratings));
-                    }
-                } else {
-                    // layout changed; skip stored data, recalc will be triggered
-                    debugLog("star ratings layout changed (stored {}x{}, current {}x{}), skipping", stored_speeds,
-                             stored_combos, (u8)StarPrecalc::SPEEDS_NUM, (uSz)StarPrecalc::NUM_MOD_COMBOS);
-                    for(u32 i = 0; i < nb_star_entries; i++) {
-                        neosu_maps.skip_bytes(sizeof(MD5Hash) + sizeof(f32) * stored_entries);
-                    }
+            const std::string_view osu_filename = neosu_maps.string(filenames[j]);
+            std::string osu_path;
+            osu_path.reserve(mapset_path.size() + osu_filename.size());
+            osu_path.append(mapset_path.str()).append(osu_filename);
+
+            // force calculate hash if we saved with empty/0 hash
+            MD5Hash diff_hash = hashes[j];
+            if(diff_hash.empty()) {
+                diff_hash = recalcMD5(osu_path);
+            }
+
+            auto diff = std::make_unique<BeatmapDifficulty>(std::move(osu_path), mapset_path,
+                                                            DatabaseBeatmap::BeatmapType::NEOSU_DIFFICULTY);
+
+            diff->iID = ids[j];
+            diff->iSetID = set_id;
+            diff->sTitle = shared(titles[j]);
+            diff->sAudioFileName = shared(audio_filenames[j]);
+            diff->iLengthMS = lengths[j];
+            diff->fStackLeniency = stack_leniencies[j];
+            diff->sArtist = shared(artists[j]);
+            diff->sCreator = shared(creators[j]);
+            diff->sDifficultyName = neosu_maps.string(diff_names[j]);
+            diff->sSource = shared(sources[j]);
+            diff->sTags = shared(tags[j]);
+            diff->writeMD5(diff_hash);
+            diff->fAR = ARs[j];
+            diff->fCS = CSs[j];
+            diff->fHP = HPs[j];
+            diff->fOD = ODs[j];
+            diff->fSliderMultiplier = slider_multipliers[j];
+            diff->iPreviewTime = preview_times[j];
+            diff->last_modification_time = mtimes[j];
+            diff->iLocalOffset = local_offsets[j];
+            diff->iOnlineOffset = online_offsets[j];
+            diff->iNumCircles = nb_circles[j];
+            diff->iNumSliders = nb_sliders[j];
+            diff->iNumSpinners = nb_spinners[j];
+            diff->fStarsNomod = stars_nomod[j];
+
+            diff->iMinBPM = min_bpms[j];
+            diff->iMaxBPM = max_bpms[j];
+            diff->iMostCommonBPM = avg_bpms[j];
+
+            diff->draw_background = draw_backgrounds[j];
+
+            if(const f32 loudness = loudnesses[j]; loudness == 0.f) {
+                this->loudness_to_calc.push_back(diff.get());
+            } else {
+                diff->loudness = loudness;
+            }
+
+            diff->sTitleUnicode = titles_unicode.has_values() ? shared(titles_unicode[j]) : diff->sTitle;
+            diff->sArtistUnicode = artists_unicode.has_values() ? shared(artists_unicode[j]) : diff->sArtist;
+
+            diff->bEmptyTitleUnicode = SString::is_wspace_only(diff->sTitleUnicode);
+            diff->bEmptyArtistUnicode = SString::is_wspace_only(diff->sArtistUnicode);
+
+            diff->sBackgroundImageFileName = shared(background_filenames[j]);
+
+            diff->ppv2Version = ppv2_versions[j];
+
+            {
+                Sync::unique_lock lock(this->beatmap_difficulties_mtx);
+                this->beatmap_difficulties[diff_hash] = diff.get();
+            }
+            diffs->push_back(std::move(diff));
+            nb_neosu_maps++;
+        }
+
+        if(diffs && !diffs->empty()) {
+            auto set = std::make_unique<BeatmapSet>(std::move(diffs), DatabaseBeatmap::BeatmapType::NEOSU_BEATMAPSET);
+            this->temp_loading_beatmapsets.push_back(std::move(set));
+        }
+    }
+
+    // overrides for osu!stable maps
+    {
+        const auto override_hashes = neosu_maps.column<MD5Hash>(Col::OVERRIDE_MD5);
+        const uSz nb_rows = override_hashes.size();
+
+        const OptColumn<i16> local_offsets(neosu_maps, Col::OVERRIDE_LOCAL_OFFSET, nb_rows);
+        const OptColumn<i16> online_offsets(neosu_maps, Col::OVERRIDE_ONLINE_OFFSET, nb_rows);
+        const OptColumn<f32> star_ratings(neosu_maps, Col::OVERRIDE_STAR_RATING, nb_rows);
+        const OptColumn<f32> loudnesses(neosu_maps, Col::OVERRIDE_LOUDNESS, nb_rows);
+        // -1 = to be re-calculated when importing the map from peppy db
+        const OptColumn<i32> min_bpms(neosu_maps, Col::OVERRIDE_MIN_BPM, nb_rows, -1);
+        const OptColumn<i32> max_bpms(neosu_maps, Col::OVERRIDE_MAX_BPM, nb_rows, -1);
+        const OptColumn<i32> avg_bpms(neosu_maps, Col::OVERRIDE_AVG_BPM, nb_rows, -1);
+        const OptColumn<u8> draw_backgrounds(neosu_maps, Col::OVERRIDE_DRAW_BACKGROUND, nb_rows, 1);
+        const OptColumn<StrRef> background_filenames(neosu_maps, Col::OVERRIDE_BACKGROUND_FILENAME, nb_rows, NO_STRING);
+        const OptColumn<u32> ppv2_versions(neosu_maps, Col::OVERRIDE_PPV2_VERSION, nb_rows);
+
+        Sync::unique_lock lock(this->peppy_overrides_mtx);
+        this->peppy_overrides.reserve(this->peppy_overrides.size() + nb_rows);
+        for(uSz i = 0; i < nb_rows; i++) {
+            MapOverrides over;
+            over.local_offset = local_offsets[i];
+            over.online_offset = online_offsets[i];
+            over.star_rating = star_ratings[i];
+            over.loudness = loudnesses[i];
+            over.min_bpm = min_bpms[i];
+            over.max_bpm = max_bpms[i];
+            over.avg_bpm = avg_bpms[i];
+            over.draw_background = draw_backgrounds[i];
+            over.background_image_filename = neosu_maps.string(background_filenames[i]);
+            over.ppv2_version = ppv2_versions[i];
+            this->peppy_overrides[override_hashes[i]] = std::move(over);
+        }
+        nb_overrides = nb_rows;
+    }
+
+    // star ratings, the column width changes along with the layout
+    {
+        const auto star_hashes = neosu_maps.column<MD5Hash>(Col::STARS_MD5);
+        const auto ratings = neosu_maps.column<StarPrecalc::SRArray>(Col::STARS_RATINGS);
+        if(ratings.size() == star_hashes.size()) {
+            Sync::unique_lock lock(this->star_ratings_mtx);
+            this->star_ratings.reserve(this->star_ratings.size() + star_hashes.size());
+            for(uSz i = 0; i < star_hashes.size(); i++) {
+                this->star_ratings.emplace(star_hashes[i], std::make_unique<StarPrecalc::SRArray>(ratings[i]));
+            }
+        } else {
+            // recalc will be triggered
+            debugLog("star ratings layout changed, skipping {} entries", star_hashes.size());
+        }
+    }
+
+    return true;
+}
+
+void Database::loadMaps() {
+    const auto &peppy_db_path = this->database_files[DatabaseType::STABLE_MAPS];
+    const auto &neosu_maps_path = this->database_files[DatabaseType::NEOSU_MAPS];
+
+    const std::string &songFolder = Database::getOsuSongsFolder();
+    debugLog("Database: songFolder = {:s}", songFolder);
+
+    this->importTimer->start();
+
+    u32 nb_neosu_maps = 0;
+    u32 nb_peppy_maps = 0;
+    u32 nb_overrides = 0;
+
+    // Load neosu map database
+    {
+        MapsDB::Reader neosu_maps(neosu_maps_path);
+        if(neosu_maps.exists()) {
+            bool loaded = true;
+            if(neosu_maps.version() <= NEOSU_MAPS_DB_LAST_STREAMED_VERSION) {
+                // one-time migration, saveMaps() only writes the columnar format
+                this->loadStreamedNeosuMaps(neosu_maps_path, nb_neosu_maps, nb_overrides);
+            } else if(!neosu_maps.good()) {
+                debugLog("Failed to load {}: {}", neosu_maps_path, neosu_maps.error());
+                loaded = false;
+            } else {
+                loaded = this->loadColumnarNeosuMaps(neosu_maps, nb_neosu_maps, nb_overrides);
+            }
+
+            if(!loaded) {
+                // it would get overwritten on the next save
+                auto backup_path = fmt::format("{}.{}-{:%F}.broken", neosu_maps_path, neosu_maps.version(),
+                                               fmt::gmtime(std::time(nullptr)));
+                if(File::copy(neosu_maps_path, backup_path)) {
+                    debugLog("backed up unreadable {} -> {}", neosu_maps_path, backup_path);
                 }
             }
+
+            this->bytes_processed += neosu_maps.size();
         }
-        this->bytes_processed += neosu_maps.total_size;
         this->neosu_maps_loaded = true;
     }
 
@@ -1408,6 +2048,9 @@ void Database::loadMaps() {
             std::vector<BPMTuple> bpm_calculation_buffer;
             std::vector<DB_TIMINGPOINT> timing_points_buffer;
 
+            // difficulties of the same set share their metadata
+            SharedStringPool shared_strings;
+
             for(uSz i = 0; i < this->num_beatmaps_to_load; i++) {
                 if(this->load_interrupted.load(std::memory_order_acquire)) break;  // cancellation point
 
@@ -1630,28 +2273,28 @@ void Database::loadMaps() {
                 BeatmapDifficulty *diffp = nullptr;
                 {
                     // fill diff with data
-                    auto map = std::make_unique<BeatmapDifficulty>(fullFilePath, beatmapPath,
+                    auto map = std::make_unique<BeatmapDifficulty>(fullFilePath, shared_strings.intern(beatmapPath),
                                                                    DatabaseBeatmap::BeatmapType::PEPPY_DIFFICULTY);
 
-                    map->sTitle = std::move(songTitle);
-                    map->sTitleUnicode = std::move(songTitleUnicode);
+                    map->sTitle = shared_strings.intern(songTitle);
+                    map->sTitleUnicode = shared_strings.intern(songTitleUnicode);
                     if(SString::is_wspace_only(map->sTitleUnicode)) {
                         map->bEmptyTitleUnicode = true;
                     }
-                    map->sAudioFileName = std::move(audioFileName);
+                    map->sAudioFileName = shared_strings.intern(audioFileName);
                     map->iLengthMS = duration;
 
                     map->fStackLeniency = stackLeniency;
 
-                    map->sArtist = std::move(artistName);
-                    map->sArtistUnicode = std::move(artistNameUnicode);
+                    map->sArtist = shared_strings.intern(artistName);
+                    map->sArtistUnicode = shared_strings.intern(artistNameUnicode);
                     if(SString::is_wspace_only(map->sArtistUnicode)) {
                         map->bEmptyArtistUnicode = true;
                     }
-                    map->sCreator = std::move(creatorName);
+                    map->sCreator = shared_strings.intern(creatorName);
                     map->sDifficultyName = std::move(difficultyName);
-                    map->sSource = std::move(songSource);
-                    map->sTags = std::move(songTags);
+                    map->sSource = shared_strings.intern(songSource);
+                    map->sTags = shared_strings.intern(songTags);
                     map->writeMD5(md5hash);
                     map->iID = beatmapID;
                     map->iSetID = beatmapSetID;
@@ -1790,6 +2433,27 @@ void Database::loadMaps() {
         }
         this->bytes_processed += dbr.total_size;
     }
+
+    // only on startup, reloads keep the index up to date by themselves
+    if(this->search_index.size() == 0) {
+        Timer t;
+        t.start();
+        if(this->search_index.load(NEOSU_SEARCH_INDEX_PATH)) {
+            t.update();
+            debugLog("Loaded search index ({} entries) in {:f} seconds.", this->search_index.size(),
+                     t.getElapsedTime());
+        }
+    }
+
+    // diffs from the databases never went through loadMetadata(), which builds these for raw loaded ones
+    // (a no-op for the search index if it already has them with the same blob)
+    for(const auto &set : this->temp_loading_beatmapsets) {
+        for(const auto &diff : set->getDifficulties()) {
+            diff->rebuildSearchBlob();
+            this->search_index.add(diff.get());
+        }
+    }
+
     this->beatmapsets = std::move(this->temp_loading_beatmapsets);
     this->temp_loading_beatmapsets.clear();
 
@@ -1826,12 +2490,6 @@ void Database::saveMaps() {
 
     const auto neosu_maps_db = getDBPath(DatabaseType::NEOSU_MAPS);
 
-    ByteBufferedFile::Writer maps(neosu_maps_db);
-    if(!maps.good()) {
-        debugLog("Cannot save maps to {}: {}", neosu_maps_db, maps.error());
-        return;
-    }
-
     // collect neosu-only sets here
     std::vector<BeatmapSet *> temp_neosu_sets;
     Hash::flat::set<std::string> folders_already_added;
@@ -1847,50 +2505,50 @@ void Database::saveMaps() {
         }
     }
 
-    maps.write<u32>(NEOSU_MAPS_DB_VERSION);
+    using MapsDB::Col;
+    MapsDB::Writer maps;
 
     // Save neosu-downloaded maps
     u32 nb_diffs_saved = 0;
-    maps.write<u32>(temp_neosu_sets.size());
     for(BeatmapSet *beatmap : temp_neosu_sets) {
-        maps.write<i32>(beatmap->getSetID());
-        maps.write<u16>(beatmap->getDifficulties().size());
+        maps.push<i32>(Col::SET_ID, beatmap->getSetID());
+        maps.push<u32>(Col::SET_NB_DIFFS, beatmap->getDifficulties().size());
 
         for(const auto &diff : beatmap->getDifficulties()) {
-            maps.write_string(env->getFileNameFromFilePath(diff->sFilePath));
-            maps.write<i32>(diff->iID);
-            maps.write_string(diff->sTitle);
-            maps.write_string(diff->sAudioFileName);
-            maps.write<i32>(diff->iLengthMS);
-            maps.write<f32>(diff->fStackLeniency);
-            maps.write_string(diff->sArtist);
-            maps.write_string(diff->sCreator);
-            maps.write_string(diff->sDifficultyName);
-            maps.write_string(diff->sSource);
-            maps.write_string(diff->sTags);
-            maps.write_hash_digest(diff->getMD5());
-            maps.write<f32>(diff->fAR);
-            maps.write<f32>(diff->fCS);
-            maps.write<f32>(diff->fHP);
-            maps.write<f32>(diff->fOD);
-            maps.write<f64>(diff->fSliderMultiplier);
-            maps.write<u32>(diff->iPreviewTime);
-            maps.write<i64>(diff->last_modification_time);
-            maps.write<i16>(diff->iLocalOffset);
-            maps.write<i16>(diff->iOnlineOffset);
-            maps.write<u16>(diff->iNumCircles);
-            maps.write<u16>(diff->iNumSliders);
-            maps.write<u16>(diff->iNumSpinners);
-            maps.write<f64>(diff->fStarsNomod);
-            maps.write<i32>(diff->iMinBPM);
-            maps.write<i32>(diff->iMaxBPM);
-            maps.write<i32>(diff->iMostCommonBPM);
-            maps.write<u8>(diff->draw_background);
-            maps.write<f32>(diff->loudness.load(std::memory_order_acquire));
-            maps.write_string(diff->sTitleUnicode);
-            maps.write_string(diff->sArtistUnicode);
-            maps.write_string(diff->sBackgroundImageFileName);
-            maps.write<u32>(diff->ppv2Version);
+            maps.push_string(Col::DIFF_FILENAME, env->getFileNameFromFilePath(diff->sFilePath));
+            maps.push<i32>(Col::DIFF_ID, diff->iID);
+            maps.push_string(Col::DIFF_TITLE, diff->sTitle);
+            maps.push_string(Col::DIFF_AUDIO_FILENAME, diff->sAudioFileName);
+            maps.push<i32>(Col::DIFF_LENGTH_MS, diff->iLengthMS);
+            maps.push<f32>(Col::DIFF_STACK_LENIENCY, diff->fStackLeniency);
+            maps.push_string(Col::DIFF_ARTIST, diff->sArtist);
+            maps.push_string(Col::DIFF_CREATOR, diff->sCreator);
+            maps.push_string(Col::DIFF_NAME, diff->sDifficultyName);
+            maps.push_string(Col::DIFF_SOURCE, diff->sSource);
+            maps.push_string(Col::DIFF_TAGS, diff->sTags);
+            maps.push<MD5Hash>(Col::DIFF_MD5, diff->getMD5());
+            maps.push<f32>(Col::DIFF_AR, diff->fAR);
+            maps.push<f32>(Col::DIFF_CS, diff->fCS);
+            maps.push<f32>(Col::DIFF_HP, diff->fHP);
+            maps.push<f32>(Col::DIFF_OD, diff->fOD);
+            maps.push<f64>(Col::DIFF_SLIDER_MULTIPLIER, diff->fSliderMultiplier);
+            maps.push<u32>(Col::DIFF_PREVIEW_TIME, diff->iPreviewTime);
+            maps.push<i64>(Col::DIFF_MTIME, diff->last_modification_time);
+            maps.push<i16>(Col::DIFF_LOCAL_OFFSET, diff->iLocalOffset);
+            maps.push<i16>(Col::DIFF_ONLINE_OFFSET, diff->iOnlineOffset);
+            maps.push<u16>(Col::DIFF_NB_CIRCLES, diff->iNumCircles);
+            maps.push<u16>(Col::DIFF_NB_SLIDERS, diff->iNumSliders);
+            maps.push<u16>(Col::DIFF_NB_SPINNERS, diff->iNumSpinners);
+            maps.push<f64>(Col::DIFF_STARS_NOMOD, diff->fStarsNomod);
+            maps.push<i32>(Col::DIFF_MIN_BPM, diff->iMinBPM);
+            maps.push<i32>(Col::DIFF_MAX_BPM, diff->iMaxBPM);
+            maps.push<i32>(Col::DIFF_AVG_BPM, diff->iMostCommonBPM);
+            maps.push<u8>(Col::DIFF_DRAW_BACKGROUND, diff->draw_background);
+            maps.push<f32>(Col::DIFF_LOUDNESS, diff->loudness.load(std::memory_order_acquire));
+            maps.push_string(Col::DIFF_TITLE_UNICODE, diff->sTitleUnicode);
+            maps.push_string(Col::DIFF_ARTIST_UNICODE, diff->sArtistUnicode);
+            maps.push_string(Col::DIFF_BACKGROUND_FILENAME, diff->sBackgroundImageFileName);
+            maps.push<u32>(Col::DIFF_PPV2_VERSION, diff->ppv2Version);
 
             nb_diffs_saved++;
         }
@@ -1922,44 +2580,62 @@ void Database::saveMaps() {
         }
     }
 
-    maps.write<u32>(real_overrides.size());
     for(const auto &[hash, override_] : real_overrides) {
-        maps.write_hash_digest(hash);
-        maps.write<i16>(override_.local_offset);
-        maps.write<i16>(override_.online_offset);
-        maps.write<f32>(override_.star_rating);
-        maps.write<f32>(override_.loudness);
-        maps.write<i32>(override_.min_bpm);
-        maps.write<i32>(override_.max_bpm);
-        maps.write<i32>(override_.avg_bpm);
-        maps.write<u8>(override_.draw_background);
-        maps.write_string(override_.background_image_filename);
-        maps.write<u32>(override_.ppv2_version);
+        maps.push<MD5Hash>(Col::OVERRIDE_MD5, hash);
+        maps.push<i16>(Col::OVERRIDE_LOCAL_OFFSET, override_.local_offset);
+        maps.push<i16>(Col::OVERRIDE_ONLINE_OFFSET, override_.online_offset);
+        maps.push<f32>(Col::OVERRIDE_STAR_RATING, override_.star_rating);
+        maps.push<f32>(Col::OVERRIDE_LOUDNESS, override_.loudness);
+        maps.push<i32>(Col::OVERRIDE_MIN_BPM, override_.min_bpm);
+        maps.push<i32>(Col::OVERRIDE_MAX_BPM, override_.max_bpm);
+        maps.push<i32>(Col::OVERRIDE_AVG_BPM, override_.avg_bpm);
+        maps.push<u8>(Col::OVERRIDE_DRAW_BACKGROUND, override_.draw_background);
+        maps.push_string(Col::OVERRIDE_BACKGROUND_FILENAME, override_.background_image_filename);
+        maps.push<u32>(Col::OVERRIDE_PPV2_VERSION, override_.ppv2_version);
 
         nb_overrides++;
     }
 
-    // star ratings section
-    // header: num_speeds, num_combos so we can detect layout changes without bumping db version
+    // star ratings section, layout changes are detected through the column width
     u32 nb_star_entries = 0;
     {
         Sync::shared_lock lock(this->star_ratings_mtx);
-        maps.write<u8>(StarPrecalc::SPEEDS_NUM);
-        maps.write<u8>(StarPrecalc::NUM_MOD_COMBOS);
-        maps.write<u32>(this->star_ratings.size());
         for(const auto &[hash, ratings] : this->star_ratings) {
-            maps.write_hash_digest(hash);
-            maps.write_bytes(reinterpret_cast<const u8 *>(ratings->data()),
-                             sizeof(f32) * StarPrecalc::NUM_PRECALC_RATINGS);
+            maps.push<MD5Hash>(Col::STARS_MD5, hash);
+            maps.push<StarPrecalc::SRArray>(Col::STARS_RATINGS, *ratings);
             nb_star_entries++;
         }
     }
 
+    if(!maps.save(neosu_maps_db, NEOSU_MAPS_DB_VERSION)) {
+        debugLog("Cannot save maps to {}", neosu_maps_db);
+        return;
+    }
+
     t.update();
     debugLog("Saved {:d} maps (+ {:d} overrides, {:d} star ratings) in {:f} seconds.", nb_diffs_saved, nb_overrides,
              nb_star_entries, t.getElapsedTime());
 }
 
+void Database::saveSearchIndex() {
+    if(this->beatmapsets.empty() || this->isLoading() || this->isCancelled()) {
+        return;
+    }
+
+    Timer t;
+    t.start();
+
+    if(this->search_index.save(NEOSU_SEARCH_INDEX_PATH)) {
+        t.update();
+        debugLog("Saved search index ({} entries) in {:f} seconds.", this->search_index.size(), t.getElapsedTime());
+    }
+}
+
+void Database::pruneSearchIndex() {
+    Sync::shared_lock lock(this->beatmap_difficulties_mtx);
+    this->search_index.retain([this](const MD5Hash &hash) { return this->beatmap_difficulties.contains(hash); });
+}
+
 void Database::findDatabases() {
     this->bytes_processed = 0;
     this->total_bytes = 0;
@@ -2048,6 +2724,94 @@ bool Database::importDatabase(const std::pair<DatabaseType, std::string> &db_pai
     std::unreachable();
 }
 
+namespace {  // static namespace
+
+// neosu_scores.db score layout (without the beatmap hash, which is stored once per beatmap), also used by the journal
+
+void read_string(ByteBufferedFile::Reader &reader, std::string &out) { reader.read_string(out); }
+void read_string(Packet &packet, std::string &out) { out = packet.read_stdstring(); }
+
+template <typename R>
+void read_score(R &reader, FinishedScore &sc) {
+    sc.mods = Replay::Mods::unpack(reader);
+    sc.score = reader.template read<u64>();
+    sc.spinner_bonus = reader.template read<u64>();
+    sc.unixTimestamp = reader.template read<u64>();
+    sc.player_id = reader.template read<i32>();
+    read_string(reader, sc.playerName);
+    sc.grade = (ScoreGrade)reader.template read<u8>();
+
+    read_string(reader, sc.client);
+    read_string(reader, sc.server);
+    sc.bancho_score_id = reader.template read<i64>();
+    sc.peppy_replay_tms = reader.template read<u64>();
+
+    sc.num300s = reader.template read<u16>();
+    sc.num100s = reader.template read<u16>();
+    sc.num50s = reader.template read<u16>();
+    sc.numGekis = reader.template read<u16>();
+    sc.numKatus = reader.template read<u16>();
+    sc.numMisses = reader.template read<u16>();
+    sc.comboMax = reader.template read<u16>();
+
+    sc.ppv2_version = reader.template read<u32>();
+    sc.ppv2_score = reader.template read<f32>();
+    sc.ppv2_total_stars = reader.template read<f32>();
+    sc.ppv2_aim_stars = reader.template read<f32>();
+    sc.ppv2_speed_stars = reader.template read<f32>();
+
+    sc.numSliderBreaks = reader.template read<u16>();
+    sc.unstableRate = reader.template read<f32>();
+    sc.hitErrorAvgMin = reader.template read<f32>();
+    sc.hitErrorAvgMax = reader.template read<f32>();
+    sc.maxPossibleCombo = reader.template read<u32>();
+    sc.numHitObjects = reader.template read<u32>();
+    sc.numCircles = reader.template read<u32>();
+}
+
+template <typename W>
+void write_score(W &writer, const FinishedScore &score) {
+    Replay::Mods::pack_and_write(writer, score.mods);
+    writer.template write<u64>(score.score);
+    writer.template write<u64>(score.spinner_bonus);
+    writer.template write<u64>(score.unixTimestamp);
+    writer.template write<i32>(score.player_id);
+    writer.write_string(score.playerName);
+    writer.template write<u8>((u8)score.grade);
+
+    writer.write_string(score.client);
+    writer.write_string(score.server);
+    writer.template write<i64>(score.bancho_score_id);
+    writer.template write<u64>(score.peppy_replay_tms);
+
+    writer.template write<u16>(score.num300s);
+    writer.template write<u16>(score.num100s);
+    writer.template write<u16>(score.num50s);
+    writer.template write<u16>(score.numGekis);
+    writer.template write<u16>(score.numKatus);
+    writer.template write<u16>(score.numMisses);
+    writer.template write<u16>(score.comboMax);
+
+    writer.template write<u32>(score.ppv2_version);
+    writer.template write<f32>(score.ppv2_score);
+    writer.template write<f32>(score.ppv2_total_stars);
+    writer.template write<f32>(score.ppv2_aim_stars);
+    writer.template write<f32>(score.ppv2_speed_stars);
+
+    writer.template write<u16>(score.numSliderBreaks);
+    writer.template write<f32>(score.unstableRate);
+    writer.template write<f32>(score.hitErrorAvgMin);
+    writer.template write<f32>(score.hitErrorAvgMax);
+    writer.template write<u32>(score.maxPossibleCombo);
+    writer.template write<u32>(score.numHitObjects);
+    writer.template write<u32>(score.numCircles);
+}
+
+// past this, the next saved play rewrites neosu_scores.db in full and empties the journal
+constexpr u32 SCORES_JOURNAL_MAX_RECORDS = 256;
+
+}  // namespace
+
 void Database::loadScores(std::string_view dbPath) {
     ByteBufferedFile::Reader dbr(dbPath);
     if(dbr.total_size == 0) {
@@ -2089,41 +2853,7 @@ void Database::loadScores(std::string_view dbPath) {
 
         for(u32 s = 0; s < nb_beatmap_scores; s++) {
             FinishedScore sc;
-
-            sc.mods = Replay::Mods::unpack(dbr);
-            sc.score = dbr.read<u64>();
-            sc.spinner_bonus = dbr.read<u64>();
-            sc.unixTimestamp = dbr.read<u64>();
-            sc.player_id = dbr.read<i32>();
-            dbr.read_string(sc.playerName);
-            sc.grade = (ScoreGrade)dbr.read<u8>();
-
-            dbr.read_string(sc.client);
-            dbr.read_string(sc.server);
-            sc.bancho_score_id = dbr.read<i64>();
-            sc.peppy_replay_tms = dbr.read<u64>();
-
-            sc.num300s = dbr.read<u16>();
-            sc.num100s = dbr.read<u16>();
-            sc.num50s = dbr.read<u16>();
-            sc.numGekis = dbr.read<u16>();
-            sc.numKatus = dbr.read<u16>();
-            sc.numMisses = dbr.read<u16>();
-            sc.comboMax = dbr.read<u16>();
-
-            sc.ppv2_version = dbr.read<u32>();
-            sc.ppv2_score = dbr.read<f32>();
-            sc.ppv2_total_stars = dbr.read<f32>();
-            sc.ppv2_aim_stars = dbr.read<f32>();
-            sc.ppv2_speed_stars = dbr.read<f32>();
-
-            sc.numSliderBreaks = dbr.read<u16>();
-            sc.unstableRate = dbr.read<f32>();
-            sc.hitErrorAvgMin = dbr.read<f32>();
-            sc.hitErrorAvgMax = dbr.read<f32>();
-            sc.maxPossibleCombo = dbr.read<u32>();
-            sc.numHitObjects = dbr.read<u32>();
-            sc.numCircles = dbr.read<u32>();
+            read_score(dbr, sc);
 
             sc.beatmap_hash = beatmap_hash;
 
@@ -2144,6 +2874,82 @@ void Database::loadScores(std::string_view dbPath) {
     this->bytes_processed += dbr.total_size;
 }
 
+void Database::replayScoresJournal() {
+    const std::vector<ScoresJournal::Record> records = this->scores_journal.load();
+    if(records.empty()) return;
+
+    u32 nb_added = 0;
+    u32 nb_deleted = 0;
+
+    Sync::unique_lock lock(this->scores_mtx);
+    for(const auto &record : records) {
+        // the payload is only read from
+        Packet payload{.memory = const_cast<u8 *>(record.payload.data()), .size = record.payload.size()};
+        const MD5Hash beatmap_hash = payload.read_hash_digest();
+
+        switch(record.type) {
+            case ScoresJournal::RecordType::SCORE_ADDED: {
+                FinishedScore sc;
+                read_score(payload, sc);
+                sc.beatmap_hash = beatmap_hash;
+                if(payload.pos > payload.size) break;
+
+                // records can already be part of neosu_scores.db, if we crashed before emptying the journal
+                auto &scorevec = this->scores[beatmap_hash];
+                const auto existing = std::ranges::find_if(scorevec, [&](const FinishedScore &other) {
+                    return other.unixTimestamp == sc.unixTimestamp && other.playerName == sc.playerName;
+                });
+                if(existing != scorevec.end()) {
+                    *existing = std::move(sc);
+                } else {
+                    scorevec.push_back(std::move(sc));
+                }
+                nb_added++;
+                break;
+            }
+            case ScoresJournal::RecordType::SCORE_DELETED: {
+                const u64 timestamp = payload.read<u64>();
+                const std::string player_name = payload.read_stdstring();
+                if(payload.pos > payload.size) break;
+
+                if(const auto &it = this->scores.find(beatmap_hash); it != this->scores.end()) {
+                    std::erase_if(it->second, [&](const FinishedScore &score) {
+                        return score.unixTimestamp == timestamp && score.playerName == player_name;
+                    });
+                }
+                nb_deleted++;
+                break;
+            }
+        }
+    }
+
+    debugLog("Replayed {:d} score journal records ({:d} added, {:d} deleted)", records.size(), nb_added, nb_deleted);
+}
+
+bool Database::journalScoreChange(ScoresJournal::RecordType type, const FinishedScore &score) {
+    if(!this->scores_loaded) return true;
+
+    Packet payload;
+    payload.write_hash_digest(score.beatmap_hash);
+    if(type == ScoresJournal::RecordType::SCORE_ADDED) {
+        write_score(payload, score);
+    } else {
+        payload.write<u64>(score.unixTimestamp);
+        payload.write_string(score.playerName);
+    }
+
+    bool appended = false;
+    u32 nb_records = 0;
+    {
+        Sync::scoped_lock lock(this->scores_save_mtx);
+        appended = this->scores_journal.append(type, {payload.memory, payload.pos});
+        nb_records = this->scores_journal.getNumRecords();
+    }
+    free(payload.memory);
+
+    return appended && nb_records < SCORES_JOURNAL_MAX_RECORDS;
+}
+
 // import scores from mcosu, or old neosu (before we started saving replays)
 void Database::loadOldMcNeosuScores(std::string_view dbPath) {
     ByteBufferedFile::Reader dbr(dbPath);
@@ -2538,18 +3344,31 @@ void Database::saveScores() {
 
     const auto neosu_scores_db = getDBPath(DatabaseType::NEOSU_SCORES);
 
-    ByteBufferedFile::Writer dbr(neosu_scores_db);
+    // no journal appends until the journal is emptied, their scores might not be part of what's being written
+    Sync::scoped_lock save_lock(this->scores_save_mtx);
+
+    u32 nb_scores = 0;
+    if(!this->writeScoresDB(neosu_scores_db, nb_scores)) return;
+
+    // everything in the journal is part of neosu_scores.db now
+    this->scores_journal.clear();
+
+    debugLog("Saved {:d} scores in {:f} seconds.", nb_scores, (Timing::getTimeReal() - startTime));
+}
+
+bool Database::writeScoresDB(std::string_view path, u32 &nb_scores) {
+    ByteBufferedFile::Writer dbr(path);
 
     if(!dbr.good()) {
-        debugLog("Cannot save scores to {}: {}", neosu_scores_db, dbr.error());
-        return;
+        debugLog("Cannot save scores to {}: {}", path, dbr.error());
+        return false;
     }
 
     dbr.write_bytes((u8 *)"NEOSC", 5);
     dbr.write<u32>(NEOSU_SCORE_DB_VERSION);
 
     u32 nb_beatmaps = 0;
-    u32 nb_scores = 0;
+    nb_scores = 0;
 
     Sync::shared_lock lock(this->scores_mtx);  // only need read lock here
     for(const auto &[_, scorevec] : this->scores) {
@@ -2578,44 +3397,40 @@ void Database::saveScores() {
                 break;
             }
 
-            Replay::Mods::pack_and_write(dbr, score.mods);
-            dbr.write<u64>(score.score);
-            dbr.write<u64>(score.spinner_bonus);
-            dbr.write<u64>(score.unixTimestamp);
-            dbr.write<i32>(score.player_id);
-            dbr.write_string(score.playerName);
-            dbr.write<u8>((u8)score.grade);
-
-            dbr.write_string(score.client);
-            dbr.write_string(score.server);
-            dbr.write<i64>(score.bancho_score_id);
-            dbr.write<u64>(score.peppy_replay_tms);
-
-            dbr.write<u16>(score.num300s);
-            dbr.write<u16>(score.num100s);
-            dbr.write<u16>(score.num50s);
-            dbr.write<u16>(score.numGekis);
-            dbr.write<u16>(score.numKatus);
-            dbr.write<u16>(score.numMisses);
-            dbr.write<u16>(score.comboMax);
-
-            dbr.write<u32>(score.ppv2_version);
-            dbr.write<f32>(score.ppv2_score);
-            dbr.write<f32>(score.ppv2_total_stars);
-            dbr.write<f32>(score.ppv2_aim_stars);
-            dbr.write<f32>(score.ppv2_speed_stars);
-
-            dbr.write<u16>(score.numSliderBreaks);
-            dbr.write<f32>(score.unstableRate);
-            dbr.write<f32>(score.hitErrorAvgMin);
-            dbr.write<f32>(score.hitErrorAvgMax);
-            dbr.write<u32>(score.maxPossibleCombo);
-            dbr.write<u32>(score.numHitObjects);
-            dbr.write<u32>(score.numCircles);
+            write_score(dbr, score);
         }
     }
 
-    debugLog("Saved {:d} scores in {:f} seconds.", nb_scores, (Timing::getTimeReal() - startTime));
+    // the journal gets emptied after this, so the new file and its rename over the old one have to be on disk first
+    if(!dbr.commit(true)) {
+        debugLog("Failed to save scores to {}: {}", path, dbr.error());
+        return false;
+    }
+    return true;
+}
+
+Database::RawFolderStamp Database::getRawFolderStamp(const std::string &folderPath) {
+    RawFolderStamp stamp;
+
+    struct stat64 st{};
+    std::string dirPath{folderPath};
+    while(dirPath.ends_with('/') || dirPath.ends_with('\\')) dirPath.pop_back();
+    if(File::stat_c(dirPath.c_str(), &st) == 0) {
+        stamp.mtime = st.st_mtime;
+    }
+
+    // the folder's own mtime only changes when entries are added/removed/renamed, not when a file is edited in-place
+    for(const auto &file : Environment::getFilesInFolder(folderPath)) {
+        if(Environment::getFileExtensionFromFilePath(file) != "osu") continue;
+
+        const std::string filePath = folderPath + file;
+        if(File::stat_c(filePath.c_str(), &st) != 0) continue;
+
+        stamp.mtime = std::max<i64>(stamp.mtime, st.st_mtime);
+        stamp.size += st.st_size;
+    }
+
+    return stamp;
 }
 
 std::unique_ptr<BeatmapSet> Database::loadRawBeatmap(const std::string &beatmapPath, bool is_peppy) {
@@ -7,11 +7,15 @@
 #include "UString.h"
 #include "score.h"
 #include "SyncMutex.h"
+#include "BeatmapSearchIndex.h"
 
 #include "Hashing.h"
 #include "DiffCalc/StarPrecalc.h"
+#include "ScoresJournal.h"
+#include "PlayerStatsIndex.h"
 
 #include <atomic>
+#include <optional>
 #include <set>
 
 namespace Timing {
@@ -31,6 +35,10 @@ namespace BatchDiffCalc {
 struct internal;
 }
 
+namespace MapsDB {
+class Reader;
+}
+
 class ScoreButton;
 class ConVar;
 
@@ -38,7 +46,9 @@ class DatabaseBeatmap;
 using BeatmapDifficulty = DatabaseBeatmap;
 using BeatmapSet = DatabaseBeatmap;
 
-#define NEOSU_MAPS_DB_VERSION 20260202
+// columnar since 20261017 (see MapsDatabaseFile.h), older versions are migrated on load
+#define NEOSU_MAPS_DB_VERSION 20261017
+#define NEOSU_MAPS_DB_LAST_STREAMED_VERSION 20260202
 #define NEOSU_SCORE_DB_VERSION 20240725
 
 class Database;
@@ -130,6 +140,26 @@ class Database final {
     BeatmapSet *addBeatmapSet(const std::string &beatmapFolderPath, i32 set_id_override = -1,
                               bool is_peppy = false);
 
+    // drops a loaded set and its difficulties (from the song browser as well), mapset is deleted afterwards
+    void removeBeatmapSet(BeatmapSet *mapset);
+
+    // swaps a loaded set for a newly loaded version of it (e.g. after its files changed on disk)
+    // the selected difficulty stays selected if it's still there, returns the new set (nullptr if it couldn't be added)
+    BeatmapSet *replaceBeatmapSet(BeatmapSet *old_mapset, std::unique_ptr<BeatmapSet> new_mapset);
+
+    struct RawFolderChanges {
+        u32 added{0};
+        u32 modified{0};
+        u32 removed{0};
+
+        [[nodiscard]] inline bool empty() const { return this->added + this->modified + this->removed == 0; }
+    };
+
+    // checks the beatmap folders containing changed_paths (folder names, or any path inside the raw songs folder,
+    // e.g. from DirectoryWatcher events) against what the last raw load saw
+    // new folders are imported, modified ones are re-parsed and replace their old set, removed ones are dropped
+    RawFolderChanges rescanRawFolders(const std::vector<std::string> &changed_paths);
+
     // returns true if adding succeeded
     bool addScore(const FinishedScore &score);
     void deleteScore(const FinishedScore &scoreToDelete);
@@ -150,6 +180,8 @@ class Database final {
     }
     [[nodiscard]] inline bool isFinished() const { return (this->getProgress() >= 1.0f); }
     [[nodiscard]] inline bool foundChanges() const { return this->raw_found_changes; }
+    // beatmapsets/second imported by the raw loader workers, 0 if no raw load is running
+    [[nodiscard]] inline f32 getImportRate() const { return this->raw_import_rate.load(std::memory_order_acquire); }
 
     BeatmapDifficulty *getBeatmapDifficulty(const MD5Hash &md5hash);
     BeatmapDifficulty *getBeatmapDifficulty(i32 map_id);
@@ -158,14 +190,17 @@ class Database final {
         return this->beatmapsets;
     }
 
+    // covers every loaded difficulty, re-add() difficulties after changing anything that's in their search blob
+    [[nodiscard]] inline BeatmapSearchIndex &getSearchIndex() { return this->search_index; }
+
     // WARNING: Before calling getScores(), you need to lock db->scores_mtx!
     [[nodiscard]] inline const HashToScoreMap &getScores() const { return this->scores; }
     inline HashToScoreMap &getOnlineScores() { return this->online_scores; }
 
     static std::string getOsuSongsFolder();
 
-    // only used for raw loading without db
-    std::unique_ptr<BeatmapSet> loadRawBeatmap(const std::string &beatmapPath, bool is_peppy = false);
+    // only used for raw loading without db (doesn't touch database state, so it's safe to call from any thread)
+    static std::unique_ptr<BeatmapSet> loadRawBeatmap(const std::string &beatmapPath, bool is_peppy = false);
 
     inline void addPathToImport(const std::string &dbPath) { this->extern_db_paths_to_import.push_back(dbPath); }
 
@@ -174,7 +209,6 @@ class Database final {
 
     Sync::shared_mutex peppy_overrides_mtx;
     Sync::shared_mutex scores_mtx;
-    std::atomic<bool> scores_changed{true};
 
     Hash::flat::map<MD5Hash, MapOverrides> peppy_overrides;
     std::vector<BeatmapDifficulty *> loudness_to_calc;
@@ -193,6 +227,8 @@ class Database final {
     friend class DatabaseBeatmap;
 
     void scheduleLoadRaw();
+    // takes ownership of an already-loaded set, deduplicates its diffs and adds it to beatmapsets
+    BeatmapSet *registerBeatmapSet(std::unique_ptr<BeatmapSet> mapset, i32 set_id_override);
 
     // for updating scores externally
     friend struct BatchDiffCalc::internal;
@@ -251,15 +287,19 @@ class Database final {
        public:
         AsyncScoreSaver() = delete;
         friend class Database;
-        FinishedScore scorecopy;
+        std::optional<FinishedScore> scorecopy;  // nullopt if only pending deletions need to be journaled
 
-        AsyncScoreSaver(FinishedScore score) : Resource(APPDEFINED), scorecopy(std::move(score)) {}
+        AsyncScoreSaver(std::optional<FinishedScore> score) : Resource(APPDEFINED), scorecopy(std::move(score)) {}
         ~AsyncScoreSaver() override { this->destroy(); }
 
        protected:
         inline void init() override { this->setReady(true); }
         void initAsync() override;
         void destroy() override {}
+
+       private:
+        // saves the replay, and journals the score (or rewrites neosu_scores.db)
+        static void saveScore(const FinishedScore &score);
     };
 
     friend class AsyncDBLoader;
@@ -267,17 +307,37 @@ class Database final {
 
     void startLoader();
     void destroyLoader();
+    void watchRawSongsFolder();
 
     void saveMaps();
+    void saveSearchIndex();
+    // drops search index entries for difficulties which are no longer loaded
+    void pruneSearchIndex();
 
     void findDatabases();
     bool importDatabase(const std::pair<DatabaseType, std::string> &db_pair);
     void loadMaps();
+    void loadStreamedNeosuMaps(std::string_view neosu_maps_path, u32 &nb_neosu_maps, u32 &nb_overrides);
+    bool loadColumnarNeosuMaps(const MapsDB::Reader &neosu_maps, u32 &nb_neosu_maps, u32 &nb_overrides);
     void loadScores(std::string_view dbPath);
     void loadOldMcNeosuScores(std::string_view dbPath);
     void loadPeppyScores(std::string_view dbPath);
     void saveScores();
+    // writes every score to a fresh neosu_scores.db, only called by saveScores
+    bool writeScoresDB(std::string_view path, u32 &nb_scores);
+    // applies the journal on top of the loaded neosu_scores.db
+    void replayScoresJournal();
+    // returns false if neosu_scores.db should be rewritten in full instead (journal is long, or couldn't be written)
+    bool journalScoreChange(ScoresJournal::RecordType type, const FinishedScore &score);
+    // starts the score saver for pending_score_deletions, unless it's still busy (then update() retries)
+    void startScoreDeletionSaver();
+    // called by the score saver, journals and clears pending_score_deletions
+    void journalPendingScoreDeletions();
     void sortScores(const MD5Hash &beatmapMD5Hash);
+    // call with scores_mtx locked, after changing any of playerName's scores on the beatmap
+    void updatePlayerStats(const MD5Hash &beatmapMD5Hash, const std::string &playerName);
+    // rebuilds player_stats if user_include_relax_and_autopilot_for_stats changed since it was built
+    void syncPlayerStatsModFilter();
     bool addScoreRaw(const FinishedScore &score);
     // returns position of existing score in the scores[hash] array if found, -1 otherwise
     // this isn't completely accurate but allows skipping importing some duplicate entries early from dbs
@@ -288,8 +348,15 @@ class Database final {
     std::unique_ptr<AsyncDBLoader> loader;
     std::unique_ptr<AsyncScoreSaver> score_saver;
 
+    // score changes since neosu_scores.db was last written in full
+    ScoresJournal scores_journal{getDBPath(DatabaseType::NEOSU_SCORES) + ".journal", NEOSU_SCORE_DB_VERSION};
+    Sync::mutex scores_save_mtx;  // serializes journal appends and full neosu_scores.db writes
+
+    // deleted scores waiting for the score saver to journal them, the main thread never waits on scores_save_mtx
+    std::vector<FinishedScore> pending_score_deletions;
+    Sync::mutex pending_score_deletions_mtx;
+
     std::unique_ptr<Timing::Timer> importTimer;
-    bool is_first_load{true};      // only load differences after first raw load
     bool raw_found_changes{true};  // for total refresh detection of raw loading
 
     // global
@@ -305,9 +372,14 @@ class Database final {
 
     bool neosu_maps_loaded{false};
 
+    // saved next to neosu_maps.db, only loaded on startup (reloads update it incrementally)
+    BeatmapSearchIndex search_index;
+
     // scores.db (legacy and custom)
     bool scores_loaded{false};
 
+    // best score per beatmap of every player, kept up to date with scores
+    PlayerStatsIndex player_stats;
     PlayerStats prevPlayerStats{
         .name = "",
         .pp = 0.0f,
@@ -318,12 +390,47 @@ class Database final {
         .totalScore = 0,
     };
 
+    // identifies the on-disk state of a raw beatmap folder, so that reloads can skip unchanged folders
+    struct RawFolderStamp {
+        i64 mtime{0};  // newest of the folder itself and its .osu files
+        u64 size{0};   // total size of its .osu files
+
+        bool operator==(const RawFolderStamp &) const = default;
+    };
+    static RawFolderStamp getRawFolderStamp(const std::string &folderPath);
+
+    struct RawFolderEntry {
+        RawFolderStamp stamp;
+        BeatmapSet *set{nullptr};  // owned by beatmapsets
+    };
+
+    struct RawImportResult {
+        std::string folder;
+        RawFolderStamp stamp;
+        std::unique_ptr<BeatmapSet> set;  // null if unchanged (reused from raw_reusable_sets) or if loading failed
+        bool unchanged{false};
+    };
+
     std::string raw_load_osu_song_folder;
-    std::vector<std::string> raw_loaded_beatmap_folders;
     std::vector<std::string> raw_load_beatmap_folders;
+    // folder name -> state of every folder registered by the last raw load
+    Hash::unstable_stringmap<RawFolderEntry> raw_loaded_folders;
+    // sets registered by the previous raw load, taken out of beatmapsets on reload so they can be reused
+    Hash::unstable_stringmap<std::unique_ptr<BeatmapSet>> raw_reusable_sets;
+    RawFolderChanges raw_load_changes;
+
+    // the raw songs folder is watched (recursively) after a raw load
+    // written .osu files and removed folders, their sets are rescanned by update() (outside of gameplay)
+    std::string raw_watched_folder;
+    std::vector<std::string> raw_watch_changed_paths;
+    bool raw_watch_rescan_all{false};  // the watcher lost events
 
     // raw load
-    u32 cur_raw_load_idx{0};
+    // parses/hashes beatmap folders on worker threads, finished sets are handed to the main thread in update()
+    struct RawImportPool;
+    std::unique_ptr<RawImportPool> raw_import_pool;
+    std::vector<RawImportResult> raw_import_batch;  // reused between update() calls
+    std::atomic<f32> raw_import_rate{0.f};
     bool needs_raw_load{false};
     bool raw_load_scheduled{false};
     bool raw_load_is_neosu{
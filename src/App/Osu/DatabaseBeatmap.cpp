@@ -22,7 +22,9 @@
 #include "Logging.h"
 #include "SongBrowser.h"
 #include "AsyncIOHandler.h"
+#include "AsyncStarCalculator.h"
 #include "crypto.h"
+#include "UString.h"
 
 #include <algorithm>
 #include <sys/stat.h>
@@ -116,7 +118,7 @@ DatabaseBeatmap::LOAD_GAMEPLAY_RESULT &DatabaseBeatmap::LOAD_GAMEPLAY_RESULT::op
 DatabaseBeatmap::DatabaseBeatmap() = default;
 DatabaseBeatmap::~DatabaseBeatmap() = default;
 
-DatabaseBeatmap::DatabaseBeatmap(std::string filePath, std::string folder, BeatmapType type)
+DatabaseBeatmap::DatabaseBeatmap(std::string filePath, SharedString folder, BeatmapType type)
     : sFolder(std::move(folder)), sFilePath(std::move(filePath)), type(type) {
     this->iVersion = cv::beatmap_version.getInt();
 }
@@ -186,8 +188,8 @@ void swap(DatabaseBeatmap &a, DatabaseBeatmap &b) noexcept {
 #define SF(fieldname) std::swap(a.fieldname, b.fieldname);
     SF(sMD5Hash)           SF(difficulties)  SF(parentSet)                SF(timingpoints)    SF(sFolder)           SF(sFilePath)         SF(last_modification_time)
     SF(sTitle)             SF(sTitleUnicode) SF(sArtist)                  SF(sArtistUnicode)  SF(sCreator)          SF(sDifficultyName)
-    SF(sSource)            SF(sTags)         SF(sBackgroundImageFileName) SF(sAudioFileName)  SF(iID)               SF(iLengthMS)
-    SF(iLocalOffset)       SF(iOnlineOffset) SF(iSetID)                   SF(iPreviewTime)    SF(fAR)               SF(fCS)
+    SF(sSource)            SF(sTags)         SF(sBackgroundImageFileName) SF(sAudioFileName)  SF(sSearchBlob)       SF(iID)
+    SF(iLengthMS)          SF(iLocalOffset)  SF(iOnlineOffset)            SF(iSetID)          SF(iPreviewTime)      SF(fAR)               SF(fCS)
     SF(fHP)                SF(fOD)           SF(fStackLeniency)           SF(fSliderTickRate) SF(fSliderMultiplier) SF(ppv2Version)
     SF(fStarsNomod)        SF(star_ratings)  SF(iMinBPM)                  SF(iMaxBPM)         SF(iMostCommonBPM)    SF(iNumCircles)
     SF(iNumSliders)        SF(iNumSpinners)  SF(last_queried_sr)          SF(last_queried_sr_idx)
@@ -217,6 +219,7 @@ DatabaseBeatmap::DatabaseBeatmap(const DatabaseBeatmap &other)
       COPYOTHER(sTitleUnicode),       COPYOTHER(sArtist),                  COPYOTHER(sArtistUnicode),
       COPYOTHER(sCreator),            COPYOTHER(sDifficultyName),          COPYOTHER(sSource),
       COPYOTHER(sTags),               COPYOTHER(sBackgroundImageFileName), COPYOTHER(sAudioFileName),
+      COPYOTHER(sSearchBlob),
       COPYOTHER(iID),                 COPYOTHER(iLengthMS),                COPYOTHER(iLocalOffset),
       COPYOTHER(iOnlineOffset),       COPYOTHER(iSetID),                   COPYOTHER(iPreviewTime),
       COPYOTHER(fAR),                 COPYOTHER(fCS),                      COPYOTHER(fHP),
@@ -247,7 +250,7 @@ DatabaseBeatmap::DatabaseBeatmap(DatabaseBeatmap &&other) noexcept
       MOVEOTHER(sTitle),             MOVEOTHER(sTitleUnicode),       MOVEOTHER(sArtist),
       MOVEOTHER(sArtistUnicode),     MOVEOTHER(sCreator),            MOVEOTHER(sDifficultyName),
       MOVEOTHER(sSource),            MOVEOTHER(sTags),               MOVEOTHER(sBackgroundImageFileName),
-      MOVEOTHER(sAudioFileName),     COPYOTHER(iID),                 COPYOTHER(iLengthMS),
+      MOVEOTHER(sAudioFileName),     MOVEOTHER(sSearchBlob),         COPYOTHER(iID),                 COPYOTHER(iLengthMS),
       COPYOTHER(iLocalOffset),       COPYOTHER(iOnlineOffset),       COPYOTHER(iSetID),
       COPYOTHER(iPreviewTime),       COPYOTHER(fAR),                 COPYOTHER(fCS),
       COPYOTHER(fHP),                COPYOTHER(fOD),                 COPYOTHER(fStackLeniency),
@@ -1317,14 +1320,26 @@ f32 DatabaseBeatmap::getStarRating(u8 idx) const {
         return this->last_queried_sr;
     }
 
-    assert(idx < StarPrecalc::NUM_PRECALC_RATINGS);
+    if(StarPrecalc::is_custom_idx(idx) && !this->difficulties) {
+        if(const f32 stars = AsyncStarCalc::query(this); stars > 0.f) {
+            this->last_queried_sr = stars;
+            this->last_queried_sr_idx = idx;
+            return stars;
+        }
+        return this->getStarRating(AsyncStarCalc::get_fallback_idx());
+    }
+
+    assert(idx < StarPrecalc::NUM_PRECALC_RATINGS || StarPrecalc::is_custom_idx(idx));
     f32 ret = 0.f;
 
     if(this->difficulties) {  // we are a beatmapset, get max sr of child difficulty
         f32 maxdiff = 0.f;
         f32 max_cached_sr = -1.f;
+        bool all_cached = true;
         for(const auto &d : *this->difficulties) {
-            if(f32 diffsr = d->getStarRating(idx); diffsr > maxdiff) {
+            const f32 diffsr = d->getStarRating(idx);
+            if(d->last_queried_sr_idx != idx) all_cached = false;
+            if(diffsr > maxdiff) {
                 maxdiff = diffsr;
                 // check if we cached it
                 if(d->last_queried_sr_idx == idx && d->last_queried_sr == diffsr) {
@@ -1336,7 +1351,8 @@ f32 DatabaseBeatmap::getStarRating(u8 idx) const {
         ret = maxdiff;
 
         // cache max child diff sr if the max child already had it cached
-        if(max_cached_sr == maxdiff) {
+        // (on-demand ratings keep coming in without the index changing, so all of them have to be final for those)
+        if(max_cached_sr == maxdiff && (all_cached || !StarPrecalc::is_custom_idx(idx))) {
             this->last_queried_sr = ret;
             this->last_queried_sr_idx = idx;
         }
@@ -1432,6 +1448,14 @@ DatabaseBeatmap::LOAD_META_RESULT DatabaseBeatmap::loadMetadata(bool compute_md5
     // load metadata
     bool foundAR = false;
 
+    // shared metadata can't be parsed into in-place
+    const auto parse_shared = [](std::string_view line, const char *key, SharedString &out) -> bool {
+        std::string str;
+        if(!Parsing::parse(line, key, ':', &str)) return false;
+        out = std::move(str);
+        return true;
+    };
+
     BlockId curBlock{BlockId::Sentinel};
     std::vector<MetadataBlock> blocksUnseen{metadataBlocks.begin(), metadataBlocks.end()};
 
@@ -1486,21 +1510,21 @@ DatabaseBeatmap::LOAD_META_RESULT DatabaseBeatmap::loadMetadata(bool compute_md5
                     return ret(LoadError::NON_STD_GAMEMODE);
                 }
                 //PARSE_LINE("Mode", ':', &this->iGameMode);
-                PARSE_LINE("AudioFilename", ':', &this->sAudioFileName);
+                if(parse_shared(curLine, "AudioFilename", this->sAudioFileName)) break;
                 PARSE_LINE("StackLeniency", ':', &this->fStackLeniency);
                 PARSE_LINE("PreviewTime", ':', &this->iPreviewTime);
                 break;
             }
 
             case Metadata: {
-                PARSE_LINE("Title", ':', &this->sTitle);
-                PARSE_LINE("TitleUnicode", ':', &this->sTitleUnicode);
-                PARSE_LINE("Artist", ':', &this->sArtist);
-                PARSE_LINE("ArtistUnicode", ':', &this->sArtistUnicode);
-                PARSE_LINE("Creator", ':', &this->sCreator);
+                if(parse_shared(curLine, "Title", this->sTitle)) break;
+                if(parse_shared(curLine, "TitleUnicode", this->sTitleUnicode)) break;
+                if(parse_shared(curLine, "Artist", this->sArtist)) break;
+                if(parse_shared(curLine, "ArtistUnicode", this->sArtistUnicode)) break;
+                if(parse_shared(curLine, "Creator", this->sCreator)) break;
                 PARSE_LINE("Version", ':', &this->sDifficultyName);
-                PARSE_LINE("Source", ':', &this->sSource);
-                PARSE_LINE("Tags", ':', &this->sTags);
+                if(parse_shared(curLine, "Source", this->sSource)) break;
+                if(parse_shared(curLine, "Tags", this->sTags)) break;
                 PARSE_LINE("BeatmapID", ':', &this->iID);
                 PARSE_LINE("BeatmapSetID", ':', &this->iSetID);
                 break;
@@ -1529,7 +1553,7 @@ DatabaseBeatmap::LOAD_META_RESULT DatabaseBeatmap::loadMetadata(bool compute_md5
                 if(!haveFilename &&
                    Parsing::parse(curLine, &type, ',', Parsing::skip<i64> /* skip start time */, ',', &str) &&
                    (type == 0)) {
-                    this->sBackgroundImageFileName = str;
+                    this->sBackgroundImageFileName = std::move(str);
                     haveFilename = true;
                 }
 
@@ -1583,9 +1607,49 @@ DatabaseBeatmap::LOAD_META_RESULT DatabaseBeatmap::loadMetadata(bool compute_md5
     // special case: old beatmaps have AR = OD, there is no ApproachRate stored
     if(!foundAR) this->fAR = this->fOD;
 
+    this->rebuildSearchBlob();
+
     return ret(LoadError::NONE);
 }
 
+void DatabaseBeatmap::rebuildSearchBlob() {
+    if(this->difficulties) return;  // sets are matched through their difficulties
+
+    std::string blob;
+    blob.reserve(this->sTitle.size() + this->sTitleUnicode.size() + this->sArtist.size() +
+                 this->sArtistUnicode.size() + this->sCreator.size() + this->sDifficultyName.size() +
+                 this->sSource.size() + this->sTags.size() + 32);
+
+    // separate fields so that a search term can never match across two of them
+    const auto append = [&blob](std::string_view field) {
+        if(field.empty()) return;
+        blob.append(field);
+        blob.push_back('\n');
+    };
+
+    append(this->sTitle);
+    append(this->sArtist);
+    if(this->sTitleUnicode != this->sTitle) append(this->sTitleUnicode);
+    if(this->sArtistUnicode != this->sArtist) append(this->sArtistUnicode);
+    append(this->sCreator);
+    append(this->sDifficultyName);
+    append(this->sSource);
+    append(this->sTags);
+    if(this->iID > 0) append(std::to_string(this->iID));
+    if(this->iSetID > 0) append(std::to_string(this->iSetID));
+
+    // fold case the same way the search string is (see AsyncSongButtonMatcher::setSongButtonsAndSearchString)
+    if(std::ranges::all_of(blob, [](unsigned char c) { return c < 0x80; })) {
+        SString::lower_inplace(blob);
+    } else {
+        UString ublob{blob};
+        ublob.lowerCase();
+        blob = ublob.utf8View();
+    }
+
+    this->sSearchBlob = std::move(blob);
+}
+
 DatabaseBeatmap::LOAD_GAMEPLAY_RESULT DatabaseBeatmap::loadGameplay(BeatmapDifficulty *databaseBeatmap,
                                                                     AbstractBeatmapInterface *beatmap,
                                                                     LOAD_META_RESULT preloadedMetadata,
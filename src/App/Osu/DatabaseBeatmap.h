@@ -18,6 +18,7 @@
 #include "Color.h"
 #include "HitSounds.h"
 #include "SyncStoptoken.h"
+#include "SharedString.h"
 
 #else
 
@@ -327,7 +328,7 @@ class DatabaseBeatmap final {
     DatabaseBeatmap();
     ~DatabaseBeatmap();
 
-    DatabaseBeatmap(std::string filePath, std::string folder, BeatmapType type);  // beatmap difficulty
+    DatabaseBeatmap(std::string filePath, SharedString folder, BeatmapType type);  // beatmap difficulty
     DatabaseBeatmap(std::unique_ptr<DiffContainer> &&difficulties,
                     BeatmapType type);  // beatmapset
 
@@ -439,6 +440,10 @@ class DatabaseBeatmap final {
     [[nodiscard]] inline const std::string &getDifficultyName() const { return this->sDifficultyName; }
     [[nodiscard]] inline const std::string &getSource() const { return this->sSource; }
     [[nodiscard]] inline const std::string &getTags() const { return this->sTags; }
+
+    // lowercased title/artist/creator/version/source/tags/ids, separated by '\n' (only built for difficulties)
+    [[nodiscard]] inline std::string_view getSearchBlob() const { return this->sSearchBlob; }
+    void rebuildSearchBlob();
     [[nodiscard]] inline const std::string &getBackgroundImageFileName() const {
         return this->sBackgroundImageFileName;
     }
@@ -462,19 +467,26 @@ class DatabaseBeatmap final {
 
     using MapFileReadDoneCallback = std::function<void(std::vector<u8>)>;  // == AsyncIOHandler::ReadCallback
     bool getMapFileAsync(MapFileReadDoneCallback data_callback);
-    [[nodiscard]] inline std::string getFullSoundFilePath() const { return this->sFolder + this->sAudioFileName; }
+    [[nodiscard]] inline std::string getFullSoundFilePath() const {
+        return this->sFolder.str() + this->sAudioFileName.str();
+    }
 
     // redundant data
     [[nodiscard]] inline std::string getFullBackgroundImageFilePath() const {
-        return this->sFolder + this->sBackgroundImageFileName;
+        return this->sFolder.str() + this->sBackgroundImageFileName.str();
     }
 
     // precomputed data
 
     // TODO: return "closest computed" SR for queries while calculating
     // falls back to nomod stars ATM
+    // custom indices (see StarPrecalc::is_custom_idx()) are rated by AsyncStarCalc, using the closest precalculated
+    // rating until they're computed
     [[nodiscard]] f32 getStarRating(u8 idx) const;
 
+    // drops the memoized getStarRating() result
+    inline void forgetQueriedStarRating() const { this->last_queried_sr_idx = 0xFF; }
+
     [[nodiscard]] inline f32 getStarsNomod() const { return this->getStarRating(StarPrecalc::NOMOD_1X_INDEX); }
 
     [[nodiscard]] inline int getMinBPM() const { return this->iMinBPM; }
@@ -522,23 +534,25 @@ class DatabaseBeatmap final {
 
     // redundant data (technically contained in metadata, but precomputed anyway)
 
-    std::string sFolder;    // path to folder containing .osu file (e.g. "/path/to/beatmapfolder/")
+    SharedString sFolder;   // path to folder containing .osu file (e.g. "/path/to/beatmapfolder/")
     std::string sFilePath;  // path to .osu file (e.g. "/path/to/beatmapfolder/beatmap.osu")
 
    public:
     // raw metadata
     i64 last_modification_time{0};
 
-    std::string sTitle;
-    std::string sTitleUnicode;
-    std::string sArtist;
-    std::string sArtistUnicode;
-    std::string sCreator;
+    // the metadata which is usually the same for every difficulty of a set is shared between them
+    SharedString sTitle;
+    SharedString sTitleUnicode;
+    SharedString sArtist;
+    SharedString sArtistUnicode;
+    SharedString sCreator;
     std::string sDifficultyName;  // difficulty name ("Version")
-    std::string sSource;          // only used by search
-    std::string sTags;            // only used by search
-    std::string sBackgroundImageFileName;
-    std::string sAudioFileName;
+    SharedString sSource;         // only used by search
+    SharedString sTags;           // only used by search
+    SharedString sBackgroundImageFileName;
+    SharedString sAudioFileName;
+    std::string sSearchBlob;  // see getSearchBlob()
 
     int iID{0};  // online ID, if uploaded
     u32 iLengthMS{0};
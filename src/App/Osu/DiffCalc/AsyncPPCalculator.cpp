@@ -1,10 +1,14 @@
 // Copyright (c) 2024, kiwec, All rights reserved.
 #include "AsyncPPCalculator.h"
 
+#include "ConVar.h"
 #include "DatabaseBeatmap.h"
 #include "DifficultyCalculator.h"
+#include "Hashing.h"
+#include "ModFlags.h"
 #include "Osu.h"
 #include "Timing.h"
+#include "Profiler.h"
 #include "Thread.h"
 #include "SyncMutex.h"
 #include "SyncCV.h"
@@ -12,6 +16,17 @@
 
 #include "SyncJthread.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <optional>
+
+namespace cv {
+extern ConVar ppcalc_cache_size_mb;
+}
+
 namespace AsyncPPC {
 
 namespace {  // static namespace
@@ -40,8 +55,6 @@ struct info_cache {
     bool ap{};
 
     // Results
-    std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> cachedDiffObjects{
-        std::make_unique<std::vector<DifficultyCalculator::DiffObject>>()};
     pp_res info{};
     DifficultyCalculator::DifficultyAttributes diffattrs{};
 
@@ -52,6 +65,34 @@ struct info_cache {
     }
 };
 
+struct RequestHash {
+    using is_avalanching = void;
+
+    u64 operator()(const pp_calc_request& rqt) const noexcept {
+        // pack the fields explicitly, the struct has padding
+        std::array<u32, 15> buf{};
+        std::memcpy(&buf[0], &rqt.modFlags, sizeof(u64));
+        std::memcpy(&buf[2], &rqt.speedOverride, sizeof(f32));
+        std::memcpy(&buf[3], &rqt.AR, sizeof(f32));
+        std::memcpy(&buf[4], &rqt.HP, sizeof(f32));
+        std::memcpy(&buf[5], &rqt.CS, sizeof(f32));
+        std::memcpy(&buf[6], &rqt.OD, sizeof(f32));
+        std::memcpy(&buf[7], &rqt.comboMax, sizeof(i32));
+        std::memcpy(&buf[8], &rqt.numMisses, sizeof(i32));
+        std::memcpy(&buf[9], &rqt.num300s, sizeof(i32));
+        std::memcpy(&buf[10], &rqt.num100s, sizeof(i32));
+        std::memcpy(&buf[11], &rqt.num50s, sizeof(i32));
+        buf[12] = rqt.legacyTotalScore;
+        buf[13] = (u32)rqt.scoreFromMcOsu;
+        return Hash::flat::detail::wyhash::hash(buf.data(), sizeof(buf));
+    }
+};
+
+// the worker only keeps the hitobjects/difficulty of a few different settings around (they're big, and usually
+// every score on a map uses the same handful of mod combinations)
+constexpr uSz MAX_HITOBJECT_CACHES = 4;
+constexpr uSz MAX_INFO_CACHES = 16;
+
 const BeatmapDifficulty* current_map = nullptr;
 
 Sync::condition_variable_any cond;
@@ -59,71 +100,158 @@ Sync::jthread thr;
 
 Sync::mutex work_mtx;
 
-// bool to keep track of "high priority" state
-// might need mod updates to be recalc'd mid-gameplay
-std::vector<std::pair<pp_calc_request, bool>> work;
+// bumped whenever the map changes, results computed for an older one are dropped
+u64 map_generation{0};
+
+// high priority requests might need mod updates to be recalc'd mid-gameplay
+// a request can be in both queues after getting upgraded, the stale copy is skipped
+// requests stay in `queued` while they're being computed, so they don't get queued again until the result is cached
+enum : u8 { IN_LOW = 1 << 0, IN_HIGH = 1 << 1, IN_FLIGHT = 1 << 2 };
+std::deque<pp_calc_request> high_prio;
+std::deque<pp_calc_request> low_prio;
+Hash::flat::map<pp_calc_request, u8, RequestHash> queued;
 
 Sync::mutex cache_mtx;
 
-std::vector<std::pair<pp_calc_request, pp_res>> cache;
-std::vector<hitobject_cache> ho_cache;
-std::vector<info_cache> inf_cache;
+// most recently used first
+std::list<std::pair<pp_calc_request, pp_res>> lru;
+Hash::flat::map<pp_calc_request, decltype(lru)::iterator, RequestHash> cache;
+uSz cache_bytes{0};
+
+// rough, but the strains are what makes the results big
+uSz entry_size(const pp_res& info) {
+    return sizeof(pp_calc_request) + sizeof(pp_res) + 4 * sizeof(void*) +
+           (info.aimStrains.capacity() + info.speedStrains.capacity()) * sizeof(f64);
+}
+
+// cache_mtx must be held
+const pp_res* cache_lookup(const pp_calc_request& rqt) {
+    const auto it = cache.find(rqt);
+    if(it == cache.end()) return nullptr;
+
+    lru.splice(lru.begin(), lru, it->second);
+    return &it->second->second;
+}
+
+// cache_mtx must be held
+void cache_insert(const pp_calc_request& rqt, pp_res info) {
+    if(cache.contains(rqt)) return;
+
+    const uSz budget = (uSz)std::max(cv::ppcalc_cache_size_mb.getInt(), 1) * 1024 * 1024;
+    const uSz size = entry_size(info);
+    while(!lru.empty() && cache_bytes + size > budget) {
+        cache_bytes -= entry_size(lru.back().second);
+        cache.erase(lru.back().first);
+        lru.pop_back();
+    }
+
+    lru.emplace_front(rqt, std::move(info));
+    cache[rqt] = lru.begin();
+    cache_bytes += size;
+}
+
+// work_mtx must be held
+std::optional<pp_calc_request> pop_request(bool allow_low_prio) {
+    while(!high_prio.empty() || (allow_low_prio && !low_prio.empty())) {
+        pp_calc_request rqt;
+        u8 flag;
+        if(!high_prio.empty()) {
+            rqt = high_prio.front();
+            high_prio.pop_front();
+            flag = IN_HIGH;
+        } else {
+            rqt = low_prio.front();
+            low_prio.pop_front();
+            flag = IN_LOW;
+        }
+
+        const auto it = queued.find(rqt);
+        if(it == queued.end() || !(it->second & flag)) continue;
+
+        it->second = IN_FLIGHT;
+        return rqt;
+    }
+    return std::nullopt;
+}
+
+// work_mtx must be held
+void finish_request(const pp_calc_request& rqt) {
+    // (might have been cleared and queued again for a new map in the meantime)
+    const auto it = queued.find(rqt);
+    if(it != queued.end() && it->second == IN_FLIGHT) queued.erase(it);
+}
 
 void clear_caches() {
     Sync::unique_lock work_lock(work_mtx);
     Sync::unique_lock cache_lock(cache_mtx);
 
-    work.clear();
+    map_generation++;
+    high_prio.clear();
+    low_prio.clear();
+    queued.clear();
     cache.clear();
-    ho_cache.clear();
-    inf_cache.clear();
+    lru.clear();
+    cache_bytes = 0;
 }
 
 void run_thread(const Sync::stop_token& stoken) {
     McThread::set_current_thread_name(US_("async_pp_calc"));
     McThread::set_current_thread_prio(McThread::Priority::LOW);  // reset priority
 
+    // only touched by this thread, so they can't get cleared from under it
+    // least recently added first
+    std::vector<hitobject_cache> ho_cache;
+    std::vector<info_cache> inf_cache;
+    u64 cached_generation = 0;
+
     while(!stoken.stop_requested()) {
         Sync::unique_lock lock(work_mtx);
-        cond.wait(lock, stoken, [] { return !work.empty(); });
+        cond.wait(lock, stoken, [] { return !queued.empty(); });
         if(stoken.stop_requested()) return;
 
-        while(!work.empty()) {
+        while(!queued.empty()) {
             if(stoken.stop_requested()) return;
 
-            auto [rqt, highprio] = work.front();
-            if(!highprio && osu->shouldPauseBGThreads()) {
+            const auto next = pop_request(!osu->shouldPauseBGThreads());
+            if(!next.has_value()) {
+                // only low priority work left, which has to wait until gameplay is over
                 lock.unlock();
                 Timing::sleepMS(100);
                 lock.lock();
                 continue;
             }
 
-            work.erase(work.begin());
+            const pp_calc_request rqt = *next;
+            VPROF_TRACE("AsyncPPCalc::request");
 
             // capture current map before unlocking (work items are specific to this map)
             const BeatmapDifficulty* map_for_rqt = current_map;
+            const u64 generation = map_generation;
             lock.unlock();
 
-            if(!map_for_rqt) continue;
+            if(!map_for_rqt) {
+                lock.lock();
+                finish_request(rqt);
+                continue;
+            }
+
+            if(generation != cached_generation) {
+                ho_cache.clear();
+                inf_cache.clear();
+                cached_generation = generation;
+            }
 
             // skip if already computed
-            bool already_cached = false;
             {
                 Sync::unique_lock cache_lock(cache_mtx);
-                for(const auto& [request, info] : cache) {
-                    if(request == rqt) {
-                        already_cached = true;
-                        break;
-                    }
+                if(cache.contains(rqt)) {
+                    cache_lock.unlock();
+                    lock.lock();
+                    finish_request(rqt);
+                    continue;
                 }
             }
 
-            if(already_cached) {
-                lock.lock();
-                continue;
-            }
-
             if(stoken.stop_requested()) return;
 
             // find or compute hitobjects
@@ -148,10 +276,14 @@ void run_thread(const Sync::stop_token& stoken) {
                                                                            rqt.speedOverride, false, stoken);
 
                 if(stoken.stop_requested()) return;
+
+                if(ho_cache.size() >= MAX_HITOBJECT_CACHES) ho_cache.erase(ho_cache.begin());
+
                 if(new_ho.diffres.error.errc) {
                     // so that we stop trying after failing once
                     ho_cache.push_back(std::move(new_ho));
                     lock.lock();
+                    finish_request(rqt);
                     continue;
                 }
 
@@ -195,17 +327,18 @@ void run_thread(const Sync::stop_token& stoken) {
                     .breakDuration = computed_ho->diffres.totalBreakDuration,
                     .playableLength = computed_ho->diffres.playableLength};
 
-                DifficultyCalculator::StarCalcParams params{.cachedDiffObjects = std::move(new_info.cachedDiffObjects),
-                                                            .outAttributes = new_info.diffattrs,
-                                                            .beatmapData = diffcalcData,
-                                                            .outAimStrains = &new_info.info.aimStrains,
-                                                            .outSpeedStrains = &new_info.info.speedStrains,
-                                                            .incremental = nullptr,
-                                                            .upToObjectIndex = -1,
-                                                            .cancelCheck = stoken};
+                // the difficulty objects are only needed during the calculation, don't keep them around
+                DifficultyCalculator::StarCalcParams params{
+                    .cachedDiffObjects = std::make_unique<std::vector<DifficultyCalculator::DiffObject>>(),
+                    .outAttributes = new_info.diffattrs,
+                    .beatmapData = diffcalcData,
+                    .outAimStrains = &new_info.info.aimStrains,
+                    .outSpeedStrains = &new_info.info.speedStrains,
+                    .incremental = nullptr,
+                    .upToObjectIndex = -1,
+                    .cancelCheck = stoken};
 
                 new_info.info.total_stars = DifficultyCalculator::calculateStarDiffForHitObjects(params);
-                new_info.cachedDiffObjects = std::move(params.cachedDiffObjects);
 
                 // TODO: get rid of duplicated pp_res shit (use new DifficultyAttributes)
                 new_info.info.aim_stars = new_info.diffattrs.AimDifficulty;
@@ -218,6 +351,7 @@ void run_thread(const Sync::stop_token& stoken) {
 
                 if(stoken.stop_requested()) return;
 
+                if(inf_cache.size() >= MAX_INFO_CACHES) inf_cache.erase(inf_cache.begin());
                 inf_cache.push_back(std::move(new_info));
                 computed_info = &inf_cache.back();
             }
@@ -243,14 +377,18 @@ void run_thread(const Sync::stop_token& stoken) {
                 .legacyTotalScore = rqt.legacyTotalScore,
                 .isMcOsuImported = rqt.scoreFromMcOsu};
 
-            computed_info->info.pp = DifficultyCalculator::calculatePPv2(ppv2calcparams);
+            pp_res result = computed_info->info;
+            result.pp = DifficultyCalculator::calculatePPv2(ppv2calcparams);
 
+            lock.lock();
             {
+                // the map might have changed while this was computed
                 Sync::unique_lock cache_lock(cache_mtx);
-                cache.emplace_back(rqt, computed_info->info);
+                if(generation == map_generation) {
+                    cache_insert(rqt, std::move(result));
+                }
             }
-
-            lock.lock();
+            finish_request(rqt);
         }
     }
 }
@@ -261,7 +399,10 @@ void set_map(const DatabaseBeatmap* new_map) {
     if(new_map && new_map->do_not_store) return;
 
     const bool had_map = (current_map != nullptr);
-    current_map = new_map;
+    {
+        Sync::unique_lock work_lock(work_mtx);
+        current_map = new_map;
+    }
 
     if(had_map) {
         clear_caches();
@@ -280,24 +421,24 @@ void set_map(const DatabaseBeatmap* new_map) {
 pp_res query_result(const pp_calc_request& rqt, bool ignoreBGThreadPause) {
     {
         Sync::unique_lock cache_lock(cache_mtx);
-        for(const auto& [request, info] : cache) {
-            if(request == rqt) {
-                return info;
-            }
+        if(const pp_res* info = cache_lookup(rqt)) {
+            return *info;
         }
     }
 
     {
+        // the same request only gets computed once, no matter how often it's queried until then
         Sync::unique_lock work_lock(work_mtx);
-        bool work_exists = false;
-        for(const auto& [w, prio] : work) {
-            if(w == rqt) {
-                work_exists = true;
-                break;
-            }
-        }
-        if(!work_exists) {
-            work.emplace_back(rqt, ignoreBGThreadPause);
+        u8& state = queued[rqt];
+        if(state & IN_FLIGHT) {
+            // already being computed
+        } else if(ignoreBGThreadPause && !(state & IN_HIGH)) {
+            state |= IN_HIGH;
+            high_prio.push_back(rqt);
+            cond.notify_one();
+        } else if(!state) {
+            state = IN_LOW;
+            low_prio.push_back(rqt);
             cond.notify_one();
         }
     }
@@ -0,0 +1,514 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "AsyncStarCalculator.h"
+#include "StarPrecalc.h"
+
+#include "Database.h"
+#include "DatabaseBeatmap.h"
+#include "DifficultyCalculator.h"
+#include "ConVar.h"
+#include "Hashing.h"
+#include "Logging.h"
+#include "ModFlags.h"
+#include "Osu.h"
+#include "Replay.h"
+#include "Timing.h"
+#include "Thread.h"
+#include "SyncMutex.h"
+#include "SyncCV.h"
+#include "SyncJthread.h"
+#include "UString.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace cv {
+extern ConVar debug_pp;
+extern ConVar starcalc_threads;
+extern ConVar starcalc_cache_size;
+}  // namespace cv
+
+namespace AsyncStarCalc {
+
+namespace {  // static namespace
+
+// everything the star rating of a map depends on, after applying the mods to its base values
+struct DiffParams {
+    f32 speed{1.f};
+    f32 AR{5.f};
+    f32 CS{5.f};
+    f32 OD{5.f};
+    f32 HP{5.f};
+    bool hd{false};
+    bool rx{false};
+    bool ap{false};
+    bool td{false};
+
+    bool operator==(const DiffParams&) const = default;
+};
+
+struct CacheKey {
+    MD5Hash hash;
+    DiffParams params;
+
+    bool operator==(const CacheKey&) const = default;
+};
+
+struct CacheKeyHash {
+    using is_avalanching = void;
+
+    u64 operator()(const CacheKey& key) const noexcept {
+        // pack the fields explicitly, the structs have padding
+        std::array<u32, 10> buf{};
+        std::memcpy(buf.data(), key.hash.data(), sizeof(MD5Hash));
+        std::memcpy(&buf[4], &key.params.speed, sizeof(f32));
+        std::memcpy(&buf[5], &key.params.AR, sizeof(f32));
+        std::memcpy(&buf[6], &key.params.CS, sizeof(f32));
+        std::memcpy(&buf[7], &key.params.OD, sizeof(f32));
+        std::memcpy(&buf[8], &key.params.HP, sizeof(f32));
+        buf[9] = (u32)key.params.hd | ((u32)key.params.rx << 1) | ((u32)key.params.ap << 2) |
+                 ((u32)key.params.td << 3);
+        return Hash::flat::detail::wyhash::hash(buf.data(), sizeof(buf));
+    }
+};
+
+struct Job {
+    CacheKey key;
+    std::string osu_path;
+};
+
+// only read/written on the main thread
+struct {
+    Replay::Mods mods{};
+    bool custom{false};
+    u8 fallback_idx{StarPrecalc::NOMOD_1X_INDEX};
+    u8 custom_idx{StarPrecalc::CUSTOM_IDX_LAST};
+    u64 next_refresh_ms{0};
+} main_state;
+
+// high priority jobs are for maps which are currently visible, so they're capped and the most recent ones go first
+constexpr uSz MAX_HIGH_PRIO_JOBS = 512;
+
+// flags for queued jobs (FINISHED: computed, waiting in finished to be published)
+enum : u8 { IN_LOW = 1 << 0, IN_HIGH = 1 << 1, IN_FLIGHT = 1 << 2, FINISHED = 1 << 3 };
+
+Sync::mutex mtx;
+Sync::condition_variable_any cond;
+std::vector<Sync::jthread> threads;
+
+// everything below is protected by mtx
+Replay::Mods active_mods{};
+bool active{false};
+u8 fallback_idx{StarPrecalc::NOMOD_1X_INDEX};
+
+std::deque<Job> high_prio;
+std::deque<Job> low_prio;
+Hash::flat::map<CacheKey, u8, CacheKeyHash> queued;
+u32 in_flight{0};
+
+// most recently used first
+// only inserted into/evicted from on the main thread (see publish_finished()), so a rating never changes during
+// main-thread work like sorting by it
+std::list<std::pair<CacheKey, f32>> lru;
+Hash::flat::map<CacheKey, decltype(lru)::iterator, CacheKeyHash> cache;
+
+// results computed by the workers which aren't in the cache yet
+std::vector<std::pair<CacheKey, f32>> finished;
+std::atomic<bool> has_finished{false};
+
+// set once after every mods change, when everything which got queued is computed
+std::atomic<bool> drained{false};
+bool drain_signaled{false};
+
+DiffParams params_for(const Replay::Mods& mods, const DatabaseBeatmap* diff) {
+    return DiffParams{.speed = mods.speed,
+                      .AR = mods.get_naive_ar(diff->getAR()),
+                      .CS = mods.get_naive_cs(diff->getCS()),
+                      .OD = mods.get_naive_od(diff->getOD()),
+                      .HP = mods.get_naive_hp(diff->getHP()),
+                      .hd = mods.has(ModFlags::Hidden),
+                      .rx = mods.has(ModFlags::Relax),
+                      .ap = mods.has(ModFlags::Autopilot),
+                      .td = mods.has(ModFlags::TouchDevice)};
+}
+
+// whether the star rating with these mods differs from every precalculated one
+bool needs_custom_rating(const Replay::Mods& mods) {
+    if(std::ranges::none_of(StarPrecalc::SPEEDS, [&mods](f32 spd) { return std::abs(spd - mods.speed) < 0.001f; })) {
+        return true;
+    }
+
+    if(mods.ar_override >= 0.f || mods.ar_overridenegative < 0.f || mods.cs_override >= 0.f ||
+       mods.cs_overridenegative < 0.f || mods.od_override >= 0.f) {
+        return true;
+    }
+
+    using enum ModFlags;
+    return mods.has(AROverrideLock) || mods.has(ODOverrideLock) || mods.has(Relax) || mods.has(Autopilot) ||
+           mods.has(TouchDevice) || StarPrecalc::mod_combo_index(mods.flags) == StarPrecalc::INVALID_MODCOMBO;
+}
+
+// only the fields which can change star ratings (flashlight doesn't)
+bool same_rating_mods(const Replay::Mods& a, const Replay::Mods& b) {
+    using enum ModFlags;
+    constexpr std::array relevant_flags{Hidden,    HardRock,       Easy,           Relax,
+                                        Autopilot, TouchDevice,    AROverrideLock, ODOverrideLock};
+    return a.speed == b.speed && a.ar_override == b.ar_override && a.ar_overridenegative == b.ar_overridenegative &&
+           a.cs_override == b.cs_override && a.cs_overridenegative == b.cs_overridenegative &&
+           a.hp_override == b.hp_override && a.od_override == b.od_override &&
+           std::ranges::all_of(relevant_flags, [&a, &b](ModFlags flag) { return a.has(flag) == b.has(flag); });
+}
+
+// mtx must be held
+f32* cache_lookup(const CacheKey& key) {
+    const auto it = cache.find(key);
+    if(it == cache.end()) return nullptr;
+
+    lru.splice(lru.begin(), lru, it->second);
+    return &it->second->second;
+}
+
+// mtx must be held
+void cache_insert(const CacheKey& key, f32 stars) {
+    if(f32* existing = cache_lookup(key)) {
+        *existing = stars;
+        return;
+    }
+
+    const uSz max_entries = std::max(cv::starcalc_cache_size.getInt(), 1);
+    while(cache.size() >= max_entries) {
+        cache.erase(lru.back().first);
+        lru.pop_back();
+    }
+
+    lru.emplace_front(key, stars);
+    cache[key] = lru.begin();
+}
+
+// mtx must be held, main thread only
+void publish_finished() {
+    for(const auto& [key, stars] : finished) {
+        queued.erase(key);
+        cache_insert(key, stars);
+    }
+    finished.clear();
+    has_finished.store(false, std::memory_order_relaxed);
+}
+
+// mtx must be held
+void check_drained() {
+    if(drain_signaled || !high_prio.empty() || !low_prio.empty() || in_flight > 0) return;
+    drain_signaled = true;
+    drained.store(true, std::memory_order_release);
+}
+
+// mtx must be held
+std::optional<Job> pop_job() {
+    while(!high_prio.empty() || !low_prio.empty()) {
+        Job job;
+        u8 flag;
+        if(!high_prio.empty()) {
+            job = std::move(high_prio.back());
+            high_prio.pop_back();
+            flag = IN_HIGH;
+        } else {
+            job = std::move(low_prio.front());
+            low_prio.pop_front();
+            flag = IN_LOW;
+        }
+
+        // the same job can be in both queues, the other copy is skipped once this one runs
+        const auto it = queued.find(job.key);
+        if(it == queued.end() || !(it->second & flag)) continue;
+
+        it->second = IN_FLIGHT;
+        return job;
+    }
+    return std::nullopt;
+}
+
+f32 compute_stars(const Job& job, const Sync::stop_token& stoken) {
+    const DiffParams& p = job.key.params;
+
+    auto diffres = DatabaseBeatmap::loadDifficultyHitObjects(job.osu_path, p.AR, p.CS, p.speed, false, stoken);
+    if(stoken.stop_requested()) return -1.f;
+    if(diffres.error.errc) return 0.f;
+
+    DifficultyCalculator::BeatmapDiffcalcData diffcalcData{.sortedHitObjects = diffres.diffobjects,
+                                                           .CS = p.CS,
+                                                           .HP = p.HP,
+                                                           .AR = p.AR,
+                                                           .OD = p.OD,
+                                                           .hidden = p.hd,
+                                                           .relax = p.rx,
+                                                           .autopilot = p.ap,
+                                                           .touchDevice = p.td,
+                                                           .speedMultiplier = p.speed,
+                                                           .breakDuration = diffres.totalBreakDuration,
+                                                           .playableLength = diffres.playableLength};
+
+    DifficultyCalculator::DifficultyAttributes attributes{};
+    DifficultyCalculator::StarCalcParams params{
+        .cachedDiffObjects = std::make_unique<std::vector<DifficultyCalculator::DiffObject>>(),
+        .outAttributes = attributes,
+        .beatmapData = diffcalcData,
+        .outAimStrains = nullptr,
+        .outSpeedStrains = nullptr,
+        .incremental = nullptr,
+        .upToObjectIndex = -1,
+        .cancelCheck = stoken};
+
+    const f64 stars = DifficultyCalculator::calculateStarDiffForHitObjects(params);
+    if(stoken.stop_requested()) return -1.f;
+
+    return std::isfinite(stars) ? (f32)stars : 0.f;
+}
+
+void run_thread(const Sync::stop_token& stoken) {
+    McThread::set_current_thread_name(US_("async_star_calc"));
+    McThread::set_current_thread_prio(McThread::Priority::LOW);  // reset priority
+
+    while(!stoken.stop_requested()) {
+        if(osu->shouldPauseBGThreads()) {
+            Timing::sleepMS(100);
+            continue;
+        }
+
+        Sync::unique_lock lock(mtx);
+        cond.wait(lock, stoken, [] { return !high_prio.empty() || !low_prio.empty(); });
+        if(stoken.stop_requested()) return;
+
+        auto job = pop_job();
+        if(!job.has_value()) continue;
+
+        in_flight++;
+        const bool already_cached = cache.contains(job->key);
+        lock.unlock();
+
+        const f32 stars = already_cached ? 0.f : compute_stars(*job, stoken);
+
+        lock.lock();
+        in_flight--;
+
+        // results for outdated mods are still worth keeping, unless the computation got cancelled
+        // (so that failing maps aren't retried, they're cached as 0 stars)
+        if(!already_cached && stars >= 0.f) {
+            // stays in queued until update_mainthread() caches it, so that it doesn't get queued again before that
+            queued[job->key] = FINISHED;
+            finished.emplace_back(job->key, stars);
+            has_finished.store(true, std::memory_order_release);
+            logIfCV(debug_pp, "{} = {:.2f} stars (speed {}, AR {}, CS {}, OD {})", job->osu_path, stars,
+                    job->key.params.speed, job->key.params.AR, job->key.params.CS, job->key.params.OD);
+        } else {
+            queued.erase(job->key);
+        }
+
+        // also when the job was for outdated mods, it might have been the last one the current ones were waiting for
+        check_drained();
+    }
+}
+
+// mtx must be held
+void start_threads() {
+    if(!threads.empty()) return;
+
+    i32 nb_threads = cv::starcalc_threads.getInt();
+    if(nb_threads <= 0) {
+        // leave most cores alone, BatchDiffCalc might be running at the same time
+        nb_threads = std::clamp(McThread::get_logical_cpu_count() / 2, 1, 4);
+    }
+
+    for(i32 i = 0; i < nb_threads; i++) {
+        threads.emplace_back(run_thread);
+    }
+}
+
+// mtx must be held
+void enqueue(const DatabaseBeatmap* diff, bool high) {
+    CacheKey key{.hash = diff->getMD5(), .params = params_for(active_mods, diff)};
+    if(cache.contains(key)) return;
+
+    u8& flags = queued[key];
+    if(flags & (IN_FLIGHT | FINISHED | (high ? IN_HIGH : IN_LOW))) return;
+
+    // don't re-queue low priority work if it's already going to run sooner
+    if(!high && (flags & IN_HIGH)) return;
+
+    flags |= high ? IN_HIGH : IN_LOW;
+
+    Job job{.key = std::move(key), .osu_path = diff->getFilePath()};
+    if(high) {
+        if(high_prio.size() >= MAX_HIGH_PRIO_JOBS) {
+            // scrolled away since, demote it
+            Job oldest = std::move(high_prio.front());
+            high_prio.pop_front();
+            if(auto it = queued.find(oldest.key); it != queued.end() && (it->second & IN_HIGH)) {
+                it->second &= ~IN_HIGH;
+                if(!(it->second & IN_LOW)) {
+                    it->second |= IN_LOW;
+                    low_prio.push_back(std::move(oldest));
+                }
+            }
+        }
+        high_prio.push_back(std::move(job));
+    } else {
+        low_prio.push_back(std::move(job));
+    }
+
+    drain_signaled = false;
+    drained.store(false, std::memory_order_relaxed);
+
+    start_threads();
+    cond.notify_one();
+}
+
+void rotate_custom_idx() {
+    if(main_state.custom_idx >= StarPrecalc::CUSTOM_IDX_LAST) {
+        main_state.custom_idx = StarPrecalc::CUSTOM_IDX_FIRST;
+
+        // everything got memoized with some custom index before, which would be reused now
+        if(db) {
+            for(const auto& set : db->getBeatmapSets()) {
+                set->forgetQueriedStarRating();
+                for(const auto& diff : set->getDifficulties()) {
+                    diff->forgetQueriedStarRating();
+                }
+            }
+        }
+    } else {
+        main_state.custom_idx++;
+    }
+
+    StarPrecalc::active_idx = main_state.custom_idx;
+}
+
+}  // namespace
+
+bool set_active_mods(const Replay::Mods& mods) {
+    const bool custom = needs_custom_rating(mods);
+
+    u8 fallback = StarPrecalc::index_of(mods.flags, mods.speed);
+    if(fallback == StarPrecalc::INVALID_MODCOMBO) {
+        fallback = StarPrecalc::speed_index(mods.speed) * StarPrecalc::NUM_MOD_COMBOS;
+    }
+
+    const bool changed = custom != main_state.custom || !same_rating_mods(mods, main_state.mods);
+    main_state.mods = mods;
+    main_state.custom = custom;
+    main_state.fallback_idx = fallback;
+
+    if(changed) {
+        Sync::scoped_lock lock(mtx);
+        active_mods = mods;
+        active = custom;
+        fallback_idx = fallback;
+
+        // queued work is for the previous mods
+        high_prio.clear();
+        low_prio.clear();
+        for(auto it = queued.begin(); it != queued.end();) {
+            if(it->second & (IN_FLIGHT | FINISHED)) {
+                it->second &= IN_FLIGHT | FINISHED;
+                ++it;
+            } else {
+                it = queued.erase(it);
+            }
+        }
+        drain_signaled = false;
+        drained.store(false, std::memory_order_relaxed);
+    }
+
+    if(!custom) return false;
+
+    if(changed || !StarPrecalc::is_custom_idx(StarPrecalc::active_idx)) {
+        rotate_custom_idx();
+    } else {
+        StarPrecalc::active_idx = main_state.custom_idx;
+    }
+
+    return true;
+}
+
+f32 query(const DatabaseBeatmap* diff) {
+    if(diff == nullptr || !diff->getDifficulties().empty() || diff->do_not_store) return -1.f;
+
+    Sync::scoped_lock lock(mtx);
+    if(!active) return -1.f;
+
+    const CacheKey key{.hash = diff->getMD5(), .params = params_for(active_mods, diff)};
+    if(const f32* stars = cache_lookup(key)) return *stars;
+
+    enqueue(diff, false);
+    return -1.f;
+}
+
+void prioritize(const DatabaseBeatmap* diff) {
+    if(diff == nullptr || diff->do_not_store) return;
+
+    Sync::scoped_lock lock(mtx);
+    if(!active) return;
+
+    if(diff->getDifficulties().empty()) {
+        enqueue(diff, true);
+        return;
+    }
+
+    // collapsed set, its rating is the max of its difficulties
+    for(const auto& child : diff->getDifficulties()) {
+        enqueue(child.get(), true);
+    }
+}
+
+u8 get_fallback_idx() {
+    Sync::scoped_lock lock(mtx);
+    return fallback_idx;
+}
+
+bool update_mainthread() {
+    if(has_finished.load(std::memory_order_acquire)) {
+        Sync::scoped_lock lock(mtx);
+        publish_finished();
+    }
+
+    if(!main_state.custom) return false;
+
+    // re-sorting by stars isn't free, so batch up drains while new ratings keep coming in (e.g. while scrolling)
+    const u64 now = Timing::getTicksMS();
+    if(now < main_state.next_refresh_ms) return false;
+    if(!drained.exchange(false, std::memory_order_acquire)) return false;
+
+    main_state.next_refresh_ms = now + 1000;
+    return true;
+}
+
+void abort() {
+    {
+        Sync::scoped_lock lock(mtx);
+        for(auto& thr : threads) thr.request_stop();
+        cond.notify_all();
+    }
+
+    // the workers need mtx to exit
+    for(auto& thr : threads) {
+        if(thr.joinable()) thr.join();
+    }
+
+    Sync::scoped_lock lock(mtx);
+    threads.clear();
+    publish_finished();
+    high_prio.clear();
+    low_prio.clear();
+    queued.clear();
+    in_flight = 0;
+    drain_signaled = false;
+    drained.store(false, std::memory_order_relaxed);
+}
+
+}  // namespace AsyncStarCalc
@@ -0,0 +1,40 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+
+class DatabaseBeatmap;
+namespace Replay {
+struct Mods;
+}
+
+// Computes exact star ratings in the background for active mods which StarPrecalc doesn't cover (arbitrary speeds,
+// AR/CS/OD overrides, relax/autopilot etc.). Results are kept in a bounded LRU cache keyed by map hash and the
+// resulting difficulty parameters, so switching back and forth between mod combinations stays cheap.
+//
+// While such mods are active, StarPrecalc::active_idx is one of the StarPrecalc::CUSTOM_IDX_* values, which makes
+// DatabaseBeatmap::getStarRating() query this. The index only changes along with the mods, newly computed ratings are
+// reported by update_mainthread() instead. Ratings only become visible to query() in update_mainthread(), so they
+// stay the same for the rest of the frame (e.g. while the song browser sorts by them).
+namespace AsyncStarCalc {
+
+// Called by Osu::updateMods(). Returns true (and updates StarPrecalc::active_idx) if the mods need on-demand ratings.
+bool set_active_mods(const Replay::Mods& mods);
+
+// Star rating of a difficulty (not a set) with the active mods. Main thread only.
+// If it isn't computed yet, it gets queued and -1 is returned.
+[[nodiscard]] f32 query(const DatabaseBeatmap* diff);
+
+// Puts a difficulty in front of the queue, e.g. because it's visible in the song browser
+void prioritize(const DatabaseBeatmap* diff);
+
+// Closest precalculated rating index to the active mods, to show while computing
+[[nodiscard]] u8 get_fallback_idx();
+
+// Must be called regularly from the main thread, publishes newly computed ratings.
+// Returns true once the queue drained since the last time (at most once per second), i.e. star ratings changed.
+[[nodiscard]] bool update_mainthread();
+
+// Stops the worker threads and drops queued work. Cached (and already computed) results are kept.
+void abort();
+
+}  // namespace AsyncStarCalc
@@ -5,6 +5,8 @@
 //   difficulty attributes are calculated once per unique parameter set
 // - Pre-calculates star ratings for 54 common mod combinations per beatmap
 //   (9 speeds x 6 mod combos: None, HR, HD, EZ, HD|HR, HD|EZ)
+// - Large beatmaps are split into independent units (one per AR/CS variant and per score group),
+//   which idle workers can steal so a single marathon map doesn't serialize the tail of the run
 
 #include "BatchDiffCalc.h"
 #include "StarPrecalc.h"
@@ -17,15 +19,21 @@
 #include "score.h"
 #include "Timing.h"
 #include "Logging.h"
+#include "Profiler.h"
 #include "Thread.h"
 #include "SyncJthread.h"
 #include "SyncStoptoken.h"
+#include "UI.h"
+#include "MainMenu.h"
 
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <optional>
 
 namespace cv {
 extern ConVar debug_pp;
+extern ConVar diffcalc_idle_all_cores;
 extern ConVar diffcalc_threads;
 }  // namespace cv
 
@@ -116,6 +124,49 @@ struct MapResult {
     i32 avg_bpm{};
 };
 
+// AR/CS/OD/HP variant: {multiplier for AR/OD/HP, multiplier for CS}
+// BASE=nomod, HR=1.4x (CS=1.3x), EZ=0.5x
+struct ArCsVariant {
+    f32 ar_od_hp_mul;
+    f32 cs_mul;
+    // mod combo indices: [hidden=false, hidden=true]
+    u8 combo_idx[2];
+};
+constexpr std::array VARIANTS{
+    ArCsVariant{1.0f, 1.0f, {0, 2}},  // BASE: None(0), HD(2)
+    ArCsVariant{1.4f, 1.3f, {1, 4}},  // HR: HR(1), HD|HR(4)
+    ArCsVariant{0.5f, 0.5f, {3, 5}},  // EZ: EZ(3), HD|EZ(5)
+};
+
+// Maps with fewer objects than this are processed entirely by the worker that loaded them
+constexpr u32 SPLIT_MIN_OBJECTS = 2000;
+
+// A beatmap being processed. Once its primitives are loaded, each AR/CS variant (if the map itself needs
+// recalculating) and each score group is an independent "unit" of work.
+struct MapJob {
+    WorkItem* item{nullptr};
+    DatabaseBeatmap::PRIMITIVE_CONTAINER primitives;
+    MapResult result;
+    std::vector<std::pair<ModParams, std::vector<ScoreWork*>>> score_groups;
+    std::atomic<u32> units_left{0};
+
+    [[nodiscard]] u32 nb_units() const {
+        return (this->item->needs_map_calc ? VARIANTS.size() : 0) + this->score_groups.size();
+    }
+};
+
+struct Subtask {
+    std::shared_ptr<MapJob> job;
+    u32 unit;
+};
+
+// Units of split maps. The owner pops from the back (the map it just loaded, still in cache),
+// other workers steal from the front once they run out of work.
+struct WorkerQueue {
+    Sync::mutex mtx;
+    std::deque<Subtask> tasks;
+};
+
 // per-thread mutable state for worker threads
 struct WorkerContext {
     std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> diffobj_cache;
@@ -143,6 +194,17 @@ Sync::mutex results_mutex;
 // owned by coordinator thread during execution
 std::vector<WorkItem> work_queue;
 std::atomic<u32> next_work_index{0};
+std::vector<std::unique_ptr<WorkerQueue>> worker_queues;
+
+// work items being loaded + subtasks that haven't finished yet
+// incremented before claiming work, so workers can only see 0 once everything is done
+std::atomic<u32> outstanding{0};
+
+// set from the main thread, lets the extra workers spawned for diffcalc_idle_all_cores run
+std::atomic<bool> idle_boost{false};
+
+// when the work queue was ready, for throughput
+std::atomic<u64> calc_start_ns{0};
 
 forceinline bool score_needs_recalc(const FinishedScore& score) {
     return score.ppv2_version < DiffCalc::PP_ALGORITHM_VERSION || (score.score > 0 && score.ppv2_score <= 0.f);
@@ -150,13 +212,11 @@ forceinline bool score_needs_recalc(const FinishedScore& score) {
 
 // Calculate difficulty and PP for a group of scores sharing mod parameters.
 void process_score_group(const BeatmapDifficulty* map, const ModParams& params, std::vector<ScoreWork*>& scores,
-                         DatabaseBeatmap::PRIMITIVE_CONTAINER& primitives, const Sync::stop_token& stoken,
+                         const DatabaseBeatmap::PRIMITIVE_CONTAINER& primitives,
+                         DatabaseBeatmap::LOAD_DIFFOBJ_RESULT& diffres, const Sync::stop_token& stoken,
                          WorkerContext& ctx) {
     if(scores.empty()) return;
 
-    auto diffres =
-        DatabaseBeatmap::loadDifficultyHitObjects(primitives, params.ar, params.cs, params.speed, false, stoken);
-    if(stoken.stop_requested()) return;
     if(diffres.error.errc) {
         const u32 item_failed_scores = scores.size();
         errored_count.fetch_add(item_failed_scores, std::memory_order_relaxed);
@@ -312,212 +372,289 @@ void build_work_queue(const Sync::stop_token& stoken) {
     std::ranges::sort(work_queue, std::ranges::less{}, [](const auto& work) { return work.scores.empty(); });
 }
 
-void process_work_item(WorkItem& item, const Sync::stop_token& stoken, WorkerContext& ctx) {
-    if(!item.map) {
-        errored_count.fetch_add(1, std::memory_order_relaxed);
-        return;
-    }
-
-    // load primitive objects once for this beatmap
-    auto primitives = DatabaseBeatmap::loadPrimitiveObjects(item.map->sFilePath, stoken);
-    if(stoken.stop_requested()) return;
+// Loads the DifficultyHitObjects a unit works on.
+DatabaseBeatmap::LOAD_DIFFOBJ_RESULT load_unit(MapJob& job, u32 unit, const Sync::stop_token& stoken) {
+    if(job.item->needs_map_calc) {
+        if(unit < VARIANTS.size()) {
+            const auto& var = VARIANTS[unit];
+            const f32 ar = std::clamp(job.item->map->getAR() * var.ar_od_hp_mul, 0.f, 10.f);
+            const f32 cs = std::clamp(job.item->map->getCS() * var.cs_mul, 0.f, 10.f);
 
-    if(primitives.error.errc) {
-        const u32 item_failed_scores = item.scores.size();
-        errored_count.fetch_add(item_failed_scores, std::memory_order_relaxed);
-        logFailure(primitives.error, "loadPrimitiveObjects map hash: {} map path: {}", item.map->getMD5(),
-                   item.map->sFilePath);
-        if(item.needs_map_calc) {
-            errored_count.fetch_add(1, std::memory_order_relaxed);
-            Sync::scoped_lock lock(results_mutex);
-            map_results.push_back(MapResult{.map = item.map});
-            maps_processed.fetch_add(1, std::memory_order_relaxed);
+            // build DifficultyHitObjects once at speed=1.0 for this AR/CS variant.
+            // object construction, sorting, and stacking are all speed-independent;
+            // only the timing fields need rescaling per speed. slider timing is
+            // calculated once (sliderTimesCalculated flag on primitives).
+            return DatabaseBeatmap::loadDifficultyHitObjects(job.primitives, ar, cs, 1.0f, false, stoken);
         }
-        scores_processed.fetch_add(item_failed_scores, std::memory_order_relaxed);
-        return;
+        unit -= VARIANTS.size();
     }
 
-    // process map calculation (multi-mod star ratings, BPM, object counts)
-    if(item.needs_map_calc) {
-        MapResult result{.map = item.map,
-                         .nb_circles = (u32)primitives.hitcircles.size(),
-                         .nb_sliders = (u32)primitives.sliders.size(),
-                         .nb_spinners = (u32)primitives.spinners.size()};
-
-        const f32 base_ar = item.map->getAR();
-        const f32 base_cs = item.map->getCS();
-        const f32 base_od = item.map->getOD();
-        const f32 base_hp = item.map->getHP();
-
-        // AR/CS/OD/HP variant: {multiplier for AR/OD/HP, multiplier for CS}
-        // BASE=nomod, HR=1.4x (CS=1.3x), EZ=0.5x
-        struct ArCsVariant {
-            f32 ar_od_hp_mul;
-            f32 cs_mul;
-            // mod combo indices: [hidden=false, hidden=true]
-            u8 combo_idx[2];
-        };
-        static constexpr std::array VARIANTS{
-            ArCsVariant{1.0f, 1.0f, {0, 2}},  // BASE: None(0), HD(2)
-            ArCsVariant{1.4f, 1.3f, {1, 4}},  // HR: HR(1), HD|HR(4)
-            ArCsVariant{0.5f, 0.5f, {3, 5}},  // EZ: EZ(3), HD|EZ(5)
-        };
-
-        for(const auto& var : VARIANTS) {
-            if(stoken.stop_requested()) return;
+    const ModParams& params = job.score_groups[unit].first;
+    return DatabaseBeatmap::loadDifficultyHitObjects(job.primitives, params.ar, params.cs, params.speed, false,
+                                                     stoken);
+}
 
-            const f32 ar = std::clamp(base_ar * var.ar_od_hp_mul, 0.f, 10.f);
-            const f32 cs = std::clamp(base_cs * var.cs_mul, 0.f, 10.f);
-            const f32 od = std::clamp(base_od * var.ar_od_hp_mul, 0.f, 10.f);
-            const f32 hp = std::clamp(base_hp * var.ar_od_hp_mul, 0.f, 10.f);
+// Calculates star ratings at every speed for one AR/CS variant.
+// Variants write to disjoint star_ratings indices, so they can run concurrently.
+void calc_variant(MapJob& job, const ArCsVariant& var, DatabaseBeatmap::LOAD_DIFFOBJ_RESULT& diffres,
+                  const Sync::stop_token& stoken, WorkerContext& ctx) {
+    const auto* map = job.item->map;
+    const f32 ar = std::clamp(map->getAR() * var.ar_od_hp_mul, 0.f, 10.f);
+    const f32 cs = std::clamp(map->getCS() * var.cs_mul, 0.f, 10.f);
+    const f32 od = std::clamp(map->getOD() * var.ar_od_hp_mul, 0.f, 10.f);
+    const f32 hp = std::clamp(map->getHP() * var.ar_od_hp_mul, 0.f, 10.f);
+
+    if(&var == &VARIANTS[0]) {
+        job.result.length_ms = diffres.playableLength;
+    }
 
-            // build DifficultyHitObjects once at speed=1.0 for this AR/CS variant.
-            // object construction, sorting, and stacking are all speed-independent;
-            // only the timing fields need rescaling per speed. slider timing is
-            // calculated once (sliderTimesCalculated flag on primitives).
-            auto diffres = DatabaseBeatmap::loadDifficultyHitObjects(primitives, ar, cs, 1.0f, false, stoken);
-            if(stoken.stop_requested()) return;
+    if(diffres.error.errc) {
+        logFailure(diffres.error, "loadDifficultyHitObjects map hash: {} map path: {}", map->getMD5(), map->sFilePath);
+        return;
+    }
 
-            if(&var == &VARIANTS[0]) {
-                result.length_ms = diffres.playableLength;
+    // save base slider timing (overwritten by speed rescaling below).
+    // baseTime/baseEndTime are already preserved on DifficultyHitObject,
+    // but spanDuration and scoringTimes have no base counterpart.
+    ctx.base_span_durations.clear();
+    ctx.base_scoring_times.clear();
+    for(const auto& obj : diffres.diffobjects) {
+        if(obj.type == DifficultyHitObject::TYPE::SLIDER) {
+            ctx.base_span_durations.push_back(obj.spanDuration);
+            for(const auto& st : obj.scoringTimes) {
+                ctx.base_scoring_times.push_back(st.time);
             }
+        }
+    }
 
-            if(diffres.error.errc) {
-                logFailure(diffres.error, "loadDifficultyHitObjects map hash: {} map path: {}", item.map->getMD5(),
-                           item.map->sFilePath);
-                continue;
-            }
+    for(u8 speed_idx = 0; speed_idx < StarPrecalc::SPEEDS_NUM; speed_idx++) {
+        if(stoken.stop_requested()) return;
+        const f32 speed = StarPrecalc::SPEEDS[speed_idx];
+        const f64 inv_speed = 1.0 / (f64)speed;
 
-            // save base slider timing (overwritten by speed rescaling below).
-            // baseTime/baseEndTime are already preserved on DifficultyHitObject,
-            // but spanDuration and scoringTimes have no base counterpart.
-            ctx.base_span_durations.clear();
-            ctx.base_scoring_times.clear();
-            for(const auto& obj : diffres.diffobjects) {
+        // rescale timing fields from base values for this speed
+        {
+            uSz si = 0, sti = 0;
+            for(auto& obj : diffres.diffobjects) {
+                obj.time = (i32)((f64)obj.baseTime * inv_speed);
+                obj.endTime = (i32)((f64)obj.baseEndTime * inv_speed);
                 if(obj.type == DifficultyHitObject::TYPE::SLIDER) {
-                    ctx.base_span_durations.push_back(obj.spanDuration);
-                    for(const auto& st : obj.scoringTimes) {
-                        ctx.base_scoring_times.push_back(st.time);
+                    obj.spanDuration = (f32)((f64)ctx.base_span_durations[si] * inv_speed);
+                    for(auto& st : obj.scoringTimes) {
+                        st.time = (f32)((f64)ctx.base_scoring_times[sti] * inv_speed);
+                        sti++;
                     }
+                    si++;
                 }
             }
+        }
 
-            for(u8 speed_idx = 0; speed_idx < StarPrecalc::SPEEDS_NUM; speed_idx++) {
-                if(stoken.stop_requested()) return;
-                const f32 speed = StarPrecalc::SPEEDS[speed_idx];
-                const f64 inv_speed = 1.0 / (f64)speed;
-
-                // rescale timing fields from base values for this speed
-                {
-                    uSz si = 0, sti = 0;
-                    for(auto& obj : diffres.diffobjects) {
-                        obj.time = (i32)((f64)obj.baseTime * inv_speed);
-                        obj.endTime = (i32)((f64)obj.baseEndTime * inv_speed);
-                        if(obj.type == DifficultyHitObject::TYPE::SLIDER) {
-                            obj.spanDuration = (f32)((f64)ctx.base_span_durations[si] * inv_speed);
-                            for(auto& st : obj.scoringTimes) {
-                                st.time = (f32)((f64)ctx.base_scoring_times[sti] * inv_speed);
-                                sti++;
-                            }
-                            si++;
-                        }
-                    }
-                }
+        // HD=0: full calculation, saving raw difficulty values
+        {
+            const u8 flat_idx = speed_idx * StarPrecalc::NUM_MOD_COMBOS + var.combo_idx[0];
+
+            DifficultyCalculator::BeatmapDiffcalcData diffcalc_data{.sortedHitObjects = diffres.diffobjects,
+                                                                    .CS = cs,
+                                                                    .HP = hp,
+                                                                    .AR = ar,
+                                                                    .OD = od,
+                                                                    .hidden = false,
+                                                                    .relax = false,
+                                                                    .autopilot = false,
+                                                                    .touchDevice = false,
+                                                                    .speedMultiplier = speed,
+                                                                    .breakDuration = job.primitives.totalBreakDuration,
+                                                                    .playableLength = diffres.playableLength};
+
+            DifficultyCalculator::DifficultyAttributes attributes{};
+            DifficultyCalculator::RawDifficultyValues raw_diff{};
+
+            DifficultyCalculator::StarCalcParams star_params{.cachedDiffObjects = std::move(ctx.diffobj_cache),
+                                                             .outAttributes = attributes,
+                                                             .beatmapData = diffcalc_data,
+                                                             .outAimStrains = nullptr,
+                                                             .outSpeedStrains = nullptr,
+                                                             .incremental = nullptr,
+                                                             .upToObjectIndex = -1,
+                                                             .cancelCheck = stoken,
+                                                             .outRawDifficulty = &raw_diff};
+
+            job.result.star_ratings[flat_idx] =
+                static_cast<f32>(DifficultyCalculator::calculateStarDiffForHitObjects(star_params));
+
+            ctx.diffobj_cache = std::move(star_params.cachedDiffObjects);
 
-                // HD=0: full calculation, saving raw difficulty values
-                {
-                    const u8 flat_idx = speed_idx * StarPrecalc::NUM_MOD_COMBOS + var.combo_idx[0];
-
-                    DifficultyCalculator::BeatmapDiffcalcData diffcalc_data{
-                        .sortedHitObjects = diffres.diffobjects,
-                        .CS = cs,
-                        .HP = hp,
-                        .AR = ar,
-                        .OD = od,
-                        .hidden = false,
-                        .relax = false,
-                        .autopilot = false,
-                        .touchDevice = false,
-                        .speedMultiplier = speed,
-                        .breakDuration = primitives.totalBreakDuration,
-                        .playableLength = diffres.playableLength};
-
-                    DifficultyCalculator::DifficultyAttributes attributes{};
-                    DifficultyCalculator::RawDifficultyValues raw_diff{};
-
-                    DifficultyCalculator::StarCalcParams star_params{.cachedDiffObjects = std::move(ctx.diffobj_cache),
-                                                                     .outAttributes = attributes,
-                                                                     .beatmapData = diffcalc_data,
-                                                                     .outAimStrains = nullptr,
-                                                                     .outSpeedStrains = nullptr,
-                                                                     .incremental = nullptr,
-                                                                     .upToObjectIndex = -1,
-                                                                     .cancelCheck = stoken,
-                                                                     .outRawDifficulty = &raw_diff};
-
-                    result.star_ratings[flat_idx] =
-                        static_cast<f32>(DifficultyCalculator::calculateStarDiffForHitObjects(star_params));
-
-                    ctx.diffobj_cache = std::move(star_params.cachedDiffObjects);
-
-                    if(stoken.stop_requested()) return;
-
-                    // HD=1: recompute star rating from cached raw difficulty values.
-                    // strains are identical (hidden only affects the final rating transform),
-                    // so we skip DiffObject construction, strain calc, and calculate_difficulty.
-                    const u8 hd_flat_idx = speed_idx * StarPrecalc::NUM_MOD_COMBOS + var.combo_idx[1];
-                    diffcalc_data.hidden = true;
-                    result.star_ratings[hd_flat_idx] =
-                        static_cast<f32>(DifficultyCalculator::recomputeStarRating(raw_diff, diffcalc_data));
-                }
+            if(stoken.stop_requested()) return;
 
-                ctx.diffobj_cache->clear();
-            }
+            // HD=1: recompute star rating from cached raw difficulty values.
+            // strains are identical (hidden only affects the final rating transform),
+            // so we skip DiffObject construction, strain calc, and calculate_difficulty.
+            const u8 hd_flat_idx = speed_idx * StarPrecalc::NUM_MOD_COMBOS + var.combo_idx[1];
+            diffcalc_data.hidden = true;
+            job.result.star_ratings[hd_flat_idx] =
+                static_cast<f32>(DifficultyCalculator::recomputeStarRating(raw_diff, diffcalc_data));
         }
 
-        if(result.star_ratings[StarPrecalc::NOMOD_1X_INDEX] <= 0.f) {
-            errored_count.fetch_add(1, std::memory_order_relaxed);
+        ctx.diffobj_cache->clear();
+    }
+}
+
+void run_unit(MapJob& job, u32 unit, DatabaseBeatmap::LOAD_DIFFOBJ_RESULT& diffres, const Sync::stop_token& stoken,
+              WorkerContext& ctx) {
+    if(job.item->needs_map_calc) {
+        if(unit < VARIANTS.size()) {
+            calc_variant(job, VARIANTS[unit], diffres, stoken, ctx);
+            return;
         }
+        unit -= VARIANTS.size();
+    }
 
-        if(stoken.stop_requested()) return;
+    auto& [params, group] = job.score_groups[unit];
+    process_score_group(job.item->map, params, group, job.primitives, diffres, stoken, ctx);
+}
 
-        if(!primitives.timingpoints.empty()) {
-            ctx.bpm_calc_buf.resize(primitives.timingpoints.size());
-            BPMInfo bpm = getBPM(primitives.timingpoints, ctx.bpm_calc_buf);
-            result.min_bpm = bpm.min;
-            result.max_bpm = bpm.max;
-            result.avg_bpm = bpm.most_common;
+// Publishes the map result once every unit is done, on whichever worker finished last.
+void finish_unit(MapJob& job, const Sync::stop_token& stoken) {
+    if(job.units_left.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    if(stoken.stop_requested()) return;
+
+    WorkItem& item = *job.item;
+    if(item.needs_map_calc) {
+        if(job.result.star_ratings[StarPrecalc::NOMOD_1X_INDEX] <= 0.f) {
+            errored_count.fetch_add(1, std::memory_order_relaxed);
         }
 
         {
             Sync::scoped_lock lock(results_mutex);
-            map_results.push_back(result);
+            map_results.push_back(job.result);
         }
         maps_processed.fetch_add(1, std::memory_order_relaxed);
     }
 
+    // free memory from processed scores
+    item.scores.clear();
+    item.scores.shrink_to_fit();
+}
+
+void run_subtask(const Subtask& task, const Sync::stop_token& stoken, WorkerContext& ctx) {
+    VPROF_TRACE("BatchDiffCalc::run_subtask");
+    if(!stoken.stop_requested()) {
+        auto diffres = load_unit(*task.job, task.unit, stoken);
+        if(!stoken.stop_requested()) {
+            run_unit(*task.job, task.unit, diffres, stoken, ctx);
+        }
+    }
+    finish_unit(*task.job, stoken);
+}
+
+void process_work_item(WorkItem& item, const Sync::stop_token& stoken, WorkerContext& ctx, WorkerQueue& own_queue) {
+    VPROF_TRACE("BatchDiffCalc::process_work_item");
+    if(!item.map) {
+        errored_count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto job = std::make_shared<MapJob>();
+    job->item = &item;
+
+    // load primitive objects once for this beatmap
+    job->primitives = DatabaseBeatmap::loadPrimitiveObjects(item.map->sFilePath, stoken);
     if(stoken.stop_requested()) return;
 
-    // process score calculations, grouped by mod parameters to share difficulty calc
-    // subsequent loadDifficultyHitObjects calls skip slider timing (sliderTimesCalculated == true)
+    const auto& primitives = job->primitives;
+    if(primitives.error.errc) {
+        const u32 item_failed_scores = item.scores.size();
+        errored_count.fetch_add(item_failed_scores, std::memory_order_relaxed);
+        logFailure(primitives.error, "loadPrimitiveObjects map hash: {} map path: {}", item.map->getMD5(),
+                   item.map->sFilePath);
+        if(item.needs_map_calc) {
+            errored_count.fetch_add(1, std::memory_order_relaxed);
+            Sync::scoped_lock lock(results_mutex);
+            map_results.push_back(MapResult{.map = item.map});
+            maps_processed.fetch_add(1, std::memory_order_relaxed);
+        }
+        scores_processed.fetch_add(item_failed_scores, std::memory_order_relaxed);
+        return;
+    }
+
+    // map calculation (multi-mod star ratings, BPM, object counts)
+    if(item.needs_map_calc) {
+        job->result = MapResult{.map = item.map,
+                                .nb_circles = (u32)primitives.hitcircles.size(),
+                                .nb_sliders = (u32)primitives.sliders.size(),
+                                .nb_spinners = (u32)primitives.spinners.size()};
+
+        if(!primitives.timingpoints.empty()) {
+            ctx.bpm_calc_buf.resize(primitives.timingpoints.size());
+            BPMInfo bpm = getBPM(primitives.timingpoints, ctx.bpm_calc_buf);
+            job->result.min_bpm = bpm.min;
+            job->result.max_bpm = bpm.max;
+            job->result.avg_bpm = bpm.most_common;
+        }
+    }
+
+    // score calculations, grouped by mod parameters to share difficulty calc
     if(!item.scores.empty()) {
         Hash::flat::map<ModParams, std::vector<ScoreWork*>, ModParamsHash> score_groups;
         for(auto& sw : item.scores) {
             score_groups[sw.params].push_back(&sw);
         }
+        job->score_groups = std::move(score_groups).extract();
+    }
+
+    const u32 nb_units = job->nb_units();
+    job->units_left.store(nb_units, std::memory_order_relaxed);
+    if(nb_units == 0) return;
+
+    // the first loadDifficultyHitObjects call calculates slider timing in the primitives,
+    // so that has to be done before they're shared with other workers
+    auto first_diffres = load_unit(*job, 0, stoken);
+    if(stoken.stop_requested()) return;
+
+    const bool split = nb_units > 1 && worker_queues.size() > 1 && primitives.sliderTimesCalculated &&
+                       primitives.getNumObjects() >= SPLIT_MIN_OBJECTS;
+    if(split) {
+        outstanding.fetch_add(nb_units - 1);
+        Sync::scoped_lock lock(own_queue.mtx);
+        for(u32 unit = 1; unit < nb_units; unit++) {
+            own_queue.tasks.push_back(Subtask{.job = job, .unit = unit});
+        }
+    }
+
+    run_unit(*job, 0, first_diffres, stoken, ctx);
+    finish_unit(*job, stoken);
 
-        for(auto& [params, group] : score_groups) {
+    if(!split) {
+        for(u32 unit = 1; unit < nb_units; unit++) {
             if(stoken.stop_requested()) return;
-            process_score_group(item.map, params, group, primitives, stoken, ctx);
+            run_subtask(Subtask{.job = job, .unit = unit}, stoken, ctx);
         }
     }
+}
 
-    // free memory from processed scores
-    item.scores.clear();
-    item.scores.shrink_to_fit();
+std::optional<Subtask> pop_own(WorkerQueue& queue) {
+    Sync::scoped_lock lock(queue.mtx);
+    if(queue.tasks.empty()) return std::nullopt;
+    Subtask task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return task;
+}
+
+std::optional<Subtask> steal(i32 thread_index) {
+    const uSz nb_queues = worker_queues.size();
+    for(uSz i = 1; i < nb_queues; i++) {
+        WorkerQueue& victim = *worker_queues[(thread_index + i) % nb_queues];
+        Sync::scoped_lock lock(victim.mtx);
+        if(victim.tasks.empty()) continue;
+        Subtask task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return task;
+    }
+    return std::nullopt;
 }
 
-void worker_fn(i32 thread_index, const Sync::stop_token& coord_stoken) {
+// idle_only: extra worker spawned for diffcalc_idle_all_cores, only takes work while idle_boost is set
+void worker_fn(i32 thread_index, bool idle_only, const Sync::stop_token& coord_stoken) {
     McThread::set_current_thread_name(fmt::format("diffcalc_{}", thread_index));
     // just use a low priority so we don't eat into main thread cpu time too much
     McThread::set_current_thread_prio(McThread::Priority::LOW);
@@ -525,18 +662,53 @@ void worker_fn(i32 thread_index, const Sync::stop_token& coord_stoken) {
     WorkerContext ctx;
     ctx.diffobj_cache = std::make_unique<std::vector<DifficultyCalculator::DiffObject>>();
 
+    WorkerQueue& own_queue = *worker_queues[thread_index];
     const u32 queue_size = work_queue.size();
-    while(!coord_stoken.stop_requested()) {
-        u32 idx = next_work_index.fetch_add(1, std::memory_order_relaxed);
-        if(idx >= queue_size) break;
+    const auto all_done = [queue_size] { return next_work_index.load() >= queue_size && outstanding.load() == 0; };
 
+    while(!coord_stoken.stop_requested()) {
         while(osu->shouldPauseBGThreads() && !coord_stoken.stop_requested()) {
             Timing::sleepMS(100);
         }
         if(coord_stoken.stop_requested()) break;
 
-        process_work_item(work_queue[idx], coord_stoken, ctx);
-        Timing::sleep(0);
+        if(idle_only && !idle_boost.load(std::memory_order_acquire)) {
+            if(all_done()) break;
+            Timing::sleepMS(100);
+            continue;
+        }
+
+        // finish units of maps we split ourselves first, then start new maps, then help with other workers' maps
+        std::optional<Subtask> task = pop_own(own_queue);
+        if(!task && next_work_index.load() < queue_size) {
+            outstanding.fetch_add(1);
+            const u32 idx = next_work_index.fetch_add(1);
+            const bool claimed = idx < queue_size;
+            if(claimed) {
+                process_work_item(work_queue[idx], coord_stoken, ctx, own_queue);
+            }
+            outstanding.fetch_sub(1);
+
+            if(claimed) {
+                Timing::sleep(0);
+                continue;
+            }
+        }
+        if(!task) {
+            task = steal(thread_index);
+        }
+
+        if(task) {
+            run_subtask(*task, coord_stoken, ctx);
+            task.reset();
+            outstanding.fetch_sub(1);
+            Timing::sleep(0);
+            continue;
+        }
+
+        // other workers are still loading maps which might get split
+        if(all_done()) break;
+        Timing::sleepMS(1);
     }
 }
 
@@ -559,6 +731,7 @@ void coordinator(const Sync::stop_token& stoken) {
 
     // determine thread count
     i32 nb_threads = 0;
+    i32 nb_idle_threads = 0;  // only working while idle in the main menu
     // if we only have a small amount of work don't even bother
     if(initial_workqueue_size < 1000) {
         nb_threads = 1;
@@ -575,16 +748,27 @@ void coordinator(const Sync::stop_token& stoken) {
         if(static_cast<u32>(nb_threads) > initial_workqueue_size) {
             nb_threads = std::max(static_cast<i32>(initial_workqueue_size), 1);
         }
+        if(cv::diffcalc_idle_all_cores.getBool()) {
+            nb_idle_threads = std::max(nb_cpus - nb_threads, 0);
+        }
     }
 
     next_work_index.store(0, std::memory_order_relaxed);
+    outstanding.store(0);
+
+    worker_queues.clear();
+    for(i32 i = 0; i < nb_threads + nb_idle_threads; i++) {
+        worker_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    calc_start_ns.store(Timing::getTicksNS(), std::memory_order_release);
 
     // spawn workers
     {
         std::vector<Sync::jthread> workers;
-        workers.reserve(nb_threads);
-        for(i32 i = 0; i < nb_threads; i++) {
-            workers.emplace_back(worker_fn, i, stoken);
+        workers.reserve(nb_threads + nb_idle_threads);
+        for(i32 i = 0; i < nb_threads + nb_idle_threads; i++) {
+            workers.emplace_back(worker_fn, i, i >= nb_threads, stoken);
         }
         // jthread destructors join all workers
     }
@@ -592,16 +776,19 @@ void coordinator(const Sync::stop_token& stoken) {
     if((!stoken.stop_requested() || is_finished()) &&
        errored_count.load(std::memory_order_relaxed) < initial_workqueue_size) {
         recalc_timer.update();
-        debugLog("DB recalculator: took {} seconds, failed to recalculate {}/{}.", recalc_timer.getDelta(),
+        debugLog("DB recalculator: took {} seconds ({:.1f} maps/s, {:.1f} scores/s), failed to recalculate {}/{}.",
+                 recalc_timer.getDelta(), get_maps_per_second(), get_scores_per_second(),
                  errored_count.load(std::memory_order_relaxed), initial_workqueue_size);
         did_work.store(true, std::memory_order_release);
     }
+    calc_start_ns.store(0, std::memory_order_release);
 
     // just in case
     maps_processed.store(get_maps_total(), std::memory_order_release);
     scores_processed.store(get_scores_total(), std::memory_order_release);
 
-    // cleanup
+    // cleanup (leftover subtasks point into the work queue)
+    worker_queues.clear();
     work_queue.clear();
     work_queue.shrink_to_fit();
 }
@@ -609,8 +796,6 @@ void coordinator(const Sync::stop_token& stoken) {
 }  // namespace
 
 void internal::flush_score_results(std::vector<ScoreResult>& pending) {
-    bool any_updated = false;
-
     Sync::unique_lock lk(db->scores_mtx);
     auto& db_scores = db->getScoresMutable();
     for(auto& res : pending) {
@@ -625,12 +810,9 @@ void internal::flush_score_results(std::vector<ScoreResult>& pending) {
             scoreIt->ppv2_total_stars = res.total_stars;
             scoreIt->ppv2_aim_stars = res.aim_stars;
             scoreIt->ppv2_speed_stars = res.speed_stars;
-            any_updated = true;
+            db->updatePlayerStats(res.score.beatmap_hash, res.score.playerName);
         }
     }
-    if(any_updated) {
-        db->scores_changed.store(true, std::memory_order_release);
-    }
 }
 
 void start_calc() {
@@ -674,6 +856,8 @@ struct {
 bool update_mainthread() {
     if(!running()) return true;
 
+    idle_boost.store(ui->getMainMenu()->isVisible(), std::memory_order_release);
+
     auto& [pending_maps, pending_scores, unique_parents]{updbuf};
 
     {
@@ -746,6 +930,20 @@ u32 get_scores_total() { return scores_total.load(std::memory_order_acquire); }
 
 u32 get_scores_processed() { return scores_processed.load(std::memory_order_acquire); }
 
+namespace {
+f64 per_second(u32 processed) {
+    const u64 start = calc_start_ns.load(std::memory_order_acquire);
+    if(start == 0) return 0.;
+
+    const u64 elapsed = Timing::getTicksNS() - start;
+    return elapsed > 0 ? (f64)processed * (f64)Timing::NS_PER_SECOND / (f64)elapsed : 0.;
+}
+}  // namespace
+
+f64 get_maps_per_second() { return per_second(get_maps_processed()); }
+
+f64 get_scores_per_second() { return per_second(get_scores_processed()); }
+
 bool running() { return workqueue_ready.load(std::memory_order_acquire) && coordinator_thread.joinable(); }
 
 bool scores_finished() {
@@ -12,6 +12,7 @@ void start_calc();
 void abort_calc();
 
 // Flush accumulated results to the database. Must be called from the main thread.
+// Also lets the extra workers from diffcalc_idle_all_cores run while the main menu is visible.
 // Returns false once when calculation is finished, signaling the caller to call abort_calc().
 [[nodiscard]] bool update_mainthread();
 
@@ -21,6 +22,10 @@ void abort_calc();
 [[nodiscard]] u32 get_scores_total();
 [[nodiscard]] u32 get_scores_processed();
 
+// Throughput since the work queue was built, 0 when not running.
+[[nodiscard]] f64 get_maps_per_second();
+[[nodiscard]] f64 get_scores_per_second();
+
 [[nodiscard]] bool running();          // is the thread still running?
 [[nodiscard]] bool scores_finished();  // are score recalculations done?
 [[nodiscard]] bool is_finished();      // is everything done?
@@ -5,18 +5,28 @@
 #include "GameRules.h"
 #include "ModFlags.h"
 
+#include <bit>
 #include <numbers>
 #include <utility>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #ifndef BUILD_TOOLS_ONLY
 #include "OsuConVars.h"
+#include "Logging.h"
 #define STARS_SLIDER_CURVE_POINTS_SEPARATION cv::stars_slider_curve_points_separation.getFloat()
 #define IGNORE_CLAMPED_SLIDERS cv::stars_ignore_clamped_sliders.getBool()
 #define SLIDER_CURVE_MAX_LENGTH cv::slider_curve_max_length.getFloat()
 #define SLIDER_END_INSIDE_CHECK_OFFSET (f64) cv::slider_end_inside_check_offset.getInt()
+#define VERIFY_STRAIN_KERNELS cv::stars_verify_strain_kernels.getBool()
 
 #define FORMAT_STRING_ fmt::format
+#define LOG_WARNING_ debugLog
 
 #define WANT_SPREADSORT
 #include "Sorting.h"
@@ -29,10 +39,12 @@
 #define IGNORE_CLAMPED_SLIDERS true
 #define SLIDER_CURVE_MAX_LENGTH 32768.f
 #define SLIDER_END_INSIDE_CHECK_OFFSET 36.
+#define VERIFY_STRAIN_KERNELS false
 
 #include <print>
 #include <algorithm>
 #define FORMAT_STRING_ std::format
+#define LOG_WARNING_(str__, ...) std::println(stderr, str__ __VA_OPT__(, ) __VA_ARGS__)
 
 #define SPREADSORT_RANGE std::ranges::sort
 
@@ -194,6 +206,257 @@ f32 DifficultyHitObject::getT(i32 pos, bool raw) const {
     }
 }
 
+namespace {  // static namespace
+
+using Skills = DifficultyCalculator::Skills;
+using DiffObject = DifficultyCalculator::DiffObject;
+
+// strainDecay() runs for every object and skill, and decays always span a whole number of milliseconds (object times
+// are integers, and so are the strain section boundaries), so the common short ones are precomputed
+constexpr uSz DECAY_TABLE_SIZE = 2048;
+
+struct DecayTable {
+    std::array<std::array<f64, DECAY_TABLE_SIZE>, Skills::NUM_SKILLS> values;
+
+    DecayTable() {
+        for(u8 type = 0; type < Skills::NUM_SKILLS; type++) {
+            for(uSz ms = 0; ms < DECAY_TABLE_SIZE; ms++) {
+                // must stay the exact same expression as the fallback in strainDecay()
+                this->values[type][ms] = std::pow(DifficultyCalculator::decay_base[type], (f64)ms / 1000.0);
+            }
+        }
+    }
+};
+
+const DecayTable decay_table;
+
+// same result as *std::max_element() for non-empty input without NaNs (up to the sign of zero)
+f64 max_value(const f64 *values, uSz count) {
+    uSz i = 0;
+    f64 result = values[0];
+
+#if defined(__SSE2__) || defined(_M_X64)
+    if(count >= 4) {
+        __m128d acc0 = _mm_loadu_pd(&values[0]);
+        __m128d acc1 = _mm_loadu_pd(&values[2]);
+        for(i = 4; i + 4 <= count; i += 4) {
+            acc0 = _mm_max_pd(acc0, _mm_loadu_pd(&values[i]));
+            acc1 = _mm_max_pd(acc1, _mm_loadu_pd(&values[i + 2]));
+        }
+        acc0 = _mm_max_pd(acc0, acc1);
+        result = _mm_cvtsd_f64(_mm_max_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    if(count >= 4) {
+        float64x2_t acc0 = vld1q_f64(&values[0]);
+        float64x2_t acc1 = vld1q_f64(&values[2]);
+        for(i = 4; i + 4 <= count; i += 4) {
+            acc0 = vmaxq_f64(acc0, vld1q_f64(&values[i]));
+            acc1 = vmaxq_f64(acc1, vld1q_f64(&values[i + 2]));
+        }
+        result = vmaxvq_f64(vmaxq_f64(acc0, acc1));
+    }
+#endif
+
+    for(; i < count; i++) {
+        result = std::max(result, values[i]);
+    }
+    return result;
+}
+
+constexpr f64 STRAIN_SECTION_LENGTH = 400.0;
+
+// skip calculating strain decay for very long breaks (e.g. beatmap upload size limit hack diffs)
+// strainDecay with a base of 0.3 at 60 seconds is 4.23911583e-32, well below any meaningful difference even after being multiplied by object strain
+constexpr f64 STRAIN_DECAY_CUTOFF_MS = 600000.0;
+
+// one strain section of a full calculation: its peak is the largest of the decayed strain it starts with and the
+// strains of the objects [begin, end) inside it (empty for sections within breaks)
+struct StrainSection {
+    u32 begin;
+    u32 end;
+    i32 decay_from;  // object whose strain decays into this section, -1 to start at 0
+    f64 decay_ms;
+};
+
+// The values calculate_difficulty() reads for every object, copied out of the (~200 byte) DiffObjects into contiguous
+// per-skill arrays once all strains are known. The section boundaries only depend on object times, so they are split
+// up once here for all skills. Reused between calculations on the same thread.
+struct StrainColumns {
+    std::vector<i32> times;
+    std::vector<u8> is_slider;
+    std::array<std::vector<f64>, Skills::NUM_SKILLS> strains;         // get_strain()
+    std::array<std::vector<f64>, Skills::NUM_SKILLS> slider_strains;  // get_slider_strain()
+    std::vector<StrainSection> sections;
+
+    void gather(const DiffObject *dobjects, uSz count) {
+        this->times.resize(count);
+        this->is_slider.resize(count);
+        for(uSz i = 0; i < count; i++) {
+            this->times[i] = dobjects[i].ho->time;
+            this->is_slider[i] = dobjects[i].ho->type == DifficultyHitObject::TYPE::SLIDER;
+        }
+
+        // same boundaries as the per-object loop in calculate_difficulty()
+        this->sections.clear();
+        if(count > 0) {
+            f64 interval_end = std::ceil((f64)this->times[0] / STRAIN_SECTION_LENGTH) * STRAIN_SECTION_LENGTH;
+            StrainSection section{.begin = 0, .end = 0, .decay_from = -1, .decay_ms = 0.0};
+            for(uSz i = 0; i < count; i++) {
+                const uSz prev = i > 0 ? i - 1 : i;
+                while(this->times[i] > interval_end) {
+                    section.end = (u32)i;
+                    this->sections.push_back(section);
+
+                    const f64 strainDelta = interval_end - (f64)this->times[prev];
+                    const bool decays = i > 0 && strainDelta <= STRAIN_DECAY_CUTOFF_MS;
+                    section = {.begin = (u32)i, .end = (u32)i, .decay_from = decays ? (i32)prev : -1,
+                               .decay_ms = strainDelta};
+
+                    interval_end += STRAIN_SECTION_LENGTH;
+                }
+            }
+            section.end = (u32)count;
+            this->sections.push_back(section);
+        }
+
+        for(u8 type = 0; type < Skills::NUM_SKILLS; type++) {
+            auto &strains = this->strains[type];
+            auto &slider_strains = this->slider_strains[type];
+            strains.resize(count);
+            slider_strains.resize(count);
+            for(uSz i = 0; i < count; i++) {
+                strains[i] = dobjects[i].get_strain((Skills::Skill)type);
+                slider_strains[i] = this->is_slider[i] ? strains[i] : -1.0;
+            }
+        }
+    }
+};
+
+thread_local StrainColumns strain_columns;
+
+// strain views for DiffObject::calculate_difficulty()
+
+// reads the DiffObjects directly, used for incremental calculations (which only look at the last object)
+struct ObjectView {
+    const DiffObject *dobjects;
+    Skills::Skill type;
+
+    [[nodiscard]] i32 time(uSz i) const { return this->dobjects[i].ho->time; }
+    [[nodiscard]] bool is_slider(uSz i) const {
+        return this->dobjects[i].ho->type == DifficultyHitObject::TYPE::SLIDER;
+    }
+    [[nodiscard]] f64 strain(uSz i) const { return this->dobjects[i].get_strain(this->type); }
+    [[nodiscard]] f64 slider_strain(uSz i) const { return this->dobjects[i].get_slider_strain(this->type); }
+    [[nodiscard]] f64 decay(f64 ms) const { return DiffObject::strainDecay(this->type, ms); }
+
+    [[nodiscard]] f64 max_strain(uSz count) const {
+        return std::max_element(this->dobjects, this->dobjects + count,
+                                [this](const DiffObject &x, const DiffObject &y) {
+                                    return x.get_strain(this->type) < y.get_strain(this->type);
+                                })
+            ->get_strain(this->type);
+    }
+    [[nodiscard]] f64 max_slider_strain(uSz count) const {
+        return std::max_element(this->dobjects, this->dobjects + count,
+                                [this](const DiffObject &x, const DiffObject &y) {
+                                    return x.get_slider_strain(this->type) < y.get_slider_strain(this->type);
+                                })
+            ->get_slider_strain(this->type);
+    }
+};
+
+// the original scalar path, for stars_verify_strain_kernels
+struct ReferenceView : ObjectView {
+    [[nodiscard]] f64 decay(f64 ms) const {
+        return std::pow(DifficultyCalculator::decay_base[this->type], ms / 1000.0);
+    }
+};
+
+// reads gathered StrainColumns, used for full calculations
+struct ColumnView {
+    const StrainColumns &columns;
+    Skills::Skill type;
+
+    [[nodiscard]] i32 time(uSz i) const { return this->columns.times[i]; }
+    [[nodiscard]] bool is_slider(uSz i) const { return this->columns.is_slider[i]; }
+    [[nodiscard]] f64 strain(uSz i) const { return this->columns.strains[this->type][i]; }
+    [[nodiscard]] f64 slider_strain(uSz i) const { return this->columns.slider_strains[this->type][i]; }
+    [[nodiscard]] f64 decay(f64 ms) const { return DiffObject::strainDecay(this->type, ms); }
+
+    [[nodiscard]] f64 max_strain(uSz count) const { return max_value(this->columns.strains[this->type].data(), count); }
+    [[nodiscard]] f64 max_slider_strain(uSz count) const {
+        return max_value(this->columns.slider_strains[this->type].data(), count);
+    }
+
+    // peak strain of every section, in time order
+    void section_peaks(std::vector<f64> &out) const {
+        const f64 *strains = this->columns.strains[this->type].data();
+
+        out.resize(this->columns.sections.size());
+        for(uSz i = 0; i < out.size(); i++) {
+            const StrainSection &section = this->columns.sections[i];
+            f64 peak = section.decay_from < 0 ? 0.0 : strains[section.decay_from] * this->decay(section.decay_ms);
+            if(section.end > section.begin)
+                peak = std::max(peak, max_value(&strains[section.begin], section.end - section.begin));
+            out[i] = peak;
+        }
+    }
+};
+
+bool bitwise_equal(f64 a, f64 b) { return std::bit_cast<u64>(a) == std::bit_cast<u64>(b); }
+
+// reruns the original scalar path over the DiffObjects, and logs anything that isn't bit-identical to what the column
+// path produced
+void verifyStrainKernels(Skills::Skill type, const DiffObject *dobjects, uSz count, f64 result,
+                         const std::vector<f64> *outStrains,
+                         const DifficultyCalculator::DifficultyAttributes &attributesBefore,
+                         const DifficultyCalculator::DifficultyAttributes &attributes) {
+    static constexpr const char *skillNames[Skills::NUM_SKILLS] = {"speed", "aim", "aim (no sliders)"};
+
+    DifficultyCalculator::DifficultyAttributes reference = attributesBefore;
+    std::vector<f64> referenceStrains;
+    const f64 referenceResult = DiffObject::calculate_difficulty(
+        ReferenceView{{dobjects, type}}, type, count, nullptr, outStrains ? &referenceStrains : nullptr, &reference);
+
+    const auto check = [&](const char *name, f64 value, f64 expected) {
+        if(!bitwise_equal(value, expected)) {
+            LOG_WARNING_("strain kernel mismatch ({:s}, {:d} objects): {:s} = {} (reference {})", skillNames[type],
+                         count, name, value, expected);
+        }
+    };
+
+    check("difficulty", result, referenceResult);
+    check("SpeedNoteCount", attributes.SpeedNoteCount, reference.SpeedNoteCount);
+    check("AimDifficultSliderCount", attributes.AimDifficultSliderCount, reference.AimDifficultSliderCount);
+    check("SpeedDifficultStrainCount", attributes.SpeedDifficultStrainCount, reference.SpeedDifficultStrainCount);
+    check("AimDifficultStrainCount", attributes.AimDifficultStrainCount, reference.AimDifficultStrainCount);
+    check("SpeedTopWeightedSliderFactor", attributes.SpeedTopWeightedSliderFactor,
+          reference.SpeedTopWeightedSliderFactor);
+    check("AimTopWeightedSliderFactor", attributes.AimTopWeightedSliderFactor, reference.AimTopWeightedSliderFactor);
+
+    if(outStrains) {
+        if(outStrains->size() != referenceStrains.size()) {
+            LOG_WARNING_("strain kernel mismatch ({:s}, {:d} objects): {:d} strain sections (reference {:d})",
+                         skillNames[type], count, outStrains->size(), referenceStrains.size());
+        } else {
+            for(uSz i = 0; i < referenceStrains.size(); i++) {
+                check("strain section", (*outStrains)[i], referenceStrains[i]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+f64 DifficultyCalculator::DiffObject::strainDecay(Skills::Skill type, f64 ms) {
+    if(ms >= 0.0 && ms < (f64)DECAY_TABLE_SIZE) {
+        const auto index = (uSz)ms;
+        if((f64)index == ms) return decay_table.values[type][index];
+    }
+    return std::pow(decay_base[type], ms / 1000.0);
+}
+
 f64 DifficultyCalculator::calculateStarDiffForHitObjects(StarCalcParams &params) {
     // NOTE: upToObjectIndex is applied way below, during the construction of the 'dobjects'
 
@@ -454,13 +717,29 @@ f64 DifficultyCalculator::calculateStarDiffForHitObjects(StarCalcParams &params)
     }
 
     // calculate final difficulty (weigh strains)
-    f64 aimNoSliders = DiffObject::calculate_difficulty(
-        Skills::AIM_NO_SLIDERS, diffObjects, numDiffObjects,
-        params.incremental ? &params.incremental[Skills::AIM_NO_SLIDERS] : nullptr, nullptr, &params.outAttributes);
+    // full calculations read every object (several times), so they go through contiguous copies of the strains
+    if(!params.incremental) strain_columns.gather(diffObjects, numDiffObjects);
+
+    const bool verifyKernels = !params.incremental && VERIFY_STRAIN_KERNELS;
+    const auto calculateSkill = [&](Skills::Skill type, std::vector<f64> *outStrains) -> f64 {
+        if(params.incremental) {
+            return DiffObject::calculate_difficulty(type, diffObjects, numDiffObjects, &params.incremental[type],
+                                                    outStrains, &params.outAttributes);
+        }
+
+        const DifficultyAttributes attributesBefore = params.outAttributes;
+        const f64 result = DiffObject::calculate_difficulty(ColumnView{strain_columns, type}, type, numDiffObjects,
+                                                            nullptr, outStrains, &params.outAttributes);
+        if(verifyKernels) {
+            verifyStrainKernels(type, diffObjects, numDiffObjects, result, outStrains, attributesBefore,
+                                params.outAttributes);
+        }
+        return result;
+    };
+
+    f64 aimNoSliders = calculateSkill(Skills::AIM_NO_SLIDERS, nullptr);
 
-    f64 speed = DiffObject::calculate_difficulty(Skills::SPEED, diffObjects, numDiffObjects,
-                                                 params.incremental ? &params.incremental[Skills::SPEED] : nullptr,
-                                                 params.outSpeedStrains, &params.outAttributes);
+    f64 speed = calculateSkill(Skills::SPEED, params.outSpeedStrains);
 
     // Very important hack (because otherwise I have to rewrite how to `DiffObject::calculate_difficulty` works):
     // At this point params.outAttributes `AimDifficultStrains` and `AimTopWeightedSlidersFactor` are calculated on aimNoSliders, what is exactly what we need here
@@ -474,9 +753,7 @@ f64 DifficultyCalculator::calculateStarDiffForHitObjects(StarCalcParams &params)
                                                          params.outAttributes.SpeedTopWeightedSliderFactor);
 
     // Don't move this aim above, it's intended, read previous comments
-    f64 aim = DiffObject::calculate_difficulty(Skills::AIM_SLIDERS, diffObjects, numDiffObjects,
-                                               params.incremental ? &params.incremental[Skills::AIM_SLIDERS] : nullptr,
-                                               params.outAimStrains, &params.outAttributes);
+    f64 aim = calculateSkill(Skills::AIM_SLIDERS, params.outAimStrains);
 
     params.outAttributes.SliderFactor =
         aim > 0.0 ? calculateDifficultyRating(aimNoSliders) / calculateDifficultyRating(aim) : 1.0;
@@ -1346,63 +1623,81 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
                                                            uSz dobjectCount, IncrementalState *incremental,
                                                            std::vector<f64> *outStrains,
                                                            DifficultyAttributes *outAttributes) {
+    return calculate_difficulty(ObjectView{dobjects, type}, type, dobjectCount, incremental, outStrains,
+                                outAttributes);
+}
+
+template <typename StrainView>
+f64 DifficultyCalculator::DiffObject::calculate_difficulty(const StrainView &view, const Skills::Skill type,
+                                                           uSz dobjectCount, IncrementalState *incremental,
+                                                           std::vector<f64> *outStrains,
+                                                           DifficultyAttributes *outAttributes) {
     // (old) see https://github.com/ppy/osu/blob/master/osu.Game/Rulesets/Difficulty/Skills/Skill.cs
     // (new) see https://github.com/ppy/osu/blob/master/osu.Game/Rulesets/Difficulty/Skills/StrainSkill.cs
 
-    static constexpr f64 strain_step = 400.0;  // the length of each strain section
+    static constexpr f64 strain_step = STRAIN_SECTION_LENGTH;  // the length of each strain section
     static constexpr f64 decay_weight =
         0.9;  // max strains are weighted from highest to lowest, and this is how much the weight decays.
 
     if(dobjectCount < 1) return 0.0;
 
-    f64 interval_end =
-        incremental ? incremental->interval_end : (std::ceil((f64)dobjects[0].ho->time / strain_step) * strain_step);
-    f64 max_strain = incremental ? incremental->max_strain : 0.0;
+    // the first incremental step starts from scratch, like a full calculation
+    if(incremental && dobjectCount == 1) {
+        *incremental = {};
+        incremental->interval_end = std::ceil((f64)view.time(0) / strain_step) * strain_step;
+    }
 
     std::vector<f64> highestStrains;
-    std::vector<f64> *highestStrainsRef = incremental ? &incremental->highest_strains : &highestStrains;
-    std::vector<f64> sliderStrains;
-    std::vector<f64> *sliderStrainsRef = incremental ? &incremental->slider_strains : &sliderStrains;
-    for(uSz i = (incremental ? dobjectCount - 1 : 0); i < dobjectCount; i++) {
-        const DiffObject &cur = dobjects[i];
-        const DiffObject &prev = dobjects[i > 0 ? i - 1 : i];
-
-        // make previous peak strain decay until the current object
-        while(cur.ho->time > interval_end) {
-            if(incremental)
-                highestStrainsRef->insert(std::ranges::upper_bound(*highestStrainsRef, max_strain), max_strain);
-            else
-                highestStrainsRef->push_back(max_strain);
+    if constexpr(requires { view.section_peaks(highestStrains); }) {
+        // full calculation over StrainColumns (never incremental), the sections were already split up by gather()
+        view.section_peaks(highestStrains);
+    } else {
+        f64 interval_end =
+            incremental ? incremental->interval_end : (std::ceil((f64)view.time(0) / strain_step) * strain_step);
+        f64 max_strain = incremental ? incremental->max_strain : 0.0;
+
+        std::vector<f64> *highestStrainsRef = incremental ? &incremental->highest_strains : &highestStrains;
+        std::vector<f64> sliderStrains;
+        std::vector<f64> *sliderStrainsRef = incremental ? &incremental->slider_strains : &sliderStrains;
+        for(uSz i = (incremental ? dobjectCount - 1 : 0); i < dobjectCount; i++) {
+            const uSz prev = i > 0 ? i - 1 : i;
+
+            // make previous peak strain decay until the current object
+            while(view.time(i) > interval_end) {
+                if(incremental)
+                    highestStrainsRef->insert(std::ranges::upper_bound(*highestStrainsRef, max_strain), max_strain);
+                else
+                    highestStrainsRef->push_back(max_strain);
 
-            // skip calculating strain decay for very long breaks (e.g. beatmap upload size limit hack diffs)
-            // strainDecay with a base of 0.3 at 60 seconds is 4.23911583e-32, well below any meaningful difference even after being multiplied by object strain
-            f64 strainDelta = interval_end - (f64)prev.ho->time;
-            if(i < 1 || strainDelta > 600000.0)  // !prev
-                max_strain = 0.0;
-            else
-                max_strain = prev.get_strain(type) * strainDecay(type, strainDelta);
+                f64 strainDelta = interval_end - (f64)view.time(prev);
+                if(i < 1 || strainDelta > STRAIN_DECAY_CUTOFF_MS)  // !prev
+                    max_strain = 0.0;
+                else
+                    max_strain = view.strain(prev) * view.decay(strainDelta);
 
-            interval_end += strain_step;
-        }
+                interval_end += strain_step;
+            }
 
-        // calculate max strain for this interval
-        f64 cur_strain = cur.get_strain(type);
-        max_strain = std::max(max_strain, cur_strain);
+            // calculate max strain for this interval
+            f64 cur_strain = view.strain(i);
+            max_strain = std::max(max_strain, cur_strain);
 
-        // NOTE: this is done in StrainValueAt in lazer's code, but doing it here is more convenient for the incremental case
-        if(type == Skills::AIM_SLIDERS && cur.ho->type == DifficultyHitObject::TYPE::SLIDER)
-            sliderStrainsRef->push_back(cur_strain);
-    }
+            // NOTE: this is done in StrainValueAt in lazer's code, but doing it here is more convenient for the incremental case
+            if(type == Skills::AIM_SLIDERS && view.is_slider(i))
+                sliderStrainsRef->push_back(cur_strain);
+        }
 
-    // the peak strain will not be saved for the last section in the above loop
-    if(incremental) {
-        incremental->interval_end = interval_end;
-        incremental->max_strain = max_strain;
-        highestStrains.reserve(incremental->highest_strains.size() + 1);  // required so insert call doesn't reallocate
-        highestStrains = incremental->highest_strains;
-        highestStrains.insert(std::ranges::upper_bound(highestStrains, max_strain), max_strain);
-    } else
-        highestStrains.push_back(max_strain);
+        // the peak strain will not be saved for the last section in the above loop
+        if(incremental) {
+            incremental->interval_end = interval_end;
+            incremental->max_strain = max_strain;
+            // required so insert call doesn't reallocate
+            highestStrains.reserve(incremental->highest_strains.size() + 1);
+            highestStrains = incremental->highest_strains;
+            highestStrains.insert(std::ranges::upper_bound(highestStrains, max_strain), max_strain);
+        } else
+            highestStrains.push_back(max_strain);
+    }
 
     if(outStrains != nullptr) (*outStrains) = highestStrains;  // save a copy
 
@@ -1410,18 +1705,12 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
         if(type == Skills::SPEED) {
             // calculate relevant speed note count
             // RelevantNoteCount @ https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Difficulty/Skills/Speed.cs
-            static constexpr auto compareDiffObjects = +[](const DiffObject &x, const DiffObject &y) -> bool {
-                return (x.get_strain(Skills::SPEED) < y.get_strain(Skills::SPEED));
-            };
-
             f64 maxObjectStrain;
             {
                 if(incremental)
-                    maxObjectStrain =
-                        std::max(incremental->max_object_strain, dobjects[dobjectCount - 1].get_strain(type));
+                    maxObjectStrain = std::max(incremental->max_object_strain, view.strain(dobjectCount - 1));
                 else
-                    maxObjectStrain =
-                        (*std::max_element(dobjects, dobjects + dobjectCount, compareDiffObjects)).get_strain(type);
+                    maxObjectStrain = view.max_strain(dobjectCount);
             }
 
             if(maxObjectStrain == 0.0)
@@ -1430,13 +1719,11 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
                 f64 tempSum = 0.0;
                 if(incremental && std::abs(incremental->max_object_strain - maxObjectStrain) < DIFFCALC_EPSILON) {
                     incremental->speed_note_count +=
-                        1.0 / (1.0 + std::exp(-((dobjects[dobjectCount - 1].get_strain(type) / maxObjectStrain * 12.0) -
-                                                6.0)));
+                        1.0 / (1.0 + std::exp(-((view.strain(dobjectCount - 1) / maxObjectStrain * 12.0) - 6.0)));
                     tempSum = incremental->speed_note_count;
                 } else {
                     for(uSz i = 0; i < dobjectCount; i++) {
-                        tempSum +=
-                            1.0 / (1.0 + std::exp(-((dobjects[i].get_strain(type) / maxObjectStrain * 12.0) - 6.0)));
+                        tempSum += 1.0 / (1.0 + std::exp(-((view.strain(i) / maxObjectStrain * 12.0) - 6.0)));
                     }
 
                     if(incremental) {
@@ -1449,22 +1736,17 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
         } else if(type == Skills::AIM_SLIDERS) {
             // calculate difficult sliders
             // GetDifficultSliders @ https://github.com/ppy/osu/blob/master/osu.Game.Rulesets.Osu/Difficulty/Skills/Aim.cs
-            static constexpr auto compareSliderObjects = +[](const DiffObject &x, const DiffObject &y) -> bool {
-                return (x.get_slider_strain(Skills::AIM_SLIDERS) < y.get_slider_strain(Skills::AIM_SLIDERS));
-            };
-
-            if(incremental && dobjects[dobjectCount - 1].ho->type != DifficultyHitObject::TYPE::SLIDER)
+            if(incremental && !view.is_slider(dobjectCount - 1))
                 outAttributes->AimDifficultSliderCount = incremental->aim_difficult_slider_count;
             else {
                 f64 maxSliderStrain;
-                f64 curSliderStrain = incremental ? dobjects[dobjectCount - 1].strains[Skills::AIM_SLIDERS] : 0.0;
+                f64 curSliderStrain = incremental ? view.strain(dobjectCount - 1) : 0.0;
                 {
-                    if(incremental) {
-                        incremental->slider_strains.push_back(curSliderStrain);
+                    // (the strain was already added to incremental->slider_strains above)
+                    if(incremental)
                         maxSliderStrain = std::max(incremental->max_slider_strain, curSliderStrain);
-                    } else
-                        maxSliderStrain = (*std::max_element(dobjects, dobjects + dobjectCount, compareSliderObjects))
-                                              .get_slider_strain(Skills::AIM_SLIDERS);
+                    else
+                        maxSliderStrain = view.max_slider_strain(dobjectCount);
                 }
 
                 if(maxSliderStrain <= 0.0)
@@ -1484,7 +1766,7 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
                             incremental->aim_difficult_slider_count = tempSum;
                         } else {
                             for(uSz i = 0; i < dobjectCount; i++) {
-                                f64 sliderStrain = dobjects[i].get_slider_strain(Skills::AIM_SLIDERS);
+                                f64 sliderStrain = view.slider_strain(i);
                                 if(sliderStrain >= 0.0)
                                     tempSum += 1.0 / (1.0 + std::exp(-((sliderStrain / maxSliderStrain * 12.0) - 6.0)));
                             }
@@ -1574,11 +1856,10 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
 
             if(incremental && std::abs(incremental->consistent_top_strain - consistentTopStrain) < DIFFCALC_EPSILON) {
                 incremental->difficult_strains +=
-                    1.1 / (1.0 + std::exp(-10.0 *
-                                          (dobjects[dobjectCount - 1].get_strain(type) / consistentTopStrain - 0.88)));
+                    1.1 / (1.0 + std::exp(-10.0 * (view.strain(dobjectCount - 1) / consistentTopStrain - 0.88)));
                 tempTotalSum = incremental->difficult_strains;
 
-                f64 sliderStrain = dobjects[dobjectCount - 1].get_slider_strain(type);
+                f64 sliderStrain = view.slider_strain(dobjectCount - 1);
                 if(sliderStrain >= 0) {
                     incremental->top_weighted_sliders +=
                         1.1 / (1.0 + std::exp(-10.0 * (sliderStrain / consistentTopStrain - 0.88)));
@@ -1586,10 +1867,9 @@ f64 DifficultyCalculator::DiffObject::calculate_difficulty(const Skills::Skill t
                 tempSliderSum = incremental->top_weighted_sliders;
             } else {
                 for(uSz i = 0; i < dobjectCount; i++) {
-                    tempTotalSum +=
-                        1.1 / (1.0 + std::exp(-10.0 * (dobjects[i].get_strain(type) / consistentTopStrain - 0.88)));
+                    tempTotalSum += 1.1 / (1.0 + std::exp(-10.0 * (view.strain(i) / consistentTopStrain - 0.88)));
 
-                    f64 sliderStrain = dobjects[i].get_slider_strain(type);
+                    f64 sliderStrain = view.slider_strain(i);
                     if(sliderStrain >= 0)
                         tempSliderSum += 1.1 / (1.0 + std::exp(-10.0 * (sliderStrain / consistentTopStrain - 0.88)));
                 }
@@ -278,7 +278,8 @@ class DifficultyCalculator {
         }
 
         inline static f64 applyDiminishingExp(f64 val) { return std::pow(val, 0.99); }
-        inline static f64 strainDecay(Skills::Skill type, f64 ms) { return std::pow(decay_base[type], ms / 1000.0); }
+        // std::pow(decay_base[type], ms / 1000.0), looked up for short whole-millisecond decays
+        static f64 strainDecay(Skills::Skill type, f64 ms);
 
         void calculate_strains(const DiffObject &prev, const DiffObject *next, f64 hitWindow300, bool autopilotNerf);
         void calculate_strain(const DiffObject &prev, const DiffObject *next, f64 hitWindow300, bool autopilotNerf,
@@ -286,6 +287,11 @@ class DifficultyCalculator {
         static f64 calculate_difficulty(const Skills::Skill type, const DiffObject *dobjects, uSz dobjectCount,
                                         IncrementalState *incremental, std::vector<f64> *outStrains = nullptr,
                                         DifficultyAttributes *outAttributes = nullptr);
+        // same as above, reading the strains through a view (see DifficultyCalculator.cpp)
+        template <typename StrainView>
+        static f64 calculate_difficulty(const StrainView &view, const Skills::Skill type, uSz dobjectCount,
+                                        IncrementalState *incremental, std::vector<f64> *outStrains,
+                                        DifficultyAttributes *outAttributes);
 
         f64 spacing_weight2(const Skills::Skill diff_type, const DiffObject &prev, const DiffObject *next,
                             f64 hitWindow300, bool autopilotNerf);
@@ -7,24 +7,63 @@
 #include "BeatmapInterface.h"
 #include "DifficultyCalculator.h"
 #include "uwu.h"
-#include "ConVar.h"
+#include "OsuConVars.h"
 
-namespace cv {
-extern ConVar debug_pp;
-}
+#include <atomic>
+#include <memory>
 
 struct LivePPCalc::LivePPCalcImpl {
     NOCOPY_NOMOVE(LivePPCalcImpl);
 
    public:
-    struct LazyPPRes {  // to know what we are actually up-to-date with
-        AsyncPPC::pp_res res{};
+    // everything the difficulty depends on, anything else only affects the pp calculation
+    struct CalcKey {
+        std::string osufile_path;
+        f32 CS, AR, HP, OD;
+        f32 speed_multiplier;
+        bool hidden, relax, autopilot, touch_device;
+
+        bool operator==(const CalcKey &) const = default;
+    };
+
+    // difficulty of the map cut off after each object
+    struct PrefixEntry {
+        DifficultyCalculator::DifficultyAttributes attributes{};
+        f64 total_stars{0.0};
+        u32 max_combo{0};
+    };
+
+    struct PrefixTable {
+        CalcKey key;
+        std::vector<PrefixEntry> entries;  // sized before the first entry is published
+        std::atomic<i32> num_ready{0};     // entries [0, num_ready) are final
+        std::atomic<bool> cancelled{false};
+    };
+
+    uwu::lazy_promise<std::function<bool()>> m_calc_inst{false};
+
+    // full calculation up to a single object, for when AR/CS change during the map and no table can be shared
+    struct FullCalcResult {
+        PrefixEntry entry{};
+        f32 AR{0.f}, OD{0.f};
         i32 calc_index{-1};
     };
-    uwu::lazy_promise<std::function<LazyPPRes()>> m_calc_inst{{}};
+
+    // only accessed async, to avoid reloading the map unless something changes
+    // declared before m_full_calc_inst so that it outlives the worker thread
+    struct FullCalcCache {
+        CalcKey key{};
+        DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffres{};
+        std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> diffobj_cache{
+            std::make_unique<std::vector<DifficultyCalculator::DiffObject>>()};
+    } m_full_calc_cache;
+    uwu::lazy_promise<std::function<FullCalcResult()>> m_full_calc_inst{{}};
 
     BeatmapInterface *m_bmi;  // parent instance
 
+    // filled in by m_calc_inst, in object order
+    std::shared_ptr<PrefixTable> m_table;
+
     f32 m_live_stars{0.f};
     f32 m_live_pp{0.f};
 
@@ -34,15 +73,6 @@ struct LivePPCalc::LivePPCalcImpl {
     bool m_calculated_valid{false};
     bool m_queued_valid{false};
 
-    inline void update_calc_res(i32 curIdx, const LazyPPRes &resPair) {
-        m_calculated_valid = (resPair.calc_index == curIdx);
-        m_last_calculated = resPair.calc_index;
-
-        m_live_pp = resPair.res.pp;
-        m_live_stars = resPair.res.total_stars;
-    }
-    inline void update_queued_idx(i32 queuedIdx) { m_last_queued = queuedIdx; }
-
     [[nodiscard]] inline bool needs_update(i32 curIdx) const {
         return !m_calculated_valid || (curIdx != m_last_calculated && curIdx >= 0);
     }
@@ -53,50 +83,135 @@ struct LivePPCalc::LivePPCalcImpl {
         return was_invalid || (curIdx != m_last_queued && curIdx >= 0);
     }
 
-    // only accessed async
-    struct LazyCalcParamCache {
-        std::string path{""};
-        f32 AR{0.f}, CS{0.f};
-        f32 speed_multiplier{0.f};
-        DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffres{};
-        std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> diffobj_cache{
-            std::make_unique<std::vector<DifficultyCalculator::DiffObject>>()};
-    } m_param_cache;
+    // these mods animate AR/CS with the music position, so the difficulty up to an object isn't fixed
+    [[nodiscard]] static inline bool difficulty_varies_over_time() {
+        return cv::mod_artimewarp.getBool() || cv::mod_arwobble.getBool() || cv::mod_minimize.getBool();
+    }
 
-    struct LazyCalcParams {
-        std::string osufile_path;
-        u64 legacy_total_score;
-        f32 CS, AR, HP, OD;
-        f32 speed_multiplier;
-        int current_hitobject;
-        int nb_circles, nb_sliders, nb_spinners;
-        int highest_combo, nb_misses;
-        int nb_300s, nb_100s, nb_50s;
-        Replay::Mods mods;
-
-        // to avoid rebuilding diffres unless something changes
-        [[nodiscard]] LazyCalcParamCache &get_latest_cached(LazyCalcParamCache &c) const {
-            // rebuild as necessary
-            if(c.path != this->osufile_path || c.AR != this->AR || c.CS != this->CS ||
-               c.speed_multiplier != this->speed_multiplier) {
-                c.path = this->osufile_path;
-                c.AR = this->AR;
-                c.CS = this->CS;
-                c.speed_multiplier = this->speed_multiplier;
-                // get new diffres
-                c.diffobj_cache->clear();
-                c.diffres = DatabaseBeatmap::loadDifficultyHitObjects(this->osufile_path, this->AR, this->CS,
-                                                                      this->speed_multiplier);
-            }
-            return c;
+    // only static while difficulty_varies_over_time() is false, otherwise AR/CS are the values at the current time
+    [[nodiscard]] CalcKey current_key(const LiveScore &score) const {
+        const ModFlags mods = score.mods.flags;
+        return {
+            .osufile_path = m_bmi->beatmap ? m_bmi->beatmap->getFilePath() : "",
+            .CS = m_bmi->getCS(),
+            .AR = m_bmi->getAR(),
+            .HP = m_bmi->getHP(),
+            .OD = m_bmi->getOD(),
+            .speed_multiplier = m_bmi->getSpeedMultiplier(),
+            .hidden = flags::has<ModFlags::Hidden>(mods),
+            .relax = flags::has<ModFlags::Relax>(mods),
+            .autopilot = flags::has<ModFlags::Autopilot>(mods),
+            .touch_device = flags::has<ModFlags::TouchDevice>(mods),
+        };
+    }
+
+    [[nodiscard]] static DifficultyCalculator::BeatmapDiffcalcData make_diffcalc_data(
+        const CalcKey &key, DatabaseBeatmap::LOAD_DIFFOBJ_RESULT &diffres) {
+        return {.sortedHitObjects = diffres.diffobjects,
+                .CS = key.CS,
+                .HP = key.HP,
+                .AR = key.AR,
+                .OD = key.OD,
+                .hidden = key.hidden,
+                .relax = key.relax,
+                .autopilot = key.autopilot,
+                .touchDevice = key.touch_device,
+                .speedMultiplier = key.speed_multiplier,
+                .breakDuration = diffres.totalBreakDuration,
+                .playableLength = diffres.playableLength};
+    }
+
+    // runs on the m_calc_inst thread
+    // every object only costs one incremental step, instead of a full calculation up to it
+    static bool fill_prefix_table(const std::shared_ptr<PrefixTable> &table) {
+        const CalcKey &key = table->key;
+        if(key.osufile_path.empty()) return false;
+
+        DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffres =
+            DatabaseBeatmap::loadDifficultyHitObjects(key.osufile_path, key.AR, key.CS, key.speed_multiplier);
+        if(diffres.error.errc) return false;  // uh-oh
+
+        const DifficultyCalculator::BeatmapDiffcalcData diffcalcData = make_diffcalc_data(key, diffres);
+
+        const i32 num_objects = static_cast<i32>(diffres.diffobjects.size());
+        table->entries.resize(num_objects);
+
+        DifficultyCalculator::IncrementalState incremental[DifficultyCalculator::Skills::NUM_SKILLS]{};
+        std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> diffobjCache =
+            std::make_unique<std::vector<DifficultyCalculator::DiffObject>>();
+
+        for(i32 i = 0; i < num_objects; i++) {
+            if(table->cancelled.load(std::memory_order_relaxed)) return false;
+
+            PrefixEntry &entry = table->entries[i];
+
+            DifficultyCalculator::StarCalcParams params{.cachedDiffObjects = std::move(diffobjCache),
+                                                        .outAttributes = entry.attributes,
+                                                        .beatmapData = diffcalcData,
+                                                        .outAimStrains = nullptr,
+                                                        .outSpeedStrains = nullptr,
+                                                        .incremental = incremental,
+                                                        .upToObjectIndex = i,
+                                                        .cancelCheck = {},
+                                                        .forceFillDiffobjCache = true};
+
+            entry.total_stars = DifficultyCalculator::calculateStarDiffForHitObjects(params);
+            entry.max_combo = diffres.getMaxComboAtIndex(i);
+
+            // move unique_ptr ownership back
+            diffobjCache = std::move(params.cachedDiffObjects);
+
+            table->num_ready.store(i + 1, std::memory_order_release);
         }
-    };
+
+        return true;
+    }
+
+    // runs on the m_full_calc_inst thread
+    static FullCalcResult calc_up_to(const CalcKey &key, i32 idx, FullCalcCache &cache) {
+        FullCalcResult result;
+        if(key.osufile_path.empty()) return result;
+
+        if(cache.key != key) {
+            cache.key = key;
+            cache.diffobj_cache->clear();
+            cache.diffres =
+                DatabaseBeatmap::loadDifficultyHitObjects(key.osufile_path, key.AR, key.CS, key.speed_multiplier);
+        }
+        DatabaseBeatmap::LOAD_DIFFOBJ_RESULT &diffres = cache.diffres;
+        if(diffres.error.errc) return result;  // uh-oh
+
+        const DifficultyCalculator::BeatmapDiffcalcData diffcalcData = make_diffcalc_data(key, diffres);
+
+        DifficultyCalculator::StarCalcParams params{.cachedDiffObjects = std::move(cache.diffobj_cache),
+                                                    .outAttributes = result.entry.attributes,
+                                                    .beatmapData = diffcalcData,
+                                                    .outAimStrains = nullptr,
+                                                    .outSpeedStrains = nullptr,
+                                                    .incremental = nullptr,
+                                                    .upToObjectIndex = idx,
+                                                    .cancelCheck = {},
+                                                    .forceFillDiffobjCache = true};
+
+        result.entry.total_stars = DifficultyCalculator::calculateStarDiffForHitObjects(params);
+        result.entry.max_combo = diffres.getMaxComboAtIndex(idx < 0 ? 0 : idx);
+
+        // move unique_ptr ownership back
+        cache.diffobj_cache = std::move(params.cachedDiffObjects);
+
+        result.AR = key.AR;
+        result.OD = key.OD;
+        result.calc_index = idx;
+        return result;
+    }
 
     LivePPCalcImpl() = delete;
     LivePPCalcImpl(BeatmapInterface *parent) : m_bmi(parent) {}
-    ~LivePPCalcImpl() = default;
+    ~LivePPCalcImpl() {
+        if(m_table) m_table->cancelled.store(true, std::memory_order_relaxed);
+    }
 
-    // designed in a way that most of the heavy lifting is done off-thread (inside the calc_inst invocation)
+    // the difficulty is only calculated once per map (and settings), so this is just a lookup and a pp calculation
     void update(const LiveScore &score) {
         const i32 cur_hobj = m_bmi->iCurrentHitObjectIndex;
 
@@ -104,138 +219,88 @@ struct LivePPCalc::LivePPCalcImpl {
             return;
         }
 
-        // get most recent results and update hud
-        if(auto maybe_res = m_calc_inst.try_get(); maybe_res != std::nullopt) {
-            update_calc_res(cur_hobj, *maybe_res);
+        if(difficulty_varies_over_time()) {
+            update_full(score, cur_hobj);
+            return;
         }
 
-        if(!needs_queue(cur_hobj)) {
+        if(CalcKey key = current_key(score); !m_table || m_table->key != key) {
+            if(m_table) m_table->cancelled.store(true, std::memory_order_relaxed);
+
+            m_table = std::make_shared<PrefixTable>();
+            m_table->key = std::move(key);
+            m_calc_inst.enqueue([table = m_table]() -> bool { return fill_prefix_table(table); });
+        }
+
+        // not there yet, keep showing the previous values
+        const i32 idx = cur_hobj < 0 ? 0 : cur_hobj;
+        if(idx >= m_table->num_ready.load(std::memory_order_acquire)) {
             return;
         }
 
-        update_queued_idx(cur_hobj);
-
-        m_calc_inst.enqueue([p =
-                                 LazyCalcParams{
-                                     .osufile_path = m_bmi->beatmap ? m_bmi->beatmap->getFilePath() : "",  //
-                                     .legacy_total_score = score.getScore(),                               //
-                                     .CS = m_bmi->getCS(),                                                 //
-                                     .AR = m_bmi->getAR(),                                                 //
-                                     .HP = m_bmi->getHP(),                                                 //
-                                     .OD = m_bmi->getOD(),                                                 //
-                                     .speed_multiplier = m_bmi->getSpeedMultiplier(),                      //
-                                     .current_hitobject = m_bmi->iCurrentHitObjectIndex,                   //
-                                     .nb_circles = m_bmi->iCurrentNumCircles,                              //
-                                     .nb_sliders = m_bmi->iCurrentNumSliders,                              //
-                                     .nb_spinners = m_bmi->iCurrentNumSpinners,                            //
-                                     .highest_combo = score.getComboMax(),                                 //
-                                     .nb_misses = score.getNumMisses(),                                    //
-                                     .nb_300s = score.getNum300s(),                                        //
-                                     .nb_100s = score.getNum100s(),                                        //
-                                     .nb_50s = score.getNum50s(),                                          //
-                                     .mods = score.mods,                                                   //
-                                 },
-                             &old_cache = m_param_cache](void) -> LazyPPRes {
-            LazyPPRes result;
-
-            if(p.osufile_path.empty()) return result;
-
-            AsyncPPC::pp_res &retInfo = result.res;
-
-            auto &cache = p.get_latest_cached(old_cache);
-            DatabaseBeatmap::LOAD_DIFFOBJ_RESULT &diffres = cache.diffres;
-
-            if(diffres.error.errc) return result;  // uh-oh
-
-            const bool relax = flags::has<ModFlags::Relax>(p.mods.flags);
-            const bool td = flags::has<ModFlags::TouchDevice>(p.mods.flags);
-            const bool hidden = flags::has<ModFlags::Hidden>(p.mods.flags);
-            const bool autopilot = flags::has<ModFlags::Autopilot>(p.mods.flags);
-            const bool modAuto = flags::has<ModFlags::Autoplay>(p.mods.flags);
-
-            // this is assumed to always be valid
-            std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> &diffobjCache = cache.diffobj_cache;
-
-            DifficultyCalculator::BeatmapDiffcalcData diffcalcData{.sortedHitObjects = diffres.diffobjects,
-                                                                   .CS = p.CS,
-                                                                   .HP = p.HP,
-                                                                   .AR = p.AR,
-                                                                   .OD = p.OD,
-                                                                   .hidden = hidden,
-                                                                   .relax = relax,
-                                                                   .autopilot = autopilot,
-                                                                   .touchDevice = td,
-                                                                   .speedMultiplier = p.speed_multiplier,
-                                                                   .breakDuration = diffres.totalBreakDuration,
-                                                                   .playableLength = diffres.playableLength};
-
-            DifficultyCalculator::DifficultyAttributes diffattrsOut{};
-
-            DifficultyCalculator::StarCalcParams params{
-                .cachedDiffObjects = std::move(diffobjCache),
-                .outAttributes = diffattrsOut,
-                .beatmapData = diffcalcData,
-                .outAimStrains = &retInfo.aimStrains,
-                .outSpeedStrains = &retInfo.speedStrains,
-                .incremental = nullptr,  // TODO: use incremental instead of this bs
-                .upToObjectIndex = p.current_hitobject,
-                .cancelCheck = {},
-                .forceFillDiffobjCache = true};
-
-            retInfo.total_stars = DifficultyCalculator::calculateStarDiffForHitObjects(params);
+        update_live_values(score, cur_hobj, m_table->entries[idx], m_table->key.AR, m_table->key.OD);
 
-            // move unique_ptr ownership back
-            diffobjCache = std::move(params.cachedDiffObjects);
+        m_last_calculated = cur_hobj;
+        m_calculated_valid = true;
+    }
 
-            retInfo.aim_stars = diffattrsOut.AimDifficulty;
-            retInfo.aim_slider_factor = diffattrsOut.SliderFactor;
-            retInfo.difficult_aim_sliders = diffattrsOut.AimDifficultSliderCount;
-            retInfo.difficult_aim_strains = diffattrsOut.AimDifficultStrainCount;
-            retInfo.speed_stars = diffattrsOut.SpeedDifficulty;
-            retInfo.speed_notes = diffattrsOut.SpeedNoteCount;
-            retInfo.difficult_speed_strains = diffattrsOut.SpeedDifficultStrainCount;
-
-            DifficultyCalculator::PPv2CalcParams ppv2pars{
-                .attributes = diffattrsOut,
-                .modFlags = p.mods.flags,
-                .timescale = p.mods.speed,
-                .ar = p.AR,
-                .od = p.OD,
-                .numHitObjects = p.current_hitobject,
-                .numCircles = p.nb_circles,
-                .numSliders = p.nb_sliders,
-                .numSpinners = p.nb_spinners,
-                .maxPossibleCombo = (i32)diffres.getMaxComboAtIndex(p.current_hitobject < 0 ? 0 : p.current_hitobject),
-                .combo = p.highest_combo,
-                .misses = p.nb_misses,
-                .c300 = p.nb_300s,
-                .c100 = p.nb_100s,
-                .c50 = p.nb_50s,
-                .legacyTotalScore = (u32)p.legacy_total_score,
-                .isMcOsuImported = false};
-
-            // HACKHACK: for auto, just ignore reality and calculate maximum pp of a perfect play up until this point
-            // this allows calculation after seeking and dropping combo
-            // need to re-simulate the play up until that point to be accurate
-            if(modAuto) {
-                ppv2pars.combo = ppv2pars.maxPossibleCombo;
-                ppv2pars.c300 = ppv2pars.numHitObjects;
-                ppv2pars.c100 = ppv2pars.c50 = ppv2pars.misses = 0;
-                ppv2pars.legacyTotalScore = 0;  // no score-based misscount
-            }
-
-            retInfo.pp = DifficultyCalculator::calculatePPv2(ppv2pars);
-
-            if(cv::debug_pp.getBool()) {
-                logRaw("[LivePPCalc] PP: {} params (post):\n{}", retInfo.pp,
-                       DifficultyCalculator::PPv2CalcParamsToString(ppv2pars));
-            }
-
-            result.calc_index = p.current_hitobject;
-            return result;
+    // the old per-object path: every new object queues a full calculation with the current AR/CS
+    void update_full(const LiveScore &score, i32 cur_hobj) {
+        if(auto maybe_res = m_full_calc_inst.try_get();
+           maybe_res != std::nullopt && maybe_res->calc_index >= 0 && maybe_res->calc_index != m_last_calculated) {
+            update_live_values(score, maybe_res->calc_index, maybe_res->entry, maybe_res->AR, maybe_res->OD);
+            m_last_calculated = maybe_res->calc_index;
+            m_calculated_valid = (maybe_res->calc_index == cur_hobj);
+        }
+
+        if(!needs_queue(cur_hobj)) {
+            return;
+        }
+
+        m_last_queued = cur_hobj;
+        m_full_calc_inst.enqueue([key = current_key(score), cur_hobj, &cache = m_full_calc_cache]() -> FullCalcResult {
+            return calc_up_to(key, cur_hobj, cache);
         });
     }
 
+    void update_live_values(const LiveScore &score, i32 cur_hobj, const PrefixEntry &entry, f32 AR, f32 OD) {
+        DifficultyCalculator::PPv2CalcParams ppv2pars{.attributes = entry.attributes,
+                                                      .modFlags = score.mods.flags,
+                                                      .timescale = score.mods.speed,
+                                                      .ar = AR,
+                                                      .od = OD,
+                                                      .numHitObjects = cur_hobj,
+                                                      .numCircles = m_bmi->iCurrentNumCircles,
+                                                      .numSliders = m_bmi->iCurrentNumSliders,
+                                                      .numSpinners = m_bmi->iCurrentNumSpinners,
+                                                      .maxPossibleCombo = (i32)entry.max_combo,
+                                                      .combo = score.getComboMax(),
+                                                      .misses = score.getNumMisses(),
+                                                      .c300 = score.getNum300s(),
+                                                      .c100 = score.getNum100s(),
+                                                      .c50 = score.getNum50s(),
+                                                      .legacyTotalScore = (u32)score.getScore(),
+                                                      .isMcOsuImported = false};
+
+        // HACKHACK: for auto, just ignore reality and calculate maximum pp of a perfect play up until this point
+        // this allows calculation after seeking and dropping combo
+        // need to re-simulate the play up until that point to be accurate
+        if(flags::has<ModFlags::Autoplay>(score.mods.flags)) {
+            ppv2pars.combo = ppv2pars.maxPossibleCombo;
+            ppv2pars.c300 = ppv2pars.numHitObjects;
+            ppv2pars.c100 = ppv2pars.c50 = ppv2pars.misses = 0;
+            ppv2pars.legacyTotalScore = 0;  // no score-based misscount
+        }
+
+        m_live_pp = DifficultyCalculator::calculatePPv2(ppv2pars);
+        m_live_stars = entry.total_stars;
+
+        if(cv::debug_pp.getBool()) {
+            logRaw("[LivePPCalc] PP: {} params (post):\n{}", m_live_pp,
+                   DifficultyCalculator::PPv2CalcParamsToString(ppv2pars));
+        }
+    }
+
     void invalidate() {
         m_last_calculated = -1;
         m_last_queued = -1;
@@ -13,7 +13,7 @@ struct LivePPCalc {
 
    private:
     struct LivePPCalcImpl;
-    StaticPImpl<LivePPCalcImpl, 450> pImpl;
+    StaticPImpl<LivePPCalcImpl, 800> pImpl;
 
    public:
     LivePPCalc() = delete;
@@ -51,6 +51,11 @@ const char *dbgstr_idx(u8 idx) {
 
     last_idx = idx;
 
+    if(is_custom_idx(idx)) {
+        std::snprintf(buf.data(), buf.size(), "custom");
+        return buf.data();
+    }
+
     if(idx >= NUM_PRECALC_RATINGS) {
         std::snprintf(buf.data(), buf.size(), "invalid");
         return buf.data();
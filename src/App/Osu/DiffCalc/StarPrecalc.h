@@ -34,6 +34,15 @@ inline constexpr uSz NOMOD_1X_INDEX = _1_0 * NUM_MOD_COMBOS;             // spee
 using SRArray = std::array<f32, NUM_PRECALC_RATINGS>;
 
 enum MOD_COMBO_INDEX : u8 { INVALID_MODCOMBO = 0xFF };
+
+// indices for mods which aren't precalculated, rated on demand by AsyncStarCalc instead
+// (it moves on to the next one whenever the mods change)
+inline constexpr u8 CUSTOM_IDX_FIRST = 0x80;
+inline constexpr u8 CUSTOM_IDX_LAST = 0xFE;
+static_assert(NUM_PRECALC_RATINGS < CUSTOM_IDX_FIRST && CUSTOM_IDX_LAST < INVALID_MODCOMBO);
+
+inline constexpr bool is_custom_idx(u8 idx) { return idx >= CUSTOM_IDX_FIRST && idx <= CUSTOM_IDX_LAST; }
+
 // if flags are an invalid combination this returns INVALID_MODCOMBO
 MOD_COMBO_INDEX mod_combo_index(ModFlags flags);
 
@@ -51,7 +60,7 @@ inline MOD_COMBO_INDEX index_of(ModFlags flags, f32 speed) {
 
 const char *dbgstr_idx(u8 idx);
 
-// currently active mod combination index, updated by Osu::updateMods()
+// currently active mod combination index (or custom index), updated by Osu::updateMods()
 inline u8 active_idx = NOMOD_1X_INDEX;
 
 }  // namespace StarPrecalc
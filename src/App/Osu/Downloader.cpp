@@ -463,6 +463,8 @@ DatabaseBeatmap* download_beatmap(i32 beatmap_id, MD5Hash beatmap_md5, DownloadH
     // While we're clueless on the beatmap IDs of the other maps in the set,
     // we can still make sure at least the one we wanted is correct.
     beatmap->iID = beatmap_id;
+    beatmap->rebuildSearchBlob();
+    db->getSearchIndex().add(beatmap);
 
     return beatmap;
 }
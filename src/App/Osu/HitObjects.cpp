@@ -1,6 +1,8 @@
 #include "HitObjects.h"
 
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 #include <utility>
 
 #include "AnimationHandler.h"
@@ -27,6 +29,42 @@
 
 using namespace flags::operators;
 
+namespace {  // static namespace
+
+template <typename T>
+void save_field(std::vector<u8> &out, const T &field) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto *bytes = reinterpret_cast<const u8 *>(&field);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void load_field(const u8 *&in, T &field) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::memcpy(&field, in, sizeof(T));
+    in += sizeof(T);
+}
+
+template <typename T>
+void save_vector(std::vector<u8> &out, const std::vector<T> &vec) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    save_field(out, static_cast<u32>(vec.size()));
+    const auto *bytes = reinterpret_cast<const u8 *>(vec.data());
+    out.insert(out.end(), bytes, bytes + vec.size() * sizeof(T));
+}
+
+template <typename T>
+void load_vector(const u8 *&in, std::vector<T> &vec) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    u32 size = 0;
+    load_field(in, size);
+    vec.resize(size);
+    if(size) std::memcpy(vec.data(), in, size * sizeof(T));
+    in += size * sizeof(T);
+}
+
+}  // namespace
+
 void HitObject::drawHitResult(BeatmapInterface *pf, vec2 rawPos, LiveScore::HIT result, float animPercentInv,
                               float hitDeltaRangePercent) {
     drawHitResult(pf->getSkin(), pf->fHitcircleDiameter, pf->fRawHitcircleDiameter, rawPos, result, animPercentInv,
@@ -471,6 +509,46 @@ void HitObject::onReset(i32 /*curPos*/) {
     this->hitresultanim2.time = -9999.0f;
 }
 
+void HitObject::saveState(std::vector<u8> &out) const {
+    save_field(out, this->hitresultanim1);
+    save_field(out, this->hitresultanim2);
+    save_field(out, this->iDelta);
+    save_field(out, this->iApproachTime);
+    save_field(out, this->iFadeInTime);
+    save_field(out, this->iAutopilotDelta);
+    save_field(out, this->fAlpha);
+    save_field(out, this->fAlphaWithoutHidden);
+    save_field(out, this->fAlphaForApproachCircle);
+    save_field(out, this->fApproachScale);
+    save_field(out, this->fHittableDimRGBColorMultiplierPercent);
+    save_field(out, this->bBlocked);
+    save_field(out, this->bMisAim);
+    save_field(out, this->bUseFadeInTimeAsApproachTime);
+    save_field(out, this->bOverrideHDApproachCircle);
+    save_field(out, this->bVisible);
+    save_field(out, this->bFinished);
+}
+
+void HitObject::loadState(const u8 *&in) {
+    load_field(in, this->hitresultanim1);
+    load_field(in, this->hitresultanim2);
+    load_field(in, this->iDelta);
+    load_field(in, this->iApproachTime);
+    load_field(in, this->iFadeInTime);
+    load_field(in, this->iAutopilotDelta);
+    load_field(in, this->fAlpha);
+    load_field(in, this->fAlphaWithoutHidden);
+    load_field(in, this->fAlphaForApproachCircle);
+    load_field(in, this->fApproachScale);
+    load_field(in, this->fHittableDimRGBColorMultiplierPercent);
+    load_field(in, this->bBlocked);
+    load_field(in, this->bMisAim);
+    load_field(in, this->bUseFadeInTimeAsApproachTime);
+    load_field(in, this->bOverrideHDApproachCircle);
+    load_field(in, this->bVisible);
+    load_field(in, this->bFinished);
+}
+
 float HitObject::lerp3f(float a, float b, float c, float percent) {
     if(percent <= 0.5f)
         return std::lerp(a, b, percent * 2.0f);
@@ -986,6 +1064,22 @@ void Circle::onReset(i32 curPos) {
     }
 }
 
+void Circle::saveState(std::vector<u8> &out) const {
+    HitObject::saveState(out);
+    save_field(out, this->bWaiting);
+    save_field(out, this->vRawPos);
+    save_field(out, this->fHitAnimation);
+    save_field(out, this->fShakeAnimation);
+}
+
+void Circle::loadState(const u8 *&in) {
+    HitObject::loadState(in);
+    load_field(in, this->bWaiting);
+    load_field(in, this->vRawPos);
+    load_field(in, this->fHitAnimation);
+    load_field(in, this->fShakeAnimation);
+}
+
 vec2 Circle::getAutoCursorPos(i32 /*curPos*/) const { return this->pi->osuCoords2Pixels(this->vRawPos); }
 
 Slider::Slider(SLIDERCURVETYPE stype, int repeat, float pixelLength, std::vector<vec2> points,
@@ -2301,6 +2395,76 @@ void Slider::onReset(i32 curPos) {
     }
 }
 
+void Slider::saveState(std::vector<u8> &out) const {
+    HitObject::saveState(out);
+    save_vector(out, this->lastSliderSampleSets);
+    save_vector(out, this->ticks);
+    save_vector(out, this->clicks);
+    save_field(out, this->vCurPoint);
+    save_field(out, this->vCurPointRaw);
+    save_field(out, this->iStrictTrackingModLastClickHeldTime);
+    save_field(out, this->fSlidePercent);
+    save_field(out, this->fSliderSnakePercent);
+    save_field(out, this->fReverseArrowAlpha);
+    save_field(out, this->fBodyAlpha);
+    save_field(out, this->fStartHitAnimation);
+    save_field(out, this->fEndHitAnimation);
+    save_field(out, this->fEndSliderBodyFadeAnimation);
+    save_field(out, this->fFollowCircleTickAnimationScale);
+    save_field(out, this->fFollowCircleAnimationScale);
+    save_field(out, this->fFollowCircleAnimationAlpha);
+    save_field(out, this->iKeyFlags);
+    save_field(out, this->iReverseArrowPos);
+    save_field(out, this->iCurRepeat);
+    save_field(out, this->iCurRepeatCounterForHitSounds);
+    save_field(out, this->startResult);
+    save_field(out, this->endResult);
+    save_field(out, this->bStartFinished);
+    save_field(out, this->bEndFinished);
+    save_field(out, this->bCursorLeft);
+    save_field(out, this->bCursorInside);
+    save_field(out, this->bHeldTillEnd);
+    save_field(out, this->bHeldTillEndForLenienceHack);
+    save_field(out, this->bHeldTillEndForLenienceHackCheck);
+    save_field(out, this->bInReverse);
+    save_field(out, this->bHideNumberAfterFirstRepeatHit);
+}
+
+void Slider::loadState(const u8 *&in) {
+    HitObject::loadState(in);
+    load_vector(in, this->lastSliderSampleSets);
+    load_vector(in, this->ticks);
+    load_vector(in, this->clicks);
+    load_field(in, this->vCurPoint);
+    load_field(in, this->vCurPointRaw);
+    load_field(in, this->iStrictTrackingModLastClickHeldTime);
+    load_field(in, this->fSlidePercent);
+    load_field(in, this->fSliderSnakePercent);
+    load_field(in, this->fReverseArrowAlpha);
+    load_field(in, this->fBodyAlpha);
+    load_field(in, this->fStartHitAnimation);
+    load_field(in, this->fEndHitAnimation);
+    load_field(in, this->fEndSliderBodyFadeAnimation);
+    load_field(in, this->fFollowCircleTickAnimationScale);
+    load_field(in, this->fFollowCircleAnimationScale);
+    load_field(in, this->fFollowCircleAnimationAlpha);
+    load_field(in, this->iKeyFlags);
+    load_field(in, this->iReverseArrowPos);
+    load_field(in, this->iCurRepeat);
+    load_field(in, this->iCurRepeatCounterForHitSounds);
+    load_field(in, this->startResult);
+    load_field(in, this->endResult);
+    load_field(in, this->bStartFinished);
+    load_field(in, this->bEndFinished);
+    load_field(in, this->bCursorLeft);
+    load_field(in, this->bCursorInside);
+    load_field(in, this->bHeldTillEnd);
+    load_field(in, this->bHeldTillEndForLenienceHack);
+    load_field(in, this->bHeldTillEndForLenienceHackCheck);
+    load_field(in, this->bInReverse);
+    load_field(in, this->bHideNumberAfterFirstRepeatHit);
+}
+
 void Slider::rebuildVertexBuffer(bool useRawCoords) {
     // base mesh (background) (raw unscaled, size in raw osu coordinates centered at (0, 0, 0))
     // this mesh needs to be scaled and translated appropriately since we are not 1:1 with the playfield
@@ -2698,6 +2862,42 @@ void Spinner::onReset(i32 curPos) {
         this->bFinished = false;
 }
 
+void Spinner::saveState(std::vector<u8> &out) const {
+    HitObject::saveState(out);
+    save_field(out, this->fPercent);
+    save_field(out, this->fDrawRot);
+    save_field(out, this->fRotations);
+    save_field(out, this->fRotationsNeeded);
+    save_field(out, this->fDeltaOverflow);
+    save_field(out, this->fSumDeltaAngle);
+    save_field(out, this->iDeltaAngleIndex);
+    save_field(out, this->fDeltaAngleOverflow);
+    save_field(out, this->fRPM);
+    save_field(out, this->fLastMouseAngle);
+    save_field(out, this->fRatio);
+
+    const auto *angles = reinterpret_cast<const u8 *>(this->storedDeltaAngles.get());
+    out.insert(out.end(), angles, angles + this->iMaxStoredDeltaAngles * sizeof(float));
+}
+
+void Spinner::loadState(const u8 *&in) {
+    HitObject::loadState(in);
+    load_field(in, this->fPercent);
+    load_field(in, this->fDrawRot);
+    load_field(in, this->fRotations);
+    load_field(in, this->fRotationsNeeded);
+    load_field(in, this->fDeltaOverflow);
+    load_field(in, this->fSumDeltaAngle);
+    load_field(in, this->iDeltaAngleIndex);
+    load_field(in, this->fDeltaAngleOverflow);
+    load_field(in, this->fRPM);
+    load_field(in, this->fLastMouseAngle);
+    load_field(in, this->fRatio);
+
+    std::memcpy(this->storedDeltaAngles.get(), in, this->iMaxStoredDeltaAngles * sizeof(float));
+    in += this->iMaxStoredDeltaAngles * sizeof(float);
+}
+
 void Spinner::onHit() {
     // calculate hit result
     LiveScore::HIT result = LiveScore::HIT::HIT_NULL;
@@ -94,6 +94,11 @@ class HitObject {
     virtual void onClickEvent(std::vector<Click> & /*clicks*/) { ; }
     virtual void onReset(i32 curPos);
 
+    // everything which changes while playing, for rewinding simulated replays to a checkpoint
+    // loadState() advances in past the state written by saveState()
+    virtual void saveState(std::vector<u8> &out) const;
+    virtual void loadState(const u8 *&in);
+
    private:
     static float lerp3f(float a, float b, float c, float percent);
 
@@ -208,6 +213,8 @@ class Circle final : public HitObject {
 
     void onClickEvent(std::vector<Click> &clicks) override;
     void onReset(i32 curPos) override;
+    void saveState(std::vector<u8> &out) const override;
+    void loadState(const u8 *&in) override;
 
    private:
     // necessary due to the static draw functions
@@ -268,6 +275,8 @@ class Slider final : public HitObject {
 
     void onClickEvent(std::vector<Click> &clicks) override;
     void onReset(i32 curPos) override;
+    void saveState(std::vector<u8> &out) const override;
+    void loadState(const u8 *&in) override;
 
     void rebuildVertexBuffer(bool useRawCoords = false);
 
@@ -376,6 +385,8 @@ class Spinner final : public HitObject {
     [[nodiscard]] vec2 getAutoCursorPos(i32 curPos) const override;
 
     void onReset(i32 curPos) override;
+    void saveState(std::vector<u8> &out) const override;
+    void loadState(const u8 *&in) override;
 
    private:
     void onHit();
@@ -32,7 +32,10 @@ void LoadingScreen::draw() {
 
     // progress message
     g->setColor(0xffffffff);
-    UString loadingMessage = fmt::format("Loading ... ({} %)", (int)(this->progress * 100.0f));
+    UString loadingMessage =
+        this->status_text.empty()
+            ? fmt::format("Loading ... ({} %)", (int)(this->progress * 100.0f))
+            : fmt::format("Loading ... ({} %, {})", (int)(this->progress * 100.0f), this->status_text);
     g->pushTransform();
     {
         g->translate((int)(osu->getVirtScreenWidth() / 2 - osu->getSubTitleFont()->getStringWidth(loadingMessage) / 2),
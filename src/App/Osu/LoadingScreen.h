@@ -4,6 +4,7 @@
 #include "UIScreen.h"
 
 #include <functional>
+#include <string>
 
 class LoadingScreen;
 using LoadingProgressFn = std::function<f32(LoadingScreen *)>;
@@ -25,6 +26,9 @@ class LoadingScreen final : public UIOverlay {
     inline bool isVisible() final { return UIOverlay::isVisible() && this->get_progress_fn && this->on_finished_fn; }
     inline bool isFinished() { return this->progress >= 1.f || !this->get_progress_fn || !this->on_finished_fn; }
 
+    // extra info appended to the progress message (e.g. import throughput), empty to hide
+    inline void setStatusText(std::string text) { this->status_text = std::move(text); }
+
    private:
     friend LoadingFinishedFn;
     friend LoadingProgressFn;
@@ -35,5 +39,6 @@ class LoadingScreen final : public UIOverlay {
     LoadingFinishedFn on_finished_fn;
     LoadingProgressFn get_progress_fn;
 
+    std::string status_text;
     f32 progress{0.f};
 };
@@ -0,0 +1,175 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "MapsDatabaseFile.h"
+
+#include "ByteBufferedFile.h"
+#include "Logging.h"
+
+#include <algorithm>
+
+namespace MapsDB {
+
+namespace {  // static namespace
+
+struct Header {
+    u32 version;
+    u32 magic;
+    u32 nb_columns;
+    u32 reserved;
+};
+
+struct DirEntry {
+    u32 id;
+    u32 elem_size;
+    u64 count;
+    u64 offset;
+};
+
+static_assert(sizeof(Header) == 16 && sizeof(DirEntry) == 24);
+
+constexpr uSz WRITE_CHUNK_SIZE = 1024ULL * 1024;
+
+constexpr uSz align_up(uSz pos) { return (pos + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1); }
+
+}  // namespace
+
+Reader::Reader(std::string_view path) : file(path) {
+    if(!this->file.good()) {
+        this->error_msg = this->file.error();
+        return;
+    }
+
+    const u8 *data = this->file.data();
+    const uSz size = this->file.size();
+    if(size < sizeof(u32)) {
+        this->error_msg = "empty file";
+        return;
+    }
+
+    std::memcpy(&this->file_version, data, sizeof(u32));
+
+    Header header{};
+    if(size < sizeof(Header)) {
+        this->error_msg = "truncated header";
+        return;
+    }
+    std::memcpy(&header, data, sizeof(Header));
+    if(header.magic != MAGIC) {
+        this->error_msg = "not a columnar database";
+        return;
+    }
+
+    if(header.nb_columns > (size - sizeof(Header)) / sizeof(DirEntry)) {
+        this->error_msg = "truncated column directory";
+        return;
+    }
+
+    for(u32 i = 0; i < header.nb_columns; i++) {
+        DirEntry entry{};
+        std::memcpy(&entry, data + sizeof(Header) + i * sizeof(DirEntry), sizeof(DirEntry));
+
+        // written by a newer version
+        if(entry.id >= static_cast<u32>(Col::COUNT)) continue;
+
+        if(entry.elem_size == 0 || entry.offset % COLUMN_ALIGNMENT != 0 || entry.offset > size ||
+           entry.count > (size - entry.offset) / entry.elem_size) {
+            this->error_msg = fmt::format("invalid column {} (offset {}, {}x{} bytes)", entry.id, entry.offset,
+                                          entry.count, entry.elem_size);
+            return;
+        }
+
+        this->columns[entry.id] = {.elem_size = entry.elem_size, .count = entry.count, .offset = entry.offset};
+    }
+
+    this->string_offsets = this->column<u32>(Col::STRING_OFFSETS);
+    this->string_data = this->column<char>(Col::STRING_DATA);
+}
+
+std::string_view Reader::string(StrRef ref) const {
+    if(static_cast<uSz>(ref) + 1 >= this->string_offsets.size()) return {};
+
+    const u32 start = this->string_offsets[ref];
+    const u32 end = this->string_offsets[ref + 1];
+    if(start > end || end > this->string_data.size()) return {};
+
+    return {this->string_data.data() + start, end - start};
+}
+
+void Writer::push_string(Col id, std::string_view str) {
+    const u64 hash = Hash::flat::hash<std::string_view>{}(str);
+
+    StrRef ref = static_cast<StrRef>(this->string_offsets.size() - 1);
+    const auto [it, inserted] = this->strings.try_emplace(hash, ref);
+    if(!inserted) {
+        const StrRef existing = it->second;
+        const std::string_view stored{this->string_data.data() + this->string_offsets[existing],
+                                      this->string_offsets[existing + 1] - this->string_offsets[existing]};
+        // on hash collisions, the string just doesn't get deduplicated
+        if(stored == str) {
+            this->push<StrRef>(id, existing);
+            return;
+        }
+    }
+
+    this->string_data.append(str);
+    this->string_offsets.push_back(static_cast<u32>(this->string_data.size()));
+    this->push<StrRef>(id, ref);
+}
+
+bool Writer::save(std::string_view path, u32 version) {
+    // the string pool is stored like any other column
+    {
+        Column &offsets = this->columns[static_cast<uSz>(Col::STRING_OFFSETS)];
+        offsets.elem_size = sizeof(u32);
+        offsets.data.resize(this->string_offsets.size() * sizeof(u32));
+        std::memcpy(offsets.data.data(), this->string_offsets.data(), offsets.data.size());
+
+        Column &chars = this->columns[static_cast<uSz>(Col::STRING_DATA)];
+        chars.elem_size = sizeof(char);
+        chars.data.assign(this->string_data.begin(), this->string_data.end());
+    }
+
+    std::vector<DirEntry> directory;
+    for(u32 id = 0; id < static_cast<u32>(Col::COUNT); id++) {
+        const Column &col = this->columns[id];
+        if(col.elem_size == 0) continue;  // never pushed to
+
+        directory.push_back({.id = id, .elem_size = col.elem_size, .count = col.data.size() / col.elem_size});
+    }
+
+    // the directory size is only known now, so offsets are assigned in a second pass
+    uSz pos = align_up(sizeof(Header) + directory.size() * sizeof(DirEntry));
+    for(DirEntry &entry : directory) {
+        entry.offset = pos;
+        pos = align_up(pos + this->columns[entry.id].data.size());
+    }
+
+    ByteBufferedFile::Writer writer(path);
+    if(!writer.good()) {
+        debugLog("Cannot save {}: {}", path, writer.error());
+        return false;
+    }
+
+    const Header header{
+        .version = version, .magic = MAGIC, .nb_columns = static_cast<u32>(directory.size()), .reserved = 0};
+    writer.write<Header>(header);
+    for(const DirEntry &entry : directory) {
+        writer.write<DirEntry>(entry);
+    }
+
+    static constexpr std::array<u8, COLUMN_ALIGNMENT> padding{};
+    uSz written = sizeof(Header) + directory.size() * sizeof(DirEntry);
+    for(const DirEntry &entry : directory) {
+        writer.write_bytes(padding.data(), entry.offset - written);
+        const std::vector<u8> &data = this->columns[entry.id].data;
+        // columns can be larger than the write buffer
+        for(uSz chunk_pos = 0; chunk_pos < data.size(); chunk_pos += WRITE_CHUNK_SIZE) {
+            writer.write_bytes(&data[chunk_pos], std::min(WRITE_CHUNK_SIZE, data.size() - chunk_pos));
+        }
+        written = entry.offset + data.size();
+    }
+
+    writer.flush();
+    return writer.good();
+}
+
+}  // namespace MapsDB
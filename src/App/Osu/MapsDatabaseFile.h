@@ -0,0 +1,187 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "noinclude.h"
+#include "Hashing.h"
+#include "MappedFile.h"
+
+#include <array>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Columnar layout of neosu_maps.db (see NEOSU_MAPS_DB_VERSION):
+//
+//   u32 version, u32 magic, u32 nb_columns, u32 reserved
+//   nb_columns * { u32 id, u32 elem_size, u64 count, u64 offset }
+//   column data, each one aligned to COLUMN_ALIGNMENT
+//
+// Every column is an array of fixed-width values. Strings are stored as indices into an interned string pool (itself
+// made of the STRING_OFFSETS and STRING_DATA columns), so the whole file can be used straight from a memory mapping
+// without parsing anything.
+//
+// Readers ignore unknown columns and fall back to defaults for missing ones (or ones with an unexpected width), so
+// new columns can be added without bumping the version. Column IDs are stored, so new ones must only be appended
+// (right before COUNT), and removed ones must stay in the enum.
+namespace MapsDB {
+
+inline constexpr u32 MAGIC = 0x43444D4E;  // "NMDC"
+inline constexpr uSz COLUMN_ALIGNMENT = 16;
+
+// index into the string pool
+using StrRef = u32;
+
+enum class Col : u32 {
+    // string pool
+    STRING_OFFSETS,  // u32, one more than the number of strings
+    STRING_DATA,     // char
+
+    // beatmapsets, their difficulties are stored consecutively in the DIFF_* columns
+    SET_ID,        // i32
+    SET_NB_DIFFS,  // u32
+
+    // difficulties
+    DIFF_FILENAME,  // StrRef, .osu filename relative to the set folder
+    DIFF_ID,
+    DIFF_TITLE,
+    DIFF_AUDIO_FILENAME,
+    DIFF_LENGTH_MS,
+    DIFF_STACK_LENIENCY,
+    DIFF_ARTIST,
+    DIFF_CREATOR,
+    DIFF_NAME,
+    DIFF_SOURCE,
+    DIFF_TAGS,
+    DIFF_MD5,
+    DIFF_AR,
+    DIFF_CS,
+    DIFF_HP,
+    DIFF_OD,
+    DIFF_SLIDER_MULTIPLIER,
+    DIFF_PREVIEW_TIME,
+    DIFF_MTIME,
+    DIFF_LOCAL_OFFSET,
+    DIFF_ONLINE_OFFSET,
+    DIFF_NB_CIRCLES,
+    DIFF_NB_SLIDERS,
+    DIFF_NB_SPINNERS,
+    DIFF_STARS_NOMOD,
+    DIFF_MIN_BPM,
+    DIFF_MAX_BPM,
+    DIFF_AVG_BPM,
+    DIFF_DRAW_BACKGROUND,
+    DIFF_LOUDNESS,
+    DIFF_TITLE_UNICODE,
+    DIFF_ARTIST_UNICODE,
+    DIFF_BACKGROUND_FILENAME,
+    DIFF_PPV2_VERSION,
+
+    // overrides for osu!stable maps
+    OVERRIDE_MD5,
+    OVERRIDE_LOCAL_OFFSET,
+    OVERRIDE_ONLINE_OFFSET,
+    OVERRIDE_STAR_RATING,
+    OVERRIDE_LOUDNESS,
+    OVERRIDE_MIN_BPM,
+    OVERRIDE_MAX_BPM,
+    OVERRIDE_AVG_BPM,
+    OVERRIDE_DRAW_BACKGROUND,
+    OVERRIDE_BACKGROUND_FILENAME,
+    OVERRIDE_PPV2_VERSION,
+
+    // precalculated star ratings, the element width changes along with the StarPrecalc layout
+    STARS_MD5,
+    STARS_RATINGS,
+
+    COUNT
+};
+
+class Reader final {
+    NOCOPY_NOMOVE(Reader)
+   public:
+    Reader(std::string_view path);
+    ~Reader() = default;
+
+    // false for missing/empty files
+    [[nodiscard]] inline bool exists() const { return this->file.size() > 0; }
+    [[nodiscard]] inline uSz size() const { return this->file.size(); }
+
+    // 0 if the file couldn't be read at all
+    [[nodiscard]] inline u32 version() const { return this->file_version; }
+
+    // whether the columns can be read (false for the old streamed format)
+    [[nodiscard]] inline bool good() const { return this->error_msg.empty(); }
+    [[nodiscard]] inline std::string_view error() const { return this->error_msg; }
+
+    // empty if the column is missing or doesn't contain T
+    template <typename T>
+    [[nodiscard]] std::span<const T> column(Col id) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(alignof(T) <= COLUMN_ALIGNMENT);
+
+        const Location &loc = this->columns[static_cast<uSz>(id)];
+        if(loc.elem_size != sizeof(T) || loc.count == 0) return {};
+        return {reinterpret_cast<const T *>(this->file.data() + loc.offset), loc.count};
+    }
+
+    // empty for invalid references
+    [[nodiscard]] std::string_view string(StrRef ref) const;
+    [[nodiscard]] inline uSz num_strings() const {
+        return this->string_offsets.empty() ? 0 : this->string_offsets.size() - 1;
+    }
+
+   private:
+    struct Location {
+        u32 elem_size{0};
+        uSz count{0};
+        uSz offset{0};
+    };
+
+    MappedFile file;
+    u32 file_version{0};
+    std::array<Location, static_cast<uSz>(Col::COUNT)> columns{};
+    std::span<const u32> string_offsets;
+    std::span<const char> string_data;
+    std::string error_msg;
+};
+
+class Writer final {
+    NOCOPY_NOMOVE(Writer)
+   public:
+    Writer() = default;
+    ~Writer() = default;
+
+    template <typename T>
+    void push(Col id, const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(alignof(T) <= COLUMN_ALIGNMENT);
+
+        Column &col = this->columns[static_cast<uSz>(id)];
+        col.elem_size = sizeof(T);
+        const uSz pos = col.data.size();
+        col.data.resize(pos + sizeof(T));
+        std::memcpy(&col.data[pos], &value, sizeof(T));
+    }
+
+    // interns the string, so duplicates (e.g. the artist of every difficulty in a set) are only stored once
+    void push_string(Col id, std::string_view str);
+
+    // atomically replaces the file
+    bool save(std::string_view path, u32 version);
+
+   private:
+    struct Column {
+        u32 elem_size{0};
+        std::vector<u8> data;
+    };
+
+    std::array<Column, static_cast<uSz>(Col::COUNT)> columns{};
+    Hash::flat::map<u64, StrRef> strings;  // content hash -> first string with that hash
+    std::vector<u32> string_offsets{0};
+    std::string string_data;
+};
+
+}  // namespace MapsDB
@@ -23,6 +23,7 @@
 #include "Downloader.h"
 #include "Engine.h"
 #include "File.h"
+#include "AsyncIOHandler.h"
 #include "Font.h"
 #include "RuntimePlatform.h"
 #include "Sound.h"
@@ -54,6 +55,7 @@
 #include "Shader.h"
 #include "Skin.h"
 #include "AsyncPPCalculator.h"
+#include "AsyncStarCalculator.h"
 #include "SongBrowser/LoudnessCalcThread.h"
 #include "DiffCalc/BatchDiffCalc.h"
 #include "SongBrowser/SongBrowser.h"
@@ -72,6 +74,8 @@
 
 #include "score.h"
 
+#include "fmt/chrono.h"
+
 #include <algorithm>
 
 using namespace flags::operators;
@@ -393,23 +397,49 @@ void Osu::doDeferredInitTasks() {
     // now handle commandline arguments after we have loaded everything
     env->getEnvInterop().handle_cmdline_args();
 
-    // extract osks & watch for osks to extract
+    // extract osks & watch for osks to extract, and for edits to the files of the current skin
     {
-        const auto osks = env->getFilesInFolder(NEOSU_SKINS_PATH "/");
-        for(const auto &file : osks) {
-            if(env->getFileExtensionFromFilePath(file) != "osk") continue;
-            auto path = NEOSU_SKINS_PATH "/" + file;
-            const bool extracted = env->getEnvInterop().handle_osk(path.c_str());
-            if(extracted) env->deleteFile(path);
-        }
+        static auto extractOsks = []() -> void {
+            const auto osks = env->getFilesInFolder(NEOSU_SKINS_PATH "/");
+            for(const auto &file : osks) {
+                if(env->getFileExtensionFromFilePath(file) != "osk") continue;
+                auto path = NEOSU_SKINS_PATH "/" + file;
+                const bool extracted = env->getEnvInterop().handle_osk(path.c_str());
+                if(extracted) env->deleteFile(path);
+            }
+        };
+        extractOsks();
+
+        directoryWatcher->watch_directory(
+            NEOSU_SKINS_PATH "/",
+            [](const FileChangeEvent &ev) -> void {
+                if(!osu) return;
+                if(ev.type == FileChangeType::RESCAN) {
+                    // events were lost, so anything could have changed
+                    extractOsks();
+                    osu->bSkinFilesChanged = true;
+                    return;
+                }
 
-        directoryWatcher->watch_directory(NEOSU_SKINS_PATH "/", [](const FileChangeEvent &ev) -> void {
-            if(ev.type != FileChangeType::CREATED) return;
-            logRaw("[DirectoryWatcher] Importing new skin {}: type {}", ev.path, static_cast<u32>(ev.type));
-            if(env->getFileExtensionFromFilePath(ev.path) != "osk") return;
-            const bool extracted = env->getEnvInterop().handle_osk(ev.path.c_str());
-            if(extracted) env->deleteFile(ev.path);
-        });
+                std::string path{ev.path};
+                File::normalizeSlashes(path, '\\', '/');
+
+                constexpr uSz rootLen = sizeof(NEOSU_SKINS_PATH "/") - 1;
+                if(path.find('/', rootLen) == std::string::npos) {
+                    // top level: only osks to import
+                    if(ev.type != FileChangeType::CREATED) return;
+                    if(env->getFileExtensionFromFilePath(path) != "osk") return;
+                    logRaw("[DirectoryWatcher] Importing new skin {}", path);
+                    const bool extracted = env->getEnvInterop().handle_osk(path.c_str());
+                    if(extracted) env->deleteFile(path);
+                    return;
+                }
+
+                if(osu->skin && path.starts_with(osu->skin->skin_dir)) {
+                    osu->bSkinFilesChanged = true;
+                }
+            },
+            true);
     }
 
     env->setCursorVisible(!this->internalRect.contains(mouse->getPos()));
@@ -712,6 +742,13 @@ void Osu::update() {
         BANCHO::Net::update_networking();
     }
 
+    // reload the current skin after its files were edited (once per batch of changes, and not mid-play)
+    if(this->bSkinFilesChanged && !this->bSkinLoadScheduled && !this->skinScheduledToLoad && !this->isInPlayMode() &&
+       !cv::skin_random.getBool()) {
+        this->bSkinFilesChanged = false;
+        this->onSkinReload();
+    }
+
     // skin async loading
     if(this->bSkinLoadScheduled) {
         if((!this->skin.get() || this->skin->isReady()) && this->skinScheduledToLoad != nullptr &&
@@ -767,6 +804,9 @@ void Osu::updateMods() {
     {
         auto idx = StarPrecalc::index_of(this->score->mods.flags, this->score->mods.speed);
         StarPrecalc::active_idx = (idx != StarPrecalc::INVALID_MODCOMBO) ? (u8)idx : StarPrecalc::NOMOD_1X_INDEX;
+
+        // overrides active_idx if none of the precalculated ratings match
+        AsyncStarCalc::set_active_mods(this->score->mods);
     }
 
     if(this->isInPlayMode()) {
@@ -1305,6 +1345,16 @@ void Osu::saveScreenshot() {
 void Osu::onPlayEnd(const FinishedScore &score, bool quit) {
     cv::snd_change_check_interval.setValue(cv::snd_change_check_interval.getDefaultFloat());
 
+    const FrameTimeStats &frameTimes = engine->getFrameTimeStats();
+    if(cv::debug_frametimes.getBool()) {
+        debugLog("frame times:\n{}", frameTimes.summary());
+
+        const auto path = fmt::format(NEOSU_DATA_DIR "frametimes_{:%F-%H-%M-%S}.csv", fmt::gmtime(std::time(nullptr)));
+        io->write(path, frameTimes.toCsv(), [path](bool success) {
+            if(!success) debugLog("failed to write {}", path);
+        });
+    }
+
     if(!quit && cv::mod_endless.getBool()) {
         this->bScheduleEndlessModNextBeatmap = true;
         return;  // nothing more to do here
@@ -1314,6 +1364,7 @@ void Osu::onPlayEnd(const FinishedScore &score, bool quit) {
         ui->setScreen(ui->getSongBrowser());
     } else {
         ui->getRankingScreen()->setScore(score);
+        ui->getRankingScreen()->setFrameTimes(frameTimes);
         ui->setScreen(ui->getRankingScreen());
         soundEngine->play(this->skin->s_applause);
     }
@@ -340,6 +340,7 @@ class Osu final : public App, public MouseListener {
     bool bScheduleEndlessModNextBeatmap{false};
     bool bWasBossKeyPaused{false};
     bool bSkinLoadWasReload{false};
+    bool bSkinFilesChanged{false};  // set by the skins directory watcher
     bool bFontReloadScheduled{false};
 
     friend class BeatmapInterface;
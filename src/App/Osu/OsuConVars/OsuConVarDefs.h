@@ -80,6 +80,8 @@ CONVAR(debug_hiterrorbar_misaims, false, CLIENT);
 CONVAR(debug_pp, false, CLIENT);
 CONVAR(debug_bg_loader, false, CLIENT);
 CONVAR(debug_thumbs, false, CLIENT);
+CONVAR(debug_frametimes, false, CLIENT,
+       "after every play, log frame time percentiles and write the histograms to frametimes_<date>.csv");
 CONVAR(slider_debug_draw, false, CLIENT | SERVER | PROTECTED | GAMEPLAY,
        "draw hitcircle at every curve point and nothing else (no vao, no rt, no shader, nothing) "
        "(requires enabling legacy slider renderer)");
@@ -144,6 +146,7 @@ CONVAR(win_disable_windows_key_while_playing, true, CLIENT);
 
 // Files
 CONVAR(database_enabled, true, CLIENT);
+CONVAR(database_import_threads, 0.f, CLIENT, "threads used for raw beatmap folder imports (0 = autodetect)");
 CONVAR(database_ignore_version, true, CLIENT, "ignore upper version limit and force load the db file (may crash)");
 CONVAR(database_version, OSU_VERSION_DATEONLY, CLIENT | NOLOAD | NOSAVE,
        "maximum supported osu!.db version, above this will use fallback loader");
@@ -555,6 +558,7 @@ CONVAR(beatmap_mirror_override, ""sv, CLIENT, "URL of custom beatmap download mi
 CONVAR(chat_auto_hide, true, CLIENT, "automatically hide chat during gameplay");
 CONVAR(chat_highlight_words, ""sv, CLIENT, "space-separated list of words to treat as a mention");
 CONVAR(chat_ignore_list, ""sv, CLIENT, "space-separated list of words to ignore");
+CONVAR(chat_max_messages, 1000, CLIENT, "maximum number of messages kept per chat channel (oldest get dropped)");
 CONVAR(chat_notify_on_dm, true, CLIENT);
 CONVAR(chat_notify_on_mention, true, CLIENT, "get notified when someone says your name");
 CONVAR(chat_ping_on_mention, true, CLIENT, "play a sound when someone says your name");
@@ -620,7 +624,14 @@ CONVAR(main_menu_startup_anim_duration, 0.25f, CLIENT | SKINS | SERVER);
 CONVAR(main_menu_use_server_logo, true, CLIENT | SKINS | SERVER);
 
 // Not sorted
+CONVAR(diffcalc_idle_all_cores, true, CLIENT,
+       "spawn extra workers which recalculate stars/pp on every CPU core while idling in the main menu");
 CONVAR(diffcalc_threads, 0.f, CLIENT, "0 = autodetect");
+CONVAR(starcalc_cache_size, 100000, CLIENT,
+       "maximum number of star ratings kept for mods which aren't precalculated (e.g. custom speed, AR/CS/OD overrides)");
+CONVAR(starcalc_threads, 0, CLIENT, "threads computing star ratings for mods which aren't precalculated, 0 = autodetect");
+CONVAR(ppcalc_cache_size_mb, 32, CLIENT,
+       "memory budget (in MB) for pp results of the selected beatmap, least recently used ones are dropped first");
 CONVAR(beatmap_preview_mods_live, false, CLIENT | SKINS | SERVER,
        "whether to immediately apply all currently selected mods while browsing beatmaps (e.g. speed/pitch)");
 CONVAR(beatmap_preview_music_loop, true, CLIENT | SKINS | SERVER);
@@ -952,6 +963,8 @@ CONVAR(stars_ignore_clamped_sliders, true, CLIENT | SKINS | SERVER,
 CONVAR(stars_slider_curve_points_separation, 20.0f, CLIENT | SKINS | SERVER,
        "massively reduce curve accuracy for star calculations to save memory/performance");
 CONVAR(stars_stacking, true, CLIENT | SKINS | SERVER, "respect hitobject stacking before calculating stars/pp");
+CONVAR(stars_verify_strain_kernels, false, CLIENT,
+       "also run the scalar reference path for every star calculation, and log results that aren't bit-identical");
 CONVAR(start_first_main_menu_song_at_preview_point, false, CLIENT);
 CONVAR(submit_after_pause, true, CLIENT | SERVER);
 CONVAR(submit_scores, false, CLIENT | SERVER);
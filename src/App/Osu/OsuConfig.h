@@ -16,6 +16,7 @@
 #define NEOSU_SCREENSHOTS_PATH	NEOSU_DATA_DIR "screenshots"
 #define NEOSU_SKINS_PATH		NEOSU_DATA_DIR "skins"
 #define NEOSU_DB_DIR			NEOSU_DATA_DIR // default is top-level, next to exe
+#define NEOSU_SEARCH_INDEX_PATH	NEOSU_DB_DIR "neosu_maps.idx"
 
 CASSERT_STR_ENDSWITH(NEOSU_DATA_DIR, '/');
 CASSERT_STR_ENDSWITH(NEOSU_DB_DIR, '/');
@@ -0,0 +1,225 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "PlayerStatsIndex.h"
+
+#include "Database.h"
+#include "ModFlags.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {  // static namespace
+
+bool counts_for_stats(const FinishedScore &score, bool include_relax_autopilot) {
+    return include_relax_autopilot ||
+           !((u64)score.mods.flags & ((u64)ModFlags::Relax | (u64)ModFlags::Autopilot));
+}
+
+// "If n is the amount of scores giving more pp than a given score, then the score's weight is 0.95^n"
+f64 rank_weight(u32 rank) { return std::pow(0.95, (f64)rank); }
+
+}  // namespace
+
+bool PlayerStatsIndex::EntryOrder::operator()(const Entry &a, const Entry &b) const {
+    const f64 a_pp = std::max(a.pp * 1000.0, 0.0);
+    const f64 b_pp = std::max(b.pp * 1000.0, 0.0);
+    if(a_pp != b_pp) return a_pp > b_pp;
+    if(a.score != b.score) return a.score > b.score;
+    if(a.unixTimestamp != b.unixTimestamp) return a.unixTimestamp > b.unixTimestamp;
+    if(a.player_id != b.player_id) return a.player_id > b.player_id;
+    if(a.play_time_ms != b.play_time_ms) return a.play_time_ms > b.play_time_ms;
+    return std::memcmp(a.beatmap_hash.data(), b.beatmap_hash.data(), a.beatmap_hash.size()) < 0;
+}
+
+void PlayerStatsIndex::pull(Node &node) {
+    const u32 left_size = node.left ? node.left->size : 0;
+    const f64 weight = rank_weight(left_size);
+
+    node.size = left_size + 1;
+    node.weighted_pp = node.entry.pp * weight;
+    node.weighted_acc = node.entry.accuracy * weight;
+    if(node.left) {
+        node.weighted_pp += node.left->weighted_pp;
+        node.weighted_acc += node.left->weighted_acc;
+    }
+    if(node.right) {
+        // everything on the right ranks below this node and its left subtree
+        const f64 right_weight = weight * 0.95;
+        node.size += node.right->size;
+        node.weighted_pp += node.right->weighted_pp * right_weight;
+        node.weighted_acc += node.right->weighted_acc * right_weight;
+    }
+}
+
+// splits into the entries ordered before key, and the rest
+std::pair<PlayerStatsIndex::NodePtr, PlayerStatsIndex::NodePtr> PlayerStatsIndex::split(NodePtr node,
+                                                                                        const Entry &key) {
+    if(!node) return {};
+
+    if(EntryOrder{}(node->entry, key)) {
+        auto [left, right] = split(std::move(node->right), key);
+        node->right = std::move(left);
+        pull(*node);
+        return {std::move(node), std::move(right)};
+    }
+
+    auto [left, right] = split(std::move(node->left), key);
+    node->left = std::move(right);
+    pull(*node);
+    return {std::move(left), std::move(node)};
+}
+
+// every entry in left must be ordered before every entry in right
+PlayerStatsIndex::NodePtr PlayerStatsIndex::merge(NodePtr left, NodePtr right) {
+    if(!left) return right;
+    if(!right) return left;
+
+    if(left->priority > right->priority) {
+        left->right = merge(std::move(left->right), std::move(right));
+        pull(*left);
+        return left;
+    }
+
+    right->left = merge(std::move(left), std::move(right->left));
+    pull(*right);
+    return right;
+}
+
+bool PlayerStatsIndex::erase(NodePtr &node, const Entry &key) {
+    if(!node) return false;
+
+    const EntryOrder less;
+    if(less(key, node->entry)) {
+        if(!erase(node->left, key)) return false;
+    } else if(less(node->entry, key)) {
+        if(!erase(node->right, key)) return false;
+    } else {
+        node = merge(std::move(node->left), std::move(node->right));
+        return true;
+    }
+
+    pull(*node);
+    return true;
+}
+
+void PlayerStatsIndex::collectTopScores(const Node *node, std::vector<TopScore> &out) {
+    if(!node) return;
+    collectTopScores(node->left.get(), out);
+    out.push_back({.beatmap_hash = node->entry.beatmap_hash, .unixTimestamp = node->entry.unixTimestamp});
+    collectTopScores(node->right.get(), out);
+}
+
+void PlayerStatsIndex::rebuild(const Hash::flat::map<MD5Hash, std::vector<FinishedScore>> &scores,
+                               bool include_relax_autopilot) {
+    Sync::scoped_lock lock(this->mtx);
+    this->players.clear();
+    this->include_relax_autopilot = include_relax_autopilot;
+    this->built = true;
+
+    for(const auto &[hash, scorevec] : scores) {
+        for(const auto &score : scorevec) {
+            Player &player = this->players[score.playerName];
+            if(player.beatmaps.contains(hash)) continue;  // already went through this player's scores on it
+            this->updatePlayer(player, hash, scorevec, score.playerName);
+        }
+    }
+}
+
+void PlayerStatsIndex::update(const MD5Hash &beatmap_hash, std::span<const FinishedScore> scores,
+                              std::string_view player_name) {
+    Sync::scoped_lock lock(this->mtx);
+    if(!this->built) return;
+
+    auto it = this->players.find(player_name);
+    if(it == this->players.end()) {
+        it = this->players.emplace(std::string{player_name}, Player{}).first;
+    }
+    this->updatePlayer(it->second, beatmap_hash, scores, player_name);
+}
+
+void PlayerStatsIndex::updatePlayer(Player &player, const MD5Hash &beatmap_hash, std::span<const FinishedScore> scores,
+                                    std::string_view player_name) {
+    const FinishedScore *best = nullptr;
+    f64 best_pp = -1.0;
+    u64 total_score = 0;
+    for(const auto &score : scores) {
+        if(score.playerName != player_name || !counts_for_stats(score, this->include_relax_autopilot)) continue;
+
+        total_score += score.score;
+
+        // scores without pp yet only stay the best one until any other score comes along
+        const f64 pp = score.get_pp();
+        if(best == nullptr || pp > best_pp || best_pp < 0.0) {
+            best = &score;
+            best_pp = pp;
+        }
+    }
+
+    if(const auto &it = player.beatmaps.find(beatmap_hash); it != player.beatmaps.end()) {
+        erase(player.by_pp, it->second.best);
+        player.total_score -= it->second.total_score;
+        player.beatmaps.erase(it);
+    }
+
+    if(best != nullptr) {
+        const Entry entry{
+            .pp = best_pp,
+            .accuracy = LiveScore::calculateAccuracy(best->num300s, best->num100s, best->num50s, best->numMisses),
+            .score = best->score,
+            .unixTimestamp = best->unixTimestamp,
+            .player_id = best->player_id,
+            .play_time_ms = best->play_time_ms,
+            .beatmap_hash = beatmap_hash,
+        };
+        auto node = std::make_unique<Node>(Node{.entry = entry, .priority = (u32)this->rng()});
+        pull(*node);
+
+        auto [left, right] = split(std::move(player.by_pp), entry);
+        player.by_pp = merge(merge(std::move(left), std::move(node)), std::move(right));
+
+        player.beatmaps.emplace(beatmap_hash, BeatmapScores{.best = entry, .total_score = total_score});
+        player.total_score += total_score;
+    }
+}
+
+bool PlayerStatsIndex::isBuilt() {
+    Sync::scoped_lock lock(this->mtx);
+    return this->built;
+}
+
+bool PlayerStatsIndex::includesRelaxAutopilot() {
+    Sync::scoped_lock lock(this->mtx);
+    return this->include_relax_autopilot;
+}
+
+PlayerStatsIndex::Totals PlayerStatsIndex::getTotals(std::string_view player_name) {
+    Sync::scoped_lock lock(this->mtx);
+
+    const auto &it = this->players.find(player_name);
+    if(it == this->players.end() || !it->second.by_pp) return {};
+
+    // "Total pp = PP[1] * 0.95^0 + PP[2] * 0.95^1 + PP[3] * 0.95^2 + ... + PP[n] * 0.95^(n-1)"
+    // also, total accuracy is apparently weighted the same as pp
+    const Node &root = *it->second.by_pp;
+
+    // normalize accuracy
+    const f32 acc = (f32)root.weighted_acc / (20.0f * (1.0f - Database::getWeightForIndex((i32)root.size)));
+
+    return {
+        .pp = (f32)root.weighted_pp,
+        .accuracy = acc,
+        .num_scores = root.size,
+        .total_score = it->second.total_score,
+    };
+}
+
+std::vector<PlayerStatsIndex::TopScore> PlayerStatsIndex::getTopScores(std::string_view player_name) {
+    Sync::scoped_lock lock(this->mtx);
+
+    std::vector<TopScore> top;
+    if(const auto &it = this->players.find(player_name); it != this->players.end() && it->second.by_pp) {
+        top.reserve(it->second.by_pp->size);
+        collectTopScores(it->second.by_pp.get(), top);
+    }
+    return top;
+}
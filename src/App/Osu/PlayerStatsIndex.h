@@ -0,0 +1,106 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "noinclude.h"
+#include "Hashing.h"
+#include "MD5Hash.h"
+#include "SyncMutex.h"
+#include "score.h"
+
+#include <memory>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Every player's best (highest pp) score on each beatmap, ordered by pp, for the local player stats.
+// Database updates it whenever a score is added, deleted or recalculated, which only re-evaluates that player's scores
+// on that one beatmap. The weighted totals are kept up to date along with it, in O(log n).
+class PlayerStatsIndex final {
+    NOCOPY_NOMOVE(PlayerStatsIndex)
+   public:
+    struct Totals {
+        f32 pp{0.f};         // weighted, without bonus pp
+        f32 accuracy{0.f};   // weighted the same way as pp, normalized
+        u32 num_scores{0};   // number of beatmaps with a score
+        u64 total_score{0};  // sum of all scores, not only the best ones
+    };
+
+    struct TopScore {
+        MD5Hash beatmap_hash;
+        u64 unixTimestamp;
+    };
+
+    PlayerStatsIndex() = default;
+    ~PlayerStatsIndex() = default;
+
+    // starts over from every loaded score
+    void rebuild(const Hash::flat::map<MD5Hash, std::vector<FinishedScore>> &scores, bool include_relax_autopilot);
+
+    // re-evaluates the scores set by player_name on a beatmap, after any of them were added, deleted or changed
+    void update(const MD5Hash &beatmap_hash, std::span<const FinishedScore> scores, std::string_view player_name);
+
+    [[nodiscard]] bool isBuilt();
+    [[nodiscard]] bool includesRelaxAutopilot();
+
+    Totals getTotals(std::string_view player_name);
+
+    // best score on each beatmap, highest pp first
+    std::vector<TopScore> getTopScores(std::string_view player_name);
+
+   private:
+    struct Entry {
+        f64 pp;
+        f32 accuracy;
+        u64 score;
+        u64 unixTimestamp;
+        i32 player_id;
+        u64 play_time_ms;
+        MD5Hash beatmap_hash;
+    };
+
+    // same order as Database::sortScoreByPP, then by beatmap (a player has one entry per beatmap)
+    struct EntryOrder {
+        bool operator()(const Entry &a, const Entry &b) const;
+    };
+
+    struct BeatmapScores {
+        Entry best;
+        u64 total_score;
+    };
+
+    // treap node ordered by EntryOrder
+    // also holds the pp and accuracy of its subtree, weighted by the rank inside of it, so that inserting or erasing
+    // an entry only has to update the nodes along its path instead of re-weighting every entry below it
+    struct Node {
+        Entry entry;
+        u32 priority;
+        u32 size{1};
+        f64 weighted_pp{0.0};
+        f64 weighted_acc{0.0};
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+    using NodePtr = std::unique_ptr<Node>;
+
+    struct Player {
+        Hash::flat::map<MD5Hash, BeatmapScores> beatmaps;
+        NodePtr by_pp;
+        u64 total_score{0};
+    };
+
+    static void pull(Node &node);
+    static std::pair<NodePtr, NodePtr> split(NodePtr node, const Entry &key);
+    static NodePtr merge(NodePtr left, NodePtr right);
+    static bool erase(NodePtr &node, const Entry &key);
+    static void collectTopScores(const Node *node, std::vector<TopScore> &out);
+
+    void updatePlayer(Player &player, const MD5Hash &beatmap_hash, std::span<const FinishedScore> scores,
+                      std::string_view player_name);
+
+    Sync::mutex mtx;
+    Hash::unstable_stringmap<Player> players;
+    std::minstd_rand rng;
+    bool built{false};
+    bool include_relax_autopilot{false};
+};
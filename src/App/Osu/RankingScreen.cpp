@@ -35,6 +35,7 @@
 #include "SongBrowser/SongBrowser.h"
 #include "SoundEngine.h"
 #include "SpectatorScreen.h"
+#include "SString.h"
 #include "TooltipOverlay.h"
 #include "UI.h"
 #include "UIButton.h"
@@ -371,6 +372,13 @@ void RankingScreen::update(CBaseUIEventCtx &c) {
                     fmt::format("Error: {:.2f}ms - {:.2f}ms avg", this->fHitErrorAvgMin, this->fHitErrorAvgMax));
                 tto->addLine(fmt::format("Unstable Rate: {:.2f}", this->fUnstableRate));
             }
+
+            if(!this->frameTimeLines.empty()) {
+                tto->addLine("Frame times:");
+                for(const auto &line : this->frameTimeLines) {
+                    tto->addLine(line);
+                }
+            }
         }
         tto->end();
     }
@@ -399,8 +407,18 @@ void RankingScreen::onRetryClicked() {
 
 void RankingScreen::onWatchClicked() { LegacyReplay::load_and_watch(this->storedScore); }
 
+void RankingScreen::setFrameTimes(const FrameTimeStats &stats) {
+    this->frameTimeLines.clear();
+    if(stats.frame.count() == 0) return;
+
+    for(const auto line : SString::split(stats.summary(), '\n')) {
+        this->frameTimeLines.emplace_back(line);
+    }
+}
+
 void RankingScreen::setScore(const FinishedScore &newscore) {
     this->storedScore = newscore;
+    this->frameTimeLines.clear();
     auto &sc = this->storedScore;
 
     this->songInfo->setFromBeatmap(sc.map);
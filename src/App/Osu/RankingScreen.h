@@ -17,6 +17,7 @@ class RankingScreenIndexLabel;
 class RankingScreenBottomElement;
 
 class ConVar;
+struct FrameTimeStats;
 
 class RankingScreen final : public ScreenBackable {
    public:
@@ -31,6 +32,7 @@ class RankingScreen final : public ScreenBackable {
     void onWatchClicked();
 
     void setScore(const FinishedScore &score);
+    void setFrameTimes(const FrameTimeStats &stats);  // only for plays which just ended, cleared by setScore()
 
    private:
     void updateLayout() override;
@@ -85,4 +87,6 @@ class RankingScreen final : public ScreenBackable {
     // custom
     FinishedScore storedScore;
     bool bIsUnranked;
+
+    std::vector<UString> frameTimeLines;
 };
@@ -0,0 +1,169 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "ScoresJournal.h"
+
+#include "File.h"
+#include "Logging.h"
+
+#include <zlib.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+
+namespace {  // static namespace
+
+constexpr u32 MAGIC = 0x4A43534E;  // "NSCJ"
+constexpr uSz HEADER_SIZE = 2 * sizeof(u32);
+constexpr uSz RECORD_OVERHEAD = sizeof(u32) + sizeof(u8) + sizeof(u32);
+
+// a score is a few hundred bytes, a bigger size can only come from a corrupt record
+constexpr u32 MAX_PAYLOAD_SIZE = 1024ULL * 1024;
+
+u32 checksum(u8 type, std::span<const u8> payload) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, &type, 1);
+    crc = crc32(crc, payload.data(), static_cast<uInt>(payload.size()));
+    return static_cast<u32>(crc);
+}
+
+void append_bytes(std::vector<u8> &out, const void *data, uSz size) {
+    const auto *bytes = static_cast<const u8 *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+}  // namespace
+
+std::vector<ScoresJournal::Record> ScoresJournal::load() {
+    std::vector<Record> records;
+    this->num_records = 0;
+
+    std::vector<u8> data;
+    if(FILE *file = File::fopen_c(this->path.c_str(), "rb")) {
+        u8 chunk[16384];
+        uSz nb_read = 0;
+        while((nb_read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            append_bytes(data, chunk, nb_read);
+        }
+        fclose(file);
+    }
+    if(data.empty()) return records;
+
+    u32 magic = 0;
+    u32 file_version = 0;
+    if(data.size() >= HEADER_SIZE) {
+        std::memcpy(&magic, &data[0], sizeof(u32));
+        std::memcpy(&file_version, &data[sizeof(u32)], sizeof(u32));
+    }
+    if(magic != MAGIC || file_version != this->version) {
+        // there is no reader for other score layouts, but its scores shouldn't just disappear either
+        const std::string kept_path = fmt::format("{:s}.{:d}-{:d}", this->path, file_version, std::time(nullptr));
+        std::error_code ec;
+        std::filesystem::rename(File::getFsPath(this->path), File::getFsPath(kept_path), ec);
+        if(ec) {
+            debugLog("Not using {:s} (not a score journal, or from version {:d}), and failed to move it aside: {:s}",
+                     this->path, file_version, ec.message());
+            this->blocked = true;
+        } else {
+            debugLog("Not replaying {:s} (not a score journal, or from version {:d}), kept it as {:s}", this->path,
+                     file_version, kept_path);
+        }
+        return records;
+    }
+
+    uSz pos = HEADER_SIZE;
+    while(data.size() - pos >= RECORD_OVERHEAD) {
+        u32 size = 0;
+        std::memcpy(&size, &data[pos], sizeof(u32));
+        if(size > MAX_PAYLOAD_SIZE || data.size() - pos - RECORD_OVERHEAD < size) break;
+
+        const u8 type = data[pos + sizeof(u32)];
+        const std::span<const u8> payload{&data[pos + sizeof(u32) + sizeof(u8)], size};
+
+        u32 crc = 0;
+        std::memcpy(&crc, payload.data() + size, sizeof(u32));
+        if(crc != checksum(type, payload)) break;
+
+        records.push_back({.type = static_cast<RecordType>(type), .payload = {payload.begin(), payload.end()}});
+        pos += RECORD_OVERHEAD + size;
+    }
+
+    if(pos != data.size()) {
+        debugLog("{:s}: dropping {:d} bytes of incomplete records after record {:d}", this->path, data.size() - pos,
+                 records.size());
+
+        // so that new records don't end up behind the garbage
+        std::error_code ec;
+        std::filesystem::resize_file(File::getFsPath(this->path), pos, ec);
+        if(ec) {
+            debugLog("Failed to truncate {:s}: {:s}", this->path, ec.message());
+        }
+    }
+
+    this->num_records = records.size();
+    return records;
+}
+
+bool ScoresJournal::append(RecordType type, std::span<const u8> payload) {
+    if(this->blocked) return false;
+
+    FILE *file = File::fopen_c(this->path.c_str(), "ab");
+    if(file == nullptr) {
+        debugLog("Failed to open {:s}: {:s}", this->path, std::generic_category().message(errno));
+        return false;
+    }
+
+    // the position of append-mode streams is unspecified until the first write
+    fseek(file, 0, SEEK_END);
+    const long start = ftell(file);
+
+    std::vector<u8> buf;
+    buf.reserve(HEADER_SIZE + RECORD_OVERHEAD + payload.size());
+    if(start == 0) {
+        append_bytes(buf, &MAGIC, sizeof(MAGIC));
+        append_bytes(buf, &this->version, sizeof(this->version));
+    }
+
+    const auto size = static_cast<u32>(payload.size());
+    const auto type_byte = static_cast<u8>(type);
+    const u32 crc = checksum(type_byte, payload);
+    append_bytes(buf, &size, sizeof(size));
+    append_bytes(buf, &type_byte, sizeof(type_byte));
+    append_bytes(buf, payload.data(), payload.size());
+    append_bytes(buf, &crc, sizeof(crc));
+
+    const bool success =
+        start >= 0 && fwrite(buf.data(), 1, buf.size(), file) == buf.size() && File::flushToDisk(file);
+    if(!success) {
+        debugLog("Failed to append to {:s}: {:s}", this->path, std::generic_category().message(errno));
+    }
+    fclose(file);
+
+    if(!success) {
+        // don't leave a partial record behind for the next append
+        if(start >= 0) {
+            std::error_code ec;
+            std::filesystem::resize_file(File::getFsPath(this->path), static_cast<uSz>(start), ec);
+        }
+        return false;
+    }
+
+    this->num_records++;
+    return true;
+}
+
+bool ScoresJournal::clear() {
+    if(this->blocked) return false;  // not ours to remove
+
+    std::error_code ec;
+    std::filesystem::remove(File::getFsPath(this->path), ec);
+    if(ec) {
+        debugLog("Failed to remove {:s}: {:s}", this->path, ec.message());
+        return false;
+    }
+
+    this->num_records = 0;
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "noinclude.h"
+
+#include <span>
+#include <string>
+#include <vector>
+
+// Append-only log of the score changes made since neosu_scores.db was last written in full:
+//
+//   u32 magic, u32 version (NEOSU_SCORE_DB_VERSION, the payloads use the same score layout)
+//   records: u32 payload size, u8 type, payload, u32 crc32 of type + payload
+//
+// Every append is synced to disk before returning, so a finished play only costs one small write instead of
+// rewriting every score. The records are replayed on top of neosu_scores.db when loading, and the journal is emptied
+// once the full database has been written again.
+class ScoresJournal final {
+    NOCOPY_NOMOVE(ScoresJournal)
+   public:
+    enum class RecordType : u8 {
+        SCORE_ADDED = 1,    // beatmap hash + score, replaces the score with the same timestamp and player name
+        SCORE_DELETED = 2,  // beatmap hash, timestamp and player name of the deleted score
+    };
+
+    struct Record {
+        RecordType type;
+        std::vector<u8> payload;
+    };
+
+    ScoresJournal(std::string path, u32 version) : path(std::move(path)), version(version) {}
+    ~ScoresJournal() = default;
+
+    // reads every intact record
+    // a torn or corrupt tail (e.g. from crashing mid-append) is cut off
+    // journals from other versions aren't replayed, they're moved aside to "<path>.<version>-<unix time>" instead
+    std::vector<Record> load();
+
+    // returns false if the record couldn't be written and synced to disk
+    bool append(RecordType type, std::span<const u8> payload);
+
+    // empties the journal, once all of its records are part of the full database
+    bool clear();
+
+    // number of records since the journal was last emptied
+    [[nodiscard]] inline u32 getNumRecords() const { return this->num_records; }
+
+   private:
+    std::string path;
+    u32 version;
+    u32 num_records{0};
+    bool blocked{false};  // a journal from another version couldn't be moved aside, leave it alone
+};
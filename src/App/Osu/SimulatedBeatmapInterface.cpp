@@ -1,6 +1,8 @@
 #include "SimulatedBeatmapInterface.h"
 
 #include <algorithm>
+#include <cstring>
+#include <iterator>
 
 #include "DatabaseBeatmap.h"
 #include "GameRules.h"
@@ -10,6 +12,13 @@
 #include "OsuConVars.h"
 #include "Timing.h"
 
+namespace {  // static namespace
+
+// map time between checkpoints, seeking has to simulate at most this much of the replay
+constexpr i32 CHECKPOINT_INTERVAL_MS = 5000;
+
+}  // namespace
+
 SimulatedBeatmapInterface::SimulatedBeatmapInterface(DatabaseBeatmap *map, const Replay::Mods &mods_)
     : AbstractBeatmapInterface() {
     this->beatmap = map;
@@ -72,7 +81,157 @@ void SimulatedBeatmapInterface::simulate_to(i32 music_pos) {
         this->iCurMusicPos = current_frame.cur_music_pos;
 
         this->update(frame_time);
+
+        // only on the first pass, after seeking back the same states are simulated again
+        if(!this->checkpoints.empty() &&
+           this->iCurMusicPos >= this->checkpoints.back().music_pos + CHECKPOINT_INTERVAL_MS) {
+            this->saveCheckpoint();
+        }
+    }
+}
+
+void SimulatedBeatmapInterface::seek_to(i32 music_pos) {
+    if(this->checkpoints.empty()) return;
+
+    // latest checkpoint at or before music_pos, or the initial state (replays can start before 0)
+    auto it = std::ranges::upper_bound(this->checkpoints, music_pos, {}, &Checkpoint::music_pos);
+    if(it != this->checkpoints.begin()) it = std::prev(it);
+
+    // when seeking forwards, only restore it if it's ahead of the current state
+    if(music_pos >= this->iCurMusicPos && it->music_pos <= this->iCurMusicPos) return;
+
+    this->restoreCheckpoint(*it);
+}
+
+void SimulatedBeatmapInterface::saveCheckpoint() {
+    const u32 num_hitobjects = this->hitobjects.size();
+    const i32 pvs = this->getPVS();
+
+    // finished hitobjects which are out of the PVS never get updated again (see update())
+    u32 first_live = this->frozen_states.offsets.size();
+    while(first_live < num_hitobjects) {
+        const HitObject *hitobject = this->hitobjects[first_live].get();
+        if(!hitobject->isFinished() || this->iCurMusicPos - pvs <= hitobject->getEndTime()) break;
+
+        this->frozen_states.offsets.push_back(this->frozen_states.data.size());
+        hitobject->saveState(this->frozen_states.data);
+        first_live++;
+    }
+
+    // skip the hitobjects at the end which are still in their initial state
+    std::vector<u8> state;
+    u32 end_live = num_hitobjects;
+    while(end_live > first_live) {
+        const u32 idx = end_live - 1;
+        const u32 initial_start = this->initial_states.offsets[idx];
+        const u32 initial_end =
+            idx + 1 < num_hitobjects ? this->initial_states.offsets[idx + 1] : this->initial_states.data.size();
+
+        state.clear();
+        this->hitobjects[idx]->saveState(state);
+        if(state.size() != initial_end - initial_start ||
+           std::memcmp(state.data(), &this->initial_states.data[initial_start], state.size()) != 0) {
+            break;
+        }
+        end_live--;
+    }
+
+    std::vector<u8> states;
+    for(u32 i = first_live; i < end_live; i++) {
+        this->hitobjects[i]->saveState(states);
+    }
+
+    // copy the score without its (growing) hit history, so checkpoint memory stays linear in the map length
+    auto &score = this->live_score;
+    std::vector<LiveScore::HIT> hitresults = std::move(score.hitresults);
+    std::vector<int> hitdeltas = std::move(score.hitdeltas);
+    LiveScore score_state = score;
+    score.hitresults = std::move(hitresults);
+    score.hitdeltas = std::move(hitdeltas);
+
+    this->checkpoints.push_back(Checkpoint{
+        .music_pos = this->iCurMusicPos,
+        .frame_idx = this->current_frame_idx,
+        .current_keys = this->current_keys,
+        .last_keys = this->last_keys,
+        .last_pressed_key = this->lastPressedKey,
+        .holding_slider = this->holding_slider,
+        .interpolated_mouse_pos = this->interpolatedMousePos,
+        .live_score = std::move(score_state),
+        .num_hitresults = (u32)score.hitresults.size(),
+        .num_hitdeltas = (u32)score.hitdeltas.size(),
+        .health = this->fHealth,
+        .failed = this->bFailed,
+        .in_break = this->bInBreak,
+        .spinner_active = this->bIsSpinnerActive,
+        .next_hitobject_time = this->iNextHitObjectTime,
+        .previous_hitobject_time = this->iPreviousHitObjectTime,
+        .allow_any_next_key_until_hitobject_index = this->iAllowAnyNextKeyUntilHitObjectIndex,
+        .nps = this->iNPS,
+        .nd = this->iND,
+        .current_hitobject_index = this->iCurrentHitObjectIndex,
+        .playfield_rotation = this->fPlayfieldRotation,
+        .auto_cursor_pos = this->vAutoCursorPos,
+        .clicks = this->clicks,
+        .first_live = first_live,
+        .end_live = end_live,
+        .states = std::move(states),
+    });
+}
+
+void SimulatedBeatmapInterface::restoreCheckpoint(const Checkpoint &checkpoint) {
+    const u32 num_hitobjects = this->hitobjects.size();
+
+    for(u32 i = 0; i < checkpoint.first_live; i++) {
+        const u8 *in = &this->frozen_states.data[this->frozen_states.offsets[i]];
+        this->hitobjects[i]->loadState(in);
+    }
+
+    const u8 *in = checkpoint.states.data();
+    for(u32 i = checkpoint.first_live; i < checkpoint.end_live; i++) {
+        this->hitobjects[i]->loadState(in);
+    }
+
+    for(u32 i = checkpoint.end_live; i < num_hitobjects; i++) {
+        const u8 *initial = &this->initial_states.data[this->initial_states.offsets[i]];
+        this->hitobjects[i]->loadState(initial);
     }
+
+    this->iCurMusicPos = checkpoint.music_pos;
+    this->current_frame_idx = checkpoint.frame_idx;
+    this->current_keys = checkpoint.current_keys;
+    this->last_keys = checkpoint.last_keys;
+    this->lastPressedKey = checkpoint.last_pressed_key;
+    this->holding_slider = checkpoint.holding_slider;
+    this->interpolatedMousePos = checkpoint.interpolated_mouse_pos;
+
+    // keep the longest history around, seeking forwards can restore a checkpoint past the current state
+    auto &score = this->live_score;
+    if(score.hitresults.size() > this->hit_history.hitresults.size())
+        this->hit_history.hitresults = std::move(score.hitresults);
+    if(score.hitdeltas.size() > this->hit_history.hitdeltas.size())
+        this->hit_history.hitdeltas = std::move(score.hitdeltas);
+
+    score = checkpoint.live_score;
+    score.hitresults.assign(this->hit_history.hitresults.begin(),
+                            this->hit_history.hitresults.begin() + checkpoint.num_hitresults);
+    score.hitdeltas.assign(this->hit_history.hitdeltas.begin(),
+                           this->hit_history.hitdeltas.begin() + checkpoint.num_hitdeltas);
+
+    this->fHealth = checkpoint.health;
+    this->bFailed = checkpoint.failed;
+    this->bInBreak = checkpoint.in_break;
+    this->bIsSpinnerActive = checkpoint.spinner_active;
+    this->currentHitObject = nullptr;  // recomputed by the next update()
+    this->iNextHitObjectTime = checkpoint.next_hitobject_time;
+    this->iPreviousHitObjectTime = checkpoint.previous_hitobject_time;
+    this->iAllowAnyNextKeyUntilHitObjectIndex = checkpoint.allow_any_next_key_until_hitobject_index;
+    this->iNPS = checkpoint.nps;
+    this->iND = checkpoint.nd;
+    this->iCurrentHitObjectIndex = checkpoint.current_hitobject_index;
+    this->fPlayfieldRotation = checkpoint.playfield_rotation;
+    this->vAutoCursorPos = checkpoint.auto_cursor_pos;
+    this->clicks = checkpoint.clicks;
 }
 
 bool SimulatedBeatmapInterface::start() {
@@ -108,6 +267,17 @@ bool SimulatedBeatmapInterface::start() {
 
     this->bInBreak = false;
 
+    // everything seek_to() rewinds to
+    this->initial_states = {};
+    this->frozen_states = {};
+    this->hit_history = {};
+    this->checkpoints.clear();
+    for(const auto &hitobject : this->hitobjects) {
+        this->initial_states.offsets.push_back(this->initial_states.data.size());
+        hitobject->saveState(this->initial_states.data);
+    }
+    this->saveCheckpoint();
+
     // NOTE: loading failures are handled dynamically in update(), so temporarily assume everything has worked in here
     return true;
 }
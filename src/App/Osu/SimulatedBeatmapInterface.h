@@ -15,6 +15,10 @@ class SimulatedBeatmapInterface final : public AbstractBeatmapInterface {
 
     void simulate_to(i32 music_pos);
 
+    // rewinds (or skips ahead) to the latest checkpoint at or before music_pos, so that the next simulate_to() only
+    // has to simulate the remainder instead of the whole replay up to there
+    void seek_to(i32 music_pos);
+
     bool start();
     void update(f64 frame_time);
 
@@ -124,6 +128,60 @@ class SimulatedBeatmapInterface final : public AbstractBeatmapInterface {
     i32 iCurrentHitObjectIndex;
 
    private:
+    // serialized HitObject states, see HitObject::saveState()
+    struct ObjectStates {
+        std::vector<u8> data;
+        std::vector<u32> offsets;  // where each object's state starts in data
+    };
+
+    // everything the simulation depends on at some point of the replay, taken every few seconds of map time
+    struct Checkpoint {
+        i32 music_pos;
+        i32 frame_idx;
+        u8 current_keys;
+        u8 last_keys;
+        u8 last_pressed_key;
+        bool holding_slider;
+        vec2 interpolated_mouse_pos;
+
+        // without hitresults/hitdeltas, those are only stored as lengths into hit_history
+        LiveScore live_score;
+        u32 num_hitresults;
+        u32 num_hitdeltas;
+        f64 health;
+        bool failed;
+        bool in_break;
+        bool spinner_active;
+        i32 next_hitobject_time;
+        i32 previous_hitobject_time;
+        i32 allow_any_next_key_until_hitobject_index;
+        i32 nps;
+        i32 nd;
+        i32 current_hitobject_index;
+        float playfield_rotation;
+        vec2 auto_cursor_pos;
+        std::vector<Click> clicks;
+
+        // only the hitobjects [first_live, end_live) are stored here, the earlier ones already had their final state
+        // (see frozen_states) and the later ones were still untouched (see initial_states)
+        u32 first_live;
+        u32 end_live;
+        std::vector<u8> states;
+    };
+
+    void saveCheckpoint();
+    void restoreCheckpoint(const Checkpoint &checkpoint);
+
+    std::vector<Checkpoint> checkpoints;  // sorted by music_pos, the first one is the state right after loading
+    ObjectStates initial_states;          // all hitobjects, before the first update
+    ObjectStates frozen_states;           // the first hitobjects which can't change anymore, in order
+
+    // the longest hitresults/hitdeltas simulated so far, shorter ones are prefixes of it (replays are deterministic)
+    struct {
+        std::vector<LiveScore::HIT> hitresults;
+        std::vector<int> hitdeltas;
+    } hit_history;
+
     static inline vec2 mapNormalizedCoordsOntoUnitCircle(const vec2 &in) {
         return vec2(in.x * std::sqrt(1.0f - in.y * in.y / 2.0f), in.y * std::sqrt(1.0f - in.x * in.x / 2.0f));
     }
@@ -35,9 +35,109 @@ BeatmapCarousel::~BeatmapCarousel() {
     this->invalidate();
 }
 
+void BeatmapCarousel::invalidate() {
+    // the buttons might already be deleted at this point, so don't touch them
+    CBaseUIScrollView::invalidate();
+    this->rows.clear();
+    this->rowIndices.clear();
+    this->materialized.clear();
+    this->onScreenBegin = this->onScreenEnd = 0;
+    this->bRowsDirty = true;
+}
+
+void BeatmapCarousel::addRow(CarouselButton *button) {
+    this->rowIndices[button] = this->rows.size();
+    this->rows.push_back({.button = button, .y = 0.f});
+    this->bRowsDirty = true;
+}
+
+f32 BeatmapCarousel::getRowY(const CarouselButton *button) const {
+    if(const auto it = this->rowIndices.find(button); it != this->rowIndices.end()) return this->rows[it->second].y;
+    return button->getRelPos().y;
+}
+
+void BeatmapCarousel::setScrollSizeToRows(int border) {
+    // rows are laid out top to bottom, so the last one determines the content height
+    // (same result as setScrollSizeToContent(), without having every row in the container)
+    this->vScrollSize = {0., 0.};
+    if(!this->rows.empty()) {
+        const Row &last = this->rows.back();
+        const vec2 rowSize = CarouselButton::getScaledSize();
+        this->vScrollSize.x = last.button->getRelPos().x + rowSize.x;
+        this->vScrollSize.y = last.y + rowSize.y;
+    }
+
+    this->vScrollSize.x += border;
+    this->vScrollSize.y += border;
+
+    this->container.setSize(this->vScrollSize);
+
+    if(this->vScrollSize.y < this->getSize().y && this->vScrollPos.y != 1) this->scrollToY(1);
+
+    this->updateScrollbars();
+
+    this->bFirstScrollSizeToContent = false;
+    this->bClippingDirty = true;
+
+    // positions changed, so materialize immediately instead of waiting for the next update()
+    this->bRowsDirty = true;
+    this->updateOnScreenRows();
+}
+
+void BeatmapCarousel::updateOnScreenRows() {
+    // one extra screen above and below, so that fast scrolling/kinetic scrolling doesn't show gaps for a frame
+    const f32 viewTop = static_cast<f32>(-this->vScrollPos.y);
+    const f32 top = viewTop - this->getSize().y;
+    const f32 bottom = viewTop + 2.f * this->getSize().y;
+    const f32 rowHeight = CarouselButton::getScaledSize().y;
+
+    // y positions are monotonic in layout order
+    const auto first = std::ranges::partition_point(this->rows, [&](const Row &r) { return r.y + rowHeight < top; });
+    const auto last = std::partition_point(first, this->rows.end(), [&](const Row &r) { return r.y <= bottom; });
+
+    const auto begin = static_cast<uSz>(first - this->rows.begin());
+    const auto end = static_cast<uSz>(last - this->rows.begin());
+    if(!this->bRowsDirty && begin == this->onScreenBegin && end == this->onScreenEnd) return;
+
+    this->nextMaterialized.clear();
+    for(uSz i = begin; i < end; i++) {
+        this->nextMaterialized.push_back(this->rows[i].button);
+    }
+    std::ranges::sort(this->nextMaterialized);
+
+    // rows which are no longer in the container would otherwise never get clipped (and keep animating)
+    for(auto *button : this->materialized) {
+        if(button->isVisible() && !std::ranges::binary_search(this->nextMaterialized, button)) {
+            button->setVisible(false);
+        }
+    }
+
+    this->container.invalidate();
+    for(uSz i = begin; i < end; i++) {
+        auto [button, y] = this->rows[i];
+
+        // only rows in the container get the size/position from the layout (and only they get hovered, so the
+        // move-away state of rows coming back on screen is stale)
+        button->updateScaledSize();
+        button->setTargetRelPosY(y);
+        if(!std::ranges::binary_search(this->materialized, button)) button->resetAnimations();
+
+        this->container.addBaseUIElement(button, button->getRelPos());
+        button->updateLayoutEx();
+    }
+    std::swap(this->materialized, this->nextMaterialized);
+
+    this->onScreenBegin = begin;
+    this->onScreenEnd = end;
+    this->bRowsDirty = false;
+    this->bClippingDirty = true;
+}
+
 void BeatmapCarousel::draw() { CBaseUIScrollView::draw(); }
 
 void BeatmapCarousel::update(CBaseUIEventCtx &c) {
+    if(this->isVisible()) this->updateOnScreenRows();
+
     CBaseUIScrollView::update(c);
     if(!this->isVisible()) {
         // just reset this as a precaution
@@ -127,21 +227,21 @@ void BeatmapCarousel::onKeyUp(KeyboardEvent & /*e*/) { /*this->container.onKeyUp
 void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
     /*this->container.onKeyDown(e);*/
 
-    // all elements must be CarouselButtons, at least
-    const auto &elements{this->container.getElements<CarouselButton>()};
+    // navigate through all rows, not just the on-screen ones
+    const auto &elements{this->rows};
 
     // selection move
     if(!keyboard->isAltDown() && key == KEY_DOWN) {
         // get bottom selection
         int selectedIndex = -1;
         for(int i = 0; i < elements.size(); i++) {
-            if(elements[i]->isSelected()) selectedIndex = i;
+            if(elements[i].button->isSelected()) selectedIndex = i;
         }
 
         // select +1
         if(selectedIndex > -1 && selectedIndex + 1 < elements.size()) {
             int nextSelectionIndex = selectedIndex + 1;
-            auto *nextButton = elements[nextSelectionIndex];
+            auto *nextButton = elements[nextSelectionIndex].button;
 
             nextButton->select({.noSelectBottomChild = true});
 
@@ -160,13 +260,13 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
         // get bottom selection
         int selectedIndex = -1;
         for(int i = 0; i < elements.size(); i++) {
-            if(elements[i]->isSelected()) selectedIndex = i;
+            if(elements[i].button->isSelected()) selectedIndex = i;
         }
 
         // select -1
         if(selectedIndex > -1 && selectedIndex - 1 > -1) {
             int nextSelectionIndex = selectedIndex - 1;
-            auto *nextButton = elements[nextSelectionIndex];
+            auto *nextButton = elements[nextSelectionIndex].button;
 
             nextButton->select();
             const bool isCollectionButton = nextButton->isType<CollectionButton>();
@@ -174,7 +274,7 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
             // automatically open collection on top of this one and go to bottom child
             if(isCollectionButton && nextSelectionIndex - 1 > -1) {
                 nextSelectionIndex = nextSelectionIndex - 1;
-                auto *nextCollectionButton = elements[nextSelectionIndex]->as<CollectionButton>();
+                auto *nextCollectionButton = elements[nextSelectionIndex].button->as<CollectionButton>();
                 if(nextCollectionButton != nullptr) {
                     nextCollectionButton->select();
 
@@ -192,10 +292,10 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
 
         bool foundSelected = false;
         for(sSz i = elements.size() - 1; i >= 0; i--) {
-            const auto *diffButtonPointer = elements[i]->as<const SongDifficultyButton>();
-            const auto *collectionButtonPointer = elements[i]->as<const CollectionButton>();
+            const auto *diffButtonPointer = elements[i].button->as<const SongDifficultyButton>();
+            const auto *collectionButtonPointer = elements[i].button->as<const CollectionButton>();
 
-            auto *button = elements[i]->as<CarouselButton>();
+            auto *button = elements[i].button->as<CarouselButton>();
             const bool isSongDifficultyButtonAndNotIndependent =
                 (diffButtonPointer != nullptr && !diffButtonPointer->isIndependentDiffButton());
 
@@ -207,7 +307,7 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
 
                     if(!jumpToNextGroup || collectionButtonPointer == nullptr) {
                         // automatically open collection below and go to bottom child
-                        auto *collectionButton = elements[i]->as<CollectionButton>();
+                        auto *collectionButton = elements[i].button->as<CollectionButton>();
                         if(collectionButton != nullptr) {
                             const auto &children = collectionButton->getChildren();
                             if(children.size() > 0 && !children.back()->isSelected()) children.back()->select();
@@ -231,15 +331,15 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
         // get bottom selection
         int selectedIndex = -1;
         for(int i = 0; i < elements.size(); i++) {
-            if(elements[i]->isSelected()) selectedIndex = i;
+            if(elements[i].button->isSelected()) selectedIndex = i;
         }
 
         if(selectedIndex > -1) {
             for(size_t i = selectedIndex; i < elements.size(); i++) {
-                const auto *diffButtonPointer = elements[i]->as<const SongDifficultyButton>();
-                const auto *collectionButtonPointer = elements[i]->as<const CollectionButton>();
+                const auto *diffButtonPointer = elements[i].button->as<const SongDifficultyButton>();
+                const auto *collectionButtonPointer = elements[i].button->as<const CollectionButton>();
 
-                auto *button = elements[i]->as<CarouselButton>();
+                auto *button = elements[i].button->as<CarouselButton>();
                 const bool isSongDifficultyButtonAndNotIndependent =
                     (diffButtonPointer != nullptr && !diffButtonPointer->isIndependentDiffButton());
 
@@ -258,7 +358,7 @@ void BeatmapCarousel::onKeyDown(KeyboardEvent &key) {
     // group open/close
     // NOTE: only closing works atm (no "focus" state on buttons yet)
     if((key == KEY_ENTER || key == KEY_NUMPAD_ENTER) && keyboard->isShiftDown()) {
-        for(auto element : elements) {
+        for(const auto &[element, _] : elements) {
             const auto *collectionButtonPointer = element->as<const CollectionButton>();
 
             auto *button = element->as<CarouselButton>();
@@ -2,8 +2,10 @@
 // Copyright (c) 2025, WH, All rights reserved.
 
 #include "CBaseUIScrollView.h"
+#include "Hashing.h"
 
 class SongBrowser;
+class CarouselButton;
 
 class BeatmapCarousel final : public CBaseUIScrollView {
     NOCOPY_NOMOVE(BeatmapCarousel)
@@ -21,11 +23,47 @@ class BeatmapCarousel final : public CBaseUIScrollView {
     // checks for context menu visibility
     bool isMouseInside() override;
 
+    // clears both the on-screen container and the full row list (buttons are owned by SongBrowser)
+    void invalidate();
+
+    // every row which is part of the current layout is added here (in layout order), but only the rows around the
+    // viewport are actually added to the container (and thus updated/clipped/drawn)
+    // the rows still point at SongBrowser's buttons (one per set/difficulty), this only limits how many are on screen
+    // the layout only writes the y positions of the rows, buttons get positioned once they're on screen
+    struct Row {
+        CarouselButton *button;
+        f32 y;
+    };
+    void addRow(CarouselButton *button);
+    [[nodiscard]] inline std::vector<Row> &getRows() { return this->rows; }
+    [[nodiscard]] inline const std::vector<Row> &getRows() const { return this->rows; }
+
+    // y position of the button's row in the current layout (or its last position, if it isn't part of it)
+    [[nodiscard]] f32 getRowY(const CarouselButton *button) const;
+
+    // call after the rows have been laid out (y positions set), replaces setScrollSizeToContent()
+    void setScrollSizeToRows(int border);
+
     // if we are actually scrolling at a "noticeable" velocity, so that we can skip
     // drawing some things for elements which the user will probably not notice anyways (backgrounds)
     [[nodiscard]] inline bool isScrollingFast() const { return this->bIsScrollingFast; }
 
    private:
+    // (re)fills the container with the rows overlapping the viewport (plus some slack), if that range changed
+    void updateOnScreenRows();
+
+    std::vector<Row> rows;
+    Hash::flat::map<const CarouselButton *, uSz> rowIndices;  // for getRowY()
+
+    // buttons currently in the container (sorted by address), and scratch space for the next ones
+    std::vector<CarouselButton *> materialized;
+    std::vector<CarouselButton *> nextMaterialized;
+
+    // [begin, end) indices into rows of what is currently in the container
+    uSz onScreenBegin{0};
+    uSz onScreenEnd{0};
+    bool bRowsDirty{false};
+
     // updated at the end of update()
     bool bIsScrollingFast{false};
 
@@ -229,8 +229,8 @@ void draw() {
     i32 calcx = osu->getUserButton()->getPos().x + osu->getUserButton()->getSize().x + 20;
     i32 calcy = osu->getUserButton()->getPos().y + 15;
     if(BatchDiffCalc::get_maps_total() > 0) {
-        UString msg = fmt::format("Calculating stars ({}/{}) ...", BatchDiffCalc::get_maps_processed(),
-                                  BatchDiffCalc::get_maps_total());
+        UString msg = fmt::format("Calculating stars ({}/{}, {:.0f}/s) ...", BatchDiffCalc::get_maps_processed(),
+                                  BatchDiffCalc::get_maps_total(), BatchDiffCalc::get_maps_per_second());
         g->pushTransform();
         g->translate(calcx, calcy);
         g->drawString(font, msg);
@@ -267,7 +267,8 @@ void draw() {
     const auto calc_total = BatchDiffCalc::get_scores_total();
     const auto calc_computed = BatchDiffCalc::get_scores_processed();
     if(calc_total > 0 && calc_computed < calc_total) {
-        UString msg = fmt::format("Converting scores ({}/{}) ...", calc_computed, calc_total);
+        UString msg = fmt::format("Converting scores ({}/{}, {:.0f}/s) ...", calc_computed, calc_total,
+                                  BatchDiffCalc::get_scores_per_second());
         g->pushTransform();
         g->translate(calcx, calcy);
         g->drawString(font, msg);
@@ -1,6 +1,7 @@
 // Copyright (c) 2016, PG, All rights reserved.
 #include "CarouselButton.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "StarPrecalc.h"
@@ -133,18 +134,29 @@ bool CarouselButton::isMouseInside() {
            static_cast<int>(mouse->getPos().x) <= osu->getVirtScreenWidth();
 }
 
-void CarouselButton::updateLayoutEx() {
+vec2 CarouselButton::getScaledSize() {
+    return vec::ceil(baseSize * (Osu::getUIScale(baseOsuPixelsScale) * Osu::getUIScale()));
+}
+
+vec2 CarouselButton::getScaledMargin() {
+    return vec::ceil(vec2{(int)marginPixelsX, (int)(marginPixelsY)} *
+                     (Osu::getUIScale(baseOsuPixelsScale) * Osu::getUIScale()));
+}
+
+void CarouselButton::updateScaledSize() {
     // these should barely ever change but we have no way to detect that as of now
-    {
-        const float scale = Osu::getUIScale(baseOsuPixelsScale) * Osu::getUIScale();
+    const float scale = Osu::getUIScale(baseOsuPixelsScale) * Osu::getUIScale();
 
-        actualScaledOffsetWithMargin = vec::ceil(vec2{(int)marginPixelsX, (int)(marginPixelsY)} * scale);
-        this->setSize(vec::ceil(baseSize * scale));
+    actualScaledOffsetWithMargin = getScaledMargin();
+    this->setSize(getScaledSize());
 
-        // complete BS sizing/rounding/etc.
-        // it seems that osu stable also doesn't scale these images in any way, though
-        bgImageScale = (scale + 0.005f /* ??? */) / (osu->getSkin()->i_menu_button_bg.scale());
-    }
+    // complete BS sizing/rounding/etc.
+    // it seems that osu stable also doesn't scale these images in any way, though
+    bgImageScale = (scale + 0.005f /* ??? */) / (osu->getSkin()->i_menu_button_bg.scale());
+}
+
+void CarouselButton::updateLayoutEx() {
+    this->updateScaledSize();
 
     if(this->bVisible) {  // lag prevention (animationHandler overflow)
         const float centerOffsetAnimationTarget =
@@ -359,6 +371,10 @@ void CarouselButton::addChildren(std::vector<SongButton *> children) {
                           std::make_move_iterator(children.end()));
 }
 
+void CarouselButton::insertChildSorted(SongButton *child, bool (*comparator)(const SongButton *, const SongButton *)) {
+    this->children.insert(std::ranges::upper_bound(this->children, child, comparator), child);
+}
+
 bool CarouselButton::childrenNeedSorting() const { return this->lastChildSortStarPrecalcIdx != StarPrecalc::active_idx; }
 
 Color CarouselButton::getActiveBackgroundColor() const {
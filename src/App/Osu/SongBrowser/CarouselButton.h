@@ -40,6 +40,13 @@ class CarouselButton : public CBaseUIButton {
 
     virtual void updateLayoutEx();
 
+    // only the (shared) size part of updateLayoutEx()
+    void updateScaledSize();
+
+    // every carousel button has the same size, so the carousel can lay out rows without touching the buttons
+    [[nodiscard]] static vec2 getScaledSize();
+    [[nodiscard]] static vec2 getScaledMargin();
+
     CarouselButton *setVisible(bool visible) override;
 
     bool isMouseInside() override;
@@ -66,6 +73,8 @@ class CarouselButton : public CBaseUIButton {
     void setChildren(std::vector<SongButton *> children);
     void addChild(SongButton *child);
     void addChildren(std::vector<SongButton *> children);
+    // assumes the children are already sorted by comparator
+    void insertChildSorted(SongButton *child, bool (*comparator)(const SongButton *, const SongButton *));
 
     inline void setOffsetPercent(float offsetPercent) { this->fOffsetPercent = offsetPercent; }
     inline void setHideIfSelected(bool hideIfSelected) { this->bHideIfSelected = hideIfSelected; }
@@ -75,6 +84,7 @@ class CarouselButton : public CBaseUIButton {
 
     [[nodiscard]] inline vec2 getActualSize() const { return this->getSize() - 2.f * actualScaledOffsetWithMargin; }
     [[nodiscard]] inline vec2 getActualPos() const { return this->getPos() + actualScaledOffsetWithMargin; }
+    [[nodiscard]] inline float getTargetRelPosY() const { return this->fTargetRelPosY; }
     [[nodiscard]] inline std::vector<SongButton *> &getChildren() { return this->children; }
     [[nodiscard]] inline const std::vector<SongButton *> &getChildren() const { return this->children; }
 
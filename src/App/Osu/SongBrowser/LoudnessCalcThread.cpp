@@ -8,6 +8,7 @@
 #include "Engine.h"
 #include "Sound.h"
 #include "SoundEngine.h"
+#include "Profiler.h"
 #include "Thread.h"
 #include "Timing.h"
 #include "Logging.h"
@@ -88,6 +89,7 @@ struct VolNormalization::LoudnessCalcThread {
 
             if(stoken.stop_requested()) return;
             if(map->loudness.load(std::memory_order_acquire) != 0.f) continue;
+            VPROF_TRACE("LoudnessCalc::map");
 
             UString song{map->getFullSoundFilePath()};
             if(song == last_song) {
@@ -170,6 +172,7 @@ struct VolNormalization::LoudnessCalcThread {
 
             if(stoken.stop_requested()) return;
             if(map->loudness.load(std::memory_order_acquire) != 0.f) continue;
+            VPROF_TRACE("LoudnessCalc::map");
             const std::string song = map->getFullSoundFilePath();
             if(song == last_song) {
                 map->loudness.store(last_loudness, std::memory_order_release);
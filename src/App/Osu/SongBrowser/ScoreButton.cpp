@@ -380,6 +380,9 @@ void ScoreButton::update(CBaseUIEventCtx &c) {
                 if(auto scorevecIt = std::ranges::find(it->second, sc); scorevecIt != it->second.end()) {
                     g_songbrowser->score_resort_scheduled = true;
                     *scorevecIt = sc;
+                    if(!sc.is_online_score) {
+                        db->updatePlayerStats(sc.beatmap_hash, sc.playerName);
+                    }
                 }
             }
             if(!sc.is_online_score) {
@@ -0,0 +1,228 @@
+// Copyright (c) 2016, PG & 2026, kiwec, All rights reserved.
+#include "SearchQuery.h"
+
+#include "SString.h"
+#include "DatabaseBeatmap.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+SearchQuery::SearchQuery(std::string_view searchString) {
+    struct OperatorStr {
+        std::string_view str;
+        Op id;
+    };
+
+    struct KeywordStr {
+        std::string_view str;
+        Keyword id;
+    };
+
+    // NOTE: the order matters, because find() is used to detect their presence (and '=' would then break '<=' etc.)
+    static constexpr OperatorStr operators[] = {
+        {.str = "<=", .id = Op::LE}, {.str = ">=", .id = Op::GE}, {.str = "<", .id = Op::LT},
+        {.str = ">", .id = Op::GT},  {.str = "!=", .id = Op::NE}, {.str = "==", .id = Op::EQ},
+        {.str = "=", .id = Op::EQ},
+    };
+
+    using enum Keyword;
+    static constexpr KeywordStr keywords[] = {
+        {.str = "ar", .id = AR},           {.str = "cs", .id = CS},
+        {.str = "od", .id = OD},           {.str = "hp", .id = HP},
+        {.str = "bpm", .id = BPM},         {.str = "opm", .id = OPM},
+        {.str = "cpm", .id = CPM},         {.str = "spm", .id = SPM},
+        {.str = "object", .id = OBJECTS},  {.str = "objects", .id = OBJECTS},
+        {.str = "circle", .id = CIRCLES},  {.str = "circles", .id = CIRCLES},
+        {.str = "slider", .id = SLIDERS},  {.str = "sliders", .id = SLIDERS},
+        {.str = "spinner", .id = SPINNERS}, {.str = "spinners", .id = SPINNERS},
+        {.str = "length", .id = LENGTH},   {.str = "len", .id = LENGTH},
+        {.str = "stars", .id = STARS},     {.str = "star", .id = STARS},
+        {.str = "creator", .id = CREATOR},
+    };
+
+    for(const auto token : SString::split(searchString, ' ')) {
+        // only accept singular expressions, things like "0<bpm<1" are treated as literals
+        bool expression = false;
+        for(const auto &[op_str, op_id] : operators) {
+            if(token.find(op_str) == std::string_view::npos) continue;
+
+            const std::vector<std::string_view> values{SString::split(token, op_str)};
+            if(values.size() == 2 && !values[0].empty() && !values[1].empty()) {
+                const std::string_view lvalue = values[0];
+                const std::string_view rstring = values[1];
+
+                const auto *kw = std::ranges::find(keywords, lvalue, &KeywordStr::str);
+                if(kw != std::ranges::end(keywords)) {
+                    expression = true;
+
+                    const auto percentIndex = rstring.find('%');
+                    const std::string_view rnumber = rstring.substr(0, percentIndex);
+
+                    Predicate pred{.keyword = kw->id,
+                                   .op = op_id,
+                                   .is_percent = percentIndex != std::string_view::npos,
+                                   .value = 0.f,
+                                   .str = {}};
+
+                    // this must always be a number (at least, assume it is)
+                    auto [ptr, ec] = std::from_chars(rnumber.data(), rnumber.data() + rnumber.size(), pred.value);
+                    if(ec != std::errc()) pred.value = 0.f;
+
+                    if(pred.keyword == Keyword::CREATOR) pred.str = SString::to_lower(rstring);
+
+                    this->predicates.push_back(std::move(pred));
+                }
+            }
+
+            break;
+        }
+
+        if(!expression) {
+            std::string literal{token};
+            SString::trim_inplace(literal);
+            if(!SString::is_wspace_only(literal) && !std::ranges::contains(this->literals, literal)) {
+                this->literals.push_back(std::move(literal));
+            }
+        }
+    }
+}
+
+bool SearchQuery::matches(const DatabaseBeatmap *map, f32 speed) const {
+    if(map == nullptr) return false;
+
+    const auto &diffs = map->getDifficulties();
+    if(diffs.empty()) {
+        // standalone difficulty
+        return this->matchesPredicates(map, speed) && this->matchesLiterals(map);
+    }
+
+    return std::ranges::any_of(diffs, [&](const auto &diff) { return this->matchesPredicates(diff.get(), speed); }) &&
+           std::ranges::any_of(diffs, [&](const auto &diff) { return this->matchesLiterals(diff.get()); });
+}
+
+bool SearchQuery::matchesPredicates(const DatabaseBeatmap *diff, f32 speed) const {
+    const auto per_minute = [diff, speed](int count) -> f32 {
+        if(diff->getLengthMS() == 0) return 0.f;
+        return ((f32)count / (f32)(diff->getLengthMS() / 1000.0f / 60.0f)) * speed;
+    };
+    const auto count_or_percent = [diff](int count, bool is_percent) -> f32 {
+        return is_percent ? ((f32)count / (f32)diff->getNumObjects()) * 100.0f : (f32)count;
+    };
+
+    for(const auto &pred : this->predicates) {
+        if(pred.keyword == Keyword::CREATOR) {
+            // string comparison, lexicographic for the ordering operators
+            const auto cmp = SString::to_lower(diff->getCreator()).compare(pred.str);
+            bool matches = false;
+            switch(pred.op) {
+                case Op::EQ:
+                    matches = cmp == 0;
+                    break;
+                case Op::NE:
+                    matches = cmp != 0;
+                    break;
+                case Op::LT:
+                    matches = cmp < 0;
+                    break;
+                case Op::GT:
+                    matches = cmp > 0;
+                    break;
+                case Op::LE:
+                    matches = cmp <= 0;
+                    break;
+                case Op::GE:
+                    matches = cmp >= 0;
+                    break;
+            }
+            if(!matches) return false;
+            continue;
+        }
+
+        f32 compareValue{0.f};
+        switch(pred.keyword) {
+            case Keyword::AR:
+                compareValue = diff->getAR();
+                break;
+            case Keyword::CS:
+                compareValue = diff->getCS();
+                break;
+            case Keyword::OD:
+                compareValue = diff->getOD();
+                break;
+            case Keyword::HP:
+                compareValue = diff->getHP();
+                break;
+            case Keyword::BPM:
+                compareValue = diff->getMostCommonBPM();
+                break;
+            case Keyword::OPM:
+                compareValue = per_minute(diff->getNumObjects());
+                break;
+            case Keyword::CPM:
+                compareValue = per_minute(diff->getNumCircles());
+                break;
+            case Keyword::SPM:
+                compareValue = per_minute(diff->getNumSliders());
+                break;
+            case Keyword::OBJECTS:
+                compareValue = diff->getNumObjects();
+                break;
+            case Keyword::CIRCLES:
+                compareValue = count_or_percent(diff->getNumCircles(), pred.is_percent);
+                break;
+            case Keyword::SLIDERS:
+                compareValue = count_or_percent(diff->getNumSliders(), pred.is_percent);
+                break;
+            case Keyword::SPINNERS:
+                compareValue = count_or_percent(diff->getNumSpinners(), pred.is_percent);
+                break;
+            case Keyword::LENGTH:
+                compareValue = diff->getLengthMS() / 1000.0f;
+                break;
+            case Keyword::STARS:
+                // round to 2 decimal places
+                compareValue = std::round(diff->getStarRating(StarPrecalc::active_idx) * 100.0f) / 100.0f;
+                break;
+            case Keyword::CREATOR:
+                std::unreachable();
+        }
+
+        bool matches = false;
+        switch(pred.op) {
+            case Op::LE:
+                matches = compareValue <= pred.value;
+                break;
+            case Op::GE:
+                matches = compareValue >= pred.value;
+                break;
+            case Op::LT:
+                matches = compareValue < pred.value;
+                break;
+            case Op::GT:
+                matches = compareValue > pred.value;
+                break;
+            case Op::NE:
+                matches = compareValue != pred.value;
+                break;
+            case Op::EQ:
+                matches = compareValue == pred.value;
+                break;
+        }
+
+        // if a single expression doesn't match, then the whole diff doesn't match
+        if(!matches) return false;
+    }
+
+    return true;
+}
+
+bool SearchQuery::matchesLiterals(const DatabaseBeatmap *diff) const {
+    if(this->literals.empty()) return true;
+    if(this->literal_candidates && !this->literal_candidates->contains(diff->getMD5())) return false;
+
+    const std::string_view blob = diff->getSearchBlob();
+    return std::ranges::all_of(this->literals,
+                               [blob](const std::string &literal) { return blob.find(literal) != std::string_view::npos; });
+}
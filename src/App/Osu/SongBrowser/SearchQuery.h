@@ -0,0 +1,69 @@
+#pragma once
+// Copyright (c) 2016, PG & 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "MD5Hash.h"
+#include "Hashing.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class DatabaseBeatmap;
+
+// A song browser search string, parsed once into predicates ("ar>9", "circles<=50%", "creator=peppy") and literal
+// terms (everything else). All of them must match: a beatmap set matches if one of its difficulties satisfies all
+// predicates, and one (possibly different) difficulty contains all literal terms in its search blob.
+class SearchQuery final {
+   public:
+    // expects an already lowercased search string
+    explicit SearchQuery(std::string_view searchString);
+
+    // works on both sets and standalone difficulties
+    [[nodiscard]] bool matches(const DatabaseBeatmap *map, f32 speed) const;
+
+    [[nodiscard]] inline bool isEmpty() const { return this->predicates.empty() && this->literals.empty(); }
+    [[nodiscard]] inline const std::vector<std::string> &getLiterals() const { return this->literals; }
+
+    // only difficulties in this set can match the literals (see BeatmapSearchIndex::findCandidates())
+    inline void setLiteralCandidates(Hash::flat::set<MD5Hash> candidates) {
+        this->literal_candidates = std::move(candidates);
+    }
+
+   private:
+    enum class Op : u8 { EQ, LT, GT, LE, GE, NE };
+
+    enum class Keyword : u8 {
+        AR,
+        CS,
+        OD,
+        HP,
+        BPM,
+        OPM,
+        CPM,
+        SPM,
+        OBJECTS,
+        CIRCLES,
+        SLIDERS,
+        SPINNERS,
+        LENGTH,
+        STARS,
+        CREATOR
+    };
+
+    struct Predicate {
+        Keyword keyword;
+        Op op;
+        bool is_percent;  // "circles>50%"
+        f32 value;        // right-hand side, 0 if it wasn't a number
+        std::string str;  // right-hand side for string keywords (creator)
+    };
+
+    [[nodiscard]] bool matchesPredicates(const DatabaseBeatmap *diff, f32 speed) const;
+    [[nodiscard]] bool matchesLiterals(const DatabaseBeatmap *diff) const;
+
+    std::vector<Predicate> predicates;
+    std::vector<std::string> literals;
+    std::optional<Hash::flat::set<MD5Hash>> literal_candidates;
+};
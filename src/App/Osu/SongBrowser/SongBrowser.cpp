@@ -24,6 +24,7 @@
 
 #include "BatchDiffCalc.h"
 #include "AsyncPPCalculator.h"
+#include "AsyncStarCalculator.h"
 #include "LoudnessCalcThread.h"
 
 #include "Skin.h"
@@ -52,6 +53,7 @@
 #include "AsyncSongButtonMatcher.h"
 #include "CollectionButton.h"
 #include "UserCard.h"
+#include "UserStatsScreen.h"
 #include "InfoLabel.h"
 #include "LoadingScreen.h"
 #include "UI.h"
@@ -300,6 +302,7 @@ SongBrowser::GlobalSongBrowserCtorDtor::~GlobalSongBrowserCtorDtor() {
 
 SongBrowser::SongBrowser() : ScreenBackable(), global_songbrowser_(this) {
     this->lastDiffSortModIndex = StarPrecalc::active_idx;
+    this->groupChildrenSortedBy.fill(SortType::MAX);
 
     this->hashToDiffButton = std::make_unique<MD5HashMap>();
 
@@ -456,6 +459,7 @@ SongBrowser::SongBrowser() : ScreenBackable(), global_songbrowser_(this) {
 
 SongBrowser::~SongBrowser() {
     BatchDiffCalc::abort_calc();
+    AsyncStarCalc::abort();
     AsyncPPC::set_map(nullptr);
     VolNormalization::abort();
     this->checkHandleKillBackgroundSearchMatcher();
@@ -468,6 +472,7 @@ SongBrowser::~SongBrowser() {
         delete songButton;
     }
     this->parentButtons.clear();
+    this->invalidateSortOrders();
 
     this->collectionButtons.clear();
 
@@ -827,6 +832,11 @@ void SongBrowser::update(CBaseUIEventCtx &c) {
             }
         }
 
+        // new on-demand ratings are in
+        if(AsyncStarCalc::update_mainthread()) {
+            this->onStarRatingsUpdated();
+        }
+
         // deferred batch calc for newly imported maps
         if(!BatchDiffCalc::running() && db->bPendingBatchDiffCalc) {
             db->bPendingBatchDiffCalc = false;
@@ -1397,6 +1407,7 @@ void SongBrowser::refreshBeatmaps(UIScreen *next_screen) {
         delete songButton;
     }
     this->parentButtons.clear();
+    this->invalidateSortOrders();
 
     this->collectionButtons.clear();
 
@@ -1429,10 +1440,13 @@ void SongBrowser::refreshBeatmaps(UIScreen *next_screen) {
 
     auto loading_screen = std::make_unique<LoadingScreen>(
         next_screen,
-        (LoadingProgressFn)[](LoadingScreen * /*ldscr*/) {
+        (LoadingProgressFn)[](LoadingScreen * ldscr) {
             if(!db->isFinished()) {
                 db->update();  // raw load logic
             }
+            if(const f32 rate = db->getImportRate(); rate > 0.f) {
+                ldscr->setStatusText(fmt::format("{:.0f} sets/s", rate));
+            }
             return db->getProgress();
         },
         (LoadingFinishedFn)[](LoadingScreen * ldscr) {
@@ -1491,10 +1505,18 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset, bool initialSongBrowserLoad)
     auto *parentButton = new SongButton(250.f, 250.f + db->getBeatmapSets().size() * 50.f, 200.f, 50.f, mapset);
     this->parentButtons.push_back(parentButton);
 
+    // keep already built sort orders sorted (invalid ones get fully sorted on their next use anyway)
+    for(int sort = 0; sort < SortType::MAX; sort++) {
+        auto &order = this->sortedParentButtons[sort];
+        if(!order.valid) continue;
+        order.buttons.insert(std::ranges::upper_bound(order.buttons, parentButton, SORTING_METHODS[sort].comparator),
+                             parentButton);
+    }
+
     // add mapset to all necessary groups
-    this->addSongButtonToAlphanumericGroup(parentButton, this->artistCollectionButtons, mapset->getArtistLatin());
-    this->addSongButtonToAlphanumericGroup(parentButton, this->creatorCollectionButtons, mapset->getCreator());
-    this->addSongButtonToAlphanumericGroup(parentButton, this->titleCollectionButtons, mapset->getTitleLatin());
+    this->addSongButtonToAlphanumericGroup(parentButton, GroupType::ARTIST, mapset->getArtistLatin());
+    this->addSongButtonToAlphanumericGroup(parentButton, GroupType::CREATOR, mapset->getCreator());
+    this->addSongButtonToAlphanumericGroup(parentButton, GroupType::TITLE, mapset->getTitleLatin());
 
     // use parent's children for grouping
     const auto &tempChildrenForGroups =
@@ -1515,7 +1537,7 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset, bool initialSongBrowserLoad)
                     ? static_cast<int>(stars_tmp)
                     : 0,
                 0, 11);
-            this->difficultyCollectionButtons[index]->addChild(diff_btn);
+            this->addChildToGroup(this->difficultyCollectionButtons[index].get(), GroupType::DIFFICULTY, diff_btn);
         }
 
         if(doBPMCollBtns) {
@@ -1535,7 +1557,7 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset, bool initialSongBrowserLoad)
                 index = 5;
             }
 
-            this->bpmCollectionButtons[index]->addChild(diff_btn);
+            this->addChildToGroup(this->bpmCollectionButtons[index].get(), GroupType::BPM, diff_btn);
         }
 
         // dateadded
@@ -1563,12 +1585,95 @@ void SongBrowser::addBeatmapSet(BeatmapSet *mapset, bool initialSongBrowserLoad)
                 btnIdx = 6;
             }
 
-            this->lengthCollectionButtons[btnIdx]->addChild(diff_btn);
+            this->addChildToGroup(this->lengthCollectionButtons[btnIdx].get(), GroupType::LENGTH, diff_btn);
         }
     }
 }
 
-void SongBrowser::addSongButtonToAlphanumericGroup(SongButton *sbtn, CollBtnContainer &group, std::string_view name) {
+void SongBrowser::removeBeatmapSet(const BeatmapSet *mapset) {
+    const auto isInSet = [mapset](const DatabaseBeatmap *map) -> bool {
+        return map == mapset || map->getParentSet() == mapset;
+    };
+
+    // references to the difficulties, whether or not the set has buttons yet
+    if(const BeatmapDifficulty *map = osu->getMapInterface()->getBeatmap(); map && isInSet(map)) {
+        osu->getMapInterface()->deselectBeatmap();
+        AsyncPPC::set_map(nullptr);
+
+        // the scores shown are the ones of the removed difficulty
+        this->scoreBrowser->invalidate();
+        this->localBestContainer->invalidate();
+        this->localBestContainer->setVisible(false);
+        this->rebuildScoreButtons();
+    }
+    ui->getMainMenu()->clearPreloadedMaps();
+    if(ui->getUserStatsScreen()->isVisible()) ui->getUserStatsScreen()->rebuildScoreButtons();
+
+    if(this->lastSelectedBeatmap && isInSet(this->lastSelectedBeatmap)) this->lastSelectedBeatmap = nullptr;
+    std::erase_if(this->previousRandomBeatmaps, isInSet);
+
+    const auto parentIt = std::ranges::find(this->parentButtons, mapset, &SongButton::getDatabaseBeatmap);
+    if(parentIt == this->parentButtons.end()) return;
+    SongButton *parentButton = *parentIt;
+
+    // the search matcher goes through the buttons in the background (restarted by the rebuild below)
+    this->checkHandleKillBackgroundSearchMatcher();
+    this->contextMenu->setVisible2(false);
+    this->carousel->invalidate();
+
+    const auto isRemoved = [parentButton](const CarouselButton *button) -> bool {
+        return button == parentButton || std::ranges::contains(parentButton->getChildren(), button);
+    };
+
+    // selection state
+    if(this->selectedButton && isRemoved(this->selectedButton)) this->selectedButton = nullptr;
+    if(this->selectionPreviousSongButton == parentButton) this->selectionPreviousSongButton = nullptr;
+    if(this->selectionPreviousSongDiffButton && isRemoved(this->selectionPreviousSongDiffButton)) {
+        this->selectionPreviousSongDiffButton = nullptr;
+    }
+
+    for(const SongButton *child : parentButton->getChildren()) {
+        const DatabaseBeatmap *diff = child->getDatabaseBeatmap();
+        if(const auto it = this->hashToDiffButton->find(diff->getMD5());
+           it != this->hashToDiffButton->end() && it->second == child) {
+            this->hashToDiffButton->erase(it);
+        }
+    }
+
+    // groups (the fixed ones keep their buckets, collections without any (loaded) maps left are dropped)
+    for(CollBtnContainer *groupButtons :
+        {&this->titleCollectionButtons, &this->artistCollectionButtons, &this->creatorCollectionButtons,
+         &this->dateaddedCollectionButtons, &this->difficultyCollectionButtons, &this->bpmCollectionButtons,
+         &this->lengthCollectionButtons, &this->collectionButtons}) {
+        for(const auto &groupButton : *groupButtons) {
+            std::erase_if(groupButton->getChildren(), isRemoved);
+        }
+    }
+    std::erase_if(this->collectionButtons, [this](const std::unique_ptr<CollectionButton> &collectionButton) -> bool {
+        if(!collectionButton->getChildren().empty()) return false;
+        if(this->selectedButton == collectionButton.get()) this->selectedButton = nullptr;
+        if(this->selectionPreviousCollectionButton == collectionButton.get()) {
+            this->selectionPreviousCollectionButton = nullptr;
+        }
+        std::erase(this->visibleSongButtons, collectionButton.get());
+        return true;
+    });
+
+    // removing keeps the orders sorted
+    for(auto &order : this->sortedParentButtons) {
+        std::erase(order.buttons, parentButton);
+    }
+    std::erase_if(this->visibleSongButtons, isRemoved);
+    this->parentButtons.erase(parentIt);
+
+    delete parentButton;
+
+    this->bSongButtonsNeedSorting = true;
+    if(this->bVisible) this->rebuildAfterGroupOrSortChange(this->curGroup);
+}
+
+void SongBrowser::addSongButtonToAlphanumericGroup(SongButton *sbtn, GroupType type, std::string_view name) {
+    auto &group = *this->getCollectionButtonsForGroup(type);
     if(group.size() != 28) {
         debugLog("Alphanumeric group wasn't initialized!");
         return;
@@ -1591,7 +1696,58 @@ void SongBrowser::addSongButtonToAlphanumericGroup(SongButton *sbtn, CollBtnCont
 
     logIfCV(debug_osu, "Inserting {:s}", name);
 
-    cbtn->addChild(sbtn);
+    this->addChildToGroup(cbtn, type, sbtn);
+}
+
+void SongBrowser::addChildToGroup(CollectionButton *groupButton, GroupType group, SongButton *child) {
+    if(this->groupChildrenSortedBy[group] == this->curSortMethod) {
+        groupButton->insertChildSorted(child, SORTING_METHODS[this->curSortMethod].comparator);
+    } else {
+        groupButton->addChild(child);
+    }
+}
+
+const std::vector<SongButton *> &SongBrowser::getSortedParentButtons() {
+    auto &order = this->sortedParentButtons[this->curSortMethod];
+    if(!order.valid) {
+        order.buttons = this->parentButtons;
+        srt::pdqsort(order.buttons, SORTING_METHODS[this->curSortMethod].comparator);
+        order.valid = true;
+    }
+    return order.buttons;
+}
+
+void SongBrowser::invalidateSortOrders() {
+    for(auto &order : this->sortedParentButtons) {
+        order.buttons.clear();
+        order.valid = false;
+    }
+    this->groupChildrenSortedBy.fill(SortType::MAX);
+    this->bDifficultyBucketsStale = true;
+}
+
+void SongBrowser::onStarRatingsUpdated() {
+    // only what's actually ordered by stars gets redone (ties in the other orders can stay slightly stale until the next
+    // mod change, rebuilding those as well for every batch of new ratings isn't worth it)
+    this->sortedParentButtons[SortType::DIFFICULTY].valid = false;
+    for(auto &sortedBy : this->groupChildrenSortedBy) {
+        if(sortedBy == SortType::DIFFICULTY) sortedBy = SortType::MAX;
+    }
+    this->bDifficultyBucketsStale = true;
+
+    if(this->curSortMethod == SortType::DIFFICULTY || this->curGroup == GroupType::DIFFICULTY) {
+        this->bSongButtonsNeedSorting = true;
+        if(this->bVisible) this->rebuildAfterGroupOrSortChange(this->curGroup);
+    }
+}
+
+void SongBrowser::onGradeChanged() {
+    // only flag it, this can get called while the order is being iterated over
+    this->sortedParentButtons[SortType::RANKACHIEVED].valid = false;
+
+    for(auto &sortedBy : this->groupChildrenSortedBy) {
+        if(sortedBy == SortType::RANKACHIEVED) sortedBy = SortType::MAX;
+    }
 }
 
 void SongBrowser::requestNextScrollToSongButtonJumpFix(SongDifficultyButton *diffButton) {
@@ -1602,8 +1758,8 @@ void SongBrowser::requestNextScrollToSongButtonJumpFix(SongDifficultyButton *dif
     // use parent position only if the diff is NOT independent
     // (i.e., parent is actually visible and expanded in the carousel)
     this->fNextScrollToSongButtonJumpFixOldRelPosY =
-        (diffButton->isIndependentDiffButton() ? diffButton->getRelPos().y
-                                               : diffButton->getParentSongButton()->getRelPos().y);
+        this->carousel->getRowY(diffButton->isIndependentDiffButton() ? diffButton
+                                                                      : diffButton->getParentSongButton());
 
     this->fNextScrollToSongButtonJumpFixOldScrollSizeY = this->carousel->getScrollSize().y;
 }
@@ -1810,7 +1966,8 @@ void SongBrowser::scrollToSongButton(CarouselButton *songButton, bool alignOnTop
         float delta = 0.0f;
         {
             if(!this->bNextScrollToSongButtonJumpFixUseScrollSizeDelta)
-                delta = (songButton->getRelPos().y - this->fNextScrollToSongButtonJumpFixOldRelPosY);  // (default case)
+                delta = (this->carousel->getRowY(songButton) -
+                         this->fNextScrollToSongButtonJumpFixOldRelPosY);  // (default case)
             else
                 delta = this->carousel->getScrollSize().y -
                         this->fNextScrollToSongButtonJumpFixOldScrollSizeY;  // technically not correct but feels a
@@ -1819,20 +1976,20 @@ void SongBrowser::scrollToSongButton(CarouselButton *songButton, bool alignOnTop
         this->carousel->scrollToY(this->carousel->getRelPosY() - delta, false);
     }
 
-    this->carousel->scrollToY(-songButton->getRelPos().y +
-                              (alignOnTop ? (0) : (this->carousel->getSize().y / 2 - songButton->getSize().y / 2)));
+    this->carousel->scrollToY(
+        -this->carousel->getRowY(songButton) +
+        (alignOnTop ? (0) : (this->carousel->getSize().y / 2 - CarouselButton::getScaledSize().y / 2)));
 }
 
 void SongBrowser::rebuildSongButtons() {
+    // (animations of the rows get reset by the carousel once they're on screen)
     this->carousel->invalidate();
 
     // NOTE: currently supports 3 depth layers (collection > beatmap > diffs)
     for(auto &visibleSongButton : this->visibleSongButtons) {
         CarouselButton *button = visibleSongButton;
 
-        if(!(button->isSelected() && button->isHiddenIfSelected())) this->carousel->container.addBaseUIElement(button);
-
-        button->resetAnimations();
+        if(!(button->isSelected() && button->isHiddenIfSelected())) this->carousel->addRow(button);
 
         // if it's a collection button, recount the number of search-matching children
         // to use as a label
@@ -1875,19 +2032,15 @@ void SongBrowser::rebuildSongButtons() {
                         for(auto *child : button2->getChildren()) {
                             if(child->isSearchMatch()) {
                                 addedSingleChild = true;
-                                this->carousel->container.addBaseUIElement(child);
-
-                                child->resetAnimations();
+                                this->carousel->addRow(child);
                                 break;  // only one visible child
                             }
                         }
                     } else {
-                        this->carousel->container.addBaseUIElement(button2);
+                        this->carousel->addRow(button2);
                     }
                 }
 
-                button2->resetAnimations();
-
                 // child children
                 if(!addedSingleChild && button2->isSelected()) {
                     const auto &children2 = button2->getChildren();
@@ -1895,9 +2048,7 @@ void SongBrowser::rebuildSongButtons() {
                         if(this->bInSearch && !button3->isSearchMatch()) continue;
 
                         if(!(button3->isSelected() && button3->isHiddenIfSelected()))
-                            this->carousel->container.addBaseUIElement(button3);
-
-                        button3->resetAnimations();
+                            this->carousel->addRow(button3);
                     }
                 }
             }
@@ -1912,15 +2063,19 @@ void SongBrowser::updateSongButtonLayout() {
     // only the y axis is set, because the x axis is constantly animated and handled within the button classes
     // themselves
 
-    // all elements must be CarouselButtons, at least
-    const auto &elements{this->carousel->container.getElements<CarouselButton>()};
+    // only the y positions of the rows are laid out here, the carousel applies them once a row is on screen
+    // (every button has the same size)
+    auto &rows{this->carousel->getRows()};
+    const f32 buttonHeight = CarouselButton::getScaledSize().y;
+    const f32 actualButtonHeight = buttonHeight - 2.f * CarouselButton::getScaledMargin().y;
 
     int yCounter = this->carousel->getSize().y / 4;
-    if(elements.size() <= 1) yCounter = this->carousel->getSize().y / 2;
+    if(rows.size() <= 1) yCounter = this->carousel->getSize().y / 2;
 
     bool isSelected = false;
     bool inOpenCollection = false;
-    for(auto *carouselButton : elements) {
+    for(auto &row : rows) {
+        const CarouselButton *carouselButton = row.button;
         const auto *diffButtonPointer = carouselButton->as<SongDifficultyButton>();
 
         // depending on the object type, layout differently
@@ -1931,14 +2086,13 @@ void SongBrowser::updateSongButtonLayout() {
         // give selected items & diffs a bit more spacing, to make them stand out
         if(((carouselButton->isSelected() && !isCollectionButton) || isSelected ||
             (isDiffButton && !isIndependentDiffButton)))
-            yCounter += carouselButton->getSize().y * 0.1f;
+            yCounter += buttonHeight * 0.1f;
 
         isSelected = carouselButton->isSelected() || (isDiffButton && !isIndependentDiffButton);
 
         // give collections a bit more spacing at start & end
-        if((carouselButton->isSelected() && isCollectionButton)) yCounter += carouselButton->getSize().y * 0.2f;
-        if(inOpenCollection && isCollectionButton && !carouselButton->isSelected())
-            yCounter += carouselButton->getSize().y * 0.2f;
+        if((carouselButton->isSelected() && isCollectionButton)) yCounter += buttonHeight * 0.2f;
+        if(inOpenCollection && isCollectionButton && !carouselButton->isSelected()) yCounter += buttonHeight * 0.2f;
         if(isCollectionButton) {
             if(carouselButton->isSelected())
                 inOpenCollection = true;
@@ -1946,12 +2100,10 @@ void SongBrowser::updateSongButtonLayout() {
                 inOpenCollection = false;
         }
 
-        carouselButton->setTargetRelPosY(yCounter);
-        carouselButton->updateLayoutEx();
-
-        yCounter += carouselButton->getActualSize().y;
+        row.y = static_cast<f32>(yCounter);
+        yCounter += actualButtonHeight;
     }
-    this->carousel->setScrollSizeToContent(this->carousel->getSize().y / 2);
+    this->carousel->setScrollSizeToRows(this->carousel->getSize().y / 2);
 }
 
 SongBrowser::SetVisibility SongBrowser::getSetVisibility(const SongButton *parent) const {
@@ -2470,6 +2622,15 @@ void SongBrowser::onDatabaseLoadingFinished() {
 
     // Watch for new maps now
     directoryWatcher->watch_directory(NEOSU_MAPS_PATH "/", [](const FileChangeEvent &ev) {
+        if(ev.type == FileChangeType::RESCAN) {
+            // events were lost, so import whatever is lying around
+            for(const auto &file : env->getFilesInFolder(NEOSU_MAPS_PATH "/")) {
+                if(env->getFileExtensionFromFilePath(file) != "osz") continue;
+                const auto path = NEOSU_MAPS_PATH "/" + file;
+                if(env->getEnvInterop().handle_osz(path.c_str())) env->deleteFile(path);
+            }
+            return;
+        }
         if(ev.type != FileChangeType::CREATED) return;
         logRaw("[DirectoryWatcher] Importing new beatmap {}: type {}", ev.path, (u32)ev.type);
         if(env->getFileExtensionFromFilePath(ev.path) != "osz") return;
@@ -2566,7 +2727,7 @@ void SongBrowser::rebuildSongButtonsAndVisibleSongButtonsWithSearchMatchSupport(
 
     // use flagged search matches to rebuild visible song buttons
     if(this->curGroup == GroupType::NO_GROUPING) {
-        for(auto *parentButton : this->parentButtons) {
+        for(auto *parentButton : this->getSortedParentButtons()) {
             const SetVisibility visibility = this->getSetVisibility(parentButton);
 
             switch(visibility) {
@@ -2850,6 +3011,8 @@ void SongBrowser::rebucketDifficultyCollections() {
     if(this->difficultyCollectionButtons.size() != 12) return;
 
     for(auto &btn : this->difficultyCollectionButtons) btn->setChildren({});
+    this->groupChildrenSortedBy[GroupType::DIFFICULTY] = SortType::MAX;
+    this->bDifficultyBucketsStale = false;
 
     for(auto *parentBtn : this->parentButtons) {
         for(auto *child : parentBtn->getChildren()) {
@@ -2875,6 +3038,11 @@ void SongBrowser::rebuildAfterGroupOrSortChange(GroupType group, const std::opti
     const bool diffSortChanged = (newSortMethod == SortType::DIFFICULTY || group == GroupType::DIFFICULTY) &&
                                  this->lastDiffSortModIndex != StarPrecalc::active_idx;
 
+    // star ratings changed, which every sort order falls back to
+    if(this->lastDiffSortModIndex != StarPrecalc::active_idx) {
+        this->invalidateSortOrders();
+    }
+
     if(!this->bSongButtonsNeedSorting && !sortingChanged && !groupingChanged && !diffSortChanged &&
        !this->visibleSongButtons.empty()) {
         return;
@@ -2884,28 +3052,26 @@ void SongBrowser::rebuildAfterGroupOrSortChange(GroupType group, const std::opti
     this->curSortMethod = newSortMethod;
     this->lastDiffSortModIndex = StarPrecalc::active_idx;
 
-    if(this->bSongButtonsNeedSorting || sortingChanged || diffSortChanged) {
-        // lazy update grade
-        if(this->curSortMethod == SortType::RANKACHIEVED) {
-            for(SongButton *songButton : this->parentButtons) {
-                for(SongDifficultyButton *diffButton :
-                    reinterpret_cast<const std::vector<SongDifficultyButton *> &>(songButton->getChildren())) {
-                    diffButton->maybeUpdateGrade();
-                }
+    // lazy update grade (invalidates the affected sort orders through onGradeChanged)
+    if(this->curSortMethod == SortType::RANKACHIEVED &&
+       (this->bSongButtonsNeedSorting || sortingChanged || diffSortChanged)) {
+        for(SongButton *songButton : this->parentButtons) {
+            for(SongDifficultyButton *diffButton :
+                reinterpret_cast<const std::vector<SongDifficultyButton *> &>(songButton->getChildren())) {
+                diffButton->maybeUpdateGrade();
             }
         }
-        // the master button list should be sorted for all groupings
-        srt::pdqsort(this->parentButtons, SORTING_METHODS[this->curSortMethod].comparator);
-        this->bSongButtonsNeedSorting = false;
     }
+    this->bSongButtonsNeedSorting = false;
 
     this->visibleSongButtons.clear();
 
     if(group == GroupType::NO_GROUPING) {
-        this->visibleSongButtons.reserve(this->parentButtons.size());
+        const auto &sortedParentButtons = this->getSortedParentButtons();
+        this->visibleSongButtons.reserve(sortedParentButtons.size());
 
         // apply visibility logic
-        for(auto *parentButton : this->parentButtons) {
+        for(auto *parentButton : sortedParentButtons) {
             const SetVisibility visibility = this->getSetVisibility(parentButton);
 
             switch(visibility) {
@@ -2928,7 +3094,7 @@ void SongBrowser::rebuildAfterGroupOrSortChange(GroupType group, const std::opti
         }
     } else {
         if(auto *collBtns = getCollectionButtonsForGroup(group)) {
-            if(group == GroupType::DIFFICULTY) {
+            if(group == GroupType::DIFFICULTY && this->bDifficultyBucketsStale) {
                 this->rebucketDifficultyCollections();
             }
 
@@ -2937,7 +3103,8 @@ void SongBrowser::rebuildAfterGroupOrSortChange(GroupType group, const std::opti
                 this->visibleSongButtons.push_back(unq.get());
             }
 
-            if(groupingChanged || sortingChanged || diffSortChanged) {
+            // children stay sorted through addChildToGroup, so this only happens if the order is new or stale
+            if(this->groupChildrenSortedBy[group] != this->curSortMethod) {
                 for(const auto &button : *collBtns) {
                     auto &children = button->getChildren();
                     if(!children.empty()) {
@@ -2945,6 +3112,7 @@ void SongBrowser::rebuildAfterGroupOrSortChange(GroupType group, const std::opti
                         button->setChildren(children);
                     }
                 }
+                this->groupChildrenSortedBy[group] = this->curSortMethod;
             }
         }
     }
@@ -3249,10 +3417,10 @@ void SongBrowser::selectSongButton(CarouselButton *songButton) {
 
 void SongBrowser::selectRandomBeatmap() {
     // filter songbuttons or independent diffs
-    const auto &elements{this->carousel->container.getElements<CarouselButton>()};
+    const auto &elements{this->carousel->getRows()};
 
     std::vector<SongButton *> songButtons;
-    for(auto element : elements) {
+    for(const auto &[element, _] : elements) {
         auto *songButtonPointer = element->as<SongButton>();
         auto *songDifficultyButtonPointer = element->as<SongDifficultyButton>();
 
@@ -3283,10 +3451,10 @@ void SongBrowser::selectPreviousRandomBeatmap() {
                                                       // we don't switch to ourself)
 
         // filter songbuttons
-        const auto &elements{this->carousel->container.getElements<CarouselButton>()};
+        const auto &elements{this->carousel->getRows()};
 
         std::vector<SongButton *> songButtons;
-        for(auto *element : elements) {
+        for(const auto &[element, _] : elements) {
             auto *songButtonPointer = element->as<SongButton>();
 
             if(songButtonPointer != nullptr)  // allow ALL songbuttons
@@ -3324,9 +3492,9 @@ void SongBrowser::selectPreviousRandomBeatmap() {
 }
 
 void SongBrowser::playSelectedDifficulty() {
-    const auto &elements{this->carousel->container.getElements<CarouselButton>()};
+    const auto &elements{this->carousel->getRows()};
 
-    for(auto *element : elements) {
+    for(const auto &[element, _] : elements) {
         if(auto *songDifficultyButton = element->as<SongDifficultyButton>();
            songDifficultyButton && songDifficultyButton->isSelected()) {
             songDifficultyButton->select();
@@ -3346,6 +3514,7 @@ void SongBrowser::recreateCollectionsButtons() {
 
         this->selectionPreviousCollectionButton = nullptr;
         this->collectionButtons.clear();
+        this->groupChildrenSortedBy[GroupType::COLLECTIONS] = SortType::MAX;
     }
 
     Timer t;
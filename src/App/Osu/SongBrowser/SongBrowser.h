@@ -154,7 +154,9 @@ class SongBrowser final : public ScreenBackable {
     void refreshBeatmaps();
     void refreshBeatmaps(UIScreen *next_screen);
     void addBeatmapSet(BeatmapSet *beatmap, bool initialSongBrowserLoad = false);
-    void addSongButtonToAlphanumericGroup(SongButton *btn, CollBtnContainer &group, std::string_view name);
+    // drops the buttons of the set and every other reference to it or its difficulties (before Database deletes it)
+    void removeBeatmapSet(const BeatmapSet *mapset);
+    void addSongButtonToAlphanumericGroup(SongButton *btn, GroupType group, std::string_view name);
 
     void requestNextScrollToSongButtonJumpFix(SongDifficultyButton *diffButton);
     [[nodiscard]] bool isButtonVisible(CarouselButton *songButton) const;
@@ -252,6 +254,12 @@ class SongBrowser final : public ScreenBackable {
     void rebuildAfterGroupOrSortChange(GroupType group, const std::optional<SortType> &sortMethod = std::nullopt);
     void rebucketDifficultyCollections();
 
+    // called by SongDifficultyButton when a (lazily loaded) grade changed
+    void onGradeChanged();
+
+    // on-demand star ratings (AsyncStarCalc) changed without the mods changing
+    void onStarRatingsUpdated();
+
     void onSelectionMode();
     void onSelectionMods();
     void onSelectionRandom();
@@ -267,6 +275,11 @@ class SongBrowser final : public ScreenBackable {
    private:
     CollBtnContainer *getCollectionButtonsForGroup(GroupType group);
 
+    // parentButtons in the current sort order (sorted on first use, then kept sorted by addBeatmapSet)
+    const std::vector<SongButton *> &getSortedParentButtons();
+    void addChildToGroup(CollectionButton *groupButton, GroupType group, SongButton *child);
+    void invalidateSortOrders();
+
     GroupType curGroup{GroupType::NO_GROUPING};
     SortType curSortMethod{SortType::ARTIST};
     u8 lastDiffSortModIndex;
@@ -328,6 +341,17 @@ class SongBrowser final : public ScreenBackable {
     std::vector<SongButton *> parentButtons;
 
    private:
+    // persistent orderings of parentButtons, one per SortType
+    struct SortedButtons {
+        std::vector<SongButton *> buttons;
+        bool valid{false};
+    };
+    std::array<SortedButtons, SortType::MAX> sortedParentButtons;
+
+    // order which the children of each group's collection buttons are currently in (SortType::MAX if unsorted)
+    std::array<SortType, GroupType::MAX> groupChildrenSortedBy;
+    bool bDifficultyBucketsStale{true};
+
     std::vector<CarouselButton *> visibleSongButtons;
 
     UIOverlay *loadingOverlay{nullptr};
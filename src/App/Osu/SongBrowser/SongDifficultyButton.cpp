@@ -10,6 +10,7 @@
 // ---
 
 #include "AnimationHandler.h"
+#include "AsyncStarCalculator.h"
 #include "BackgroundImageHandler.h"
 #include "BeatmapInterface.h"
 #include "OsuConVars.h"
@@ -95,6 +96,9 @@ void SongDifficultyButton::draw() {
 
     // draw stars
     // NOTE: stars can sometimes be infinity! (e.g. broken osu!.db database)
+    if(StarPrecalc::is_custom_idx(StarPrecalc::active_idx)) {
+        AsyncStarCalc::prioritize(this->databaseBeatmap);
+    }
     float stars = this->databaseBeatmap->getStarRating(StarPrecalc::active_idx);
     if(stars > 0) {
         const float starOffsetY = (size.y * 0.85);
@@ -242,15 +246,19 @@ void SongDifficultyButton::updateGrade() {
         return;
     }
 
+    bool gradeChanged = false;
     for(const auto& score : dbScoreIt->second) {
         if(score.grade < this->grade) {
             this->grade = score.grade;
+            gradeChanged = true;
 
             if(this->parentSongButton->grade > this->grade) {
                 this->parentSongButton->grade = this->grade;
             }
         }
     }
+
+    if(gradeChanged) g_songbrowser->onGradeChanged();
 }
 
 bool SongDifficultyButton::isIndependentDiffButton() const {
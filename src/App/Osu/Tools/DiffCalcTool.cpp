@@ -13,11 +13,20 @@
 #include "SString.h"
 #include "Parsing.h"
 
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <atomic>
 #include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace {  // static
 
@@ -148,83 +157,64 @@ std::string modsStringFromMods(ModFlags mods, float speed) {
     return modsString;
 }
 
-}  // namespace
-
-#ifdef BUILD_TOOLS_ONLY
-#define entrypoint main
-#else
-#define entrypoint NEOSU_run_diffcalc
-#endif
-
-int entrypoint(int argc_, char *argv_[]) {
-    auto argv = std::vector<std::string>(argv_, argv_ + argc_);
-
-#ifdef BUILD_TOOLS_ONLY
-    // lazy
-    argv.insert(argv.begin() + 1, "-");
-    constexpr std::string_view usage = "<osu_file> [speed] [mod flags bitmask (0xHEX)]";
-#else
-    constexpr std::string_view usage = "-diffcalc <osu_file> [speed] [mod flags bitmask (0xHEX)]";
-#endif
-
-    size_t argc = argv.size();
+float parseSpeed(std::string_view str) {
+    float speed = 1.f;
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), speed);
+    if(ec == std::errc() && speed >= 0.01f && speed <= 3.f) return speed;
+    return 1.f;
+}
 
-    if(argc < 3) {
-        std::cerr << "usage: " << argv[0] << usage << '\n';
-        return 1;
+ModFlags parseModFlags(std::string_view str) {
+    int base = 10;
+    uint64_t flagsValue = 0;
+    if(str.starts_with("0x") || str.starts_with("0X")) {
+        base = 16;
+        str = str.substr(2);
     }
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), flagsValue, base);
+    if(ec == std::errc()) return static_cast<ModFlags>(flagsValue);
+    return {};
+}
 
-    std::string osuFilePath = argv[2];
+struct LoadedMap {
+    BeatmapSettings settings;
+    DatabaseBeatmap::PRIMITIVE_CONTAINER primitives;
+};
 
+// returns an error message on failure
+std::string loadMap(const std::string &osuFilePath, LoadedMap &out) {
     LiteFile file(osuFilePath);
     if(!file.canRead() || (file.getFileSize() == 0)) {
-        std::cerr << "error: could not read file" << osuFilePath << '\n';
-        return 1;
+        return "could not read file " + osuFilePath;
     }
 
     // parse difficulty settings from file
-    BeatmapSettings settings = parseDifficultySettings(file);
+    out.settings = parseDifficultySettings(file);
 
     std::vector<uint8_t> fileBuffer;
     file.readToVector(fileBuffer);
 
     // load primitive hitobjects
-    DatabaseBeatmap::PRIMITIVE_CONTAINER primitives =
-        DatabaseBeatmap::loadPrimitiveObjectsFromData(fileBuffer, osuFilePath);
-    if(primitives.error.errc) {
-        std::cerr << "error loading beatmap primitives: " << primitives.error.error_string() << '\n';
-        return 1;
-    }
-
-    float speedMultiplier = 1.0f;
-    if(argc > 3) {
-        std::string_view cur{argv[3]};
-        float speedTemp = 1.f;
-        auto [ptr, ec] = std::from_chars(cur.data(), cur.data() + cur.size(), speedTemp);
-        if(ec == std::errc() && speedTemp >= 0.01f && speedTemp <= 3.f) speedMultiplier = speedTemp;
+    out.primitives = DatabaseBeatmap::loadPrimitiveObjectsFromData(fileBuffer, osuFilePath);
+    if(out.primitives.error.errc) {
+        return "error loading beatmap primitives: " + std::string{out.primitives.error.error_string()};
     }
 
-    ModFlags modFlags = {};
-    if(argc > 4) {
-        int base = 10;
-        uint64_t flagsValue = 0;
-        std::string_view cur{argv[4]};
-        if(cur.starts_with("0x") || cur.starts_with("0X")) {
-            base = 16;
-            cur = cur.substr(2);
-        }
-        auto [ptr, ec] = std::from_chars(cur.data(), cur.data() + cur.size(), flagsValue, base);
-        if(ec == std::errc()) modFlags = static_cast<ModFlags>(flagsValue);
-    }
+    return {};
+}
 
-    // load difficulty hitobjects for star calculation
-    DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffResult =
-        DatabaseBeatmap::loadDifficultyHitObjects(primitives, settings.AR, settings.CS, speedMultiplier, false);
+struct CalcResult {
+    double totalStars;
+    double aim;
+    double speed;
+    double pp;  // SS
+};
 
-    if(diffResult.error.errc) {
-        std::cerr << "error loading difficulty objects: " << diffResult.error.error_string() << '\n';
-        return 1;
-    }
+CalcResult calculate(const LoadedMap &map, DatabaseBeatmap::LOAD_DIFFOBJ_RESULT &diffResult, float speedMultiplier,
+                     ModFlags modFlags,
+                     std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> *diffObjCache = nullptr) {
+    const auto &settings = map.settings;
+    const auto &primitives = map.primitives;
 
     // calculate star rating
     DifficultyCalculator::BeatmapDiffcalcData diffcalcData{.sortedHitObjects = diffResult.diffobjects,
@@ -243,7 +233,7 @@ int entrypoint(int argc_, char *argv_[]) {
     DifficultyCalculator::DifficultyAttributes outAttrs{};
 
     DifficultyCalculator::StarCalcParams starParams{
-        .cachedDiffObjects = {},
+        .cachedDiffObjects = diffObjCache ? std::move(*diffObjCache) : nullptr,
         .outAttributes = outAttrs,
         .beatmapData = diffcalcData,
         .outAimStrains = nullptr,
@@ -255,8 +245,11 @@ int entrypoint(int argc_, char *argv_[]) {
 
     const double totalStars = DifficultyCalculator::calculateStarDiffForHitObjects(starParams);
 
-    const double aim = outAttrs.AimDifficulty;
-    const double speed = outAttrs.SpeedDifficulty;
+    // the cached objects depend on the mods, only the allocation can be reused
+    if(diffObjCache) {
+        *diffObjCache = std::move(starParams.cachedDiffObjects);
+        (*diffObjCache)->clear();
+    }
 
     // calculate PP for SS play
     DifficultyCalculator::PPv2CalcParams ppParams{.attributes = outAttrs,
@@ -277,13 +270,451 @@ int entrypoint(int argc_, char *argv_[]) {
                                                   .legacyTotalScore = 0,
                                                   .isMcOsuImported = false};
 
-    const double pp = DifficultyCalculator::calculatePPv2(ppParams);
+    return {.totalStars = totalStars,
+            .aim = outAttrs.AimDifficulty,
+            .speed = outAttrs.SpeedDifficulty,
+            .pp = DifficultyCalculator::calculatePPv2(ppParams)};
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// batch mode
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct ModCombo {
+    float speed;
+    ModFlags mods;
+};
+
+enum class OutputFormat : uint8_t { JSONL, CSV };
+
+struct BatchOptions {
+    std::string input;
+    std::vector<ModCombo> combos{{.speed = 1.f, .mods = {}}};
+    unsigned threads{0};
+    OutputFormat format{OutputFormat::JSONL};
+};
+
+constexpr std::string_view batchUsage =
+    "--batch <directory|list file|-> [--combos speed:mods[,speed:mods...]] [--threads N] [--format jsonl|csv]\n"
+    "  directory: every .osu file in it (recursively), list file/stdin: one .osu path per line\n"
+    "  --combos: speed/mod flag bitmask pairs to calculate for every map (default 1:0)";
+
+// returns false on invalid arguments
+bool parseBatchOptions(std::span<const std::string> args, BatchOptions &opts) {
+    if(args.empty()) return false;
+    opts.input = args[0];
+
+    for(size_t i = 1; i < args.size(); i++) {
+        const std::string_view arg = args[i];
+        if(i + 1 >= args.size()) return false;
+        const std::string_view value = args[++i];
+
+        if(arg == "--combos") {
+            opts.combos.clear();
+            for(const auto &combo : SString::split(value, ',')) {
+                const auto sep = combo.find(':');
+                if(sep == std::string_view::npos) {
+                    opts.combos.push_back({.speed = parseSpeed(combo), .mods = {}});
+                } else {
+                    opts.combos.push_back(
+                        {.speed = parseSpeed(combo.substr(0, sep)), .mods = parseModFlags(combo.substr(sep + 1))});
+                }
+            }
+            if(opts.combos.empty()) return false;
+        } else if(arg == "--threads") {
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), opts.threads);
+            if(ec != std::errc()) return false;
+        } else if(arg == "--format") {
+            if(value == "jsonl") {
+                opts.format = OutputFormat::JSONL;
+            } else if(value == "csv") {
+                opts.format = OutputFormat::CSV;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<std::string> readPathList(std::istream &in) {
+    std::vector<std::string> paths;
+    std::string line;
+    while(std::getline(in, line)) {
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(!line.empty()) paths.push_back(std::move(line));
+    }
+    return paths;
+}
+
+// returns an error message on failure
+std::string collectInputs(const std::string &input, std::vector<std::string> &paths) {
+    namespace fs = std::filesystem;
+
+    if(input == "-") {
+        paths = readPathList(std::cin);
+        return {};
+    }
+
+    std::error_code ec;
+    if(fs::is_directory(input, ec)) {
+        for(fs::recursive_directory_iterator it(input, fs::directory_options::skip_permission_denied, ec), end;
+            !ec && it != end; it.increment(ec)) {
+            if(!it->is_regular_file(ec)) continue;
+            const auto path = it->path();
+            if(SString::to_lower(path.extension().string()) == ".osu") {
+                paths.push_back(path.string());
+            }
+        }
+        if(ec) return "could not scan directory " + input + ": " + ec.message();
+
+        // stable output order, for diffing runs against each other
+        std::ranges::sort(paths);
+        return {};
+    }
+
+    std::ifstream list(input);
+    if(!list.good()) return "could not read list file " + input;
+    paths = readPathList(list);
+    return {};
+}
+
+void appendNumber(std::string &out, double value) {
+    // shortest representation that round-trips, so runs can be compared exactly
+    char buf[32];
+    auto [ptr, ec] = std::to_chars(std::begin(buf), std::end(buf), value);
+    out.append(buf, ec == std::errc() ? ptr : buf);
+}
+
+void appendJsonString(std::string &out, std::string_view str) {
+    out.push_back('"');
+    for(const char c : str) {
+        switch(c) {
+            case '"':
+                out.append("\\\"");
+                break;
+            case '\\':
+                out.append("\\\\");
+                break;
+            case '\n':
+                out.append("\\n");
+                break;
+            case '\r':
+                out.append("\\r");
+                break;
+            case '\t':
+                out.append("\\t");
+                break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    constexpr std::string_view hex = "0123456789abcdef";
+                    out.append("\\u00");
+                    out.push_back(hex[(c >> 4) & 0xF]);
+                    out.push_back(hex[c & 0xF]);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+void appendCsvString(std::string &out, std::string_view str) {
+    out.push_back('"');
+    for(const char c : str) {
+        if(c == '"') out.push_back('"');
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+std::string modsHex(ModFlags mods) {
+    char buf[24] = "0x";
+    auto [ptr, ec] = std::to_chars(buf + 2, std::end(buf), static_cast<uint64_t>(mods), 16);
+    return {buf, ptr};
+}
+
+// one output record (map + mod combo), or one per map if it failed to load
+struct Record {
+    std::string_view path;
+    const ModCombo *combo;  // nullptr if the map failed to load
+    const CalcResult *result;
+    const LoadedMap *map;
+    uint32_t maxCombo;
+    double loadMS;
+    double calcMS;
+    std::string_view error;
+};
+
+void appendRecord(std::string &out, OutputFormat format, const Record &rec) {
+    const std::string hex = rec.combo ? modsHex(rec.combo->mods) : std::string{};
+    const std::string modsStr = rec.combo ? modsStringFromMods(rec.combo->mods, rec.combo->speed) : std::string{};
+
+    if(format == OutputFormat::JSONL) {
+        out.append("{\"file\":");
+        appendJsonString(out, rec.path);
+        if(rec.combo) {
+            out.append(",\"speed\":");
+            appendNumber(out, rec.combo->speed);
+            out.append(",\"mods\":");
+            appendJsonString(out, hex);
+            out.append(",\"mods_str\":");
+            appendJsonString(out, modsStr);
+        }
+        if(rec.result) {
+            out.append(",\"stars\":");
+            appendNumber(out, rec.result->totalStars);
+            out.append(",\"aim\":");
+            appendNumber(out, rec.result->aim);
+            out.append(",\"speed_stars\":");
+            appendNumber(out, rec.result->speed);
+            out.append(",\"pp\":");
+            appendNumber(out, rec.result->pp);
+            out.append(",\"objects\":");
+            appendNumber(out, rec.map->primitives.getNumObjects());
+            out.append(",\"max_combo\":");
+            appendNumber(out, rec.maxCombo);
+        }
+        out.append(",\"load_ms\":");
+        appendNumber(out, rec.loadMS);
+        if(rec.combo) {
+            out.append(",\"calc_ms\":");
+            appendNumber(out, rec.calcMS);
+        }
+        if(!rec.error.empty()) {
+            out.append(",\"error\":");
+            appendJsonString(out, rec.error);
+        }
+        out.append("}\n");
+    } else {
+        // file,speed,mods,mods_str,stars,aim,speed_stars,pp,objects,max_combo,load_ms,calc_ms,error
+        appendCsvString(out, rec.path);
+        out.push_back(',');
+        if(rec.combo) appendNumber(out, rec.combo->speed);
+        out.push_back(',');
+        out.append(hex);
+        out.push_back(',');
+        appendCsvString(out, modsStr);
+        out.push_back(',');
+        if(rec.result) {
+            appendNumber(out, rec.result->totalStars);
+            out.push_back(',');
+            appendNumber(out, rec.result->aim);
+            out.push_back(',');
+            appendNumber(out, rec.result->speed);
+            out.push_back(',');
+            appendNumber(out, rec.result->pp);
+            out.push_back(',');
+            appendNumber(out, rec.map->primitives.getNumObjects());
+            out.push_back(',');
+            appendNumber(out, rec.maxCombo);
+        } else {
+            out.append(",,,,,");
+        }
+        out.push_back(',');
+        appendNumber(out, rec.loadMS);
+        out.push_back(',');
+        if(rec.combo) appendNumber(out, rec.calcMS);
+        out.push_back(',');
+        appendCsvString(out, rec.error);
+        out.push_back('\n');
+    }
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Loads the map once, then calculates every requested combo.
+// Combos sharing a speed share the same difficulty hitobjects.
+std::string processBatchMap(const std::string &path, const BatchOptions &opts,
+                            std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> &cache) {
+    std::string out;
+
+    const auto loadStart = std::chrono::steady_clock::now();
+    LoadedMap map;
+    const std::string loadError = loadMap(path, map);
+    const double loadMS = msSince(loadStart);
+
+    if(!loadError.empty()) {
+        appendRecord(out, opts.format, {.path = path, .loadMS = loadMS, .error = loadError});
+        return out;
+    }
+
+    std::vector<bool> done(opts.combos.size(), false);
+    for(size_t i = 0; i < opts.combos.size(); i++) {
+        if(done[i]) continue;
+
+        const float speed = opts.combos[i].speed;
+        auto calcStart = std::chrono::steady_clock::now();
+        DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffResult = DatabaseBeatmap::loadDifficultyHitObjects(
+            map.primitives, map.settings.AR, map.settings.CS, speed, false);
+
+        for(size_t j = i; j < opts.combos.size(); j++) {
+            const ModCombo &combo = opts.combos[j];
+            if(done[j] || combo.speed != speed) continue;
+            done[j] = true;
+
+            if(diffResult.error.errc) {
+                const std::string error =
+                    "error loading difficulty objects: " + std::string{diffResult.error.error_string()};
+                appendRecord(out, opts.format,
+                             {.path = path, .combo = &combo, .loadMS = loadMS, .calcMS = 0., .error = error});
+                continue;
+            }
+
+            const CalcResult result = calculate(map, diffResult, combo.speed, combo.mods, &cache);
+
+            appendRecord(out, opts.format,
+                         {.path = path,
+                          .combo = &combo,
+                          .result = &result,
+                          .map = &map,
+                          .maxCombo = diffResult.getTotalMaxCombo(),
+                          .loadMS = loadMS,
+                          .calcMS = msSince(calcStart)});
+            calcStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    return out;
+}
+
+int runBatch(std::span<const std::string> args) {
+    BatchOptions opts;
+    if(!parseBatchOptions(args, opts)) {
+        std::cerr << "usage: " << batchUsage << '\n';
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    if(const std::string error = collectInputs(opts.input, paths); !error.empty()) {
+        std::cerr << "error: " << error << '\n';
+        return 1;
+    }
+
+    unsigned nbThreads = opts.threads > 0 ? opts.threads : std::max(std::thread::hardware_concurrency(), 1u);
+    nbThreads = std::min<size_t>(nbThreads, std::max<size_t>(paths.size(), 1));
+
+    std::cerr << "processing " << paths.size() << " maps x " << opts.combos.size() << " combos on " << nbThreads
+              << " threads\n";
+
+    if(opts.format == OutputFormat::CSV) {
+        std::cout << "file,speed,mods,mods_str,stars,aim,speed_stars,pp,objects,max_combo,load_ms,calc_ms,error\n";
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // results are printed in input order as soon as every map before them is done
+    std::vector<std::string> outputs(paths.size());
+    std::vector<bool> finished(paths.size(), false);
+    size_t nextToPrint = 0;
+    std::mutex outputMutex;
+
+    std::atomic<size_t> nextIndex{0};
+    const auto worker = [&] {
+        std::unique_ptr<std::vector<DifficultyCalculator::DiffObject>> cache;
+        for(size_t i = nextIndex.fetch_add(1); i < paths.size(); i = nextIndex.fetch_add(1)) {
+            std::string out = processBatchMap(paths[i], opts, cache);
+
+            std::scoped_lock lock(outputMutex);
+            outputs[i] = std::move(out);
+            finished[i] = true;
+            for(; nextToPrint < paths.size() && finished[nextToPrint]; nextToPrint++) {
+                std::cout << outputs[nextToPrint];
+                outputs[nextToPrint] = {};
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(nbThreads);
+        for(unsigned i = 0; i < nbThreads; i++) {
+            threads.emplace_back(worker);
+        }
+    }
+    std::cout.flush();
+
+    const double totalSeconds = msSince(start) / 1000.;
+    std::cerr << "done: " << paths.size() << " maps in " << totalSeconds << "s ("
+              << (totalSeconds > 0. ? paths.size() / totalSeconds : 0.) << " maps/s)\n";
+
+    return 0;
+}
+
+}  // namespace
+
+#ifdef BUILD_TOOLS_ONLY
+#define entrypoint main
+#else
+#define entrypoint NEOSU_run_diffcalc
+#endif
+
+int entrypoint(int argc_, char *argv_[]) {
+    auto argv = std::vector<std::string>(argv_, argv_ + argc_);
+
+#ifdef BUILD_TOOLS_ONLY
+    // lazy
+    argv.insert(argv.begin() + 1, "-");
+    constexpr std::string_view usage = " <osu_file> [speed] [mod flags bitmask (0xHEX)]";
+    constexpr std::string_view batchPrefix = " ";
+#else
+    constexpr std::string_view usage = " -diffcalc <osu_file> [speed] [mod flags bitmask (0xHEX)]";
+    constexpr std::string_view batchPrefix = " -diffcalc ";
+#endif
+
+    size_t argc = argv.size();
+
+    if(argc < 3) {
+        std::cerr << "usage: " << argv[0] << usage << '\n';
+        std::cerr << "       " << argv[0] << batchPrefix << batchUsage << '\n';
+        return 1;
+    }
+
+    if(argv[2] == "--batch") {
+        return runBatch(std::span<const std::string>(argv).subspan(3));
+    }
+
+    std::string osuFilePath = argv[2];
+
+    LoadedMap map;
+    if(const std::string error = loadMap(osuFilePath, map); !error.empty()) {
+        std::cerr << "error: " << error << '\n';
+        return 1;
+    }
+    const auto &settings = map.settings;
+    const auto &primitives = map.primitives;
+
+    float speedMultiplier = 1.0f;
+    if(argc > 3) {
+        speedMultiplier = parseSpeed(argv[3]);
+    }
+
+    ModFlags modFlags = {};
+    if(argc > 4) {
+        modFlags = parseModFlags(argv[4]);
+    }
+
+    // load difficulty hitobjects for star calculation
+    DatabaseBeatmap::LOAD_DIFFOBJ_RESULT diffResult =
+        DatabaseBeatmap::loadDifficultyHitObjects(map.primitives, settings.AR, settings.CS, speedMultiplier, false);
+
+    if(diffResult.error.errc) {
+        std::cerr << "error loading difficulty objects: " << diffResult.error.error_string() << '\n';
+        return 1;
+    }
+
+    const CalcResult result = calculate(map, diffResult, speedMultiplier, modFlags);
 
     // output results
-    std::cout << "star rating: " << totalStars << '\n';
-    std::cout << "  aim: " << aim << '\n';
-    std::cout << "  speed: " << speed << '\n';
-    std::cout << "pp (SS): " << pp << '\n';
+    std::cout << "star rating: " << result.totalStars << '\n';
+    std::cout << "  aim: " << result.aim << '\n';
+    std::cout << "  speed: " << result.speed << '\n';
+    std::cout << "pp (SS): " << result.pp << '\n';
     std::cout << '\n';
     std::cout << "map info:\n";
     std::cout << "  mods: " << modsStringFromMods(modFlags, speedMultiplier) << '\n';
@@ -224,10 +224,8 @@ void UserCard::update(CBaseUIEventCtx &c) {
         this->setText(BanchoState::get_username().c_str());
     }
 
-    // calculatePlayerStats() does nothing unless username changed or scores changed
+    // calculatePlayerStats() reads the running totals of the player stats index, which are updated as scores change
     // so this should not be an expensive operation
-    // calling this on each update loop allows us to just set db->bDidScoresChangeForStats = true
-    // to recalculate local user stats
     this->updateUserStats();
 
     CBaseUIButton::update(c);
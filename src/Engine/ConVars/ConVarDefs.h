@@ -64,6 +64,7 @@ extern void _update();
 
 namespace Profiling {
 extern void vprofToggleCB(float);
+extern void vprofTraceToggleCB(float);
 }
 namespace McThread {
 enum Priority : unsigned char;
@@ -109,6 +110,7 @@ CONVAR(restart, CLIENT, CFUNC(_restart));
 CONVAR(save);  // database save, set in Database
 CONVAR(showconsolebox);
 CONVAR(snd_restart);
+CONVAR(snd_soloud_queue_stats);  // set in SoLoudSoundEngine
 CONVAR(take_screenshot, CLIENT | NOLOAD | NOSAVE,
        [](std::string_view args) -> void { g ? g->takeScreenshot(args) : (void)0; });
 CONVAR(update);
@@ -210,6 +212,11 @@ CONVAR(r_opengl_legacy_vao_use_vertex_array, Env::cfg(REND::GLES32) ? true : fal
        "texcoords/normals/etc. are NOT in gl_MultiTexCoord0 -> requiring a shader with attributes)");
 CONVAR(font_load_system, true, CLIENT, "try to load a similar system font if a glyph is missing in the bundled fonts");
 CONVAR(r_gl_image_unbind, false, CLIENT);
+CONVAR(r_batch_quads, true, CLIENT,
+       "collect consecutive rects/quads/images into as few draw calls as possible (legacy opengl renderer only)");
+CONVAR(r_batch_text, true, CLIENT,
+       "merge the glyphs of consecutive strings using the same font into as few draw calls as possible (legacy opengl "
+       "renderer only)");
 CONVAR(r_gles_orphan_buffers, Env::cfg(OS::WASM) ? false : true, CLIENT,  // destroys WASM perf for some reason
        "reduce cpu/gpu synchronization by freeing buffer objects before modifying them");
 CONVAR(r_gl_rt_unbind, false, CLIENT);
@@ -218,7 +225,7 @@ CONVAR(r_globaloffset_y, 0.0f, CLIENT | PROTECTED | GAMEPLAY);
 CONVAR(r_sync_debug, false, CLIENT | HIDDEN, "print debug information about sync objects");
 CONVAR(vprof, false, CLIENT | SERVER, "enables/disables the visual profiler", CFUNC(Profiling::vprofToggleCB));
 CONVAR(vprof_display_mode, 0, CLIENT | SERVER,
-       "which info blade to show on the top right (gpu/engine/app/etc. info), use CTRL + TAB to "
+       "which info blade to show on the top right (gpu/engine/app/render/etc. info), use CTRL + TAB to "
        "cycle through, 0 = disabled");
 CONVAR(vprof_graph, true, CLIENT | SERVER, "whether to draw the graph when the overlay is enabled");
 CONVAR(vprof_graph_alpha, 0.9f, CLIENT | SERVER, "line opacity");
@@ -228,8 +235,16 @@ CONVAR(vprof_graph_height, 250.0f, CLIENT | SERVER);
 CONVAR(vprof_graph_margin, 40.0f, CLIENT | SERVER);
 CONVAR(vprof_graph_range_max, 16.666666f, CLIENT | SERVER, "max value of the y-axis in milliseconds");
 CONVAR(vprof_graph_width, 800.0f, CLIENT | SERVER);
+CONVAR(vprof_render_csv, false, CLIENT,
+       "while the profiler is enabled, append per-frame render counters (total and per scope) to "
+       "vprof_render_stats.csv");
 CONVAR(vprof_spike, 0, CLIENT | SERVER,
        "measure and display largest spike details (1 = small info, 2 = extended info)");
+CONVAR(vprof_trace, false, CLIENT | NOSAVE,
+       "capture profiler scopes from all threads for vprof_trace_seconds, then write them to a chrome trace json file "
+       "(set to 0 to stop early)",
+       CFUNC(Profiling::vprofTraceToggleCB));
+CONVAR(vprof_trace_seconds, 10.0f, CLIENT, "how long vprof_trace captures for");
 
 // Display settings
 CONVAR(fps_max, 1000.0f, CLIENT, "framerate limiter, gameplay");
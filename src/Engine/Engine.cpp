@@ -277,6 +277,8 @@ void Engine::onPaint() {
     if(this->bShuttingDown) return;
     VPROF_BUDGET("Engine::onPaint", VPROF_BUDGETGROUP_DRAW);
 
+    const u64 paintStartNS = Timing::getTicksNS();
+
     this->bDrawing = true;
     {
         // begin
@@ -310,9 +312,19 @@ void Engine::onPaint() {
             VPROF_BUDGET("Graphics::endScene", VPROF_BUDGETGROUP_DRAW_SWAPBUFFERS);
             g->endScene();
         }
+        g->finishDrawStatsFrame();
     }
     this->bDrawing = false;
 
+    const u64 presentedNS = Timing::getTicksNS();
+    this->frameTimeStats.draw.record((presentedNS - paintStartNS) / Timing::NS_PER_US);
+    if(this->iPendingInputNS != 0) {
+        if(presentedNS > this->iPendingInputNS) {
+            this->frameTimeStats.inputToPresent.record((presentedNS - this->iPendingInputNS) / Timing::NS_PER_US);
+        }
+        this->iPendingInputNS = 0;
+    }
+
     this->iFrameCount++;
 }
 
@@ -321,6 +333,10 @@ void Engine::onUpdate() {
 
     VPROF_BUDGET("Engine::onUpdate", VPROF_BUDGETGROUP_UPDATE);
 
+    const u64 updateStartNS = Timing::getTicksNS();
+
+    Profiling::Trace::update();
+
     {
         VPROF_BUDGET("Timer::update", VPROF_BUDGETGROUP_UPDATE);
         // update time
@@ -328,6 +344,7 @@ void Engine::onUpdate() {
             // frame time
             const f64 now = Timing::getTimeReal();
             const f64 frameTime = this->dFrameTime = std::max<f64>(now - this->dTime, 0.00005);
+            if(this->iFrameCount > 0) this->frameTimeStats.frame.record((u64)(frameTime * 1'000'000.));
             // total engine runtime
             this->dTime = now;
             if(this->bEngineThrottle) {
@@ -420,6 +437,13 @@ void Engine::onUpdate() {
         VPROF_BUDGET("Environment::update", VPROF_BUDGETGROUP_UPDATE);
         env->update();
     }
+
+    this->frameTimeStats.update.record((Timing::getTicksNS() - updateStartNS) / Timing::NS_PER_US);
+}
+
+void Engine::onInputEvent(u64 timestampNS) {
+    // only the oldest press matters, anything after it gets presented in the same frame
+    if(this->iPendingInputNS == 0 || timestampNS < this->iPendingInputNS) this->iPendingInputNS = timestampNS;
 }
 
 void Engine::onFocusGained() {
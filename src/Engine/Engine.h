@@ -8,6 +8,7 @@
 
 #include "Rect.h"
 #include "KeyboardListener.h"
+#include "FrameTimeHistogram.h"
 #include "CompatShims.h"
 #include "SyncMutex.h"
 #include "SyncJthread.h"
@@ -109,6 +110,13 @@ class Engine final : public KeyboardListener {
     [[nodiscard]] constexpr u64 getFrameCount() const { return this->iFrameCount; }
     [[nodiscard]] double getSimulatedVsyncFrameDelta() const;  // 0 on non-vsync frames
 
+    // frame/update/draw/input latency histograms, always recording
+    [[nodiscard]] constexpr const FrameTimeStats &getFrameTimeStats() const { return this->frameTimeStats; }
+    inline void resetFrameTimeStats() { this->frameTimeStats.reset(); }
+
+    // timestamp (Timing::getTicksNS() clock) of a key/button press, for the input-to-present histogram
+    void onInputEvent(u64 timestampNS);
+
     // clang-format off
     // NOTE: if engine_throttle cvar is off, this will always return true
     [[nodiscard]] inline bool throttledShouldRun(unsigned int howManyVsyncFramesToWaitBetweenExecutions) {
@@ -141,6 +149,9 @@ class Engine final : public KeyboardListener {
     u64 iFrameCount;
     double dFrameTime;
 
+    FrameTimeStats frameTimeStats;
+    u64 iPendingInputNS{0};  // oldest press which hasn't been presented yet
+
     // this will wrap quickly, and that's fine, it should be used as a dividend in a modular expression anyways
     double fVsyncFrameCounterTime;
     uint8_t iVsyncFrameCount;
@@ -225,23 +225,55 @@ ByteBufferedFile::Writer::Writer(std::string_view writePath_param)
 
 ByteBufferedFile::Writer::~Writer() {
     if(this->file.is_open()) {
-        this->flush();
-        this->file.close();
-
-        if(!this->error_flag && this->tmp_file_path != this->file_path) {
-            std::error_code ec;
-            std::filesystem::remove(this->file_path, ec);  // Windows (the Microsoft docs are LYING)
-            std::filesystem::rename(this->tmp_file_path, this->file_path, ec);
-            if(ec) {
-                // can't set error in destructor, but log it
-                debugLog("Failed to rename temporary file: {:s}", ec.message().c_str());
-            }
+        const bool had_error = this->error_flag;
+        if(!this->commit() && !had_error) {
+            // can't report it from the destructor, but log it
+            debugLog("Failed to save '{:s}': {:s}", this->write_path, this->last_error);
         }
     }
 
     file_locks[path_to_lock_index(this->write_path)].unlock();
 }
 
+bool ByteBufferedFile::Writer::commit(bool syncToDisk) {
+    if(!this->file.is_open()) {
+        this->set_error("File is not open");
+        return false;
+    }
+
+    this->flush();
+    this->file.close();
+    if(this->error_flag) return false;
+    if(this->file.fail()) {
+        this->set_error("Failed to close file: " + std::generic_category().message(errno));
+        return false;
+    }
+
+    const bool renaming = this->tmp_file_path != this->file_path;
+    if(syncToDisk) {
+        const std::string tmp_write_path = renaming ? this->write_path + ".tmp" : this->write_path;
+        if(!File::syncToDisk(tmp_write_path)) {
+            this->set_error("Failed to sync file to disk: " + std::generic_category().message(errno));
+            return false;
+        }
+    }
+
+    if(renaming) {
+        std::error_code ec;
+        if(!File::replaceFile(this->write_path + ".tmp", this->write_path, ec)) {
+            this->set_error("Failed to rename temporary file: " + ec.message());
+            return false;
+        }
+
+        if(syncToDisk && !File::syncParentDirectory(this->write_path)) {
+            this->set_error("Failed to sync directory to disk: " + std::generic_category().message(errno));
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void ByteBufferedFile::Writer::set_error(const std::string &error_msg) {
     if(!this->error_flag) {  // only set first error
         this->error_flag = true;
@@ -224,6 +224,12 @@ class ByteBufferedFile {
         [[nodiscard]] constexpr std::string_view error() const { return this->last_error; }
 
         void flush();
+
+        // flushes, closes and atomically renames the temporary file over the target now, instead of in the destructor
+        // with syncToDisk, the temporary file is synced before the rename and its directory after it
+        // returns false (and sets the error) if any step failed. failures before the rename leave the target untouched
+        bool commit(bool syncToDisk = false);
+
         void write_bytes(const u8 *bytes, uSz n);
         void write_hash_chars(const MD5String &hash_str);
         void write_hash_digest(const MD5Hash &hash_digest);
@@ -17,11 +17,18 @@
 #ifdef MCENGINE_PLATFORM_WINDOWS
 #include "WinDebloatDefs.h"
 #include <windows.h>
+#elif defined(MCENGINE_PLATFORM_LINUX)
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #endif
 
 namespace fs = std::filesystem;
 
-// The Windows implementation does not poll, only wakes up when files in folders on disk have changed
+// The Windows and Linux implementations do not poll, they only wake up when files in folders on disk have changed
 struct DirWatcherImpl {
    private:
     NOCOPY_NOMOVE(DirWatcherImpl)
@@ -30,11 +37,17 @@ struct DirWatcherImpl {
         this->init_wakeup_notification();
         this->thr = Sync::jthread([this](const Sync::stop_token& stoken) { return this->worker_loop(stoken); });
     }
-    ~DirWatcherImpl() { this->destroy_wakeup_notification(); }
+    ~DirWatcherImpl() {
+        // the worker might still be waiting on the wakeup notification, so it has to be gone before that is destroyed
+        this->thr.request_stop();
+        this->notify_thread();
+        if(this->thr.joinable()) this->thr.join();
+        this->destroy_wakeup_notification();
+    }
 
-    void watch_directory(std::string path, FileChangeCallback cb) {
+    void watch_directory(std::string path, FileChangeCallback cb, bool recursive) {
         Sync::scoped_lock lock(this->directories_mtx);
-        this->directories_to_add.emplace_back(std::move(path), std::move(cb));
+        this->directories_to_add.push_back({std::move(path), std::move(cb), recursive});
         this->notify_thread();
     }
 
@@ -63,8 +76,14 @@ struct DirWatcherImpl {
         u8 stable_checks{0};  // consecutive checks where timestamp was stable
     };
 
+    struct WatchRequest {
+        std::string path;
+        FileChangeCallback cb;
+        bool recursive;
+    };
+
     Sync::mutex directories_mtx;
-    std::vector<std::pair<std::string, FileChangeCallback>> directories_to_add;
+    std::vector<WatchRequest> directories_to_add;
     std::vector<std::string> directories_to_remove;
 
     Sync::mutex finished_events_mtx;
@@ -85,9 +104,10 @@ struct DirWatcherImpl {
     void notify_thread() { SetEvent(this->wakeup_event); }
 
     struct DirectoryState {
-        DirectoryState(FileChangeCallback cb) : cb(std::move(cb)) {}
+        DirectoryState(FileChangeCallback cb, bool recursive) : cb(std::move(cb)), recursive(recursive) {}
 
         FileChangeCallback cb;
+        bool recursive;
 
         Hash::stable_stringmap<UnconfirmedEvent> unconfirmed_events{};
 
@@ -130,7 +150,7 @@ struct DirWatcherImpl {
             OVERLAPPED overlapped{};
         } w;
 
-        alignas(DWORD) std::array<u8, 4096> buffer{};
+        alignas(DWORD) std::array<u8, 64 * 1024> buffer{};  // big enough for bursts in recursive watches
         bool read_pending{false};
     };
 
@@ -155,11 +175,11 @@ struct DirWatcherImpl {
             // Add/remove directories
             {
                 Sync::scoped_lock lock(this->directories_mtx);
-                for(auto& [path, cb] : this->directories_to_add) {
+                for(auto& [path, cb, recursive] : this->directories_to_add) {
                     if(std::ranges::contains(this->directories_to_remove, path)) continue;
                     if(!path.ends_with('/')) path.push_back('/');  // make sure it ends with a /
 
-                    auto [it, added] = active_directories.emplace(path, DirectoryState(cb));
+                    auto [it, added] = active_directories.emplace(path, DirectoryState(cb, recursive));
                     if(added) {
                         // This should always be true
                         directories_to_init.push_back(it);
@@ -207,8 +227,10 @@ struct DirWatcherImpl {
 
                 ResetEvent(state.w.overlapped.hEvent);
                 BOOL result = ReadDirectoryChangesW(
-                    state.w.dir_handle, state.buffer.data(), static_cast<DWORD>(state.buffer.size()), FALSE,
-                    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, nullptr,
+                    state.w.dir_handle, state.buffer.data(), static_cast<DWORD>(state.buffer.size()), state.recursive,
+                    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE |
+                        FILE_NOTIFY_CHANGE_SIZE,
+                    nullptr,
                     &state.w.overlapped, nullptr);
 
                 if(result || GetLastError() == ERROR_IO_PENDING) {
@@ -271,7 +293,13 @@ struct DirWatcherImpl {
 
                 state.read_pending = false;
 
-                if(bytes_transferred == 0) continue;
+                if(bytes_transferred == 0) {
+                    // the buffer overflowed and its contents were discarded, so we don't know what changed
+                    Sync::scoped_lock lock(this->finished_events_mtx);
+                    this->finished_events.emplace_back(
+                        state.cb, FileChangeEvent{.path = path, .type = FileChangeType::RESCAN, .tms = {}});
+                    continue;
+                }
 
                 // Process notifications
                 uSz offset = 0;
@@ -373,6 +401,268 @@ struct DirWatcherImpl {
 
         CloseHandle(stop_event);
     }
+#elif defined(MCENGINE_PLATFORM_LINUX)
+   private:
+    // inotify tells us when a file was closed after writing (IN_CLOSE_WRITE) or moved into place (IN_MOVED_TO),
+    // so unlike the other backends, events are final as soon as we see them and no debouncing is needed.
+    // inotify itself isn't recursive, so recursive watches add one watch per subdirectory (and follow new ones).
+
+    int inotify_fd{-1};
+    int wakeup_fd{-1};  // eventfd
+
+    void init_wakeup_notification() {
+        this->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(this->inotify_fd < 0) debugLog("DirectoryWatcher: inotify_init1 failed: {}", strerror(errno));
+
+        this->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        assert(this->wakeup_fd >= 0);
+    }
+    void destroy_wakeup_notification() {
+        if(this->inotify_fd >= 0) close(this->inotify_fd);
+        if(this->wakeup_fd >= 0) close(this->wakeup_fd);
+        this->inotify_fd = this->wakeup_fd = -1;
+    }
+    void notify_thread() {
+        if(this->wakeup_fd < 0) return;
+        const u64 one = 1;
+        (void)!write(this->wakeup_fd, &one, sizeof(one));
+    }
+
+    static constexpr u32 WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE |
+                                      IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    struct DirectoryState {
+        DirectoryState(FileChangeCallback cb, bool recursive) : cb(std::move(cb)), recursive(recursive) {}
+
+        FileChangeCallback cb;
+        bool recursive;
+
+        // created files which haven't been closed yet, so that IN_CLOSE_WRITE can report them as CREATED
+        Hash::flat::set<std::string> pending_creations{};
+    };
+
+    struct WatchedDir {
+        std::string path;       // always ends with a '/'
+        DirectoryState* state;  // owned by active_directories, which is node-based
+    };
+
+    Hash::stable_stringmap<DirectoryState> active_directories;
+    Hash::flat::map<int, WatchedDir> watches;  // wd -> directory
+    Hash::unstable_stringmap<int> watch_descriptors;  // directory -> wd
+
+    std::vector<std::pair<FileChangeCallback, FileChangeEvent>> new_events;  // published once per wakeup
+    bool warned_watch_limit{false};
+
+    void add_event(const DirectoryState& state, std::string path, FileChangeType type) {
+        std::error_code ec;
+        const auto tms = type == FileChangeType::DELETED ? fs::file_time_type{} : fs::last_write_time(path, ec);
+        this->new_events.emplace_back(state.cb, FileChangeEvent{.path = std::move(path), .type = type, .tms = tms});
+    }
+
+    bool add_watch(const std::string& dir_path, DirectoryState* state) {
+        const int wd = inotify_add_watch(this->inotify_fd, dir_path.c_str(), WATCH_MASK);
+        if(wd < 0) {
+            if(errno == ENOSPC && !this->warned_watch_limit) {
+                this->warned_watch_limit = true;
+                debugLog("DirectoryWatcher: out of inotify watches at {} (raise fs.inotify.max_user_watches)",
+                         dir_path);
+            } else if(errno != ENOSPC) {
+                debugLog("DirectoryWatcher: failed to watch {}: {}", dir_path, strerror(errno));
+            }
+            return false;
+        }
+
+        if(const auto it = this->watches.find(wd); it != this->watches.end() && it->second.state != state) {
+            // the same directory is already part of another watch, and there can only be one callback per path
+            return false;
+        }
+
+        this->watches[wd] = {.path = dir_path, .state = state};
+        this->watch_descriptors[dir_path] = wd;
+        return true;
+    }
+
+    // watches dir_path and (if recursive) everything below it
+    // files which are already there are reported as created if report_existing is set, since anything in a directory
+    // that was just created or moved in could have been written before we started watching it
+    void add_tree(const std::string& dir_path, DirectoryState* state, bool report_existing) {
+        if(!this->add_watch(dir_path, state)) return;
+
+        std::error_code ec;
+        if(state->recursive) {
+            for(auto it = fs::recursive_directory_iterator(dir_path, fs::directory_options::skip_permission_denied, ec);
+                !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                const auto type = it->symlink_status(ec).type();
+                if(type == fs::file_type::directory) {
+                    std::string sub_path = it->path().string();
+                    sub_path.push_back('/');
+                    if(!this->add_watch(sub_path, state)) it.disable_recursion_pending();
+                } else if(report_existing && type == fs::file_type::regular) {
+                    this->add_event(*state, it->path().string(), FileChangeType::CREATED);
+                }
+            }
+        } else if(report_existing) {
+            for(const auto& entry : fs::directory_iterator(dir_path, ec)) {
+                if(entry.symlink_status(ec).type() != fs::file_type::regular) continue;
+                this->add_event(*state, entry.path().string(), FileChangeType::CREATED);
+            }
+        }
+    }
+
+    template <typename F>
+    void remove_watches_if(F&& pred) {
+        for(auto it = this->watches.begin(); it != this->watches.end();) {
+            if(!pred(it->second)) {
+                ++it;
+                continue;
+            }
+            inotify_rm_watch(this->inotify_fd, it->first);
+            if(const auto dit = this->watch_descriptors.find(it->second.path);
+               dit != this->watch_descriptors.end() && dit->second == it->first) {
+                this->watch_descriptors.erase(dit);
+            }
+            it = this->watches.erase(it);
+        }
+    }
+
+    // removes the watches on dir_path and everything below it
+    void remove_tree(const std::string& dir_path) {
+        this->remove_watches_if([&dir_path](const WatchedDir& dir) { return dir.path.starts_with(dir_path); });
+    }
+
+    // after a queue overflow we don't know what changed (or which new subdirectories still need watches),
+    // so sync the watches with what's on disk again and have every callback rescan its directory
+    void rescan_all() {
+        std::error_code ec;
+        this->remove_watches_if([&ec](const WatchedDir& dir) { return !fs::is_directory(dir.path, ec); });
+
+        for(auto& [root, state] : this->active_directories) {
+            state.pending_creations.clear();
+            this->add_tree(root, &state, false);
+            this->add_event(state, root, FileChangeType::RESCAN);
+        }
+    }
+
+    void handle_event(const inotify_event& ev) {
+        if(ev.mask & IN_Q_OVERFLOW) {
+            debugLog("DirectoryWatcher: inotify queue overflowed, rescanning watched directories");
+            this->rescan_all();
+            return;
+        }
+
+        const auto it = this->watches.find(ev.wd);
+        if(it == this->watches.end()) return;  // already removed
+
+        if(ev.mask & IN_IGNORED) {
+            // the directory is gone (or we removed the watch ourselves)
+            if(const auto dit = this->watch_descriptors.find(it->second.path);
+               dit != this->watch_descriptors.end() && dit->second == ev.wd) {
+                this->watch_descriptors.erase(dit);
+            }
+            this->watches.erase(it);
+            return;
+        }
+
+        if(ev.len == 0) return;  // only interested in events on directory entries
+
+        DirectoryState& state = *it->second.state;
+        std::string path = it->second.path + ev.name;
+
+        if(ev.mask & IN_ISDIR) {
+            if(!state.recursive) return;
+
+            if(ev.mask & (IN_CREATE | IN_MOVED_TO)) {
+                path.push_back('/');
+                this->add_tree(path, &state, true);
+            } else if(ev.mask & (IN_DELETE | IN_MOVED_FROM)) {
+                this->remove_tree(path + '/');
+                this->add_event(state, std::move(path), FileChangeType::DELETED);
+            }
+            return;
+        }
+
+        if(ev.mask & IN_CREATE) {
+            state.pending_creations.insert(std::move(path));
+        } else if(ev.mask & IN_CLOSE_WRITE) {
+            const bool created = state.pending_creations.erase(path) > 0;
+            this->add_event(state, std::move(path), created ? FileChangeType::CREATED : FileChangeType::MODIFIED);
+        } else if(ev.mask & IN_MOVED_TO) {
+            state.pending_creations.erase(path);
+            this->add_event(state, std::move(path), FileChangeType::CREATED);
+        } else if(ev.mask & (IN_DELETE | IN_MOVED_FROM)) {
+            state.pending_creations.erase(path);
+            this->add_event(state, std::move(path), FileChangeType::DELETED);
+        }
+    }
+
+    void worker_loop(const Sync::stop_token& stoken) {
+        McThread::set_current_thread_name(US_("dir_watcher"));
+        McThread::set_current_thread_prio(McThread::Priority::LOW);
+
+        if(this->inotify_fd < 0) return;
+
+        // wake up the poll() below when stop is requested
+        Sync::stop_callback stop_cb(stoken, [this]() { this->notify_thread(); });
+
+        alignas(inotify_event) std::array<u8, 64 * 1024> buffer;
+
+        while(!stoken.stop_requested()) {
+            // Add/remove directories
+            {
+                Sync::scoped_lock lock(this->directories_mtx);
+                for(auto& path : this->directories_to_remove) {
+                    if(!path.ends_with('/')) path.push_back('/');
+
+                    const auto it = this->active_directories.find(path);
+                    if(it == this->active_directories.end()) continue;
+
+                    const DirectoryState* state = &it->second;
+                    this->remove_watches_if([state](const WatchedDir& dir) { return dir.state == state; });
+                    this->active_directories.erase(it);
+                }
+                this->directories_to_remove.clear();
+
+                for(auto& [path, cb, recursive] : this->directories_to_add) {
+                    if(!path.ends_with('/')) path.push_back('/');
+
+                    auto [it, added] = this->active_directories.emplace(path, DirectoryState(cb, recursive));
+                    if(added) this->add_tree(it->first, &it->second, false);
+                }
+                this->directories_to_add.clear();
+            }
+
+            std::array<pollfd, 2> fds{{{.fd = this->inotify_fd, .events = POLLIN, .revents = 0},
+                                       {.fd = this->wakeup_fd, .events = POLLIN, .revents = 0}}};
+            if(poll(fds.data(), fds.size(), -1) < 0) {
+                if(errno == EINTR) continue;
+                debugLog("DirectoryWatcher: poll failed: {}", strerror(errno));
+                break;
+            }
+
+            if(fds[1].revents & POLLIN) {
+                u64 count;
+                (void)!read(this->wakeup_fd, &count, sizeof(count));
+            }
+
+            if(fds[0].revents & POLLIN) {
+                ssize_t len;
+                while((len = read(this->inotify_fd, buffer.data(), buffer.size())) > 0) {
+                    for(ssize_t offset = 0; offset < len;) {
+                        const auto* ev = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                        this->handle_event(*ev);
+                        offset += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+                    }
+                }
+            }
+
+            if(!this->new_events.empty()) {
+                Sync::scoped_lock lock(this->finished_events_mtx);
+                std::ranges::move(this->new_events, std::back_inserter(this->finished_events));
+                this->finished_events_count.store(this->finished_events.size(), std::memory_order_release);
+                this->new_events.clear();
+            }
+        }
+    }
 #else
    private:
     // Generic implementation (polling)
@@ -403,6 +693,7 @@ struct DirWatcherImpl {
 
         // The downside is that this doesn't work recursively, so we can't
         // just monitor the entire Skins/ and Songs/ directories.
+        // (recursive watches are only supported by the native backends, only the top level is checked here)
 
         static auto getFileTimes = [](const std::string& dir_path) -> Hash::stable_stringmap<fs::file_time_type> {
             Hash::stable_stringmap<fs::file_time_type> files;
@@ -429,7 +720,7 @@ struct DirWatcherImpl {
             // Add/remove directories
             {
                 Sync::scoped_lock lock(this->directories_mtx);
-                for(auto& [path, cb] : this->directories_to_add) {
+                for(auto& [path, cb, recursive] : this->directories_to_add) {
                     // Don't add if it's going to be removed
                     if(std::ranges::contains(this->directories_to_remove, path)) continue;
                     if(!path.ends_with('/')) path.push_back('/');
@@ -531,8 +822,8 @@ DirectoryWatcher::DirectoryWatcher() : pImpl() {}
 
 DirectoryWatcher::~DirectoryWatcher() = default;
 
-void DirectoryWatcher::watch_directory(std::string path, FileChangeCallback cb) {
-    return pImpl->watch_directory(std::move(path), std::move(cb));
+void DirectoryWatcher::watch_directory(std::string path, FileChangeCallback cb, bool recursive) {
+    return pImpl->watch_directory(std::move(path), std::move(cb), recursive);
 }
 
 void DirectoryWatcher::stop_watching(std::string path) { return pImpl->stop_watching(std::move(path)); }
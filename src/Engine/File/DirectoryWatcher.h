@@ -12,6 +12,7 @@ enum class FileChangeType : u8 {
     CREATED,
     MODIFIED,
     DELETED,
+    RESCAN,  // changes were lost (event queue overflow), path is the watched directory which should be rescanned
 };
 
 struct FileChangeEvent {
@@ -33,7 +34,8 @@ class DirectoryWatcher {
     DirectoryWatcher();
     ~DirectoryWatcher();
 
-    void watch_directory(std::string path, FileChangeCallback cb);
+    // recursive watches also report changes in subdirectories (only on Windows and Linux, otherwise top level only)
+    void watch_directory(std::string path, FileChangeCallback cb, bool recursive = false);
     void stop_watching(std::string path);
 
    private:
@@ -43,7 +45,7 @@ class DirectoryWatcher {
     // to avoid race condition issues.
     void update();
 
-    StaticPImpl<DirWatcherImpl, 256> pImpl;
+    StaticPImpl<DirWatcherImpl, 512> pImpl;
 };
 
 extern std::unique_ptr<DirectoryWatcher> directoryWatcher;
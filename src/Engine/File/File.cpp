@@ -25,6 +25,15 @@
 #include <vector>
 #include <cstdio>
 
+#ifdef MCENGINE_PLATFORM_WINDOWS
+#include <io.h>
+#include "WinDebloatDefs.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 namespace chrono = std::chrono;
 
@@ -584,6 +593,56 @@ int File::stat_c(const char *__restrict utf8filename, struct stat64 *__restrict
 #endif
 }
 
+bool File::flushToDisk(FILE *file) {
+    if(fflush(file) != 0) return false;
+#ifdef MCENGINE_PLATFORM_WINDOWS
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool File::syncToDisk(std::string_view utf8path) {
+    FILE *file = fopen_c(std::string{utf8path}.c_str(), "r+b");
+    if(file == nullptr) return false;
+
+    const bool success = flushToDisk(file);
+    fclose(file);
+    return success;
+}
+
+bool File::replaceFile(std::string_view fromPath, std::string_view toPath, std::error_code &ec) {
+    ec.clear();
+#ifdef MCENGINE_PLATFORM_WINDOWS
+    // rename() can't replace an existing file on Windows
+    if(!MoveFileExW(getFsPath(fromPath).c_str(), getFsPath(toPath).c_str(),
+                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        ec.assign((int)GetLastError(), std::system_category());
+    }
+#else
+    fs::rename(getFsPath(fromPath), getFsPath(toPath), ec);
+#endif
+    return !ec;
+}
+
+bool File::syncParentDirectory(std::string_view utf8path) {
+#ifdef MCENGINE_PLATFORM_WINDOWS
+    // directories can't be synced on Windows, MOVEFILE_WRITE_THROUGH already covers renames
+    (void)utf8path;
+    return true;
+#else
+    fs::path dir = getFsPath(utf8path).parent_path();
+    if(dir.empty()) dir = ".";
+
+    const int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if(fd < 0) return false;
+
+    const bool success = fsync(fd) == 0;
+    close(fd);
+    return success;
+#endif
+}
+
 bool File::copy(std::string_view fromPath, std::string_view toPath) {
     if(fromPath.empty() || toPath.empty() || fromPath == toPath) {
         return false;
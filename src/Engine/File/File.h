@@ -17,6 +17,7 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <system_error>
 #include <vector>
 #include <sys/stat.h>
 
@@ -95,6 +96,18 @@ class File {
     // passthrough to "_wstat64" on Windows, "stat64" otherwise
     [[nodiscard]] static int stat_c(const char *__restrict utf8filename, struct stat64 *__restrict buffer);
 
+    // flushes and syncs an open file to disk ("_commit" on Windows, "fsync" otherwise)
+    [[nodiscard]] static bool flushToDisk(FILE *file);
+
+    // syncs an already written file to disk
+    [[nodiscard]] static bool syncToDisk(std::string_view utf8path);
+
+    // atomically replaces toPath with fromPath ("MoveFileExW" with write-through on Windows, "rename" otherwise)
+    [[nodiscard]] static bool replaceFile(std::string_view fromPath, std::string_view toPath, std::error_code &ec);
+
+    // syncs the directory containing utf8path, so that a rename into it survives a crash (no-op on Windows)
+    [[nodiscard]] static bool syncParentDirectory(std::string_view utf8path);
+
     // copy file from source to destination, overwriting if exists
     [[nodiscard]] static bool copy(std::string_view fromPath, std::string_view toPath);
 
@@ -0,0 +1,129 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "MappedFile.h"
+
+#include "File.h"
+#include "Logging.h"
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include "WinDebloatDefs.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(std::string_view path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(File::getFsPath(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        this->error_msg = "Failed to open file: " + std::system_category().message((int)GetLastError());
+        return;
+    }
+
+    LARGE_INTEGER file_size{};
+    if(!GetFileSizeEx(file, &file_size)) {
+        this->error_msg = "Failed to get file size: " + std::system_category().message((int)GetLastError());
+        CloseHandle(file);
+        return;
+    }
+
+    if(file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    // the mapping keeps its own reference to the file
+    HANDLE mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if(mapping_handle == nullptr) {
+        debugLog("Failed to map '{:s}', reading it instead: {:s}", path,
+                 std::system_category().message((int)GetLastError()));
+        this->read_fallback(path);
+        return;
+    }
+
+    const void *view_ptr = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if(view_ptr == nullptr) {
+        debugLog("Failed to map '{:s}', reading it instead: {:s}", path,
+                 std::system_category().message((int)GetLastError()));
+        CloseHandle(mapping_handle);
+        this->read_fallback(path);
+        return;
+    }
+
+    this->mapping = mapping_handle;
+    this->view = static_cast<const u8 *>(view_ptr);
+    this->view_size = static_cast<uSz>(file_size.QuadPart);
+#else
+    const int fd = ::open(File::getFsPath(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        this->error_msg = "Failed to open file: " + std::generic_category().message(errno);
+        return;
+    }
+
+    struct stat st{};
+    if(::fstat(fd, &st) != 0) {
+        this->error_msg = "Failed to get file size: " + std::generic_category().message(errno);
+        ::close(fd);
+        return;
+    }
+
+    if(st.st_size <= 0) {
+        ::close(fd);
+        return;
+    }
+
+    // the mapping stays valid after closing the descriptor
+    void *view_ptr = ::mmap(nullptr, static_cast<uSz>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(view_ptr == MAP_FAILED) {
+        debugLog("Failed to map '{:s}', reading it instead: {:s}", path, std::generic_category().message(errno));
+        this->read_fallback(path);
+        return;
+    }
+
+    this->mapping = view_ptr;
+    this->view = static_cast<const u8 *>(view_ptr);
+    this->view_size = static_cast<uSz>(st.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if(this->mapping == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(this->view);
+    CloseHandle(static_cast<HANDLE>(this->mapping));
+#else
+    ::munmap(this->mapping, this->view_size);
+#endif
+}
+
+void MappedFile::read_fallback(std::string_view path) {
+    std::ifstream file(File::getFsPath(path), std::ios::binary | std::ios::ate);
+    if(!file.is_open()) {
+        this->error_msg = "Failed to open file: " + std::generic_category().message(errno);
+        return;
+    }
+
+    const auto file_size = static_cast<uSz>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    this->fallback = std::make_unique_for_overwrite<u8[]>(file_size);
+    file.read(reinterpret_cast<char *>(this->fallback.get()), static_cast<std::streamsize>(file_size));
+    if(static_cast<uSz>(file.gcount()) != file_size) {
+        this->error_msg = "Failed to read file: " + std::generic_category().message(errno);
+        this->fallback.reset();
+        return;
+    }
+
+    this->view = this->fallback.get();
+    this->view_size = file_size;
+}
@@ -0,0 +1,38 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+
+#include "noinclude.h"
+#include "types.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only view of a whole file, memory-mapped where possible (read into memory otherwise).
+// Keep the lifetime short: on Windows, the file can't be replaced while it's mapped.
+class MappedFile {
+    NOCOPY_NOMOVE(MappedFile)
+   public:
+    MappedFile() = delete;
+    MappedFile(std::string_view path);
+    ~MappedFile();
+
+    [[nodiscard]] constexpr bool good() const { return this->error_msg.empty(); }
+    [[nodiscard]] constexpr std::string_view error() const { return this->error_msg; }
+
+    // nullptr for empty files
+    [[nodiscard]] constexpr const u8 *data() const { return this->view; }
+    [[nodiscard]] constexpr uSz size() const { return this->view_size; }
+
+   private:
+    void read_fallback(std::string_view path);
+
+    const u8 *view{nullptr};
+    uSz view_size{0};
+
+    // platform mapping handle(s), unused with the fallback
+    void *mapping{nullptr};
+    std::unique_ptr<u8[]> fallback;
+
+    std::string error_msg;
+};
@@ -0,0 +1,97 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "FrameTimeHistogram.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+u32 FrameTimeHistogram::bucketIndex(u64 us) {
+    us = std::min(us, MAX_US);
+    if(us < SUB_BUCKETS * 2) return (u32)us;
+
+    const u32 shift = (u32)std::bit_width(us) - (SUB_BUCKET_BITS + 1);
+    return (SUB_BUCKETS * 2) + ((shift - 1) * SUB_BUCKETS) + (u32)((us >> shift) - SUB_BUCKETS);
+}
+
+u64 FrameTimeHistogram::bucketLow(u32 index) {
+    if(index < SUB_BUCKETS * 2) return index;
+
+    const u32 shift = ((index - (SUB_BUCKETS * 2)) / SUB_BUCKETS) + 1;
+    const u64 sub = ((index - (SUB_BUCKETS * 2)) % SUB_BUCKETS) + SUB_BUCKETS;
+    return sub << shift;
+}
+
+u64 FrameTimeHistogram::bucketHigh(u32 index) {
+    if(index < SUB_BUCKETS * 2) return index;
+
+    const u32 shift = ((index - (SUB_BUCKETS * 2)) / SUB_BUCKETS) + 1;
+    return bucketLow(index) + (1ull << shift) - 1;
+}
+
+void FrameTimeHistogram::record(u64 us) {
+    u32 &bucket = this->buckets[bucketIndex(us)];
+    if(bucket == UINT32_MAX) return;  // saturated, would take ~800 days at 60fps
+
+    bucket++;
+    this->iCount++;
+    this->iSum += us;
+    this->iMax = std::max(this->iMax, us);
+}
+
+void FrameTimeHistogram::reset() {
+    this->buckets.fill(0);
+    this->iCount = 0;
+    this->iSum = 0;
+    this->iMax = 0;
+}
+
+u64 FrameTimeHistogram::percentile(f64 p) const {
+    if(this->iCount == 0) return 0;
+
+    const u64 target =
+        std::clamp<u64>((u64)std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * (f64)this->iCount), 1, this->iCount);
+
+    u64 seen = 0;
+    for(u32 i = 0; i < NUM_BUCKETS; i++) {
+        seen += this->buckets[i];
+        if(seen >= target) return std::min(bucketHigh(i), this->iMax);
+    }
+    return this->iMax;
+}
+
+void FrameTimeStats::reset() {
+    this->frame.reset();
+    this->update.reset();
+    this->draw.reset();
+    this->inputToPresent.reset();
+}
+
+std::string FrameTimeStats::summary(std::string_view separator) const {
+    const auto line = [](std::string_view name, const FrameTimeHistogram &h) {
+        return fmt::format("{}: p50 {:.2f}ms, p99 {:.2f}ms, p99.9 {:.2f}ms, max {:.2f}ms ({} samples)", name,
+                           (f64)h.percentile(50.0) / 1000.0, (f64)h.percentile(99.0) / 1000.0,
+                           (f64)h.percentile(99.9) / 1000.0, (f64)h.max() / 1000.0, h.count());
+    };
+
+    return fmt::format("{}{}{}{}{}{}{}", line("Frame", this->frame), separator, line("Update", this->update), separator,
+                       line("Draw", this->draw), separator, line("Input to present", this->inputToPresent));
+}
+
+std::string FrameTimeStats::toCsv() const {
+    std::string out = "bucket_low_us,bucket_high_us,frame,update,draw,input_to_present\n";
+
+    for(u32 i = 0; i < FrameTimeHistogram::NUM_BUCKETS; i++) {
+        const u32 f = this->frame.getBuckets()[i];
+        const u32 u = this->update.getBuckets()[i];
+        const u32 d = this->draw.getBuckets()[i];
+        const u32 l = this->inputToPresent.getBuckets()[i];
+        if((f | u | d | l) == 0) continue;
+
+        out += fmt::format("{},{},{},{},{},{}\n", FrameTimeHistogram::bucketLow(i), FrameTimeHistogram::bucketHigh(i),
+                           f, u, d, l);
+    }
+
+    return out;
+}
@@ -0,0 +1,59 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+
+// constant-memory log-linear histogram (like HdrHistogram), in microseconds
+// every power of two is split into 32 linear sub-buckets, so percentiles are within ~3% of the recorded values
+// values up to 64us are exact, anything above ~2 minutes is clamped
+class FrameTimeHistogram {
+   public:
+    static constexpr u32 SUB_BUCKET_BITS = 5;
+    static constexpr u32 SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr u32 MAX_SHIFT = 21;
+    static constexpr u32 NUM_BUCKETS = (SUB_BUCKETS * 2) + (MAX_SHIFT * SUB_BUCKETS);
+    static constexpr u64 MAX_US = ((u64)SUB_BUCKETS * 2 << MAX_SHIFT) - 1;
+
+    void record(u64 us);
+    void reset();
+
+    // highest value in the bucket which contains the p-th percentile (p in [0, 100])
+    [[nodiscard]] u64 percentile(f64 p) const;
+
+    [[nodiscard]] inline u64 count() const { return this->iCount; }
+    [[nodiscard]] inline u64 max() const { return this->iMax; }
+    [[nodiscard]] inline f64 mean() const { return this->iCount > 0 ? (f64)this->iSum / (f64)this->iCount : 0.0; }
+
+    // inclusive value range of a bucket
+    [[nodiscard]] static u32 bucketIndex(u64 us);
+    [[nodiscard]] static u64 bucketLow(u32 index);
+    [[nodiscard]] static u64 bucketHigh(u32 index);
+
+    [[nodiscard]] inline const std::array<u32, NUM_BUCKETS> &getBuckets() const { return this->buckets; }
+
+   private:
+    std::array<u32, NUM_BUCKETS> buckets{};
+    u64 iCount{0};
+    u64 iSum{0};
+    u64 iMax{0};
+};
+
+// everything the engine measures per frame
+// reset by the app whenever it wants to start a new measurement window (e.g. when a map starts)
+struct FrameTimeStats {
+    FrameTimeHistogram frame;           // time between two Engine::onUpdate() calls, includes the fps limiter
+    FrameTimeHistogram update;          // Engine::onUpdate()
+    FrameTimeHistogram draw;            // Engine::onPaint(), including the buffer swap
+    FrameTimeHistogram inputToPresent;  // oldest unhandled key/button press until the end of the next present
+
+    void reset();
+
+    // one "name: p50 p99 p99.9 max" line per histogram
+    [[nodiscard]] std::string summary(std::string_view separator = "\n") const;
+
+    // per-bucket counts of every histogram, as csv
+    [[nodiscard]] std::string toCsv() const;
+};
@@ -1,10 +1,23 @@
 // Copyright (c) 2020, PG, All rights reserved.
 #include "Profiler.h"
 
+#include "AsyncIOHandler.h"
+#include "ConVar.h"
 #include "Engine.h"
+#include "Graphics.h"
+#include "Logging.h"
+#include "SyncMutex.h"
+#include "Thread.h"
 #include "Timing.h"
 #include "UString.h"
 
+#include "fmt/chrono.h"
+
+#include <array>
+#include <ctime>
+#include <memory>
+#include <vector>
+
 ProfilerProfile g_profCurrentProfile(true);
 
 // weird extra namespace here due to msvc linkage issues for callback in ConVarDefs.h
@@ -19,6 +32,215 @@ void vprofToggleCB(float newValue) {
             g_profCurrentProfile.stop();
     }
 }
+
+namespace Trace {
+std::atomic<bool> g_bCapturing{false};
+
+namespace {  // static namespace
+
+// per thread, so 1 MB each
+constexpr uSz RING_SIZE = 1ULL << 16;
+
+struct Event {
+    // relaxed atomics, only so that reading a slot which is being overwritten isn't a data race
+    // (such slots are thrown away afterwards anyway)
+    std::atomic<const char *> name{nullptr};  // nullptr for end events
+    std::atomic<u64> timestampNS{0};
+};
+
+struct ThreadBuffer {
+    std::array<Event, RING_SIZE> events;
+    std::atomic<u64> head{0};  // total number of events ever written, only the owning thread writes
+
+    u32 tid{0};
+    std::string name;         // protected by s_registryMutex
+    bool bThreadExited{false};  // protected by s_registryMutex
+};
+
+Sync::mutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+u32 s_iNextTid{1};
+
+u64 s_iCaptureStartNS{0};
+
+// marks the buffer as reusable when its thread exits
+struct ThreadBufferHandle {
+    ThreadBuffer *buffer{nullptr};
+
+    ~ThreadBufferHandle() {
+        if(this->buffer == nullptr) return;
+        Sync::scoped_lock lock(s_registryMutex);
+        this->buffer->bThreadExited = true;
+    }
+};
+thread_local ThreadBufferHandle t_buffer;
+
+ThreadBuffer *getThreadBuffer() noexcept {
+    if(t_buffer.buffer != nullptr) return t_buffer.buffer;
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->name = McThread::is_main_thread() ? "main" : McThread::get_current_thread_name();
+
+    Sync::scoped_lock lock(s_registryMutex);
+    buffer->tid = s_iNextTid++;
+    t_buffer.buffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return t_buffer.buffer;
+}
+
+forceinline void pushEvent(const char *name) noexcept {
+    ThreadBuffer *buffer = getThreadBuffer();
+    const u64 index = buffer->head.load(std::memory_order_relaxed);
+    Event &event = buffer->events[index & (RING_SIZE - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.timestampNS.store(Timing::getTicksNS(), std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void appendJsonString(std::string &out, std::string_view str) {
+    out.push_back('"');
+    for(const char c : str) {
+        if(c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if(static_cast<u8>(c) < 0x20) {
+            out.append(fmt::format("\\u{:04x}", static_cast<int>(c)));
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+void startCapture() {
+    {
+        Sync::scoped_lock lock(s_registryMutex);
+
+        // threads which are gone can't be writing anymore
+        std::erase_if(s_buffers, [](const auto &buffer) { return buffer->bThreadExited; });
+
+        // events from before this capture are filtered out by their timestamp, no need to clear anything
+        s_iCaptureStartNS = Timing::getTicksNS();
+    }
+    g_bCapturing.store(true, std::memory_order_release);
+
+    debugLog("Started trace capture ({:.1f} seconds, stop early with vprof_trace 0)",
+             cv::vprof_trace_seconds.getFloat());
+}
+
+void stopCapture() {
+    g_bCapturing.store(false, std::memory_order_release);
+
+    const u64 captureEndNS = Timing::getTicksNS();
+
+    std::string json;
+    json.reserve(1024ULL * 1024);
+    json.append(R"({"displayTimeUnit":"ms","traceEvents":[)");
+
+    uSz numEvents = 0;
+    const auto appendEvent = [&](std::string_view fields) {
+        if(numEvents++ > 0) json.push_back(',');
+        json.append(fields);
+    };
+
+    {
+        Sync::scoped_lock lock(s_registryMutex);
+        for(const auto &buffer : s_buffers) {
+            // copy out whatever is still in the ring
+            // a thread which hasn't noticed the end of the capture yet can still be overwriting the oldest slots,
+            // so anything older than RING_SIZE events before the head *after* copying is dropped
+            const u64 headBefore = buffer->head.load(std::memory_order_acquire);
+            const u64 first = headBefore > RING_SIZE ? headBefore - RING_SIZE : 0;
+
+            std::vector<std::pair<const char *, u64>> events;
+            events.reserve(headBefore - first);
+            for(u64 i = first; i < headBefore; i++) {
+                const Event &event = buffer->events[i & (RING_SIZE - 1)];
+                events.emplace_back(event.name.load(std::memory_order_relaxed),
+                                    event.timestampNS.load(std::memory_order_relaxed));
+            }
+
+            const u64 headAfter = buffer->head.load(std::memory_order_acquire);
+            const u64 firstValid = headAfter > RING_SIZE ? headAfter - RING_SIZE : 0;
+            const uSz numOverwritten = firstValid > first ? std::min<uSz>(firstValid - first, events.size()) : 0;
+
+            appendEvent(fmt::format(R"({{"ph":"M","name":"thread_name","pid":1,"tid":{:d},"args":{{"name":)",
+                                    buffer->tid));
+            appendJsonString(json, buffer->name);
+            json.append("}}");
+            appendEvent(fmt::format(
+                R"({{"ph":"M","name":"thread_sort_index","pid":1,"tid":{:d},"args":{{"sort_index":{:d}}}}})",
+                buffer->tid, buffer->tid));
+
+            // end events without a begin (scopes entered before the capture, or lost to the ring wrapping around)
+            // would confuse the viewers, so they're skipped
+            u32 depth = 0;
+            for(uSz i = numOverwritten; i < events.size(); i++) {
+                const auto &[name, timestampNS] = events[i];
+                if(timestampNS < s_iCaptureStartNS || timestampNS > captureEndNS) continue;
+
+                const f64 timestampUS = static_cast<f64>(timestampNS - s_iCaptureStartNS) / 1000.0;
+                if(name != nullptr) {
+                    depth++;
+                    appendEvent(fmt::format(R"({{"ph":"B","pid":1,"tid":{:d},"ts":{:.3f},"name":)", buffer->tid,
+                                            timestampUS));
+                    appendJsonString(json, name);
+                    json.push_back('}');
+                } else if(depth > 0) {
+                    depth--;
+                    appendEvent(fmt::format(R"({{"ph":"E","pid":1,"tid":{:d},"ts":{:.3f}}})", buffer->tid,
+                                            timestampUS));
+                }
+            }
+        }
+    }
+
+    json.append("]}");
+
+    const std::string path =
+        fmt::format(MCENGINE_DATA_DIR "vprof_trace_{:%F-%H-%M-%S}.json", fmt::gmtime(std::time(nullptr)));
+    debugLog("Writing {:d} trace events to {:s}", numEvents, path);
+    io->write(path, std::move(json), [path](bool success) {
+        if(success) {
+            debugLog("Trace written to {:s}, open it with ui.perfetto.dev or chrome://tracing", path);
+        } else {
+            debugLog("Failed to write {:s}", path);
+        }
+    });
+}
+
+}  // namespace
+
+void beginEvent(const char *name) noexcept { pushEvent(name); }
+void endEvent() noexcept { pushEvent(nullptr); }
+
+void onCurrentThreadNamed(const char *name) {
+    if(t_buffer.buffer == nullptr) return;  // picked up when the buffer gets created
+
+    Sync::scoped_lock lock(s_registryMutex);
+    t_buffer.buffer->name = name;
+}
+
+void update() {
+    if(!g_bCapturing.load(std::memory_order_relaxed)) return;
+
+    const f64 elapsed =
+        static_cast<f64>(Timing::getTicksNS() - s_iCaptureStartNS) / static_cast<f64>(Timing::NS_PER_SECOND);
+    if(elapsed >= cv::vprof_trace_seconds.getFloat()) {
+        cv::vprof_trace.setValue(false);  // stops the capture via the callback
+    }
+}
+}  // namespace Trace
+
+void vprofTraceToggleCB(float newValue) {
+    const bool enable = !!static_cast<int>(newValue);
+    if(enable == Trace::g_bCapturing.load(std::memory_order_relaxed)) return;
+
+    if(enable)
+        Trace::startCapture();
+    else
+        Trace::stopCapture();
+}
 }  // namespace Profiling
 
 ProfilerProfile::ProfilerProfile(bool manualStartViaMain) : root("Root", VPROF_BUDGETGROUP_ROOT, nullptr) {
@@ -114,12 +336,17 @@ void ProfilerNode::constructor(const char *name, const char *group, ProfilerNode
     this->fTimeCurrentFrame = 0.0;
     this->fTimeLastFrame = 0.0;
 
+    this->statsEnter = {};
+    this->statsCurrentFrame = {};
+    this->statsLastFrame = {};
+
     this->iGroupID = (s_iNodeCounter++ > 0 ? g_profCurrentProfile.groupNameToID(group) : 0);
 }
 
 void ProfilerNode::enterScope() {
     if(this->iNumRecursions++ == 0) {
         this->fTime = Timing::getTimeReal();
+        if(g) this->statsEnter = g->getDrawStatsTotal();
     }
 }
 
@@ -127,6 +354,7 @@ bool ProfilerNode::exitScope() {
     if(--this->iNumRecursions == 0) {
         this->fTime = Timing::getTimeReal() - this->fTime;
         this->fTimeCurrentFrame = this->fTime;
+        if(g) this->statsCurrentFrame = g->getDrawStatsTotal() - this->statsEnter;
     }
 
     return (this->iNumRecursions == 0);
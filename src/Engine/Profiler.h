@@ -1,5 +1,9 @@
 #pragma once
 // Copyright (c) 2020, PG, All rights reserved.
+#include "DrawStats.h"
+
+#include <atomic>
+
 #define VPROF_MAIN()                 \
     g_profCurrentProfile.mainprof(); \
     VPROF("Main")
@@ -9,6 +13,9 @@
 
 #define VPROF_BUDGET(name, group) VPROF_(name, group)
 
+// only shows up in vprof_trace captures, but can be used on any thread (the regular VPROF scopes are main thread only)
+#define VPROF_TRACE(name) Profiling::TraceScope Prof_(name);
+
 #define VPROF_SCOPE_BEGIN(name) \
     do {                        \
     VPROF(name)
@@ -16,8 +23,9 @@
     }                     \
     while(0)
 
-#define VPROF_ENTER_SCOPE(name, group) g_profCurrentProfile.enterScope(name, group)
-#define VPROF_EXIT_SCOPE() g_profCurrentProfile.exitScope()
+#define VPROF_ENTER_SCOPE(name, group) \
+    (g_profCurrentProfile.enterScope(name, group), Profiling::Trace::begin(name))
+#define VPROF_EXIT_SCOPE() (Profiling::Trace::end(), g_profCurrentProfile.exitScope())
 
 #define VPROF_BUDGETGROUP_ROOT "Root"
 #define VPROF_BUDGETGROUP_SLEEP "Sleep"
@@ -71,7 +79,37 @@
 
 namespace Profiling {
 void vprofToggleCB(float newValue);
+void vprofTraceToggleCB(float newValue);
+
+// scope begin/end events for chrome://tracing or ui.perfetto.dev, from every thread
+// each thread writes into its own ring buffer without locking, they are only read once the capture is over
+namespace Trace {
+extern std::atomic<bool> g_bCapturing;
+
+void beginEvent(const char *name) noexcept;
+void endEvent() noexcept;
+
+// NOTE: name must outlive the capture (string literal)
+inline void begin(const char *name) noexcept {
+    if(g_bCapturing.load(std::memory_order_relaxed)) beginEvent(name);
 }
+inline void end() noexcept {
+    if(g_bCapturing.load(std::memory_order_relaxed)) endEvent();
+}
+
+// called by McThread::set_current_thread_name
+void onCurrentThreadNamed(const char *name);
+
+// main thread, once per frame: stops the capture and writes it out once vprof_trace_seconds have passed
+void update();
+}  // namespace Trace
+
+class TraceScope {
+   public:
+    inline TraceScope(const char *name) { Trace::begin(name); }
+    inline ~TraceScope() { Trace::end(); }
+};
+}  // namespace Profiling
 
 class ProfilerNode {
     friend class ProfilerProfile;
@@ -95,6 +133,9 @@ class ProfilerNode {
     }  // NOTE: this is incomplete if retrieved within engine update(), use getTimeLastFrame() instead
     [[nodiscard]] inline double getTimeLastFrame() const { return this->fTimeLastFrame; }
 
+    // render counters accumulated while this scope was active (including children)
+    [[nodiscard]] inline const DrawStats &getDrawStatsLastFrame() const { return this->statsLastFrame; }
+
    private:
     void constructor(const char *name, const char *group, ProfilerNode *parent);
 
@@ -113,6 +154,10 @@ class ProfilerNode {
     double fTime;
     double fTimeCurrentFrame;
     double fTimeLastFrame;
+
+    DrawStats statsEnter;
+    DrawStats statsCurrentFrame;
+    DrawStats statsLastFrame;
 };
 
 class ProfilerProfile {
@@ -131,6 +176,7 @@ class ProfilerProfile {
         if(this->iEnabled > 0) {
             for(int i = 0; i < this->iNumNodes; i++) {
                 this->nodes[i].fTimeLastFrame = this->nodes[i].fTimeCurrentFrame;
+                this->nodes[i].statsLastFrame = this->nodes[i].statsCurrentFrame;
             }
         }
     }
@@ -212,6 +258,12 @@ extern ProfilerProfile g_profCurrentProfile;
 
 class ProfilerScope {
    public:
-    inline ProfilerScope(const char *name, const char *group) { g_profCurrentProfile.enterScope(name, group); }
-    inline ~ProfilerScope() { g_profCurrentProfile.exitScope(); }
+    inline ProfilerScope(const char *name, const char *group) {
+        g_profCurrentProfile.enterScope(name, group);
+        Profiling::Trace::begin(name);
+    }
+    inline ~ProfilerScope() {
+        Profiling::Trace::end();
+        g_profCurrentProfile.exitScope();
+    }
 };
@@ -130,6 +130,7 @@ void DirectX11Image::init() {
 
             if(fullImage) {
                 context->UpdateSubresource(this->texture, 0, nullptr, this->rawImage.get(), srcRowPitch, 0);
+                g->countUpload((u64)srcRowPitch * this->iHeight);
             } else {
                 for(const auto& rect : dirtyRects) {
                     D3D11_BOX box;
@@ -143,6 +144,7 @@ void DirectX11Image::init() {
                     const u8* src = this->rawImage.get() +
                                     ((i64)rect.getMinY() * this->iWidth + rect.getMinX()) * Image::NUM_CHANNELS;
                     context->UpdateSubresource(this->texture, 0, &box, src, srcRowPitch, 0);
+                    g->countUpload((u64)rect.getWidth() * rect.getHeight() * Image::NUM_CHANNELS);
                 }
             }
 
@@ -271,6 +273,8 @@ void DirectX11Image::deleteDX() {
 void DirectX11Image::bind(unsigned int textureUnit) const {
     if(!this->isReady()) return;
 
+    g->countTextureBind();
+
     this->iTextureUnitBackup = textureUnit;
 
     auto* dx11 = static_cast<DirectX11Interface*>(g.get());
@@ -1513,6 +1513,8 @@ void DirectX11Interface::uploadAndDrawVertexBatch(D3D_PRIMITIVE_TOPOLOGY topolog
 
             this->deviceContext->Draw(batchSize, numVertexOffset);
             this->iStatsNumDrawCalls++;
+            this->countDrawCall(batchSize);
+            this->countUpload(sizeof(SimpleVertex) * batchSize);
         }
 
         verticesRemaining -= batchSize;
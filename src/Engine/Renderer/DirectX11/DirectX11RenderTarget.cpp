@@ -229,6 +229,8 @@ void DirectX11RenderTarget::drawRect(int x, int y, int width, int height) {
 void DirectX11RenderTarget::enable() {
     if(!this->isReady()) return;
 
+    g->countRenderTargetSwitch();
+
     auto* context = static_cast<DirectX11Interface*>(g.get())->getDeviceContext();
 
     // backup
@@ -255,6 +257,8 @@ void DirectX11RenderTarget::enable() {
 void DirectX11RenderTarget::disable() {
     if(!this->isReady()) return;
 
+    g->countRenderTargetSwitch();
+
     // restore
     // HACKHACK: slow af
     {
@@ -279,6 +283,8 @@ void DirectX11RenderTarget::disable() {
 void DirectX11RenderTarget::bind(unsigned int textureUnit) {
     if(!this->isReady()) return;
 
+    g->countTextureBind();
+
     auto* dx11 = static_cast<DirectX11Interface*>(g.get());
     auto* context = dx11->getDeviceContext();
 
@@ -292,6 +292,8 @@ void DirectX11Shader::enable() {
     auto *dx11 = static_cast<DirectX11Interface *>(g.get());
     if(!this->isReady() || dx11->getActiveShader() == this) return;
 
+    dx11->countShaderSwitch();
+
     auto *context = dx11->getDeviceContext();
 
     // backup
@@ -320,6 +322,8 @@ void DirectX11Shader::disable() {
     auto *dx11 = static_cast<DirectX11Interface *>(g.get());
     if(!this->isReady() || dx11->getActiveShader() != this || !this->bStateBackedUp) return;
 
+    dx11->countShaderSwitch();
+
     auto *context = dx11->getDeviceContext();
 
     // restore
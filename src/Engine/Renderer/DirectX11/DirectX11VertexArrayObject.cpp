@@ -297,6 +297,7 @@ void DirectX11VertexArrayObject::draw() {
         context->IASetVertexBuffers(0, 1, &this->vertexBuffer, &stride, &offset);
         context->IASetPrimitiveTopology((D3D_PRIMITIVE_TOPOLOGY)primitiveToDirectX(this->convertedPrimitive));
         context->Draw(end - start, start);
+        g->countDrawCall(end - start);
     }
 }
 
@@ -0,0 +1,33 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+
+// render counters, incremented by the graphics backends
+// Graphics keeps running totals, per-frame or per-scope numbers are the difference between two snapshots
+// (unsigned wraparound keeps the differences correct)
+struct DrawStats {
+    u32 draw_calls{0};              // anything submitted to the gpu, a batch counts once
+    u32 vertices{0};                // vertices submitted by those draw calls
+    u32 texture_binds{0};           // images and rendertargets bound for drawing
+    u32 shader_switches{0};         // shaders enabled/disabled
+    u32 render_target_switches{0};  // rendertargets enabled/disabled
+    u64 uploaded_bytes{0};          // texture and vertex buffer data sent to the gpu
+
+    u32 batched_quads{0};  // quads that went through the quad batch instead of being drawn one by one
+    u32 batched_text{0};   // drawString() passes merged into the quad batch (a text shadow is a separate pass)
+    u32 state_changes{0};  // texture/shader/blend/clip/... changes which flushed a pending batch
+
+    DrawStats operator-(const DrawStats &rhs) const {
+        return {
+            .draw_calls = this->draw_calls - rhs.draw_calls,
+            .vertices = this->vertices - rhs.vertices,
+            .texture_binds = this->texture_binds - rhs.texture_binds,
+            .shader_switches = this->shader_switches - rhs.shader_switches,
+            .render_target_switches = this->render_target_switches - rhs.render_target_switches,
+            .uploaded_bytes = this->uploaded_bytes - rhs.uploaded_bytes,
+            .batched_quads = this->batched_quads - rhs.batched_quads,
+            .batched_text = this->batched_text - rhs.batched_text,
+            .state_changes = this->state_changes - rhs.state_changes,
+        };
+    }
+};
@@ -10,6 +10,16 @@
 #include "Image.h"
 #include "Logging.h"
 
+#include <algorithm>
+#include <cstring>
+
+namespace {  // static namespace
+
+// quads per draw, before a batch is flushed even though nothing changed
+constexpr uSz MAX_BATCH_QUADS = 4096;
+
+}  // namespace
+
 void Graphics::takeScreenshot(ScreenshotParams params) { this->pendingScreenshots.push_back(std::move(params)); }
 
 void Graphics::processPendingScreenshot() {
@@ -246,6 +256,93 @@ void Graphics::updateTransform(bool force) {
     }
 }
 
+void Graphics::setBlending(bool enabled) {
+    if(enabled != this->bBlendingEnabled) this->flushBatch();
+    this->bBlendingEnabled = enabled;
+}
+
+void Graphics::setBlendMode(DrawBlendMode blendMode) {
+    if(blendMode != this->currentBlendMode) this->flushBatch();
+    this->currentBlendMode = blendMode;
+}
+
+void Graphics::prepareBatch(BatchTexture texture, Matrix4 &worldOut) {
+    // same as updateTransform(), without uploading anything
+    worldOut = this->worldTransformStack.back();
+    const Matrix4 *projection = &this->projectionTransformStack.back();
+    if(this->bIs3dScene) {
+        worldOut = this->scene3d_world_matrix * worldOut;
+        projection = &this->scene3d_projection_matrix;
+    }
+
+    if(!this->batchVertices.empty()) {
+        if(texture != this->batchTexture) {
+            this->flushBatch();
+        } else if(std::memcmp(projection->get(), this->batchProjection.get(), 16 * sizeof(float)) != 0) {
+            this->submitBatch();
+        }
+    }
+
+    if(this->batchVertices.empty()) {
+        this->batchVertices.reserve(MAX_BATCH_QUADS * 4);
+        this->batchTexture = texture;
+        this->batchProjection = *projection;
+    }
+}
+
+void Graphics::batchQuad(BatchTexture texture, const std::array<vec2, 4> &pos, const std::array<vec2, 4> &tex,
+                         const std::array<Color, 4> &col) {
+    Matrix4 world;
+    this->prepareBatch(texture, world);
+    if(this->batchVertices.size() >= MAX_BATCH_QUADS * 4) this->submitBatch();
+
+    for(int i = 0; i < 4; i++) {
+        this->batchVertices.push_back({.pos = world * vec3(pos[i].x, pos[i].y, 0.f), .tex = tex[i], .col = col[i]});
+    }
+    this->drawStats.batched_quads++;
+}
+
+void Graphics::batchQuads(BatchTexture texture, std::span<const vec3> verts, std::span<const vec2> texcoords,
+                          Color col) {
+    Matrix4 world;
+    this->prepareBatch(texture, world);
+
+    const uSz numVerts = std::min(verts.size(), texcoords.size()) / 4 * 4;
+    for(uSz i = 0; i < numVerts; i += 4) {
+        // texture and projection stay the same after submitting
+        if(this->batchVertices.size() >= MAX_BATCH_QUADS * 4) this->submitBatch();
+
+        for(uSz j = i; j < i + 4; j++) {
+            this->batchVertices.push_back({.pos = world * verts[j], .tex = texcoords[j], .col = col});
+        }
+    }
+    this->drawStats.batched_quads += numVerts / 4;
+}
+
+void Graphics::flushBatch() {
+    if(this->batchVertices.empty() || this->bSubmittingBatch) return;
+
+    this->drawStats.state_changes++;
+    this->submitBatch();
+}
+
+void Graphics::submitBatch() {
+    if(this->batchVertices.empty() || this->bSubmittingBatch) return;
+
+    // drawBatch() binding the texture would flush again otherwise
+    this->bSubmittingBatch = true;
+    this->drawBatch(this->batchTexture, this->batchVertices, this->batchProjection);
+    this->bSubmittingBatch = false;
+
+    this->countDrawCall(static_cast<u32>(this->batchVertices.size()));
+    this->batchVertices.clear();
+}
+
+void Graphics::finishDrawStatsFrame() {
+    this->lastDrawStats = this->drawStats - this->frameStartDrawStats;
+    this->frameStartDrawStats = this->drawStats;
+}
+
 void Graphics::checkStackLeaks() {
     if(this->worldTransformStack.size() > 1) {
         engine->showMessageErrorFatal("World Transform Stack Leak", "Make sure all push*() have a pop*()!");
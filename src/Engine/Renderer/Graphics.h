@@ -4,6 +4,7 @@
 #include "noinclude.h"
 #include "types.h"
 #include "Color.h"
+#include "DrawStats.h"
 #include "Matrices.h"
 #include "Rect.h"
 #include "Vectors.h"
@@ -15,6 +16,7 @@
 #include <array>
 #include <optional>
 #include <functional>
+#include <span>
 
 class ConVar;
 class UString;
@@ -205,9 +207,9 @@ class Graphics {
     virtual void setClipping(bool enabled) = 0;
     virtual void setAlphaTesting(bool enabled) = 0;
     virtual void setAlphaTestFunc(DrawCompareFunc alphaFunc, float ref) = 0;
-    virtual void setBlending(bool enabled) { this->bBlendingEnabled = enabled; }
+    virtual void setBlending(bool enabled);
     [[nodiscard]] inline bool getBlending() const { return this->bBlendingEnabled; }
-    virtual void setBlendMode(DrawBlendMode blendMode) { this->currentBlendMode = blendMode; }
+    virtual void setBlendMode(DrawBlendMode blendMode);
     [[nodiscard]] inline DrawBlendMode getBlendMode() const { return this->currentBlendMode; }
     virtual void setDepthBuffer(bool enabled) = 0;
     virtual void setColorWriting(bool r, bool g, bool b, bool a) = 0;
@@ -221,6 +223,38 @@ class Graphics {
     // renderer actions
     virtual void flush() = 0;
 
+    // draws all pending batched quads, must be called before anything changes state the batch depends on
+    // (bound textures, shaders, render targets, ...) outside of Graphics
+    void flushBatch();
+
+    // merges a string's glyph quads (4 vertices each, in drawing order) into the pending quad batch, with the current
+    // color and transform baked into the vertices
+    // returns false if the backend doesn't batch text, the font has to draw it by itself then
+    virtual bool batchText(const Image * /*atlas*/, std::span<const vec3> /*verts*/,
+                           std::span<const vec2> /*texcoords*/) {
+        return false;
+    }
+
+    // render counters, called by the backends (and their images/shaders/rendertargets/vaos)
+    inline void countDrawCall(u32 numVertices) {
+        this->drawStats.draw_calls++;
+        this->drawStats.vertices += numVertices;
+    }
+    inline void countTextureBind() { this->drawStats.texture_binds++; }
+    inline void countShaderSwitch() { this->drawStats.shader_switches++; }
+    inline void countRenderTargetSwitch() { this->drawStats.render_target_switches++; }
+    inline void countUpload(u64 numBytes) { this->drawStats.uploaded_bytes += numBytes; }
+
+    // stats of the last finished frame
+    [[nodiscard]] inline const DrawStats &getDrawStats() const { return this->lastDrawStats; }
+
+    // running totals since startup, e.g. for attributing counters to profiler scopes
+    [[nodiscard]] inline const DrawStats &getDrawStatsTotal() const { return this->drawStats; }
+
+    // gpu time of the last frame whose timer query finished (a few frames behind) in milliseconds,
+    // negative if the backend doesn't support timer queries
+    [[nodiscard]] inline f64 getGPUFrameTime() const { return this->fGPUFrameTimeMS; }
+
     // can be called any time
     void takeScreenshot(ScreenshotParams params);
     inline void takeScreenshot(std::string_view savePath) {
@@ -301,6 +335,52 @@ class Graphics {
     void processPendingScreenshot();
     std::vector<ScreenshotParams> pendingScreenshots;
 
+    // quad batching
+    // vertices are already transformed by the world matrix, so consecutive quads with different transforms can still be
+    // drawn together, as long as their texture and projection matrix are the same
+    struct BatchVertex {
+        vec3 pos;
+        vec2 tex;
+        Color col;
+    };
+
+    struct BatchTexture {
+        const Image *image{nullptr};  // nullptr + textured: whatever texture is currently bound
+        bool textured{false};
+
+        bool operator==(const BatchTexture &) const = default;
+    };
+
+    // the four corners' positions/texcoords/colors, in the order they're drawn in
+    void batchQuad(BatchTexture texture, const std::array<vec2, 4> &pos, const std::array<vec2, 4> &tex,
+                   const std::array<Color, 4> &col);
+
+    // same for many quads with the same color, 4 vertices each
+    void batchQuads(BatchTexture texture, std::span<const vec3> verts, std::span<const vec2> texcoords, Color col);
+
+    // draws the vertices as quads with the given texture and projection, and the identity world matrix
+    // the vertices may be modified, they are thrown away afterwards
+    virtual void drawBatch(BatchTexture /*texture*/, std::span<BatchVertex> /*vertices*/,
+                           const Matrix4 & /*projection*/) {}
+
+    // like flushBatch(), but doesn't count as a state change (for draws which can't be batched)
+    void submitBatch();
+
+    void finishDrawStatsFrame();  // called by the engine after every endScene()
+
+    // flushes if the texture or projection changed, returns the world matrix to transform the new vertices with
+    void prepareBatch(BatchTexture texture, Matrix4 &worldOut);
+
+    std::vector<BatchVertex> batchVertices;
+    Matrix4 batchProjection;
+    BatchTexture batchTexture;
+    bool bSubmittingBatch{false};
+
+    DrawStats drawStats;
+    DrawStats frameStartDrawStats;
+    DrawStats lastDrawStats;
+    f64 fGPUFrameTimeMS{-1.0};
+
     // transforms
     std::vector<Matrix4> worldTransformStack;
     std::vector<Matrix4> projectionTransformStack;
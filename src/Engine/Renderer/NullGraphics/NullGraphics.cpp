@@ -8,14 +8,18 @@
 #include "NullVertexArrayObject.h"
 
 #include "Font.h"
+#include "Image.h"
 #include "UString.h"
 
+// nothing is drawn, but batches/draw calls are still counted the same way as in the real backends
+// so that getDrawStats() can be checked without a gpu
+
 // scene
 void NullGraphics::beginScene() {}
-void NullGraphics::endScene() {}
+void NullGraphics::endScene() { this->submitBatch(); }
 
 // depth buffer
-void NullGraphics::clearDepthBuffer() {}
+void NullGraphics::clearDepthBuffer() { this->flushBatch(); }
 
 // color
 void NullGraphics::setColor(Color /*color*/) {}
@@ -23,61 +27,100 @@ void NullGraphics::setAlpha(float /*alpha*/) {}
 
 // 2d primitive drawing
 void NullGraphics::drawPixels(int /*x*/, int /*y*/, int /*width*/, int /*height*/, DrawPixelsType /*type*/,
-                              const void * /*pixels*/) {}
-void NullGraphics::drawPixel(int /*x*/, int /*y*/) {}
-void NullGraphics::drawLinef(float /*x1*/, float /*y1*/, float /*x2*/, float /*y2*/) {}
-void NullGraphics::drawRectf(const RectOptions & /*opt*/) {}
-void NullGraphics::fillRectf(float /*x*/, float /*y*/, float /*width*/, float /*height*/) {}
-void NullGraphics::fillRoundedRect(int /*x*/, int /*y*/, int /*width*/, int /*height*/, int /*radius*/) {}
+                              const void * /*pixels*/) {
+    this->drawUnbatched(0);
+}
+void NullGraphics::drawPixel(int /*x*/, int /*y*/) { this->drawUnbatched(1); }
+void NullGraphics::drawLinef(float /*x1*/, float /*y1*/, float /*x2*/, float /*y2*/) { this->drawUnbatched(2); }
+void NullGraphics::drawRectf(const RectOptions &opt) { this->drawUnbatched(opt.withColor ? 8 : 4); }
+void NullGraphics::fillRectf(float x, float y, float width, float height) {
+    this->batchQuad({.textured = false}, {vec2{x, y}, {x, y + height}, {x + width, y + height}, {x + width, y}}, {},
+                    {});
+}
+void NullGraphics::fillRoundedRect(int /*x*/, int /*y*/, int /*width*/, int /*height*/, int /*radius*/) {
+    this->drawUnbatched(4);
+}
 void NullGraphics::fillGradient(int /*x*/, int /*y*/, int /*width*/, int /*height*/, Color /*topLeftColor*/,
-                                Color /*topRightColor*/, Color /*bottomLeftColor*/, Color /*bottomRightColor*/) {}
+                                Color /*topRightColor*/, Color /*bottomLeftColor*/, Color /*bottomRightColor*/) {
+    this->drawUnbatched(4);
+}
 
-void NullGraphics::drawQuad(int /*x*/, int /*y*/, int /*width*/, int /*height*/) {}
-void NullGraphics::drawQuad(vec2 /*topLeft*/, vec2 /*topRight*/, vec2 /*bottomRight*/, vec2 /*bottomLeft*/,
-                            Color /*topLeftColor*/, Color /*topRightColor*/, Color /*bottomRightColor*/,
-                            Color /*bottomLeftColor*/) {}
+void NullGraphics::drawQuad(int x, int y, int width, int height) {
+    const auto fx = (f32)x, fy = (f32)y, fw = (f32)width, fh = (f32)height;
+    this->batchQuad({.textured = true}, {vec2{fx, fy}, {fx, fy + fh}, {fx + fw, fy + fh}, {fx + fw, fy}}, {}, {});
+}
+void NullGraphics::drawQuad(vec2 topLeft, vec2 topRight, vec2 bottomRight, vec2 bottomLeft, Color topLeftColor,
+                            Color topRightColor, Color bottomRightColor, Color bottomLeftColor) {
+    this->batchQuad({.textured = true}, {topLeft, bottomLeft, bottomRight, topRight}, {},
+                    {topLeftColor, bottomLeftColor, bottomRightColor, topRightColor});
+}
 
 // 2d resource drawing
-void NullGraphics::drawImage(const Image * /*image*/, AnchorPoint /*anchor*/, float /*edgeSoftness*/,
-                             McRect /*clipRect*/) {}
+void NullGraphics::drawImage(const Image *image, AnchorPoint /*anchor*/, float edgeSoftness, McRect /*clipRect*/) {
+    if(image == nullptr || !image->isReady()) return;
+
+    // smoothed edges need a shader
+    if(edgeSoftness > 0.0f) {
+        this->drawUnbatched(4);
+        return;
+    }
+
+    const f32 width = image->getWidth();
+    const f32 height = image->getHeight();
+    this->batchQuad({.image = image, .textured = true}, {vec2{0.f, 0.f}, {0.f, height}, {width, height}, {width, 0.f}},
+                    {}, {});
+}
 void NullGraphics::drawString(McFont *font, const UString &text, std::optional<TextShadow> shadow) {
     updateTransform();
 
     font->drawString(text, shadow);
 }
+bool NullGraphics::batchText(const Image *atlas, std::span<const vec3> verts, std::span<const vec2> texcoords) {
+    this->batchQuads({.image = atlas, .textured = true}, verts, texcoords, {});
+    this->drawStats.batched_text++;
+    return true;
+}
 
 // 3d type drawing
-void NullGraphics::drawVAO(VertexArrayObject * /*vao*/) {}
+void NullGraphics::drawVAO(VertexArrayObject *vao) {
+    if(vao == nullptr) return;
+    this->drawUnbatched(vao->getNumVertices());
+}
 
 // 2d clipping
-void NullGraphics::setClipRect(McRect /*clipRect*/) {}
-void NullGraphics::pushClipRect(McRect /*clipRect*/) {}
-void NullGraphics::popClipRect() {}
+void NullGraphics::setClipRect(McRect /*clipRect*/) { this->flushBatch(); }
+void NullGraphics::pushClipRect(McRect /*clipRect*/) { this->flushBatch(); }
+void NullGraphics::popClipRect() { this->flushBatch(); }
 
 // viewport
 void NullGraphics::pushViewport() {}
-void NullGraphics::setViewport(int /*x*/, int /*y*/, int /*width*/, int /*height*/) {}
-void NullGraphics::popViewport() {}
+void NullGraphics::setViewport(int /*x*/, int /*y*/, int /*width*/, int /*height*/) { this->flushBatch(); }
+void NullGraphics::popViewport() { this->flushBatch(); }
 
 // stencil buffer
-void NullGraphics::pushStencil() {}
-void NullGraphics::fillStencil(bool /*inside*/) {}
-void NullGraphics::popStencil() {}
+void NullGraphics::pushStencil() { this->flushBatch(); }
+void NullGraphics::fillStencil(bool /*inside*/) { this->flushBatch(); }
+void NullGraphics::popStencil() { this->flushBatch(); }
 
 // renderer settings
-void NullGraphics::setClipping(bool /*enabled*/) {}
-void NullGraphics::setAlphaTesting(bool /*enabled*/) {}
-void NullGraphics::setAlphaTestFunc(DrawCompareFunc /*alphaFunc*/, float /*ref*/) {}
-void NullGraphics::setDepthBuffer(bool /*enabled*/) {}
-void NullGraphics::setColorWriting(bool /*r*/, bool /*g*/, bool /*b*/, bool /*a*/) {}
-void NullGraphics::setColorInversion(bool /*enabled*/) {}
-void NullGraphics::setCulling(bool /*enabled*/) {}
+void NullGraphics::setClipping(bool /*enabled*/) { this->flushBatch(); }
+void NullGraphics::setAlphaTesting(bool /*enabled*/) { this->flushBatch(); }
+void NullGraphics::setAlphaTestFunc(DrawCompareFunc /*alphaFunc*/, float /*ref*/) { this->flushBatch(); }
+void NullGraphics::setDepthBuffer(bool /*enabled*/) { this->flushBatch(); }
+void NullGraphics::setColorWriting(bool /*r*/, bool /*g*/, bool /*b*/, bool /*a*/) { this->flushBatch(); }
+void NullGraphics::setColorInversion(bool /*enabled*/) { this->flushBatch(); }
+void NullGraphics::setCulling(bool /*enabled*/) { this->flushBatch(); }
 void NullGraphics::setVSync(bool /*enabled*/) {}
-void NullGraphics::setAntialiasing(bool /*enabled*/) {}
-void NullGraphics::setWireframe(bool /*enabled*/) {}
+void NullGraphics::setAntialiasing(bool /*enabled*/) { this->flushBatch(); }
+void NullGraphics::setWireframe(bool /*enabled*/) { this->flushBatch(); }
 
 // renderer actions
-void NullGraphics::flush() {}
+void NullGraphics::flush() { this->submitBatch(); }
+
+void NullGraphics::drawUnbatched(u32 numVertices) {
+    this->submitBatch();
+    this->countDrawCall(numVertices);
+}
 std::vector<u8> NullGraphics::getScreenshot(bool /*withAlpha*/) { return {}; }
 
 // renderer info
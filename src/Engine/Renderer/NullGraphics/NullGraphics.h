@@ -35,6 +35,7 @@ class NullGraphics : public Graphics {
     void drawImage(const Image *image, AnchorPoint anchor = AnchorPoint::CENTER, float edgeSoftness = 0.0f,
                    McRect clipRect = {}) final;
     void drawString(McFont *font, const UString &text, std::optional<TextShadow> shadow = std::nullopt) final;
+    bool batchText(const Image *atlas, std::span<const vec3> verts, std::span<const vec2> texcoords) override;
 
     // 3d type drawing
     void drawVAO(VertexArrayObject *vao) override;
@@ -93,4 +94,7 @@ class NullGraphics : public Graphics {
    protected:
     void onTransformUpdate() override;
     std::vector<u8> getScreenshot(bool withAlpha) override;
+
+   private:
+    void drawUnbatched(u32 numVertices);
 };
@@ -1,13 +1,18 @@
 
 #include "NullImage.h"
 
+#include "Graphics.h"
+
 // image that does CPU-side pixel loading but never uploads to GPU
 NullImage::NullImage(std::string filepath, bool mipmapped, bool keepInSystemMemory)
     : Image(std::move(filepath), mipmapped, keepInSystemMemory) {}
 NullImage::NullImage(i32 width, i32 height, bool mipmapped, bool keepInSystemMemory)
     : Image(width, height, mipmapped, keepInSystemMemory) {}
 
-void NullImage::bind(unsigned int /*textureUnit*/) const {}
+void NullImage::bind(unsigned int /*textureUnit*/) const {
+    g->flushBatch();
+    g->countTextureBind();
+}
 void NullImage::unbind() const {}
 
 void NullImage::init() {
@@ -1,12 +1,23 @@
 // Copyright (c) 2026, WH, All rights reserved.
 #include "NullRenderTarget.h"
 
+#include "Graphics.h"
+
 NullRenderTarget::NullRenderTarget(int x, int y, int width, int height, MultisampleType multiSampleType)
     : RenderTarget(x, y, width, height, multiSampleType) {}
 
-void NullRenderTarget::enable() {}
-void NullRenderTarget::disable() {}
-void NullRenderTarget::bind(unsigned int /*textureUnit*/) {}
+void NullRenderTarget::enable() {
+    g->flushBatch();
+    g->countRenderTargetSwitch();
+}
+void NullRenderTarget::disable() {
+    g->flushBatch();
+    g->countRenderTargetSwitch();
+}
+void NullRenderTarget::bind(unsigned int /*textureUnit*/) {
+    g->flushBatch();
+    g->countTextureBind();
+}
 void NullRenderTarget::unbind() {}
 
 void NullRenderTarget::init() { this->setReady(true); }
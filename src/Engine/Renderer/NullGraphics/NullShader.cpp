@@ -1,10 +1,18 @@
 // Copyright (c) 2026, WH, All rights reserved.
 #include "NullShader.h"
 
+#include "Graphics.h"
+
 NullShader::NullShader() : Shader() {}
 
-void NullShader::enable() {}
-void NullShader::disable() {}
+void NullShader::enable() {
+    g->flushBatch();
+    g->countShaderSwitch();
+}
+void NullShader::disable() {
+    g->flushBatch();
+    g->countShaderSwitch();
+}
 void NullShader::setUniform1f(std::string_view /*name*/, float /*value*/) {}
 void NullShader::setUniform1fv(std::string_view /*name*/, int /*count*/, const float *const /*values*/) {}
 void NullShader::setUniform1i(std::string_view /*name*/, int /*value*/) {}
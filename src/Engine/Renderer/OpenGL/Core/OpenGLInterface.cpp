@@ -65,9 +65,18 @@ OpenGLInterface::OpenGLInterface()
 
     // initialize the state cache
     GLStateCache::initialize();
+
+    // timer queries are core since 3.3
+    if(glGenQueries != nullptr && glGetQueryObjectui64v != nullptr) {
+        glGenQueries(NUM_TIMER_QUERIES, this->timerQueries.data());
+    }
 }
 
-OpenGLInterface::~OpenGLInterface() = default;
+OpenGLInterface::~OpenGLInterface() {
+    if(this->timerQueries[0] != 0 && glDeleteQueries != nullptr) {
+        glDeleteQueries(NUM_TIMER_QUERIES, this->timerQueries.data());
+    }
+}
 
 void OpenGLInterface::beginScene() {
     this->bInScene = true;
@@ -90,11 +99,32 @@ void OpenGLInterface::beginScene() {
     // glClearColor(0.9568f, 0.9686f, 0.9882f, 1);
     glClearColor(0, 0, 0, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    if(this->timerQueries[0] != 0) {
+        // the oldest query gets reused, so collect its result first (if it's not done yet, it's skipped)
+        const unsigned int query = this->timerQueries[this->iTimerQueryFrame % NUM_TIMER_QUERIES];
+        if(this->iTimerQueryFrame >= NUM_TIMER_QUERIES) {
+            GLint available = 0;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if(available) {
+                GLuint64 elapsedNS = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNS);
+                this->fGPUFrameTimeMS = static_cast<f64>(elapsedNS) / 1000000.0;
+            }
+        }
+        glBeginQuery(GL_TIME_ELAPSED, query);
+    }
 }
 
 void OpenGLInterface::endScene() {
+    this->submitBatch();
     popTransform();
 
+    if(this->timerQueries[0] != 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        this->iTimerQueryFrame++;
+    }
+
     if constexpr(Env::cfg(BUILD::DEBUG)) {
         checkStackLeaks();
 
@@ -109,7 +139,10 @@ void OpenGLInterface::endScene() {
     this->bInScene = false;
 }
 
-void OpenGLInterface::clearDepthBuffer() { glClear(GL_DEPTH_BUFFER_BIT); }
+void OpenGLInterface::clearDepthBuffer() {
+    this->flushBatch();
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
 
 void OpenGLInterface::setColor(Color color) {
     if(color == this->color) return;
@@ -120,11 +153,16 @@ void OpenGLInterface::setColor(Color color) {
 }
 
 void OpenGLInterface::drawPixels(int x, int y, int width, int height, DrawPixelsType type, const void *pixels) {
+    this->submitBatch();
+    this->countDrawCall(0);
     glRasterPos2i(x, y + height);  // '+height' because of opengl bottom left origin, but engine top left origin
     glDrawPixels(width, height, GL_RGBA, (type == DrawPixelsType::UBYTE ? GL_UNSIGNED_BYTE : GL_FLOAT), pixels);
 }
 
 void OpenGLInterface::drawPixel(int x, int y) {
+    this->submitBatch();
+    this->countDrawCall(1);
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -137,6 +175,9 @@ void OpenGLInterface::drawPixel(int x, int y) {
 }
 
 void OpenGLInterface::drawLinef(float x1, float y1, float x2, float y2) {
+    this->submitBatch();
+    this->countDrawCall(2);
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -150,6 +191,9 @@ void OpenGLInterface::drawLinef(float x1, float y1, float x2, float y2) {
 }
 
 void OpenGLInterface::drawRectf(const RectOptions &opts) {
+    this->submitBatch();
+    this->countDrawCall(opts.withColor ? 8 : 4);
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -191,6 +235,15 @@ void OpenGLInterface::drawRectf(const RectOptions &opts) {
 }
 
 void OpenGLInterface::fillRectf(float x, float y, float width, float height) {
+    if(cv::r_batch_quads.getBool()) {
+        this->batchQuad({.textured = false}, {vec2{x, y}, {x, y + height}, {x + width, y + height}, {x + width, y}}, {},
+                        {this->color, this->color, this->color, this->color});
+        return;
+    }
+
+    this->submitBatch();
+    this->countDrawCall(4);
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -212,40 +265,52 @@ void OpenGLInterface::fillRoundedRect(int x, int y, int width, int height, int r
     double i = 0;
     const double factor = 0.05;
 
+    this->submitBatch();
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
 
+    u32 numVertices = 0;
     glBegin(GL_POLYGON);
     {
         // top left
         for(i = PI; i <= (1.5 * PI); i += factor) {
             glVertex2d(radius * std::cos(i) + xOffset, radius * std::sin(i) + yOffset);
+            numVertices++;
         }
 
         // top right
         xOffset = x + width - radius;
         for(i = (1.5 * PI); i <= (2 * PI); i += factor) {
             glVertex2d(radius * std::cos(i) + xOffset, radius * std::sin(i) + yOffset);
+            numVertices++;
         }
 
         // bottom right
         yOffset = y + height - radius;
         for(i = 0; i <= (0.5 * PI); i += factor) {
             glVertex2d(radius * std::cos(i) + xOffset, radius * std::sin(i) + yOffset);
+            numVertices++;
         }
 
         // bottom left
         xOffset = x + radius;
         for(i = (0.5 * PI); i <= PI; i += factor) {
             glVertex2d(radius * std::cos(i) + xOffset, radius * std::sin(i) + yOffset);
+            numVertices++;
         }
     }
     glEnd();
+
+    this->countDrawCall(numVertices);
 }
 
 void OpenGLInterface::fillGradient(int x, int y, int width, int height, Color topLeftColor, Color topRightColor,
                                    Color bottomLeftColor, Color bottomRightColor) {
+    this->submitBatch();
+    this->countDrawCall(4);
+
     updateTransform();
 
     glDisable(GL_TEXTURE_2D);
@@ -268,14 +333,26 @@ void OpenGLInterface::fillGradient(int x, int y, int width, int height, Color to
 }
 
 void OpenGLInterface::drawQuad(int x, int y, int width, int height) {
-    updateTransform();
-
     const int left = x;
     const int right = (x + width);
 
     const int top = (y + height);
     const int bottom = y;
 
+    if(cv::r_batch_quads.getBool()) {
+        this->batchQuad({.textured = true},
+                        {vec2{(f32)left, (f32)bottom}, {(f32)left, (f32)top}, {(f32)right, (f32)top},
+                         {(f32)right, (f32)bottom}},
+                        {vec2{0.f, 0.f}, {0.f, 1.f}, {1.f, 1.f}, {1.f, 0.f}},
+                        {this->color, this->color, this->color, this->color});
+        return;
+    }
+
+    this->submitBatch();
+    this->countDrawCall(4);
+
+    updateTransform();
+
     glBegin(GL_QUADS);
     {
         glTexCoord2i(0, 0);
@@ -295,6 +372,19 @@ void OpenGLInterface::drawQuad(int x, int y, int width, int height) {
 
 void OpenGLInterface::drawQuad(vec2 topLeft, vec2 topRight, vec2 bottomRight, vec2 bottomLeft, Color topLeftColor,
                                Color topRightColor, Color bottomRightColor, Color bottomLeftColor) {
+    if(cv::r_batch_quads.getBool()) {
+        this->batchQuad({.textured = true}, {topLeft, bottomLeft, bottomRight, topRight},
+                        {vec2{0.f, 0.f}, {0.f, 1.f}, {1.f, 1.f}, {1.f, 0.f}},
+                        {topLeftColor, bottomLeftColor, bottomRightColor, topRightColor});
+
+        // same current color as after drawing it immediately
+        this->setColor(topRightColor);
+        return;
+    }
+
+    this->submitBatch();
+    this->countDrawCall(4);
+
     updateTransform();
 
     glBegin(GL_QUADS);
@@ -343,8 +433,6 @@ void OpenGLInterface::drawImage(const Image *image, AnchorPoint anchor, float ed
         pushClipRect(clipRect);
     }
 
-    this->updateTransform();
-
     const float width = image->getWidth();
     const float height = image->getHeight();
 
@@ -379,7 +467,35 @@ void OpenGLInterface::drawImage(const Image *image, AnchorPoint anchor, float ed
         clipRect = McRect{x, y, width, height};
     }
 
+    if(!smoothedEdges && cv::r_batch_quads.getBool()) {
+        this->batchQuad({.image = image, .textured = true},
+                        {vec2{x, y}, {x, y + height}, {x + width, y + height}, {x + width, y}},
+                        {vec2{0.f, 0.f}, {0.f, 1.f}, {1.f, 1.f}, {1.f, 0.f}},
+                        {this->color, this->color, this->color, this->color});
+    } else {
+        this->submitBatch();
+        this->countDrawCall(4);
+        this->updateTransform();
+        this->drawImageImmediate(image, x, y, width, height, smoothedEdges ? std::optional{clipRect} : std::nullopt,
+                                 edgeSoftness);
+    }
+
+    if(fallbackClip) {
+        popClipRect();
+    }
+
+    if(cv::r_debug_drawimage.getBool()) {
+        this->setColor(0xbbff00ff);
+        this->drawRect(x, y, width - 1, height - 1);
+    }
+}
+
+void OpenGLInterface::drawImageImmediate(const Image *image, f32 x, f32 y, f32 width, f32 height,
+                                         std::optional<McRect> smoothClipRect, float edgeSoftness) {
+    const bool smoothedEdges = smoothClipRect.has_value();
     if(smoothedEdges) {
+        const McRect &clipRect = *smoothClipRect;
+
         // compensate for viewport changed by rendertargets
         // flip Y for engine<->opengl coordinate origin
         const auto &viewport{GLStateCache::getCurrentViewport()};
@@ -417,13 +533,6 @@ void OpenGLInterface::drawImage(const Image *image, AnchorPoint anchor, float ed
 
     if(smoothedEdges) {
         this->smoothClipShader->disable();
-    } else if(fallbackClip) {
-        popClipRect();
-    }
-
-    if(cv::r_debug_drawimage.getBool()) {
-        this->setColor(0xbbff00ff);
-        this->drawRect(x, y, width - 1, height - 1);
     }
 }
 
@@ -433,6 +542,7 @@ void OpenGLInterface::drawString(McFont *font, const UString &text, std::optiona
     updateTransform();
 
     if(cv::r_debug_flush_drawstring.getBool()) {
+        this->submitBatch();
         glFinish();
         glFlush();
         glFinish();
@@ -442,9 +552,19 @@ void OpenGLInterface::drawString(McFont *font, const UString &text, std::optiona
     font->drawString(text, shadow);
 }
 
+bool OpenGLInterface::batchText(const Image *atlas, std::span<const vec3> verts, std::span<const vec2> texcoords) {
+    if(!cv::r_batch_text.getBool()) return false;
+
+    this->batchQuads({.image = atlas, .textured = true}, verts, texcoords, this->color);
+    this->drawStats.batched_text++;
+    return true;
+}
+
 void OpenGLInterface::drawVAO(VertexArrayObject *vao) {
     if(vao == nullptr) return;
 
+    this->submitBatch();
+
     updateTransform();
 
     // HACKHACK: disable texturing for special primitives, also for untextured vaos
@@ -541,11 +661,13 @@ void OpenGLInterface::drawVAO(VertexArrayObject *vao) {
     }
 
     // draw using client-side arrays
+    this->countDrawCall(static_cast<u32>(drawCount));
     glDrawArrays(SDLGLInterface::primitiveToOpenGLMap[vao->getPrimitive()], 0, static_cast<GLint>(drawCount));
 }
 
 void OpenGLInterface::setClipRect(McRect clipRect) {
     if(cv::r_debug_disable_cliprect.getBool()) return;
+    this->flushBatch();
     // if (m_bIs3DScene) return; // TODO
 
     // rendertargets change the current viewport
@@ -585,11 +707,13 @@ void OpenGLInterface::pushViewport() {
 }
 
 void OpenGLInterface::setViewport(int x, int y, int width, int height) {
+    this->flushBatch();
     this->vResolution = vec2(width, height);
     GLStateCache::setViewport(x, y, width, height);
 }
 
 void OpenGLInterface::popViewport() {
+    this->flushBatch();
     if(this->viewportStack.empty() || this->resolutionStack.empty()) {
         debugLog("WARNING: viewport stack underflow!");
         return;
@@ -603,6 +727,7 @@ void OpenGLInterface::popViewport() {
 }
 
 void OpenGLInterface::pushStencil() {
+    this->flushBatch();
     // init and clear
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
@@ -615,14 +740,19 @@ void OpenGLInterface::pushStencil() {
 }
 
 void OpenGLInterface::fillStencil(bool inside) {
+    this->flushBatch();
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glStencilFunc(GL_NOTEQUAL, inside ? 0 : 1, 1);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
-void OpenGLInterface::popStencil() { glDisable(GL_STENCIL_TEST); }
+void OpenGLInterface::popStencil() {
+    this->flushBatch();
+    glDisable(GL_STENCIL_TEST);
+}
 
 void OpenGLInterface::setClipping(bool enabled) {
+    this->flushBatch();
     if(enabled) {
         if(this->clipRectStack.size() > 0) glEnable(GL_SCISSOR_TEST);
     } else
@@ -630,6 +760,7 @@ void OpenGLInterface::setClipping(bool enabled) {
 }
 
 void OpenGLInterface::setAlphaTesting(bool enabled) {
+    this->flushBatch();
     if(enabled)
         glEnable(GL_ALPHA_TEST);
     else
@@ -637,6 +768,7 @@ void OpenGLInterface::setAlphaTesting(bool enabled) {
 }
 
 void OpenGLInterface::setAlphaTestFunc(DrawCompareFunc alphaFunc, float ref) {
+    this->flushBatch();
     glAlphaFunc(SDLGLInterface::compareFuncToOpenGLMap[alphaFunc], ref);
 }
 
@@ -669,15 +801,20 @@ void OpenGLInterface::setBlendMode(DrawBlendMode blendMode) {
 }
 
 void OpenGLInterface::setDepthBuffer(bool enabled) {
+    this->flushBatch();
     if(enabled)
         glEnable(GL_DEPTH_TEST);
     else
         glDisable(GL_DEPTH_TEST);
 }
 
-void OpenGLInterface::setColorWriting(bool r, bool g, bool b, bool a) { glColorMask(r, g, b, a); }
+void OpenGLInterface::setColorWriting(bool r, bool g, bool b, bool a) {
+    this->flushBatch();
+    glColorMask(r, g, b, a);
+}
 
 void OpenGLInterface::setColorInversion(bool enabled) {
+    this->flushBatch();
     if(enabled) {
         glEnable(GL_COLOR_LOGIC_OP);
         glLogicOp(GL_COPY_INVERTED);
@@ -687,6 +824,7 @@ void OpenGLInterface::setColorInversion(bool enabled) {
 }
 
 void OpenGLInterface::setCulling(bool culling) {
+    this->flushBatch();
     if(culling)
         glEnable(GL_CULL_FACE);
     else
@@ -694,6 +832,7 @@ void OpenGLInterface::setCulling(bool culling) {
 }
 
 void OpenGLInterface::setAntialiasing(bool aa) {
+    this->flushBatch();
     this->bAntiAliasing = aa;
     if(aa)
         glEnable(GL_MULTISAMPLE);
@@ -702,13 +841,17 @@ void OpenGLInterface::setAntialiasing(bool aa) {
 }
 
 void OpenGLInterface::setWireframe(bool enabled) {
+    this->flushBatch();
     if(enabled)
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     else
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 }
 
-void OpenGLInterface::flush() { glFlush(); }
+void OpenGLInterface::flush() {
+    this->submitBatch();
+    glFlush();
+}
 
 std::vector<u8> OpenGLInterface::getScreenshot(bool withAlpha) {
     std::vector<u8> result;
@@ -746,6 +889,8 @@ std::vector<u8> OpenGLInterface::getScreenshot(bool withAlpha) {
 }
 
 void OpenGLInterface::onResolutionChange(vec2 newResolution) {
+    this->flushBatch();
+
     // rebuild viewport
     this->vResolution = newResolution;
     GLStateCache::setViewport(0, 0, this->vResolution.x, this->vResolution.y);
@@ -792,6 +937,53 @@ void OpenGLInterface::onTransformUpdate() {
     glLoadMatrixf(this->worldMatrix.get());
 }
 
+void OpenGLInterface::drawBatch(BatchTexture texture, std::span<BatchVertex> vertices, const Matrix4 &projection) {
+    if(texture.image != nullptr) {
+        texture.image->bind();
+    } else if(!texture.textured) {
+        glDisable(GL_TEXTURE_2D);
+    }
+
+    // vertices are already in world space
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(projection.get());
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    this->bTransformUpToDate = false;
+
+    // RGBA byte order (see drawVAO)
+    for(auto &vertex : vertices) {
+        vertex.col = abgr(vertex.col);
+    }
+
+    GLStateCache::bindArrayBuffer(0);
+    if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
+        glBindVertexArray(0);
+    }
+
+    constexpr GLsizei stride = sizeof(BatchVertex);
+    GLStateCache::enableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, &vertices[0].pos.x);
+    if(texture.textured) {
+        GLStateCache::enableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, stride, &vertices[0].tex.x);
+    } else {
+        GLStateCache::disableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+    GLStateCache::enableClientState(GL_COLOR_ARRAY);
+    glColorPointer(4, GL_UNSIGNED_BYTE, stride, &vertices[0].col);
+    GLStateCache::disableClientState(GL_NORMAL_ARRAY);
+
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(vertices.size()));
+
+    if(texture.image != nullptr) {
+        texture.image->unbind();
+    }
+
+    // the current color is undefined after drawing with a color array
+    glColor4ub(this->color.R(), this->color.G(), this->color.B(), this->color.A());
+}
+
 void OpenGLInterface::initSmoothClipShader() {
     if(this->smoothClipShader != nullptr) return;
 
@@ -50,6 +50,7 @@ class OpenGLInterface : public Graphics {
     void drawImage(const Image *image, AnchorPoint anchor = AnchorPoint::CENTER, float edgeSoftness = 0.0f,
                    McRect clipRect = {}) final;
     void drawString(McFont *font, const UString &text, std::optional<TextShadow> shadow = std::nullopt) final;
+    bool batchText(const Image *atlas, std::span<const vec3> verts, std::span<const vec2> texcoords) final;
 
     // 3d type drawing
     void drawVAO(VertexArrayObject *vao) final;
@@ -105,11 +106,16 @@ class OpenGLInterface : public Graphics {
    protected:
     void onTransformUpdate() final;
     std::vector<u8> getScreenshot(bool withAlpha = false) final;
+    void drawBatch(BatchTexture texture, std::span<BatchVertex> vertices, const Matrix4 &projection) final;
 
    private:
     std::unique_ptr<Shader> smoothClipShader{nullptr};
     void initSmoothClipShader();
 
+    // glBegin/glEnd path, for smoothed edges or with r_batch_quads disabled
+    void drawImageImmediate(const Image *image, f32 x, f32 y, f32 width, f32 height,
+                            std::optional<McRect> smoothClipRect, float edgeSoftness);
+
     // renderer
     bool bInScene{false};
     vec2 vResolution{0.f};
@@ -122,6 +128,11 @@ class OpenGLInterface : public Graphics {
 
     // clipping
     std::vector<McRect> clipRectStack;
+
+    // gpu frame timing, with a few frames in flight so that reading a result never stalls
+    static constexpr int NUM_TIMER_QUERIES = 4;
+    std::array<unsigned int, NUM_TIMER_QUERIES> timerQueries{};
+    u32 iTimerQueryFrame{0};
 };
 
 #endif
@@ -46,6 +46,9 @@ void OpenGLShader::enable() {
     unsigned int currentProgram = GLStateCache::getCurrentProgram();
     if(currentProgram == this->iProgram) return;  // already active
 
+    g->flushBatch();
+    g->countShaderSwitch();
+
     this->iProgramBackup = currentProgram;
     glUseProgramObjectARB(this->iProgram);
     GLStateCache::setCurrentProgram(this->iProgram);
@@ -54,6 +57,9 @@ void OpenGLShader::enable() {
 void OpenGLShader::disable() {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+    g->countShaderSwitch();
+
     glUseProgramObjectARB(this->iProgramBackup);
 
     // update cache
@@ -63,6 +69,8 @@ void OpenGLShader::disable() {
 void OpenGLShader::setUniform1f(std::string_view name, float value) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -74,6 +82,8 @@ void OpenGLShader::setUniform1f(std::string_view name, float value) {
 void OpenGLShader::setUniform1fv(std::string_view name, int count, const float *const values) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -85,6 +95,8 @@ void OpenGLShader::setUniform1fv(std::string_view name, int count, const float *
 void OpenGLShader::setUniform1i(std::string_view name, int value) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -96,6 +108,8 @@ void OpenGLShader::setUniform1i(std::string_view name, int value) {
 void OpenGLShader::setUniform2f(std::string_view name, float value1, float value2) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -107,6 +121,8 @@ void OpenGLShader::setUniform2f(std::string_view name, float value1, float value
 void OpenGLShader::setUniform2fv(std::string_view name, int count, const float *const vectors) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -118,6 +134,8 @@ void OpenGLShader::setUniform2fv(std::string_view name, int count, const float *
 void OpenGLShader::setUniform3f(std::string_view name, float x, float y, float z) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -129,6 +147,8 @@ void OpenGLShader::setUniform3f(std::string_view name, float x, float y, float z
 void OpenGLShader::setUniform3fv(std::string_view name, int count, const float *const vectors) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -140,6 +160,8 @@ void OpenGLShader::setUniform3fv(std::string_view name, int count, const float *
 void OpenGLShader::setUniform4f(std::string_view name, float x, float y, float z, float w) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -151,6 +173,8 @@ void OpenGLShader::setUniform4f(std::string_view name, float x, float y, float z
 void OpenGLShader::setUniformMatrix4fv(std::string_view name, const Matrix4 &matrix) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -162,6 +186,8 @@ void OpenGLShader::setUniformMatrix4fv(std::string_view name, const Matrix4 &mat
 void OpenGLShader::setUniformMatrix4fv(std::string_view name, const float *const v) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+
     const int id = getAndCacheUniformLocation(name);
     if(id == -1) {
         logIfCV(debug_shaders, "OpenGLShader Warning: Can't find uniform {:s}", name);
@@ -50,6 +50,7 @@ void OpenGLVertexArrayObject::init() {
 
                 glBufferSubData(GL_ARRAY_BUFFER, sizeof(vec3) * offsetIndex, sizeof(vec3) * numContinuousIndices,
                                 &(this->vertices[offsetIndex]));
+                g->countUpload(sizeof(vec3) * numContinuousIndices);
             }
             this->partialUpdateVertexIndices.clear();
         }
@@ -77,6 +78,7 @@ void OpenGLVertexArrayObject::init() {
 
                 glBufferSubData(GL_ARRAY_BUFFER, sizeof(Color) * offsetIndex, sizeof(Color) * numContinuousIndices,
                                 &(this->colors[offsetIndex]));
+                g->countUpload(sizeof(Color) * numContinuousIndices);
             }
             this->partialUpdateColorIndices.clear();
         }
@@ -100,6 +102,7 @@ void OpenGLVertexArrayObject::init() {
         GLStateCache::bindArrayBuffer(this->iVertexBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * this->vertices.size(), &(this->vertices[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(vec3) * this->vertices.size());
 
         if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
             glEnableVertexAttribArray(vertexAttribArrayIndexCounter);
@@ -119,6 +122,7 @@ void OpenGLVertexArrayObject::init() {
         GLStateCache::bindArrayBuffer(this->iTexcoordBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * this->texcoords.size(), &(this->texcoords[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(vec2) * this->texcoords.size());
 
         if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
             if(this->iNumTexcoords > 0) {
@@ -141,6 +145,7 @@ void OpenGLVertexArrayObject::init() {
         GLStateCache::bindArrayBuffer(this->iColorBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(Color) * this->colors.size(), &(this->colors[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(Color) * this->colors.size());
 
         if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
             if(this->iNumColors > 0) {
@@ -159,6 +164,7 @@ void OpenGLVertexArrayObject::init() {
         GLStateCache::bindArrayBuffer(this->iNormalBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * this->normals.size(), &(this->normals[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(vec3) * this->normals.size());
 
         if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
             if(this->iNumNormals > 0) {
@@ -217,6 +223,8 @@ void OpenGLVertexArrayObject::draw() {
 
     if(start > end || std::abs(end - start) == 0) return;
 
+    g->countDrawCall(end - start);
+
     if(cv::r_opengl_legacy_vao_use_vertex_array.getBool()) {
         // set vao
         glBindVertexArray(this->iVertexArray);
@@ -636,6 +636,7 @@ void OpenGLES32Interface::drawVAO(VertexArrayObject *vao) {
         if(orphanBuffers)
             glBufferData(GL_ARRAY_BUFFER, 16384 * sizeof(vec3), nullptr, GL_STREAM_DRAW);  // orphan the buffer
         glBufferSubData(GL_ARRAY_BUFFER, 0, finalVertices.size() * sizeof(vec3), &(finalVertices[0]));
+        this->countUpload(finalVertices.size() * sizeof(vec3));
     }
 
     // upload texcoords to gpu
@@ -644,6 +645,7 @@ void OpenGLES32Interface::drawVAO(VertexArrayObject *vao) {
         if(orphanBuffers)
             glBufferData(GL_ARRAY_BUFFER, 16384 * sizeof(vec2), nullptr, GL_STREAM_DRAW);  // orphan the buffer
         glBufferSubData(GL_ARRAY_BUFFER, 0, finalTexcoords.size() * sizeof(vec2), &(finalTexcoords[0]));
+        this->countUpload(finalTexcoords.size() * sizeof(vec2));
     }
 
     // upload vertex colors to gpu
@@ -652,6 +654,7 @@ void OpenGLES32Interface::drawVAO(VertexArrayObject *vao) {
         if(orphanBuffers)
             glBufferData(GL_ARRAY_BUFFER, 16384 * sizeof(vec4), nullptr, GL_STREAM_DRAW);  // orphan the buffer
         glBufferSubData(GL_ARRAY_BUFFER, 0, finalColors.size() * sizeof(Color), &(finalColors[0]));
+        this->countUpload(finalColors.size() * sizeof(Color));
     }
 
     // configure shader
@@ -685,6 +688,7 @@ void OpenGLES32Interface::drawVAO(VertexArrayObject *vao) {
     }
 
     // draw it
+    this->countDrawCall(static_cast<u32>(finalVertices.size()));
     glDrawArrays(SDLGLInterface::primitiveToOpenGLMap[primitive], 0, finalVertices.size());
 }
 
@@ -71,6 +71,8 @@ void OpenGLES32Shader::enable() {
     if(currentProgram == m_iProgram)  // already active
         return;
 
+    g->countShaderSwitch();
+
     // use the state cache instead of querying gl directly
     m_iProgramBackup = static_cast<int>(GLStateCache::getCurrentProgram());
     glUseProgram(m_iProgram);
@@ -82,6 +84,8 @@ void OpenGLES32Shader::enable() {
 void OpenGLES32Shader::disable() {
     if(!this->isReady()) return;
 
+    g->countShaderSwitch();
+
     glUseProgram(m_iProgramBackup);  // restore
 
     // update cache
@@ -53,6 +53,7 @@ void OpenGLES32VertexArrayObject::init() {
 
                 glBufferSubData(GL_ARRAY_BUFFER, sizeof(vec3) * offsetIndex, sizeof(vec3) * numContinuousIndices,
                                 &(this->vertices[offsetIndex]));
+                g->countUpload(sizeof(vec3) * numContinuousIndices);
             }
             this->partialUpdateVertexIndices.clear();
         }
@@ -80,6 +81,7 @@ void OpenGLES32VertexArrayObject::init() {
 
                 glBufferSubData(GL_ARRAY_BUFFER, sizeof(Color) * offsetIndex, sizeof(Color) * numContinuousIndices,
                                 &(this->colors[offsetIndex]));
+                g->countUpload(sizeof(Color) * numContinuousIndices);
             }
             this->partialUpdateColorIndices.clear();
         }
@@ -95,6 +97,7 @@ void OpenGLES32VertexArrayObject::init() {
     glBindBuffer(GL_ARRAY_BUFFER, m_iVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * this->vertices.size(), &(this->vertices[0]),
                  SDLGLInterface::usageToOpenGLMap[this->usage]);
+    g->countUpload(sizeof(vec3) * this->vertices.size());
 
     // build and fill texcoord buffer
     if(this->texcoords.size() > 0) {
@@ -104,6 +107,7 @@ void OpenGLES32VertexArrayObject::init() {
         glBindBuffer(GL_ARRAY_BUFFER, m_iTexcoordBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * this->texcoords.size(), &(this->texcoords[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(vec2) * this->texcoords.size());
     }
 
     // build and fill color buffer
@@ -119,6 +123,7 @@ void OpenGLES32VertexArrayObject::init() {
         glBindBuffer(GL_ARRAY_BUFFER, m_iColorBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(Color) * this->colors.size(), &(this->colors[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(Color) * this->colors.size());
     }
 
     // build and fill normal buffer
@@ -129,6 +134,7 @@ void OpenGLES32VertexArrayObject::init() {
         glBindBuffer(GL_ARRAY_BUFFER, m_iNormalBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * this->normals.size(), &(this->normals[0]),
                      SDLGLInterface::usageToOpenGLMap[this->usage]);
+        g->countUpload(sizeof(vec3) * this->normals.size());
     }
 
     // free memory
@@ -201,6 +207,7 @@ void OpenGLES32VertexArrayObject::draw() {
     }
 
     // draw the geometry
+    g->countDrawCall(end - start);
     glDrawArrays(SDLGLInterface::primitiveToOpenGLMap[this->primitive], start, end - start);
 
     // restore default state
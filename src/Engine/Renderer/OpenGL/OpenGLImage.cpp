@@ -37,6 +37,9 @@ void OpenGLImage::init() {
     // rawImage cannot be empty here, if it is, we're screwed
     assert(this->totalBytes() != 0);
 
+    // the texture is bound directly below
+    g->flushBatch();
+
     // create texture object
     const bool glTextureWasEmpty = this->GLTexture == 0;
     if(glTextureWasEmpty) {
@@ -64,6 +67,7 @@ void OpenGLImage::init() {
             // first upload: must use glTexImage2D to allocate texture storage
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->rawImage.getX(), this->rawImage.getY(), 0, GL_RGBA,
                          GL_UNSIGNED_BYTE, this->rawImage.get());
+            g->countUpload((u64)this->rawImage.getX() * this->rawImage.getY() * Image::NUM_CHANNELS);
         } else {
             // rebind
             glBindTexture(GL_TEXTURE_2D, this->GLTexture);
@@ -76,6 +80,7 @@ void OpenGLImage::init() {
             if(fullImage) {
                 glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->rawImage.getX(), this->rawImage.getY(), GL_RGBA,
                                 GL_UNSIGNED_BYTE, this->rawImage.get());
+                g->countUpload((u64)this->rawImage.getX() * this->rawImage.getY() * Image::NUM_CHANNELS);
             } else {
                 glPixelStorei(GL_UNPACK_ROW_LENGTH, this->rawImage.getX());
                 for(const auto &rect : dirtyRects) {
@@ -84,6 +89,7 @@ void OpenGLImage::init() {
                         ((i64)rect.getMinY() * this->rawImage.getX() + rect.getMinX()) * Image::NUM_CHANNELS;
                     glTexSubImage2D(GL_TEXTURE_2D, 0, rect.getMinX(), rect.getMinY(), rect.getWidth(), rect.getHeight(),
                                     GL_RGBA, GL_UNSIGNED_BYTE, src);
+                    g->countUpload((u64)rect.getWidth() * rect.getHeight() * Image::NUM_CHANNELS);
                 }
                 glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
             }
@@ -142,6 +148,9 @@ void OpenGLImage::destroy() {
 }
 
 void OpenGLImage::deleteGL() {
+    // a pending batch might still be using this texture
+    if(g) g->flushBatch();
+
 #ifdef MCENGINE_FEATURE_GLES32
     constexpr bool hasGLFuncs = true;
 #else
@@ -161,6 +170,9 @@ void OpenGLImage::deleteGL() {
 void OpenGLImage::bind(unsigned int textureUnit) const {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+    g->countTextureBind();
+
     this->iTextureUnitBackup = textureUnit;
 
     // switch texture units before enabling+binding
@@ -178,6 +190,8 @@ void OpenGLImage::bind(unsigned int textureUnit) const {
 void OpenGLImage::unbind() const {
     if(!this->isReady() || !cv::r_gl_image_unbind.getBool()) return;
 
+    g->flushBatch();
+
     // restore texture unit (just in case) and set to no texture
     glActiveTexture(GL_TEXTURE0 + this->iTextureUnitBackup);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -212,6 +212,9 @@ void OpenGLRenderTarget::destroy() {
 void OpenGLRenderTarget::enable() {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+    g->countRenderTargetSwitch();
+
     // use the state cache instead of querying OpenGL directly
     this->iFrameBufferBackup = GLStateCache::getCurrentFramebuffer();
     GLStateCache::bindFramebuffer(this->iFrameBuffer);
@@ -255,6 +258,9 @@ void OpenGLRenderTarget::enable() {
 void OpenGLRenderTarget::disable() {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+    g->countRenderTargetSwitch();
+
     // if multisampled, blit content for multisampling into resolve texture
     if(isMultiSampled()) {
         // HACKHACK: force disable antialiasing
@@ -287,6 +293,9 @@ void OpenGLRenderTarget::disable() {
 void OpenGLRenderTarget::bind(unsigned int textureUnit) {
     if(!this->isReady()) return;
 
+    g->flushBatch();
+    g->countTextureBind();
+
     this->iTextureUnitBackup = textureUnit;
 
     // switch texture units before enabling+binding
@@ -305,6 +314,8 @@ void OpenGLRenderTarget::bind(unsigned int textureUnit) {
 void OpenGLRenderTarget::unbind() {
     if(!this->isReady() || !cv::r_gl_rt_unbind.getBool()) return;
 
+    g->flushBatch();
+
     // restore texture unit (just in case) and set to no texture
     glActiveTexture(GL_TEXTURE0 + this->iTextureUnitBackup);
     glBindTexture(GL_TEXTURE_2D, 0);
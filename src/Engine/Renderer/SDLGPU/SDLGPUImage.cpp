@@ -178,6 +178,7 @@ void SDLGPUImage::uploadPixelData(SDL_GPUDevice *device) {
                 dst.d = 1;
 
                 SDL_UploadToGPUTexture(copyPass, &src, &dst, false);
+                g->countUpload(totalBytes);
             } else {
                 for(size_t i = 0; i < dirtyRects.size(); i++) {
                     const auto &rect = dirtyRects[i];
@@ -196,6 +197,7 @@ void SDLGPUImage::uploadPixelData(SDL_GPUDevice *device) {
                     dst.d = 1;
 
                     SDL_UploadToGPUTexture(copyPass, &src, &dst, false);
+                    g->countUpload((u64)dst.w * dst.h * Image::NUM_CHANNELS);
                 }
             }
             SDL_EndGPUCopyPass(copyPass);
@@ -310,6 +312,7 @@ void SDLGPUImage::bind(unsigned int /*textureUnit*/) const {
     if(!this->isReady()) return;
 
     auto *gpu = static_cast<SDLGPUInterface *>(g.get());
+    gpu->countTextureBind();
 
     // backup current
     m_prevTexture = gpu->getBoundTexture();
@@ -1086,6 +1086,7 @@ void SDLGPUInterface::recordDraw(SDL_GPUBuffer *bakedBuffer, u32 vertexOffset, u
 
     m_pendingDraws.push_back(cmd);
     m_iStatsNumDrawCalls++;
+    this->countDrawCall(vertexCount);
 }
 
 void SDLGPUInterface::flushDrawCommands() {
@@ -1141,6 +1142,7 @@ void SDLGPUInterface::flushDrawCommands() {
             };
             SDL_UploadToGPUBuffer(copyPass, &src, &dst, true);
             SDL_EndGPUCopyPass(copyPass);
+            this->countUpload(dst.size);
         }
     }
 
@@ -220,6 +220,7 @@ void SDLGPURenderTarget::enable() {
     if(!this->isReady()) return;
 
     auto *gpu = static_cast<SDLGPUInterface *>(g.get());
+    gpu->countRenderTargetSwitch();
 
     Color clearCol = this->clearColor;
     if(cv::debug_rt.getBool()) clearCol = argb(0.5f, 0.0f, 0.5f, 0.0f);
@@ -237,6 +238,7 @@ void SDLGPURenderTarget::disable() {
     if(!this->isReady()) return;
 
     auto *gpu = static_cast<SDLGPUInterface *>(g.get());
+    gpu->countRenderTargetSwitch();
     gpu->popRenderTarget();
 }
 
@@ -244,6 +246,7 @@ void SDLGPURenderTarget::bind(unsigned int /*textureUnit*/) {
     if(!this->isReady()) return;
 
     auto *gpu = static_cast<SDLGPUInterface *>(g.get());
+    gpu->countTextureBind();
 
     // backup current
     m_prevTexture = gpu->getBoundTexture();
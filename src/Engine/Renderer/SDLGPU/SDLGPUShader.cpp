@@ -177,6 +177,7 @@ void SDLGPUShader::enable() {
 
     m_lastActiveShader = currentShader;
 
+    gpu->countShaderSwitch();
     gpu->setActiveShader(this);
 }
 
@@ -188,6 +189,7 @@ void SDLGPUShader::disable() {
 
     // restore backup
     assert(m_lastActiveShader);
+    gpu->countShaderSwitch();
     gpu->setActiveShader(m_lastActiveShader);
 }
 
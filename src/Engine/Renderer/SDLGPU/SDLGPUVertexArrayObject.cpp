@@ -54,6 +54,7 @@ void SDLGPUVertexArrayObject::init() {
                         .size = static_cast<Uint32>(sizeof(SDLGPUSimpleVertex) * m_convertedVertices.size()),
                     };
                     SDL_UploadToGPUBuffer(copyPass, &src, &dst, true);
+                    g->countUpload(dst.size);
                     SDL_EndGPUCopyPass(copyPass);
                 }
                 SDL_SubmitGPUCommandBuffer(cmdBuf);
@@ -211,6 +212,7 @@ void SDLGPUVertexArrayObject::init() {
             SDL_GPUTransferBufferLocation src{.transfer_buffer = m_transferBuffer, .offset = 0};
             SDL_GPUBufferRegion dst{.buffer = m_vertexBuffer, .offset = 0, .size = bufSize};
             SDL_UploadToGPUBuffer(copyPass, &src, &dst, false);
+            g->countUpload(bufSize);
             SDL_EndGPUCopyPass(copyPass);
         }
         SDL_SubmitGPUCommandBuffer(cmdBuf);
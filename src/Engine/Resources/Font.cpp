@@ -449,8 +449,6 @@ void McFontImpl::drawString(const UString &text, std::optional<TextShadow> shado
 
     if(text.length() == 0 || text.length() > cv::r_drawstring_max_string_length.getInt()) return;
 
-    m_vao->clear();
-
     // cache entire strings' vertex/texcoord representations,
     // and only do the minimal work necessary if needing to re-upload them to the texture atlas
     const bool useCache = text.length() >= 8 && text.length() <= 384;  // arbitrary limits
@@ -504,29 +502,54 @@ void McFontImpl::drawString(const UString &text, std::optional<TextShadow> shado
     //     debugLog("cache memory usage: {}MB", totalBytes / (1024ULL * 1024));
     // }
 
-    m_vao->reserve(buffer.getVerts().size());
+    // glyph quads of consecutive strings are merged into one draw, if the renderer can
+    bool batched = false;
+    if constexpr(VERTS_PER_VAO == 4) {
+        const Image *atlas = m_textureAtlas->getAtlasImage().get();
+        if(const auto &shadOpt = shadow; shadOpt.has_value() && shadOpt->col_shadow.A() > 0) {
+            const auto &shadowConf = *shadOpt;
+            const int px = shadowConf.offs_px;
 
-    m_vao->setVertices(buffer.getVerts());
-    m_vao->setTexcoords(buffer.getTexcoords());
+            g->translate(px, px);
+            g->setColor(shadowConf.col_shadow);
 
-    m_textureAtlas->getAtlasImage()->bind();
+            batched = g->batchText(atlas, buffer.getVerts(), buffer.getTexcoords());
 
-    if(const auto &shadOpt = shadow; shadOpt.has_value() && shadOpt->col_shadow.A() > 0) {
-        const auto &shadowConf = *shadOpt;
-        const int px = shadowConf.offs_px;
+            g->translate(-px, -px);
+            g->setColor(shadowConf.col_text);
 
-        g->translate(px, px);
-        g->setColor(shadowConf.col_shadow);
+            if(batched) g->batchText(atlas, buffer.getVerts(), buffer.getTexcoords());
+        } else {
+            batched = g->batchText(atlas, buffer.getVerts(), buffer.getTexcoords());
+        }
+    }
 
-        g->drawVAO(m_vao.get());
+    if(!batched) {
+        m_vao->clear();
+        m_vao->reserve(buffer.getVerts().size());
 
-        g->translate(-px, -px);
-        g->setColor(shadowConf.col_text);
-    }
+        m_vao->setVertices(buffer.getVerts());
+        m_vao->setTexcoords(buffer.getTexcoords());
+
+        m_textureAtlas->getAtlasImage()->bind();
 
-    g->drawVAO(m_vao.get());
+        if(const auto &shadOpt = shadow; shadOpt.has_value() && shadOpt->col_shadow.A() > 0) {
+            const auto &shadowConf = *shadOpt;
+            const int px = shadowConf.offs_px;
 
-    if(cv::r_debug_drawstring_unbind.getBool()) m_textureAtlas->getAtlasImage()->unbind();
+            g->translate(px, px);
+            g->setColor(shadowConf.col_shadow);
+
+            g->drawVAO(m_vao.get());
+
+            g->translate(-px, -px);
+            g->setColor(shadowConf.col_text);
+        }
+
+        g->drawVAO(m_vao.get());
+
+        if(cv::r_debug_drawstring_unbind.getBool()) m_textureAtlas->getAtlasImage()->unbind();
+    }
 
     if(!useCache) {
         buffer.clear();
@@ -3,6 +3,7 @@
 
 #include "ConVar.h"
 #include "Engine.h"
+#include "Profiler.h"
 #include "Thread.h"
 #include "Timing.h"
 #include "Logging.h"
@@ -83,7 +84,10 @@ class AsyncResourceLoader::LoaderThread final {
             } else {
                 work->state = WorkState::ASYNC_IN_PROGRESS;
 
-                resource->loadAsync();
+                {
+                    VPROF_TRACE("Resource::loadAsync");
+                    resource->loadAsync();
+                }
 
                 logIf(debug, "Thread #{} finished async loading {:s}", thread_index, debugName);
 
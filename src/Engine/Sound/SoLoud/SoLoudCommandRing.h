@@ -0,0 +1,153 @@
+#pragma once
+// Copyright (c) 2026, kiwec, All rights reserved.
+#include "types.h"
+#include "noinclude.h"
+#include "Timing.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Fixed-capacity single-producer/single-consumer queue of type-erased commands, for SoLoudThreadWrapper.
+// Commands are constructed in place inside the ring, so submitting one never allocates or takes a lock.
+// Callables that don't fit in a slot (see fits) have to be boxed by the caller.
+class SoLoudCommandRing final {
+    NOCOPY_NOMOVE(SoLoudCommandRing)
+
+    static constexpr uSz CACHE_LINE = 64;
+
+   public:
+    static constexpr u64 CAPACITY = 1024;  // must be a power of two
+    static constexpr uSz INLINE_SIZE = 40;
+
+    template <typename F>
+    static constexpr bool fits =
+        sizeof(std::decay_t<F>) <= INLINE_SIZE && alignof(std::decay_t<F>) <= alignof(std::max_align_t);
+
+    SoLoudCommandRing() noexcept = default;
+
+    // commands that never ran are destroyed without running them
+    ~SoLoudCommandRing() noexcept {
+        const u64 end = this->write_pos;
+        for(u64 pos = this->consumed.load(std::memory_order_acquire); pos != end; pos++) {
+            Slot &slot = this->slots[pos & MASK];
+            slot.destroy(slot.storage);
+        }
+    }
+
+    // producer: returns false if the ring is full
+    // the command only becomes visible to the consumer after publish()
+    template <typename F>
+    bool try_emplace(F &&func) noexcept {
+        using Fn = std::decay_t<F>;
+        static_assert(fits<F>);
+
+        const u64 pos = this->write_pos;
+        if(pos - this->cached_consumed >= CAPACITY) {
+            this->cached_consumed = this->consumed.load(std::memory_order_acquire);
+            if(pos - this->cached_consumed >= CAPACITY) return false;
+        }
+
+        Slot &slot = this->slots[pos & MASK];
+        ::new(static_cast<void *>(slot.storage)) Fn(std::forward<F>(func));
+        slot.run = [](void *storage) noexcept {
+            Fn *fn = std::launder(static_cast<Fn *>(storage));
+            (*fn)();
+            fn->~Fn();
+        };
+        slot.destroy = [](void *storage) noexcept { std::launder(static_cast<Fn *>(storage))->~Fn(); };
+        slot.enqueue_time = Timing::getTicksNS();
+
+        this->write_pos = pos + 1;
+        return true;
+    }
+
+    // producer: makes everything emplaced so far visible to the consumer
+    // returns false if there was nothing new to publish
+    bool publish() noexcept {
+        if(this->published.load(std::memory_order_relaxed) == this->write_pos) return false;
+        this->published.store(this->write_pos, std::memory_order_release);
+
+        // sampled here rather than per command, so the consumer's cache line isn't touched every time
+        this->max_depth = std::max(this->max_depth, this->write_pos - this->consumed.load(std::memory_order_relaxed));
+        return true;
+    }
+
+    // consumer: runs every published command, returns how many ran
+    u64 drain() noexcept {
+        const u64 end = this->published.load(std::memory_order_acquire);
+        const u64 start = this->consumed.load(std::memory_order_relaxed);
+
+        for(u64 pos = start; pos != end; pos++) {
+            Slot &slot = this->slots[pos & MASK];
+
+            const u64 latency = Timing::getTicksNS() - slot.enqueue_time;
+            this->total_latency.store(this->total_latency.load(std::memory_order_relaxed) + latency,
+                                      std::memory_order_relaxed);
+            if(latency > this->max_latency.load(std::memory_order_relaxed)) {
+                this->max_latency.store(latency, std::memory_order_relaxed);
+            }
+
+            slot.run(slot.storage);
+            this->consumed.store(pos + 1, std::memory_order_release);
+        }
+
+        return end - start;
+    }
+
+    // consumer
+    [[nodiscard]] bool empty() const noexcept {
+        return this->published.load(std::memory_order_acquire) == this->consumed.load(std::memory_order_relaxed);
+    }
+
+    struct Stats {
+        u64 submitted;       // emplaced, published or not
+        u64 executed;
+        u64 depth;           // commands waiting to run
+        u64 max_depth;       // highest depth seen when publishing
+        u64 avg_latency_ns;  // from emplacing to running
+        u64 max_latency_ns;
+    };
+
+    // producer
+    [[nodiscard]] Stats stats() const noexcept {
+        const u64 executed = this->consumed.load(std::memory_order_acquire);
+        return {
+            .submitted = this->write_pos,
+            .executed = executed,
+            .depth = this->write_pos - executed,
+            .max_depth = this->max_depth,
+            .avg_latency_ns = executed > 0 ? this->total_latency.load(std::memory_order_relaxed) / executed : 0,
+            .max_latency_ns = this->max_latency.load(std::memory_order_relaxed),
+        };
+    }
+
+   private:
+    static constexpr u64 MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0);
+
+    struct alignas(CACHE_LINE) Slot {
+        alignas(std::max_align_t) std::byte storage[INLINE_SIZE];
+        void (*run)(void *) noexcept;
+        void (*destroy)(void *) noexcept;
+        u64 enqueue_time;
+    };
+    static_assert(sizeof(Slot) == CACHE_LINE);
+
+    std::array<Slot, CAPACITY> slots;
+
+    // producer side
+    alignas(CACHE_LINE) u64 write_pos{0};
+    u64 cached_consumed{0};
+    u64 max_depth{0};
+    alignas(CACHE_LINE) std::atomic<u64> published{0};
+
+    // consumer side
+    alignas(CACHE_LINE) std::atomic<u64> consumed{0};
+    std::atomic<u64> total_latency{0};
+    std::atomic<u64> max_latency{0};
+};
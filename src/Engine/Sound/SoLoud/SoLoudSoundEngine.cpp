@@ -186,6 +186,8 @@ bool SoLoudSoundEngine::updateExistingSound(SoLoudSound *soloudSound, SOUNDHANDL
         }
     }
 
+    SoLoudThreadWrapper::Batch batch(*soloud);
+
     soloudSound->setHandleVolume(handle, soloudSound->getBaseVolume() * playVolume);
 
     // update existing handle in cache with new params
@@ -253,6 +255,8 @@ bool SoLoudSoundEngine::playSound(SoLoudSound *soloudSound, f32 pan, f32 pitch,
 
     const bool debug = cv::debug_snd.getBool();
 
+    SoLoudThreadWrapper::Batch batch(*soloud);
+
     if(!soloudSound->bStream) {
         // calculate final pitch by combining all pitch modifiers
         float playbackPitch = pitch * soloudSound->getPitch() * soloudSound->getSpeed();
@@ -501,6 +505,7 @@ void SoLoudSoundEngine::allowInternalCallbacks() {
     // convar callbacks
     cv::snd_freq.setCallback(SA::MakeDelegate<&SoLoudSoundEngine::restart>(this));
     cv::cmd::snd_restart.setCallback(SA::MakeDelegate<&SoLoudSoundEngine::restart>(this));
+    cv::cmd::snd_soloud_queue_stats.setCallback(SA::MakeDelegate<&SoLoudSoundEngine::printQueueStats>(this));
 
     static auto backendSwitchCB = [](std::string_view arg) -> void {
         if(!soundEngine || soundEngine->getTypeId() != SndEngineType::SOLOUD) return;
@@ -556,6 +561,7 @@ SoLoudSoundEngine::~SoLoudSoundEngine() {
     soloud.reset();
     cv::snd_freq.removeCallback();
     cv::cmd::snd_restart.removeCallback();
+    cv::cmd::snd_soloud_queue_stats.removeCallback();
     cv::snd_soloud_backend.removeCallback();
     cv::snd_sanity_simultaneous_limit.removeCallback();
     cv::snd_output_device.removeCallback();
@@ -581,6 +587,20 @@ void SoLoudSoundEngine::setVolumeGradual(SOUNDHANDLE handle, float targetVol, fl
     soloud->fadeVolume(handle, targetVol, fadeTimeMs / 1000.0f);
 }
 
+void SoLoudSoundEngine::printQueueStats() {
+    if(!soloud || !soloud->isThreaded()) {
+        debugLog("not running with -sound soloud-threaded, no command queue");
+        return;
+    }
+
+    const auto stats = soloud->getCommandStats();
+    debugLog("commands: {} submitted, {} executed, {} pending (max {})", stats.ring.submitted, stats.ring.executed,
+             stats.ring.depth, stats.ring.max_depth);
+    debugLog("latency: {:.3f}ms avg, {:.3f}ms max", stats.ring.avg_latency_ns / 1e6, stats.ring.max_latency_ns / 1e6);
+    debugLog("{} boxed, {} stalled on a full queue, {} from other threads", stats.boxed, stats.full_stalls,
+             stats.other_thread);
+}
+
 void SoLoudSoundEngine::updateOutputDevices(bool printInfo) {
     if(!this->isReady())  // soloud needs to be initialized first
         return;
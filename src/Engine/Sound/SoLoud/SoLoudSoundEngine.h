@@ -52,6 +52,7 @@ class SoLoudSoundEngine final : public SoundEngine {
                              bool startPaused);
 
     void setVolumeGradual(SOUNDHANDLE handle, float targetVol, float fadeTimeMs = 10.0f);
+    void printQueueStats();
     void updateOutputDevices(bool printInfo) override;
 
     bool initializeOutputDevice(const OUTPUT_DEVICE &device) override;
@@ -4,11 +4,13 @@
 
 #ifdef MCENGINE_FEATURE_SOLOUD
 
+#include "Profiler.h"
 #include "Thread.h"
 #include "Timing.h"
 #include "SyncCV.h"
 #include "SyncJthread.h"
 #include "UString.h"
+#include "SoLoudCommandRing.h"
 
 #include "soloud.h"
 
@@ -18,6 +20,7 @@
 #include <functional>
 #include <chrono>
 #include <cassert>
+#include <optional>
 
 class SoLoudThreadWrapper {
     NOCOPY_NOMOVE(SoLoudThreadWrapper)
@@ -61,8 +64,34 @@ class SoLoudThreadWrapper {
     };
 
    public:
+    struct CommandStats {
+        SoLoudCommandRing::Stats ring;
+        u64 boxed;         // too large to be stored inline in the ring
+        u64 full_stalls;   // submissions that had to wait for the audio thread to make room
+        u64 other_thread;  // submitted from outside the main thread, through the locked queue
+    };
+
+    // fire-and-forget calls made while a Batch is alive are handed to the audio thread all at once when it goes out of
+    // scope (synchronous calls still go through immediately, along with everything batched before them)
+    class Batch {
+        NOCOPY_NOMOVE(Batch)
+       public:
+        Batch(SoLoudThreadWrapper &wrapper) noexcept
+            : wrapper(wrapper), active(wrapper.threaded && McThread::is_main_thread()) {
+            if(this->active) this->wrapper.batch_depth++;
+        }
+        ~Batch() noexcept {
+            if(this->active && --this->wrapper.batch_depth == 0) this->wrapper.publish_and_wake();
+        }
+
+       private:
+        SoLoudThreadWrapper &wrapper;
+        bool active;
+    };
+
     SoLoudThreadWrapper(bool threaded = false) noexcept : threaded(threaded) {
         if(this->threaded) {
+            this->ring = std::make_unique<SoLoudCommandRing>();
             this->start_worker_thread();
         } else {
             this->soloud = std::make_unique<SoLoud::Soloud>();
@@ -87,29 +116,32 @@ class SoLoudThreadWrapper {
         if(likely(!this->threaded)) return func();
         using ReturnType = std::invoke_result_t<F>;
 
-        if constexpr(std::is_void_v<ReturnType>) {
-            auto task = std::make_unique<Task<void>>(std::forward<F>(func));
-            auto future = task->get_future();
-
-            {
-                Sync::scoped_lock lock(queue_mutex);
-                this->task_queue.push(std::move(task));
-            }
-            this->queue_cv.notify_one();
-
-            future.wait();
-        } else {
+        if(!McThread::is_main_thread()) {
             auto task = std::make_unique<Task<ReturnType>>(std::forward<F>(func));
             auto future = task->get_future();
-
-            {
-                Sync::scoped_lock lock(queue_mutex);
-                this->task_queue.push(std::move(task));
-            }
-            this->queue_cv.notify_one();
-
+            this->submit_locked(std::move(task));
             return future.get();
         }
+
+        // we block until it ran, so the function and its result can stay on our stack
+        const u32 ticket = this->sync_done.load(std::memory_order_relaxed);
+        if constexpr(std::is_void_v<ReturnType>) {
+            this->submit([&func, this]() noexcept {
+                func();
+                this->signal_sync_done();
+            });
+            this->publish_and_wake();
+            this->wait_sync_done(ticket);
+        } else {
+            std::optional<ReturnType> result;
+            this->submit([&func, &result, this]() noexcept {
+                result.emplace(func());
+                this->signal_sync_done();
+            });
+            this->publish_and_wake();
+            this->wait_sync_done(ticket);
+            return *std::move(result);
+        }
     }
 
     // for future reference: example for async play for cases where we don't need the handle immediately
@@ -145,12 +177,7 @@ class SoLoudThreadWrapper {
 
         auto task = std::make_unique<Task<ReturnType>>(std::forward<F>(func));
         auto future = task->get_future();
-
-        {
-            Sync::scoped_lock lock(queue_mutex);
-            this->task_queue.push(std::move(task));
-        }
-        this->queue_cv.notify_one();
+        this->submit_task(std::move(task));
 
         return future;
     }
@@ -162,13 +189,13 @@ class SoLoudThreadWrapper {
             func();
             return;
         }
-        auto task = std::make_unique<FireAndForgetTask>(std::forward<F>(func));
-
-        {
-            Sync::scoped_lock lock(queue_mutex);
-            this->task_queue.push(std::move(task));
+        if(!McThread::is_main_thread()) {
+            this->submit_locked(std::make_unique<FireAndForgetTask>(std::forward<F>(func)));
+            return;
         }
-        this->queue_cv.notify_one();
+
+        this->submit(std::forward<F>(func));
+        if(this->batch_depth == 0) this->publish_and_wake();
     }
 
     // convenience passthroughs for the current methods we need
@@ -192,12 +219,7 @@ class SoLoudThreadWrapper {
                 return this->init_with_name(aFlags, aBackend, aSamplerate, aBufferSize, aChannels);
             });
         auto future = task->get_future();
-
-        {
-            Sync::scoped_lock lock(queue_mutex);
-            this->task_queue.push(std::move(task));
-        }
-        this->queue_cv.notify_one();
+        this->submit_task(std::move(task));
 
         // wait with 10 second timeout
         if(future.wait_for(std::chrono::seconds(10)) == std::future_status::timeout) {
@@ -354,9 +376,90 @@ class SoLoudThreadWrapper {
 
     [[nodiscard]] constexpr bool isThreaded() const { return this->threaded; }
 
+    // must be called from the main thread
+    [[nodiscard]] CommandStats getCommandStats() const {
+        if(!this->ring) return {};
+        return {
+            .ring = this->ring->stats(),
+            .boxed = this->nb_boxed,
+            .full_stalls = this->nb_full_stalls,
+            .other_thread = this->nb_other_thread.load(std::memory_order_relaxed),
+        };
+    }
+
    private:
+    // main thread only: queues func in the ring without publishing it
+    template <typename F>
+    void submit(F &&func) {
+        if constexpr(SoLoudCommandRing::fits<F>) {
+            this->emplace_blocking(std::forward<F>(func));
+        } else {
+            this->nb_boxed++;
+            this->emplace_blocking(
+                [fn = std::make_unique<std::decay_t<F>>(std::forward<F>(func))]() noexcept { (*fn)(); });
+        }
+    }
+
+    template <typename F>
+    void emplace_blocking(F &&func) {
+        if(likely(this->ring->try_emplace(std::forward<F>(func)))) return;
+
+        // full: let the audio thread catch up (try_emplace doesn't consume func on failure)
+        this->nb_full_stalls++;
+        do {
+            this->publish_and_wake();
+            Timing::tinyYield();
+        } while(!this->ring->try_emplace(std::forward<F>(func)));
+    }
+
+    // for tasks that are already heap-allocated anyway (because they carry a promise)
+    void submit_task(std::unique_ptr<TaskBase> task) {
+        if(!McThread::is_main_thread()) {
+            this->submit_locked(std::move(task));
+            return;
+        }
+
+        this->submit([task = std::move(task)]() noexcept { task->execute(); });
+        this->publish_and_wake();
+    }
+
+    // for other threads, which can't use the ring since it only has a single producer
+    void submit_locked(std::unique_ptr<TaskBase> task) {
+        this->nb_other_thread.fetch_add(1, std::memory_order_relaxed);
+        {
+            Sync::scoped_lock lock(this->queue_mutex);
+            this->task_queue.push(std::move(task));
+        }
+        this->queue_cv.notify_one();
+    }
+
+    void publish_and_wake() {
+        if(!this->ring->publish()) return;
+
+        // pairs with the fence in worker_loop: either we see that the worker went to sleep, or it sees our commands
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(this->worker_sleeping.load(std::memory_order_relaxed)) {
+            // the worker checks the ring under the lock before waiting, so this can't slip in between
+            { Sync::scoped_lock lock(this->queue_mutex); }
+            this->queue_cv.notify_one();
+        }
+    }
+
+    void signal_sync_done() noexcept {
+        this->sync_done.fetch_add(1, std::memory_order_release);
+        this->sync_done.notify_one();
+    }
+
+    void wait_sync_done(u32 ticket) noexcept {
+        while(this->sync_done.load(std::memory_order_acquire) == ticket) {
+            this->sync_done.wait(ticket, std::memory_order_acquire);
+        }
+    }
+
     void start_worker_thread() {
-        this->worker_thread = Sync::jthread([this](const Sync::stop_token &stoken) { this->worker_loop(stoken); });
+        this->worker_thread = Sync::jthread([this, ring = this->ring.get()](const Sync::stop_token &stoken) {
+            this->worker_loop(stoken, *ring);
+        });
 
         // wait for initialization to complete
         Sync::unique_lock lock(this->init_mutex);
@@ -397,13 +500,18 @@ class SoLoudThreadWrapper {
             }
         }
 
+        // the hung thread would still drain the old ring if it ever wakes up, so it can't be freed or reused
+        (void)this->ring.release();
+        this->ring = std::make_unique<SoLoudCommandRing>();
+        this->worker_sleeping.store(false, std::memory_order_relaxed);
+
         // reset state and start a new worker
         this->initialized = false;
 
         this->start_worker_thread();
     }
 
-    void worker_loop(const Sync::stop_token &stoken) noexcept {
+    void worker_loop(const Sync::stop_token &stoken, SoLoudCommandRing &commands) noexcept {
         McThread::set_current_thread_name(US_("soloud_mixer"));
         McThread::set_current_thread_prio(McThread::Priority::REALTIME);  // raise priority to the max
 
@@ -419,30 +527,38 @@ class SoLoudThreadWrapper {
 
         // main processing loop
         while(!stoken.stop_requested()) {
-            Sync::unique_lock lock(this->queue_mutex);
+            commands.drain();
 
-            // wait for tasks or stop signal
-            this->queue_cv.wait(lock, [&stoken, &task_queue = this->task_queue] {
-                return !task_queue.empty() || stoken.stop_requested();
-            });
+            Sync::unique_lock lock(this->queue_mutex);
 
-            // process all available tasks
-            while(!this->task_queue.empty() && !stoken.stop_requested()) {
-                auto task = std::move(this->task_queue.front());
-                this->task_queue.pop();
+            // tasks from other threads
+            if(!this->task_queue.empty()) {
+                auto tasks = std::exchange(this->task_queue, {});
 
-                // unlock while executing task
+                // unlock while executing tasks
                 lock.unlock();
-                task->execute();
-                lock.lock();
+                VPROF_TRACE("SoLoudThread::tasks");
+                while(!tasks.empty()) {
+                    tasks.front()->execute();
+                    tasks.pop();
+                }
 
                 // small yield to avoid stealing 100% cpu
                 Timing::tinyYield();
+                continue;
             }
-            Timing::tinyYield();
+
+            // wait for tasks or stop signal
+            this->worker_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            this->queue_cv.wait(lock, [&stoken, &commands, &task_queue = this->task_queue] {
+                return !commands.empty() || !task_queue.empty() || stoken.stop_requested();
+            });
+            this->worker_sleeping.store(false, std::memory_order_relaxed);
         }
 
         // cleanup/process remaining tasks before shutdown
+        commands.drain();
         while(!this->task_queue.empty()) {
             auto task = std::move(this->task_queue.front());
             this->task_queue.pop();
@@ -468,10 +584,21 @@ class SoLoudThreadWrapper {
 
     std::unique_ptr<SoLoud::Soloud> soloud{nullptr};
 
-    // task queue
+    // commands from the main thread
+    std::unique_ptr<SoLoudCommandRing> ring{nullptr};
+    std::atomic<bool> worker_sleeping{false};
+    std::atomic<u32> sync_done{0};
+    u32 batch_depth{0};
+
+    // main thread only
+    u64 nb_boxed{0};
+    u64 nb_full_stalls{0};
+
+    // task queue for other threads (also used to wake the worker up)
     std::queue<std::unique_ptr<TaskBase>> task_queue;
     mutable Sync::mutex queue_mutex;
     Sync::condition_variable queue_cv;
+    std::atomic<u64> nb_other_thread{0};
 
     // init/shutdown signaling
 
@@ -2,6 +2,7 @@
 
 #include "Thread.h"
 #include "Logging.h"
+#include "Profiler.h"
 #include "UString.h"
 
 #include <SDL3/SDL_init.h>
@@ -98,6 +99,7 @@ void on_thread_init() noexcept {
 // WARNING: must be called from within the thread itself! otherwise, the main process name will be changed
 bool set_current_thread_name(const UString &name) noexcept {
     (void)name;  // may be unused on some platforms
+    Profiling::Trace::onCurrentThreadNamed(name.toUtf8());
 #if defined(_WIN32)
     try_load_funcs();
     if(pset_thread_desc) {
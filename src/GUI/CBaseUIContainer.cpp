@@ -14,6 +14,7 @@ CBaseUIContainer::~CBaseUIContainer() { this->freeElements(); }
 
 // free memory from children
 void CBaseUIContainer::freeElements() {
+    this->elementsGeneration++;
     for(ssize_t i = static_cast<ssize_t>(this->vElements.size()) - 1; i >= 0; --i) {
         CBaseUIElement *toDelete = this->vElements[i];
         this->vElements.erase(this->vElements.begin() + i);
@@ -22,7 +23,10 @@ void CBaseUIContainer::freeElements() {
 }
 
 // invalidate children without freeing memory
-void CBaseUIContainer::invalidate() { this->vElements.clear(); }
+void CBaseUIContainer::invalidate() {
+    this->vElements.clear();
+    this->elementsGeneration++;
+}
 
 CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element, float xPos, float yPos) {
     if(element == nullptr) return this;
@@ -30,6 +34,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element, fl
     element->setRelPos(xPos, yPos);
     element->setPos(this->rect.getPos() + element->relRect.getPos());
     this->vElements.push_back(element);
+    this->elementsGeneration++;
 
     return this;
 }
@@ -40,6 +45,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElement(CBaseUIElement *element) {
     element->relRect.setPos(element->rect.getPos());
     element->setPos(this->rect.getPos() + element->relRect.getPos());
     this->vElements.push_back(element);
+    this->elementsGeneration++;
 
     return this;
 }
@@ -50,6 +56,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElementBack(CBaseUIElement *element
     element->setRelPos(xPos, yPos);
     element->setPos(this->rect.getPos() + element->relRect.getPos());
     this->vElements.insert(this->vElements.begin(), element);
+    this->elementsGeneration++;
 
     return this;
 }
@@ -60,6 +67,7 @@ CBaseUIContainer *CBaseUIContainer::addBaseUIElementBack(CBaseUIElement *element
     element->relRect.setPos(element->rect.getPos());
     element->setPos(this->rect.getPos() + element->relRect.getPos());
     this->vElements.insert(this->vElements.begin(), element);
+    this->elementsGeneration++;
 
     return this;
 }
@@ -74,6 +82,7 @@ CBaseUIContainer *CBaseUIContainer::insertBaseUIElement(CBaseUIElement *element,
             this->vElements.insert(
                 this->vElements.begin() + std::clamp<ssize_t>(i, 0, static_cast<ssize_t>(this->vElements.size())),
                 element);
+            this->elementsGeneration++;
             return this;
         }
     }
@@ -93,6 +102,7 @@ CBaseUIContainer *CBaseUIContainer::insertBaseUIElementBack(CBaseUIElement *elem
             this->vElements.insert(
                 this->vElements.begin() + std::clamp<ssize_t>(i + 1, 0, static_cast<ssize_t>(this->vElements.size())),
                 element);
+            this->elementsGeneration++;
             return this;
         }
     }
@@ -106,6 +116,7 @@ CBaseUIContainer *CBaseUIContainer::removeBaseUIElement(CBaseUIElement *element)
     for(ssize_t i = 0; i < this->vElements.size(); i++) {
         if(this->vElements[i] == element) {
             this->vElements.erase(this->vElements.begin() + i);
+            this->elementsGeneration++;
             return this;
         }
     }
@@ -120,6 +131,7 @@ CBaseUIContainer *CBaseUIContainer::deleteBaseUIElement(CBaseUIElement *element)
         if(this->vElements[i] == element) {
             delete element;
             this->vElements.erase(this->vElements.begin() + i);
+            this->elementsGeneration++;
             return this;
         }
     }
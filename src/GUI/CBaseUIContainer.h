@@ -1,6 +1,7 @@
 #pragma once
 // Copyright (c) 2011, PG, All rights reserved.
 #include "CBaseUIElement.h"
+#include "types.h"
 
 class CBaseUIContainer : public CBaseUIElement {
     NOCOPY_NOMOVE(CBaseUIContainer)
@@ -51,7 +52,8 @@ class CBaseUIContainer : public CBaseUIElement {
     void onEnabled() override;
     void onDisabled() override;
 
-    void update_pos();
+    // call after moving/resizing elements with setRelPos() etc.
+    virtual void update_pos();
 
     // don't use this blindly, make sure that you haven't added anything that isn't compatible with T to the container!
     template <typename T = CBaseUIElement>
@@ -63,4 +65,7 @@ class CBaseUIContainer : public CBaseUIElement {
 
    protected:
     std::vector<CBaseUIElement *> vElements;
+
+    // bumped whenever vElements changes, so that derived containers can cheaply tell if cached per-element data is stale
+    u32 elementsGeneration{0};
 };
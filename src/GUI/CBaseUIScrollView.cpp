@@ -59,6 +59,74 @@ void ScrollContainer::invalidate() {
     CBaseUIContainer::invalidate();
 }
 
+void ScrollContainer::updateYIndex() {
+    if(!this->bYIndexDirty && this->yIndexGeneration == this->elementsGeneration) return;
+
+    this->bYIndexDirty = false;
+    this->yIndexGeneration = this->elementsGeneration;
+
+    this->yIndex.clear();
+    this->yIndex.reserve(this->vElements.size());
+    for(u32 i = 0; i < this->vElements.size(); i++) {
+        auto *e = this->vElements[i];
+        const f32 top = e->getRelPos().y;
+        this->yIndex.push_back({.top = top, .bottom = top + e->getSize().y, .order = i, .element = e});
+    }
+    std::ranges::sort(this->yIndex, {}, &YIndexEntry::top);
+
+    this->yIndexSlots.resize(this->yIndex.size());
+    for(u32 i = 0; i < this->yIndex.size(); i++) {
+        this->yIndexSlots[this->yIndex[i].order] = i;
+    }
+
+    this->yIndexMaxBottom.resize(this->yIndex.size());
+    for(uSz i = 0; i < this->yIndex.size(); i++) {
+        this->yIndexMaxBottom[i] =
+            (i == 0 ? this->yIndex[i].bottom : std::max(this->yIndexMaxBottom[i - 1], this->yIndex[i].bottom));
+    }
+}
+
+void ScrollContainer::update_pos() {
+    CBaseUIContainer::update_pos();
+    if(this->isYIndexStale()) return;
+
+    // elements can be moved anywhere (e.g. from far off-screen into view), so check all of them, not just the ones
+    // which are currently near the viewport
+    for(u32 i = 0; i < this->vElements.size(); i++) {
+        const auto *e = this->vElements[i];
+        const YIndexEntry &entry = this->yIndex[this->yIndexSlots[i]];
+        const f32 top = e->getRelPos().y;
+        if(std::abs(top - entry.top) > 1.f || std::abs(top + e->getSize().y - entry.bottom) > 1.f) {
+            this->bYIndexDirty = true;
+            return;
+        }
+    }
+}
+
+void ScrollContainer::queryYIndex(f32 top, f32 bottom, std::vector<CBaseUIElement *> &out) {
+    this->updateYIndex();
+
+    // everything before first ends above the range, everything from last on starts below it
+    const auto first = std::ranges::lower_bound(this->yIndexMaxBottom, top) - this->yIndexMaxBottom.begin();
+    const auto last = std::ranges::upper_bound(this->yIndex, bottom, {}, &YIndexEntry::top) - this->yIndex.begin();
+
+    this->yIndexHits.clear();
+    for(auto i = first; i < last; i++) {
+        const YIndexEntry &entry = this->yIndex[i];
+        if(entry.bottom < top) continue;
+
+        // elements moved without a setScrollSizeToContent(), pick that up on the next query
+        if(std::abs(entry.element->getRelPos().y - entry.top) > 1.f) this->bYIndexDirty = true;
+
+        this->yIndexHits.push_back(&entry);
+    }
+
+    std::ranges::sort(this->yIndexHits, {}, &YIndexEntry::order);
+    for(const auto *entry : this->yIndexHits) {
+        out.push_back(entry->element);
+    }
+}
+
 void ScrollContainer::update(CBaseUIEventCtx &c) {
     // intentionally not calling parent
     CBaseUIElement::update(c);
@@ -84,11 +152,20 @@ void ScrollContainer::draw() {
     this->invalidateUpdate = false;
 
     // if we were invalidated in the update() in this frame, clipping (elements to draw) will not have been updated
-    // if there's a manageable amount of elements in the full vElements array, then just temporarily use the unoptimized
-    // path of iterating over all of them to avoid 1 frame of flicker
+    // in that case, look up whatever overlaps the viewport in the y index to avoid 1 frame of flicker
+    // if the index is stale as well (contents just changed) and there's a manageable amount of elements in the full
+    // vElements array, then just temporarily use the unoptimized path of iterating over all of them
     // otherwise draw only pre-clipped elements
-    if(this->vVisibleElements.size() < 3 && this->vElements.size() < 1024) {
-        for(auto *e : this->vElements) {
+    const bool yIndexStale = this->isYIndexStale();
+    if(this->vVisibleElements.size() < 3 && (!yIndexStale || this->vElements.size() < 1024)) {
+        const std::vector<CBaseUIElement *> *elements = &this->vElements;
+        if(!yIndexStale) {
+            this->vClippingCandidates.clear();
+            this->queryYIndex(this->fViewTop, this->fViewBottom, this->vClippingCandidates);
+            elements = &this->vClippingCandidates;
+        }
+
+        for(auto *e : *elements) {
             if(e->isVisible() && e->isVisibleOnScreen()) {
                 e->draw();
             }
@@ -201,6 +278,8 @@ void CBaseUIScrollView::draw() {
         g->pushClipRect(clip_rect);
     }
 
+    this->container.fViewTop = this->getPos().y - this->container.getPos().y;
+    this->container.fViewBottom = this->container.fViewTop + this->getSize().y;
     this->container.draw();
 
     if(this->bDrawScrollbars) {
@@ -482,6 +561,9 @@ void CBaseUIScrollView::update(CBaseUIEventCtx &c) {
         this->updateScrollbars();
     }
 
+    // elements were added/removed/moved, which clipping has to pick up even without scrolling
+    if(this->container.isYIndexStale()) this->bClippingDirty = true;
+
     if(this->bClippingDirty) this->updateClipping();
 }
 
@@ -667,7 +749,7 @@ void CBaseUIScrollView::updateClipping() {
                             2.f * this->getSize().y >= this->vScrollPos.y + this->vScrollSize.y);  // overscroll, bottom
     // don't use cached clipping near top/bottom bounds because we might have set some elements as invisible without replacing them
 
-    bool foundDifferent = !useCache;
+    bool foundDifferent = !useCache || this->container.isYIndexStale();
 
     if(useCache) {
         for(auto *e : visibleElems) {
@@ -680,9 +762,26 @@ void CBaseUIScrollView::updateClipping() {
     }
 
     if(foundDifferent) {
-        bool eVisible{false}, nowVisible{false};
+        // if elements were added/removed/moved, walk all of them once (this also hides new off-screen elements)
+        // otherwise (i.e. just scrolling), only elements overlapping the expanded rect vertically can possibly be
+        // visible, so get those from the y index instead of walking every element
+        const bool fullScan = this->container.isYIndexStale();
+
+        auto &candidates = this->container.vClippingCandidates;
+        candidates.clear();
+        if(!fullScan) {
+            const f32 containerY = this->container.getPos().y;
+            this->container.queryYIndex(expandedMe.getY() - containerY,
+                                        expandedMe.getY() + expandedMe.getHeight() - containerY, candidates);
+        }
+
+        auto &prevVisibleElems = this->container.vPrevVisibleElements;
+        prevVisibleElems.clear();
+        if(!fullScan) prevVisibleElems.swap(visibleElems);
         visibleElems.clear();  // rebuild
-        for(auto *e : elements) {
+
+        bool eVisible{false}, nowVisible{false};
+        for(auto *e : (fullScan ? elements : candidates)) {
             eVisible = nowVisible = e->isVisible();
             //numVisElements += eVisible;
             if(expandedMe.intersects(e->getRect())) {
@@ -703,6 +802,29 @@ void CBaseUIScrollView::updateClipping() {
                 visibleElems.push_back(e);
             }
         }
+
+        // previously visible elements which aren't candidates anymore have scrolled out of view
+        // (or moved without the index knowing about it, in which case keep them)
+        if(!prevVisibleElems.empty()) {
+            auto &sortedVisibleElems = candidates;  // done with these
+            sortedVisibleElems.assign(visibleElems.begin(), visibleElems.end());
+            std::ranges::sort(sortedVisibleElems);
+
+            for(auto *e : prevVisibleElems) {
+                if(std::ranges::binary_search(sortedVisibleElems, e) || !e->isVisible()) continue;
+
+                if(expandedMe.intersects(e->getRect())) {
+                    visibleElems.push_back(e);
+                    this->container.bYIndexDirty = true;
+                } else {
+                    e->setVisible(false);
+                    ++numChangedElements;
+                }
+            }
+            prevVisibleElems.clear();
+        }
+
+        if(fullScan) this->container.updateYIndex();
     }
 
     if(!numChangedElements) {
@@ -785,6 +907,7 @@ CBaseUIScrollView *CBaseUIScrollView::setScrollSizeToContent(int border) {
     this->vScrollSize.y += border;
 
     this->container.setSize(this->vScrollSize);
+    this->container.bYIndexDirty = true;
 
     // TODO: duplicate code, ref onResized(), but can't call onResized() due to possible endless recursion if
     // setScrollSizeToContent() within onResized() HACKHACK: shit code
@@ -853,6 +976,7 @@ void CBaseUIScrollView::onDisabled() {
 
 void CBaseUIScrollView::onResized() {
     this->bClippingDirty = true;
+    this->container.bYIndexDirty = true;
 
     this->container.setSize(this->vScrollSize);
 
@@ -161,6 +161,11 @@ class CBaseUIScrollView : public CBaseUIElement {
         bool isBusy() override;
         bool isActive() override;
 
+        // also marks the y index dirty if any element was moved or resized since it was built
+        void update_pos() override;
+        // scrolling only moves the container as a whole, that doesn't need to check the y index
+        void onMoved() override { CBaseUIContainer::update_pos(); }
+
         inline void setDrawOrderComparatorFunc(DrawOrderComparator comparator) { this->drawOrderCmp = comparator; }
 
        private:
@@ -173,6 +178,39 @@ class CBaseUIScrollView : public CBaseUIElement {
         // this is kind of a hack to avoid iterating over a bunch of not-visible elements
         std::vector<CBaseUIElement *> vVisibleElements;
 
+        // ordered y-interval index over vElements (relative positions), so that clipping and drawing only have to
+        // look at the elements overlapping the viewport instead of all of them
+        // rebuilt lazily after elements were added/removed, or after a relayout (see update_pos() and
+        // setScrollSizeToContent(), one of which has to be called after moving elements)
+        struct YIndexEntry {
+            f32 top;
+            f32 bottom;
+            u32 order;  // index in vElements, to keep the insertion/draw order
+            CBaseUIElement *element;
+        };
+        std::vector<YIndexEntry> yIndex;
+        std::vector<f32> yIndexMaxBottom;  // running maximum of bottom, monotonic so it can be binary searched
+        std::vector<u32> yIndexSlots;  // position of each element (in vElements order) in yIndex
+        std::vector<const YIndexEntry *> yIndexHits;
+        u32 yIndexGeneration{0};
+        bool bYIndexDirty{true};
+
+        void updateYIndex();
+        [[nodiscard]] inline bool isYIndexStale() const {
+            return this->bYIndexDirty || this->yIndexGeneration != this->elementsGeneration;
+        }
+
+        // appends all elements whose y interval overlaps [top, bottom] (relative to the container), in vElements order
+        void queryYIndex(f32 top, f32 bottom, std::vector<CBaseUIElement *> &out);
+
+        // viewport relative to the container, set by the scrollview before drawing
+        f32 fViewTop{0.f};
+        f32 fViewBottom{0.f};
+
+        // scratch space, to avoid reallocating every clipping update/draw
+        std::vector<CBaseUIElement *> vClippingCandidates;
+        std::vector<CBaseUIElement *> vPrevVisibleElements;
+
         // we need to break out of certain iteration loops (e.g. update()) if the container we're iterating through has been cleared
         bool invalidateUpdate{false};
     };
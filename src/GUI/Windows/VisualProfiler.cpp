@@ -6,7 +6,9 @@
 #include "ConVarHandler.h"
 #include "Engine.h"
 #include "Environment.h"
+#include "File.h"
 #include "Keyboard.h"
+#include "Logging.h"
 #include "Mouse.h"
 #include "Profiler.h"
 #include "ResourceManager.h"
@@ -17,6 +19,7 @@
 #include "VertexArrayObject.h"
 #include "SysMon.h"
 
+#include <algorithm>
 #include <cstring>
 
 namespace cv {
@@ -259,6 +262,46 @@ void VisualProfiler::draw() {
 
                     if(this->appTextLines.size() < 1) addTextLine("(Empty)", textFont, this->textLines);
                 } break;
+
+                case INFO_BLADE_DISPLAY_MODE::RENDER_INFO: {
+                    textFont = this->fontConsole;
+                    textScale = std::round(env->getDPIScale() + 0.255f);
+
+                    const DrawStats &stats = g->getDrawStats();
+                    const f64 gpuTime = g->getGPUFrameTime();
+
+                    addTextLine(US_("Last frame:"), {}, textFont, this->textLines);
+                    addTextLine(US_("GPU Time:"), gpuTime < 0.0 ? US_("n/a") : fmt::format("{:.3f} ms"_cf, gpuTime),
+                                textFont, this->textLines);
+                    addTextLine(US_("Draw Calls:"), fmt::format("{:d}"_cf, stats.draw_calls), textFont,
+                                this->textLines);
+                    addTextLine(US_("Vertices:"), fmt::format("{:d}"_cf, stats.vertices), textFont, this->textLines);
+                    addTextLine(US_("Texture Binds:"), fmt::format("{:d}"_cf, stats.texture_binds), textFont,
+                                this->textLines);
+                    addTextLine(US_("Shader Switches:"), fmt::format("{:d}"_cf, stats.shader_switches), textFont,
+                                this->textLines);
+                    addTextLine(US_("RT Switches:"), fmt::format("{:d}"_cf, stats.render_target_switches), textFont,
+                                this->textLines);
+                    addTextLine(US_("Uploaded:"), fmt::format("{:.1f} KB"_cf, stats.uploaded_bytes / 1024.0), textFont,
+                                this->textLines);
+                    addTextLine(US_("Batched Quads:"), fmt::format("{:d}"_cf, stats.batched_quads), textFont,
+                                this->textLines);
+                    addTextLine(US_("Batched Text:"), fmt::format("{:d}"_cf, stats.batched_text), textFont,
+                                this->textLines);
+                    addTextLine(US_("Batch Flushes:"), fmt::format("{:d}"_cf, stats.state_changes), textFont,
+                                this->textLines);
+
+                    // scopes include their children
+                    addTextLine({}, textFont, this->textLines);
+                    addTextLine(US_("Draw calls by scope:"), {}, textFont, this->textLines);
+                    for(const NODE &node : this->renderNodes) {
+                        const DrawStats &nodeStats = node.node->getDrawStatsLastFrame();
+                        addTextLine(UString{node.node->getName()},
+                                    fmt::format("{:d} ({:d} verts)"_cf, nodeStats.draw_calls, nodeStats.vertices),
+                                    textFont, this->textLines);
+                    }
+                    if(this->renderNodes.empty()) addTextLine("(Empty)", textFont, this->textLines);
+                } break;
                 default:
                     break;
             }
@@ -499,6 +542,30 @@ void VisualProfiler::update(CBaseUIEventCtx &c) {
         this->infoGatherer->update();
     }
 
+    const bool showRenderInfo =
+        cv::vprof_display_mode.getVal<INFO_BLADE_DISPLAY_MODE>() == INFO_BLADE_DISPLAY_MODE::RENDER_INFO;
+    if(showRenderInfo || cv::vprof_render_csv.getBool()) {
+        SPIKE unused{};
+        this->renderNodes.clear();
+        collectProfilerNodesRecursive(this->profile->getRoot(), 0, this->renderNodes, unused);
+    }
+
+    if(cv::vprof_render_csv.getBool()) {
+        this->writeRenderStatsCsv();
+    } else if(this->renderStatsCsv) {
+        this->renderStatsCsv.reset();
+    }
+
+    if(showRenderInfo) {
+        // only keep the ones which drew anything, and don't let the list grow off the screen
+        std::erase_if(this->renderNodes,
+                      [](const NODE &node) { return node.node->getDrawStatsLastFrame().draw_calls == 0; });
+        std::ranges::stable_sort(this->renderNodes, std::ranges::greater{}, [](const NODE &node) {
+            return node.node->getDrawStatsLastFrame().draw_calls;
+        });
+        if(this->renderNodes.size() > 16) this->renderNodes.resize(16);
+    }
+
     const bool isFrozen = (keyboard->isShiftDown() && (!this->bRequiresAltShiftKeysToFreeze || keyboard->isAltDown()));
 
     if(cv::debug_vprof.getBool() || cv::vprof_spike.getBool()) {
@@ -723,6 +790,39 @@ void VisualProfiler::setProfile(ProfilerProfile *profile) {
 
 bool VisualProfiler::isEnabled() { return cv::vprof.getBool(); }
 
+void VisualProfiler::writeRenderStatsCsv() {
+    if(!this->renderStatsCsv) {
+        const std::string path = MCENGINE_DATA_DIR "vprof_render_stats.csv";
+        this->renderStatsCsv = std::make_unique<File>(path, File::MODE::WRITE);
+        if(!this->renderStatsCsv->canWrite()) {
+            debugLog("Failed to open {:s}, disabling vprof_render_csv", path);
+            this->renderStatsCsv.reset();
+            cv::vprof_render_csv.setValue(false);
+            return;
+        }
+
+        this->renderStatsCsv->writeLine(
+            "frame,scope,group,cpu_ms,gpu_ms,draw_calls,vertices,texture_binds,shader_switches,render_target_switches,"
+            "uploaded_bytes,batched_quads,batched_text,state_changes");
+    }
+
+    const auto writeRow = [&](std::string_view scope, std::string_view group, f64 cpuTime, f64 gpuTime,
+                              const DrawStats &stats) {
+        this->renderStatsCsv->writeLine(fmt::format(
+            "{:d},{:s},{:s},{:.4f},{:s},{:d},{:d},{:d},{:d},{:d},{:d},{:d},{:d},{:d}", engine->getFrameCount(), scope,
+            group, cpuTime * 1000.0, gpuTime < 0.0 ? std::string{} : fmt::format("{:.4f}", gpuTime), stats.draw_calls,
+            stats.vertices, stats.texture_binds, stats.shader_switches, stats.render_target_switches,
+            stats.uploaded_bytes, stats.batched_quads, stats.batched_text, stats.state_changes));
+    };
+
+    // whole frame first, then every scope (the scope numbers are cpu-side only, and include their children)
+    writeRow("Frame", "", engine->getFrameTime(), g->getGPUFrameTime(), g->getDrawStats());
+    for(const NODE &node : this->renderNodes) {
+        writeRow(node.node->getName(), this->profile->getGroupName(node.node->getGroupID()),
+                 node.node->getTimeLastFrame(), -1.0, node.node->getDrawStatsLastFrame());
+    }
+}
+
 void VisualProfiler::collectProfilerNodesRecursive(const ProfilerNode *node, int depth, std::vector<NODE> &nodes,
                                                    SPIKE &spike) {
     if(node == nullptr) return;
@@ -13,6 +13,7 @@ class ProfilerProfile;
 
 class McFont;
 class VertexArrayObject;
+class File;
 
 struct VProfGatherer;
 
@@ -45,8 +46,9 @@ class VisualProfiler : public CBaseUIElement {
         CPU_RAM_INFO = 2,
         ENGINE_INFO = 3,
         APP_INFO = 4,
+        RENDER_INFO = 5,
 
-        COUNT = 5
+        COUNT = 6
     };
 
     struct TEXT_LINE {
@@ -78,6 +80,8 @@ class VisualProfiler : public CBaseUIElement {
                                               SPIKE &spike);
     static void collectProfilerNodesSpikeRecursive(const ProfilerNode *node, int depth, std::vector<SPIKE> &spikeNodes);
 
+    void writeRenderStatsCsv();
+
     static int getGraphWidth();
     static int getGraphHeight();
 
@@ -100,6 +104,7 @@ class VisualProfiler : public CBaseUIElement {
     std::vector<GROUP> groups;
     std::vector<NODE> nodes;
     std::vector<SPIKE> spikes;
+    std::vector<NODE> renderNodes;  // scopes which drew anything last frame, most draw calls first
 
     SPIKE spike;
     std::vector<SPIKE> spikeNodes;
@@ -117,6 +122,7 @@ class VisualProfiler : public CBaseUIElement {
     std::vector<UString> appTextLines;
 
     std::unique_ptr<VProfGatherer> infoGatherer;
+    std::unique_ptr<File> renderStatsCsv;
 };
 
 extern VisualProfiler *vprof;
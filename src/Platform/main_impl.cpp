@@ -481,6 +481,7 @@ SDL_AppResult SDLMain::handleEvent(SDL_Event *event) {
 
         // keyboard events
         case SDL_EVENT_KEY_DOWN:
+            if(!event->key.repeat) m_engine->onInputEvent(event->key.timestamp);
             keyboard->onKeyDown({static_cast<SCANCODE>(event->key.scancode), static_cast<char16_t>(event->key.key),
                                  event->key.timestamp, event->key.repeat});
             break;
@@ -506,6 +507,7 @@ SDL_AppResult SDLMain::handleEvent(SDL_Event *event) {
 
         // mouse events
         case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            m_engine->onInputEvent(event->button.timestamp);
             mouse->onButtonChange({event->button.timestamp, (MouseButtonFlags)(1 << (event->button.button - 1)), true});
             break;
 
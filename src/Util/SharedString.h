@@ -0,0 +1,57 @@
+// Copyright (c) 2026, kiwec, All rights reserved.
+#pragma once
+#include "Hashing.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// immutable, reference counted string
+// copies only share the text, so e.g. all difficulties of a beatmapset can use one allocation for their metadata
+class SharedString {
+   public:
+    SharedString() = default;
+    SharedString(std::string str)
+        : ptr(str.empty() ? nullptr : std::make_shared<const std::string>(std::move(str))) {}
+    SharedString(std::string_view str) : SharedString(std::string{str}) {}
+    SharedString(const char *str) : SharedString(std::string{str}) {}
+
+    [[nodiscard]] inline const std::string &str() const { return this->ptr ? *this->ptr : empty_string(); }
+    inline operator const std::string &() const { return this->str(); }
+    inline operator std::string_view() const { return this->str(); }
+
+    [[nodiscard]] inline bool empty() const { return this->ptr == nullptr; }
+    [[nodiscard]] inline size_t size() const { return this->ptr ? this->ptr->size() : 0; }
+    [[nodiscard]] inline size_t length() const { return this->size(); }
+    [[nodiscard]] inline const char *c_str() const { return this->str().c_str(); }
+
+    [[nodiscard]] inline bool operator==(const SharedString &other) const {
+        return this->ptr == other.ptr || this->str() == other.str();
+    }
+
+   private:
+    static const std::string &empty_string() {
+        static const std::string empty;
+        return empty;
+    }
+
+    std::shared_ptr<const std::string> ptr;
+};
+
+// hands out the same SharedString for equal text, e.g. while loading a database where many entries repeat it
+class SharedStringPool {
+   public:
+    [[nodiscard]] SharedString intern(std::string_view str) {
+        if(str.empty()) return {};
+
+        if(const auto it = this->strings.find(str); it != this->strings.end()) return it->second;
+
+        SharedString shared{str};
+        // the key points into the shared text, which never moves
+        this->strings.emplace(shared.str(), shared);
+        return shared;
+    }
+
+   private:
+    Hash::flat::map<std::string_view, SharedString> strings;
+};